@@ -376,6 +376,12 @@ Api::IoCallUint64Result VclIoHandle::recvmsg(Buffer::RawSlice* slices, const uin
   return vclCallResultToIoCallResult(result);
 }
 
+Api::IoCallUint64Result VclIoHandle::sendmmsg(const Buffer::RawSlice*, uint64_t, int,
+                                              const Envoy::Network::Address::Ip*,
+                                              const Envoy::Network::Address::Instance&) {
+  PANIC("not implemented");
+}
+
 Api::IoCallUint64Result VclIoHandle::recvmmsg(RawSliceArrays&, uint32_t, const UdpSaveCmsgConfig&,
                                               RecvMsgOutput&) {
   PANIC("not implemented");
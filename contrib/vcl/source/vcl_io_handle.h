@@ -45,6 +45,9 @@ public:
   Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                   uint32_t self_port, const UdpSaveCmsgConfig& save_cmsg_config,
                                   RecvMsgOutput& output) override;
+  Api::IoCallUint64Result sendmmsg(const Buffer::RawSlice* datagrams, uint64_t num_datagrams,
+                                   int flags, const Envoy::Network::Address::Ip* self_ip,
+                                   const Envoy::Network::Address::Instance& peer_address) override;
   Api::IoCallUint64Result recvmmsg(RawSliceArrays& slices, uint32_t self_port,
                                    const UdpSaveCmsgConfig& save_cmsg_config,
                                    RecvMsgOutput& output) override;
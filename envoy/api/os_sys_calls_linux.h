@@ -25,6 +25,11 @@ public:
    * @see sched_getaffinity (man 2 sched_getaffinity)
    */
   virtual SysCallIntResult sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask) PURE;
+
+  /**
+   * @see sendfile (man 2 sendfile)
+   */
+  virtual SysCallSizeResult sendfile(int out_fd, int in_fd, off_t* offset, size_t count) PURE;
 };
 
 using LinuxOsSysCallsPtr = std::unique_ptr<LinuxOsSysCalls>;
@@ -47,6 +47,17 @@ struct ConstRawSlice {
 
 using RawSliceVector = absl::InlinedVector<RawSlice, 16>;
 
+/**
+ * A range of an open file which holds the same bytes as some buffered data. A writer that can move
+ * data from a file to its destination inside the kernel, e.g. with sendfile, may write the range
+ * instead of the data, saving a copy through user space.
+ */
+struct FileRange {
+  int fd_ = -1;
+  off_t offset_ = 0;
+  uint64_t length_ = 0;
+};
+
 /**
  * A wrapper class to facilitate passing in externally owned data to a buffer via addBufferFragment.
  * When the buffer no longer needs the data passed in through a fragment, it calls done() on it.
@@ -68,6 +79,12 @@ public:
    * Called by a buffer when the referenced data is no longer needed.
    */
   virtual void done() PURE;
+
+  /**
+   * @return the file range holding the referenced data, if the data is backed by a file. The file
+   * must stay open, and its contents unchanged, until done() is called.
+   */
+  virtual absl::optional<FileRange> fileRange() const { return absl::nullopt; }
 };
 
 /**
@@ -244,6 +261,13 @@ public:
    */
   virtual RawSlice frontSlice() const PURE;
 
+  /**
+   * Fetch the file range holding the data of the first non-zero-length slice in the buffer, if
+   * that slice was added from a file-backed BufferFragment and is still unmodified.
+   * @return the file range, whose length is that of the front slice, or absl::nullopt.
+   */
+  virtual absl::optional<FileRange> frontFileRange() const { return absl::nullopt; }
+
   /**
    * Transfer ownership of the front slice to the caller. Must only be called if the
    * buffer is not empty otherwise the implementation will have undefined behavior.
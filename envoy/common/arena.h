@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "envoy/common/optref.h"
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+
+/**
+ * A monotonic allocator for objects that share a lifetime, such as the objects belonging to one
+ * HTTP stream. Memory handed out by the arena is released all at once when the arena is destroyed.
+ */
+class Arena {
+public:
+  virtual ~Arena() = default;
+
+  /**
+   * Allocate memory from the arena.
+   * @param size supplies the number of bytes to allocate.
+   * @param alignment supplies the required alignment, which must be a power of two.
+   * @return memory that stays valid until the arena is destroyed.
+   */
+  virtual void* allocate(size_t size, size_t alignment) PURE;
+
+  /**
+   * @return the number of bytes handed out by allocate() so far.
+   */
+  virtual uint64_t bytesAllocated() const PURE;
+};
+
+/**
+ * Deleter for objects that live either in an Arena or on the heap. Objects placed in an arena are
+ * only destroyed; their memory is released together with the arena.
+ */
+template <class T> class ArenaDeleter {
+public:
+  ArenaDeleter() = default;
+  explicit ArenaDeleter(bool arena_allocated) : arena_allocated_(arena_allocated) {}
+  // Allows heap allocated std::unique_ptr<U> to be converted to ArenaPtr<T>.
+  template <class U, class = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+  ArenaDeleter(std::default_delete<U>) {} // NOLINT(google-explicit-constructor)
+  template <class U, class = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+  ArenaDeleter(const ArenaDeleter<U>& other) // NOLINT(google-explicit-constructor)
+      : arena_allocated_(other.arenaAllocated()) {}
+
+  void operator()(T* object) const {
+    if (arena_allocated_) {
+      object->~T();
+    } else {
+      delete object;
+    }
+  }
+
+  bool arenaAllocated() const { return arena_allocated_; }
+
+private:
+  bool arena_allocated_{false};
+};
+
+template <class T> using ArenaPtr = std::unique_ptr<T, ArenaDeleter<T>>;
+
+/**
+ * Construct an object in the arena if one is supplied, or on the heap otherwise.
+ */
+template <class T, class... Args> ArenaPtr<T> makeArenaPtr(OptRef<Arena> arena, Args&&... args) {
+  if (!arena.has_value()) {
+    return ArenaPtr<T>(new T(std::forward<Args>(args)...));
+  }
+  void* memory = arena->allocate(sizeof(T), alignof(T));
+  return ArenaPtr<T>(new (memory) T(std::forward<Args>(args)...), ArenaDeleter<T>(true));
+}
+
+/**
+ * Standard allocator backed by an Arena, e.g. for std::allocate_shared(). Deallocation is a no-op.
+ * Anything allocated this way, including shared_ptr control blocks, must not be referenced after
+ * the arena is destroyed.
+ */
+template <class T> class ArenaAllocator {
+public:
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena& arena) : arena_(&arena) {}
+  template <class U>
+  ArenaAllocator(const ArenaAllocator<U>& other) // NOLINT(google-explicit-constructor)
+      : arena_(&other.arena()) {}
+
+  T* allocate(size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+  void deallocate(T*, size_t) {}
+
+  Arena& arena() const { return *arena_; }
+
+  template <class U> bool operator==(const ArenaAllocator<U>& rhs) const {
+    return arena_ == &rhs.arena();
+  }
+  template <class U> bool operator!=(const ArenaAllocator<U>& rhs) const {
+    return !(*this == rhs);
+  }
+
+private:
+  Arena* arena_;
+};
+
+} // namespace Envoy
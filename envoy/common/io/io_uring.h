@@ -42,8 +42,21 @@ public:
    */
   IoUringSocket& socket() const { return socket_; }
 
+  /**
+   * Returns the flags of the completion being delivered for the request, e.g. `IORING_CQE_F_MORE`
+   * for a multishot request that stays armed, or `IORING_CQE_F_BUFFER` and the id of the provided
+   * buffer the data was received into. Injected completions have no flags.
+   */
+  uint32_t completionFlags() const { return completion_flags_; }
+
+  /**
+   * Sets the flags of the completion being delivered for the request.
+   */
+  void setCompletionFlags(uint32_t flags) { completion_flags_ = flags; }
+
 private:
   RequestType type_;
+  uint32_t completion_flags_{0};
   IoUringSocket& socket_;
 };
 
@@ -87,6 +100,31 @@ public:
    */
   virtual bool isEventfdRegistered() const PURE;
 
+  /**
+   * Returns true if the kernel supports zero copy sends with prepareSendmsgZc().
+   */
+  virtual bool isZeroCopySendSupported() const PURE;
+
+  /**
+   * Registers a ring of buffers shared by all recv requests of the ring. Since the kernel only
+   * takes a buffer from the ring when data arrives, read memory scales with in-flight data rather
+   * than with the number of sockets.
+   * @param buffer_count the number of buffers, which must be a power of two no larger than 32768.
+   * @param buffer_size the size of each buffer in bytes.
+   * Returns false if the kernel does not support provided buffer rings.
+   */
+  virtual bool registerBufferRing(uint32_t buffer_count, uint32_t buffer_size) PURE;
+
+  /**
+   * Returns the buffer with the given id from the registered buffer ring.
+   */
+  virtual uint8_t* providedBuffer(uint16_t buffer_id) PURE;
+
+  /**
+   * Hands the buffer with the given id back to the kernel once its data has been consumed.
+   */
+  virtual void recycleProvidedBuffer(uint16_t buffer_id) PURE;
+
   /**
    * Iterates over entries in the completion queue, calls the given callback for
    * every entry and marks them consumed.
@@ -118,6 +156,16 @@ public:
   virtual IoUringResult prepareReadv(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                                      off_t offset, Request* user_data) PURE;
 
+  /**
+   * Prepares a recv system call that receives into a buffer the kernel picks from the registered
+   * buffer ring when data arrives, and puts it into the submission queue. A multishot recv stays
+   * armed and completes with `IORING_CQE_F_MORE` until it is cancelled or fails, e.g. with -ENOBUFS
+   * when the buffer ring is empty.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareRecv(os_fd_t fd, bool multishot, Request* user_data) PURE;
+
   /**
    * Prepares a writev system call and puts it into the submission queue.
    * Returns IoUringResult::Failed in case the submission queue is full already
@@ -126,6 +174,18 @@ public:
   virtual IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                                       off_t offset, Request* user_data) PURE;
 
+  /**
+   * Prepares a zero copy sendmsg system call and puts it into the submission queue. The kernel
+   * sends from the memory referenced by the message rather than copying it into the socket
+   * buffer, so the memory has to stay valid until a second completion flagged with
+   * `IORING_CQE_F_NOTIF` arrives. The first completion carries the result and is flagged with
+   * `IORING_CQE_F_MORE` if the notification follows.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareSendmsgZc(os_fd_t fd, const struct msghdr* msg,
+                                         Request* user_data) PURE;
+
   /**
    * Prepares a close system call and puts it into the submission queue.
    * Returns IoUringResult::Failed in case the submission queue is full already
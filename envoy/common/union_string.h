@@ -126,15 +126,18 @@ public:
   }
 
   /**
-   * Trim trailing whitespaces from the InlinedString. Only supported by the "Inline" InlinedString
-   * representation.
+   * Trim trailing whitespaces from the string. A reference string is trimmed by narrowing the
+   * referenced view; the referenced data is not modified.
    */
   void rtrim() {
-    ASSERT(type() == Type::Inline);
     absl::string_view original = getStringView();
     absl::string_view rtrimmed = StringUtil::rtrim(original);
     if (original.size() != rtrimmed.size()) {
-      getInVec(buffer_).resize(rtrimmed.size());
+      if (type() == Type::Reference) {
+        buffer_ = rtrimmed;
+      } else {
+        getInVec(buffer_).resize(rtrimmed.size());
+      }
     }
   }
 
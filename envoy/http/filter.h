@@ -7,6 +7,7 @@
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/buffer/buffer.h"
+#include "envoy/common/arena.h"
 #include "envoy/common/scope_tracker.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/grpc/status.h"
@@ -1255,6 +1256,15 @@ public:
    * @param return the worker thread's dispatcher.
    */
   virtual Event::Dispatcher& dispatcher() PURE;
+
+  /**
+   * Allows filter factories to allocate per-stream filters in the stream's arena, for example with
+   * std::allocate_shared() and an ArenaAllocator. The arena is destroyed right after the filter
+   * chain, so a filter may only be allocated in it if neither the filter nor a weak_ptr to it is
+   * retained past the stream (e.g. by posted callbacks or async clients).
+   * @return the stream arena, or an empty OptRef if the stream has none.
+   */
+  virtual OptRef<Arena> streamArena() { return {}; }
 };
 } // namespace Http
 } // namespace Envoy
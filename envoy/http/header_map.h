@@ -129,6 +129,13 @@ public:
   explicit HeaderString(UnionString&& move_value) noexcept;
 };
 
+/**
+ * Opaque owner of memory that reference HeaderStrings point into. A codec that hands out
+ * references into its receive storage attaches the owner to the header map so that the referenced
+ * bytes live as long as the map does.
+ */
+using HeaderStorageConstSharedPtr = std::shared_ptr<const void>;
+
 /**
  * Encapsulates an individual header entry (including both key and value).
  */
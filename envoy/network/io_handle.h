@@ -129,6 +129,23 @@ public:
                                           int flags, const Address::Ip* self_ip,
                                           const Address::Instance& peer_address) PURE;
 
+  /**
+   * Send multiple datagrams to the same address with as few system calls as the platform allows.
+   * Datagrams of equal size may be sent as a single UDP GSO message.
+   * @param datagrams points to the datagrams to be sent, each in a single slice.
+   * @param num_datagrams indicates number of datagrams |datagrams| contains.
+   * @param flags flags to pass to the underlying send function.
+   * @param self_ip is the source address whose port should be ignored. Nullptr
+   * if caller wants kernel to select source address.
+   * @param peer_address is the destination address.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the number of leading datagrams sent for success.
+   */
+  virtual Api::IoCallUint64Result sendmmsg(const Buffer::RawSlice* datagrams,
+                                           uint64_t num_datagrams, int flags,
+                                           const Address::Ip* self_ip,
+                                           const Address::Instance& peer_address) PURE;
+
   struct RecvMsgPerPacketInfo {
     // The destination address from transport header.
     Address::InstanceConstSharedPtr local_address_;
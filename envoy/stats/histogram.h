@@ -24,6 +24,12 @@ public:
    * @return The buckets for the histogram. Each value is an upper bound of a bucket.
    */
   virtual ConstSupportedBuckets& buckets(absl::string_view stat_name) const PURE;
+
+  /**
+   * @return whether histogram values are recorded into per-thread atomic buckets, which can be
+   * merged without posting to the threads that recorded them.
+   */
+  virtual bool lockFreeRecording() const PURE;
 };
 
 using HistogramSettingsConstPtr = std::unique_ptr<const HistogramSettings>;
@@ -220,6 +220,14 @@ public:
    */
   virtual HostStats& stats() const PURE;
 
+  /**
+   * @return host specific stats, or nullptr if the host creates its stats lazily and has not
+   *         created them yet, in which case all of them are zero. Unlike stats(), this never
+   *         allocates stats, so paths that only read them (admin, load reports, load balancers)
+   *         should use it, in order not to allocate stats for hosts that never see traffic.
+   */
+  virtual HostStats* statsIfAllocated() const { return &stats(); }
+
   /**
    * @return custom stats for multi-dimensional load balancing.
    */
@@ -3,6 +3,7 @@
 #endif
 
 #include <sched.h>
+#include <sys/sendfile.h>
 
 #include <cerrno>
 
@@ -22,5 +23,11 @@ SysCallIntResult LinuxOsSysCallsImpl::setns(int fd, int nstype) const {
   return {rc, errno};
 }
 
+SysCallSizeResult LinuxOsSysCallsImpl::sendfile(int out_fd, int in_fd, off_t* offset,
+                                                size_t count) {
+  const ssize_t rc = ::sendfile(out_fd, in_fd, offset, count);
+  return {rc, errno};
+}
+
 } // namespace Api
 } // namespace Envoy
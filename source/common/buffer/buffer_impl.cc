@@ -19,10 +19,6 @@ namespace {
 constexpr uint64_t CopyThreshold = 512;
 } // namespace
 
-thread_local absl::InlinedVector<Slice::StoragePtr,
-                                 OwnedImpl::OwnedImplReservationSlicesOwnerMultiple::free_list_max_>
-    OwnedImpl::OwnedImplReservationSlicesOwnerMultiple::free_list_;
-
 uint64_t Slice::prepend(const void* data, uint64_t size) {
   const uint8_t* src = static_cast<const uint8_t*>(data);
   uint64_t copy_size;
@@ -245,6 +241,15 @@ RawSlice OwnedImpl::frontSlice() const {
   return {nullptr, 0};
 }
 
+absl::optional<FileRange> OwnedImpl::frontFileRange() const {
+  for (const auto& slice : slices_) {
+    if (slice.dataSize() > 0) {
+      return slice.fileRange();
+    }
+  }
+  return absl::nullopt;
+}
+
 SliceDataPtr OwnedImpl::extractMutableFrontSlice() {
   RELEASE_ASSERT(length_ > 0, "Extract called on empty buffer");
   // Remove zero byte fragments from the front of the queue to ensure
@@ -9,6 +9,7 @@
 #include "envoy/buffer/buffer.h"
 #include "envoy/http/stream_reset_handler.h"
 
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/common/assert.h"
 #include "source/common/common/non_copyable.h"
 #include "source/common/common/utility.h"
@@ -37,7 +38,8 @@ namespace Buffer {
 class Slice {
 public:
   using Reservation = RawSlice;
-  using StoragePtr = std::unique_ptr<uint8_t[]>;
+  // Storage is allocated from the thread's SlicePool and returned to it when released.
+  using StoragePtr = SlicePool::BlockPtr;
 
   struct SizedStorage {
     StoragePtr mem_{};
@@ -57,7 +59,7 @@ public:
    * @param account the account to charge.
    */
   Slice(uint64_t min_capacity, const BufferMemoryAccountSharedPtr& account)
-      : capacity_(sliceSize(min_capacity)), storage_(new uint8_t[capacity_]),
+      : capacity_(sliceSize(min_capacity)), storage_(SlicePool::allocate(capacity_)),
         base_(storage_.get()) {
     if (account) {
       account->charge(capacity_);
@@ -93,6 +95,12 @@ public:
         base_(static_cast<uint8_t*>(const_cast<void*>(fragment.data()))),
         reservable_(fragment.size()) {
     releasor_ = [&fragment]() { fragment.done(); };
+    absl::optional<FileRange> file_range = fragment.fileRange();
+    if (file_range.has_value()) {
+      ASSERT(file_range->length_ == fragment.size());
+      file_fd_ = file_range->fd_;
+      file_offset_ = file_range->offset_;
+    }
   }
 
   Slice(Slice&& rhs) noexcept {
@@ -104,8 +112,11 @@ public:
     drain_trackers_ = std::move(rhs.drain_trackers_);
     account_ = std::move(rhs.account_);
     releasor_.swap(rhs.releasor_);
+    file_fd_ = rhs.file_fd_;
+    file_offset_ = rhs.file_offset_;
 
     rhs.capacity_ = 0;
+    rhs.file_fd_ = -1;
     rhs.base_ = nullptr;
     rhs.data_ = 0;
     rhs.reservable_ = 0;
@@ -127,8 +138,11 @@ public:
       }
       releasor_ = rhs.releasor_;
       rhs.releasor_ = nullptr;
+      file_fd_ = rhs.file_fd_;
+      file_offset_ = rhs.file_offset_;
 
       rhs.capacity_ = 0;
+      rhs.file_fd_ = -1;
       rhs.base_ = nullptr;
       rhs.data_ = 0;
       rhs.reservable_ = 0;
@@ -149,6 +163,17 @@ public:
    */
   bool isMutable() const { return storage_ != nullptr; }
 
+  /**
+   * @return the range of the file holding the slice's data, if it was created from a file-backed
+   * BufferFragment. Such slices are immutable, so the range tracks the data as it is drained.
+   */
+  absl::optional<FileRange> fileRange() const {
+    if (file_fd_ == -1) {
+      return absl::nullopt;
+    }
+    return FileRange{file_fd_, static_cast<off_t>(file_offset_ + data_), dataSize()};
+  }
+
   /**
    * @return true if content in this Slice can be coalesced into another Slice.
    */
@@ -365,7 +390,7 @@ public:
    */
   static inline SizedStorage newStorage(uint64_t min_capacity) {
     const uint64_t slice_size = sliceSize(min_capacity);
-    return {StoragePtr{new uint8_t[slice_size]}, static_cast<size_t>(slice_size)};
+    return {SlicePool::allocate(slice_size), static_cast<size_t>(slice_size)};
   }
 
 protected:
@@ -396,6 +421,11 @@ protected:
 
   /** The releasor for the BufferFragment */
   std::function<void()> releasor_;
+
+  /** The file descriptor and offset of the file holding the data at base_, for slices created
+   * from a file-backed BufferFragment, or -1. */
+  int file_fd_ = -1;
+  off_t file_offset_ = 0;
 };
 
 class OwnedImpl;
@@ -663,6 +693,7 @@ public:
   void drain(uint64_t size) override;
   RawSliceVector getRawSlices(absl::optional<uint64_t> max_slices = absl::nullopt) const override;
   RawSlice frontSlice() const override;
+  absl::optional<FileRange> frontFileRange() const override;
   SliceDataPtr extractMutableFrontSlice() override;
   uint64_t length() const override;
   void* linearize(uint32_t size) override;
@@ -763,32 +794,10 @@ private:
 
   struct OwnedImplReservationSlicesOwnerMultiple : public OwnedImplReservationSlicesOwner {
   public:
-    static constexpr uint32_t free_list_max_ = Buffer::Reservation::MAX_SLICES_;
-
-    OwnedImplReservationSlicesOwnerMultiple() : free_list_ref_(free_list_) {}
-    ~OwnedImplReservationSlicesOwnerMultiple() override {
-      for (auto r = owned_storages_.rbegin(); r != owned_storages_.rend(); r++) {
-        if (r->mem_ != nullptr) {
-          ASSERT(r->len_ == Slice::default_slice_size_);
-          if (free_list_ref_.size() < free_list_max_) {
-            free_list_ref_.push_back(std::move(r->mem_));
-          }
-        }
-      }
-    }
-
     Slice::SizedStorage newStorage() {
       ASSERT(Slice::sliceSize(Slice::default_slice_size_) == Slice::default_slice_size_);
-
-      Slice::SizedStorage storage{nullptr, Slice::default_slice_size_};
-      if (!free_list_ref_.empty()) {
-        storage.mem_ = std::move(free_list_ref_.back());
-        free_list_ref_.pop_back();
-      } else {
-        storage.mem_.reset(new uint8_t[Slice::default_slice_size_]);
-      }
-
-      return storage;
+      // Unused storage is recycled by the thread's SlicePool when the owner is destroyed.
+      return {SlicePool::allocate(Slice::default_slice_size_), Slice::default_slice_size_};
     }
 
     absl::Span<Slice::SizedStorage> ownedStorages() override {
@@ -796,16 +805,6 @@ private:
     }
 
     absl::InlinedVector<Slice::SizedStorage, Buffer::Reservation::MAX_SLICES_> owned_storages_;
-
-  private:
-    // Thread local resolving introduces additional overhead. Initialize this reference once when
-    // constructing the owner to reduce thread local resolving to improve performance.
-    absl::InlinedVector<Slice::StoragePtr, free_list_max_>& free_list_ref_;
-
-    // Simple thread local cache to reduce unnecessary memory allocation and release. This cache
-    // is currently only used for multiple slices reservation because of the additional overhead
-    // that thread local resolving would introduce.
-    static thread_local absl::InlinedVector<Slice::StoragePtr, free_list_max_> free_list_;
   };
 
   struct OwnedImplReservationSlicesOwnerSingle : public OwnedImplReservationSlicesOwner {
@@ -0,0 +1,189 @@
+#include "source/common/buffer/slice_pool.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+std::atomic<uint32_t> max_blocks_per_class{SlicePoolConfig::DefaultMaxBlocksPerClass};
+std::atomic<uint64_t> max_cached_bytes{SlicePoolConfig::DefaultMaxCachedBytes};
+std::atomic<uint64_t> cross_thread_releases{};
+// Bumped to make every thread drop its cached blocks.
+std::atomic<uint64_t> release_generation{};
+
+// Set once the calling thread's pool has been destroyed during thread exit, after which blocks
+// released on the thread go to the heap. Trivially destructible so it is usable at any point.
+thread_local bool pool_destroyed = false;
+
+/**
+ * All live pools, plus the counters of the pools whose threads have exited.
+ */
+struct PoolRegistry {
+  absl::Mutex mutex_;
+  SlicePool* head_ ABSL_GUARDED_BY(mutex_){};
+  SlicePoolStats retired_ ABSL_GUARDED_BY(mutex_);
+};
+
+PoolRegistry& registry() { MUTABLE_CONSTRUCT_ON_FIRST_USE(PoolRegistry); }
+
+} // namespace
+
+struct ThreadLocalSlicePool {
+  ~ThreadLocalSlicePool() { pool_destroyed = true; }
+
+  SlicePool pool_;
+};
+
+SlicePool::SlicePool() : release_generation_(release_generation.load(std::memory_order_relaxed)) {
+  PoolRegistry& pools = registry();
+  absl::MutexLock lock(&pools.mutex_);
+  next_ = pools.head_;
+  if (next_ != nullptr) {
+    next_->prev_ = this;
+  }
+  pools.head_ = this;
+}
+
+SlicePool::~SlicePool() {
+  for (auto& free_list : free_lists_) {
+    for (uint8_t* block : free_list) {
+      delete[] block;
+    }
+  }
+
+  PoolRegistry& pools = registry();
+  absl::MutexLock lock(&pools.mutex_);
+  if (prev_ != nullptr) {
+    prev_->next_ = next_;
+  } else {
+    pools.head_ = next_;
+  }
+  if (next_ != nullptr) {
+    next_->prev_ = prev_;
+  }
+  pools.retired_.hits_ += hits_.load(std::memory_order_relaxed);
+  pools.retired_.misses_ += misses_.load(std::memory_order_relaxed);
+  pools.retired_.overflows_ += overflows_.load(std::memory_order_relaxed);
+}
+
+SlicePool* SlicePool::local() {
+  if (pool_destroyed) {
+    return nullptr;
+  }
+  static thread_local ThreadLocalSlicePool pool;
+  return &pool.pool_;
+}
+
+uint32_t SlicePool::sizeClass(uint64_t size) {
+  if (size < MinBlockSize || size > MaxBlockSize || size % PageSize != 0) {
+    return NumSizeClasses;
+  }
+  return (size - MinBlockSize) / PageSize;
+}
+
+SlicePool::BlockPtr SlicePool::allocate(uint64_t size) {
+  const uint32_t size_class = sizeClass(size);
+  const bool pooled =
+      size_class < NumSizeClasses && max_blocks_per_class.load(std::memory_order_relaxed) > 0;
+  SlicePool* pool = pooled ? local() : nullptr;
+  if (pool == nullptr) {
+    return {new uint8_t[size], Deleter(size, nullptr)};
+  }
+
+  pool->dropCacheIfRequested();
+  uint8_t* block = pool->take(size_class);
+  if (block != nullptr) {
+    increment(pool->hits_);
+  } else {
+    increment(pool->misses_);
+    block = new uint8_t[size];
+  }
+  return {block, Deleter(size, pool)};
+}
+
+void SlicePool::Deleter::operator()(uint8_t* block) const {
+  if (owner_ != nullptr) {
+    SlicePool* pool = local();
+    if (pool == owner_) {
+      pool->dropCacheIfRequested();
+      if (pool->put(block, sizeClass(size_), size_)) {
+        return;
+      }
+      increment(pool->overflows_);
+    } else {
+      cross_thread_releases.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  delete[] block;
+}
+
+void SlicePool::dropCacheIfRequested() {
+  const uint64_t generation = release_generation.load(std::memory_order_relaxed);
+  if (generation == release_generation_) {
+    return;
+  }
+  release_generation_ = generation;
+  for (auto& free_list : free_lists_) {
+    for (uint8_t* block : free_list) {
+      delete[] block;
+    }
+    free_list.clear();
+  }
+  cached_bytes_.store(0, std::memory_order_relaxed);
+}
+
+uint8_t* SlicePool::take(uint32_t size_class) {
+  auto& free_list = free_lists_[size_class];
+  if (free_list.empty()) {
+    return nullptr;
+  }
+  uint8_t* block = free_list.back();
+  free_list.pop_back();
+  increment(cached_bytes_, 0 - (MinBlockSize + size_class * PageSize));
+  return block;
+}
+
+bool SlicePool::put(uint8_t* block, uint32_t size_class, uint64_t size) {
+  ASSERT(size_class < NumSizeClasses);
+  auto& free_list = free_lists_[size_class];
+  const uint64_t cached_bytes = cached_bytes_.load(std::memory_order_relaxed);
+  if (free_list.size() >= max_blocks_per_class.load(std::memory_order_relaxed) ||
+      cached_bytes + size > max_cached_bytes.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  free_list.push_back(block);
+  cached_bytes_.store(cached_bytes + size, std::memory_order_relaxed);
+  return true;
+}
+
+void SlicePool::setConfig(const SlicePoolConfig& config) {
+  max_blocks_per_class.store(config.max_blocks_per_class_, std::memory_order_relaxed);
+  max_cached_bytes.store(config.max_cached_bytes_, std::memory_order_relaxed);
+  releaseCachedBlocks();
+}
+
+void SlicePool::releaseCachedBlocks() {
+  release_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+SlicePoolStats SlicePool::stats() {
+  PoolRegistry& pools = registry();
+  absl::MutexLock lock(&pools.mutex_);
+  SlicePoolStats stats = pools.retired_;
+  for (const SlicePool* pool = pools.head_; pool != nullptr; pool = pool->next_) {
+    stats.hits_ += pool->hits_.load(std::memory_order_relaxed);
+    stats.misses_ += pool->misses_.load(std::memory_order_relaxed);
+    stats.overflows_ += pool->overflows_.load(std::memory_order_relaxed);
+    stats.cached_bytes_ += pool->cached_bytes_.load(std::memory_order_relaxed);
+  }
+  stats.cross_thread_releases_ = cross_thread_releases.load(std::memory_order_relaxed);
+  return stats;
+}
+
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "source/common/common/non_copyable.h"
+
+#include "absl/container/inlined_vector.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * Process-wide limits of the slice pool. Each thread caches at most max_blocks_per_class_ blocks
+ * of every size class and at most max_cached_bytes_ bytes in total.
+ */
+struct SlicePoolConfig {
+  static constexpr uint32_t DefaultMaxBlocksPerClass = 16;
+  static constexpr uint64_t DefaultMaxCachedBytes = 1024 * 1024;
+
+  uint32_t max_blocks_per_class_{DefaultMaxBlocksPerClass};
+  uint64_t max_cached_bytes_{DefaultMaxCachedBytes};
+};
+
+/**
+ * Totals over all threads since process start.
+ */
+struct SlicePoolStats {
+  // Allocations served from a thread's cache.
+  uint64_t hits_{};
+  // Allocations of a pooled size class that had to go to the heap.
+  uint64_t misses_{};
+  // Pooled blocks released to the heap because the releasing thread's cache was full.
+  uint64_t overflows_{};
+  // Pooled blocks released to the heap because they were freed on a different thread.
+  uint64_t cross_thread_releases_{};
+  // Bytes currently cached by all threads.
+  uint64_t cached_bytes_{};
+};
+
+/**
+ * Thread-local, size-classed pool of slice storage blocks. Blocks whose size is a page multiple
+ * between MinBlockSize and MaxBlockSize are returned to the pool of the thread that allocated
+ * them when they are freed on that thread; blocks freed on another thread, and blocks of other
+ * sizes, go back to the heap. This keeps the 16 KiB blocks churned by proxying large bodies out
+ * of the global allocator.
+ */
+class SlicePool : NonCopyable {
+public:
+  static constexpr uint64_t PageSize = 4096;
+  static constexpr uint64_t MinBlockSize = 16384;
+  static constexpr uint64_t MaxBlockSize = 65536;
+  static constexpr uint32_t NumSizeClasses = (MaxBlockSize - MinBlockSize) / PageSize + 1;
+
+  /**
+   * Deleter for blocks returned by allocate(). Returns pooled blocks to the pool of the current
+   * thread if it is the one that allocated them.
+   */
+  class Deleter {
+  public:
+    Deleter() = default;
+    Deleter(uint64_t size, const SlicePool* owner) : size_(size), owner_(owner) {}
+
+    void operator()(uint8_t* block) const;
+
+  private:
+    uint64_t size_{};
+    // Pool of the allocating thread, or nullptr if the block is not pooled. Only compared with
+    // the current thread's pool and never dereferenced, so it may outlive its thread.
+    const SlicePool* owner_{};
+  };
+  using BlockPtr = std::unique_ptr<uint8_t[], Deleter>;
+
+  /**
+   * Allocate a block of storage.
+   * @param size supplies the size of the block in bytes.
+   * @return the block, which is released to the pool or the heap when destroyed.
+   */
+  static BlockPtr allocate(uint64_t size);
+
+  /**
+   * Set the limits of all thread pools. Setting max_blocks_per_class_ to 0 disables the pools.
+   * Cached blocks are dropped as each thread next uses its pool.
+   */
+  static void setConfig(const SlicePoolConfig& config);
+
+  /**
+   * Ask every thread to return its cached blocks to the heap. Threads drop their caches the next
+   * time they allocate or release a pooled block, so the memory is reclaimed on busy threads first.
+   */
+  static void releaseCachedBlocks();
+
+  /**
+   * @return totals over all threads.
+   */
+  static SlicePoolStats stats();
+
+  ~SlicePool();
+
+private:
+  SlicePool();
+
+  static SlicePool* local();
+  static uint32_t sizeClass(uint64_t size);
+
+  void dropCacheIfRequested();
+  uint8_t* take(uint32_t size_class);
+  bool put(uint8_t* block, uint32_t size_class, uint64_t size);
+
+  template <class T> static void increment(std::atomic<T>& counter, T delta = 1) {
+    // Only the owning thread writes its counters; stats() reads them concurrently.
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+  }
+
+  std::array<absl::InlinedVector<uint8_t*, SlicePoolConfig::DefaultMaxBlocksPerClass>,
+             NumSizeClasses>
+      free_lists_;
+  std::atomic<uint64_t> hits_{};
+  std::atomic<uint64_t> misses_{};
+  std::atomic<uint64_t> overflows_{};
+  std::atomic<uint64_t> cached_bytes_{};
+  // The release generation the cache was last dropped for. See releaseCachedBlocks().
+  uint64_t release_generation_{};
+  // Pools are linked into a process-wide list so that stats() can sum their counters.
+  SlicePool* next_{};
+  SlicePool* prev_{};
+
+  friend struct ThreadLocalSlicePool;
+};
+
+} // namespace Buffer
+} // namespace Envoy
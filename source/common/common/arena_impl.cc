@@ -0,0 +1,32 @@
+#include "source/common/common/arena_impl.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+
+MonotonicArena::MonotonicArena(uint32_t block_size) : block_size_(block_size) {
+  ASSERT(block_size_ > 0);
+}
+
+void* MonotonicArena::allocate(size_t size, size_t alignment) {
+  ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+  size_t padding = -reinterpret_cast<uintptr_t>(current_) & (alignment - 1);
+  if (current_ == nullptr || padding + size > remaining_) {
+    // Over-allocate by the alignment so that any alignment can be satisfied in a fresh block.
+    const size_t block_size = std::max<size_t>(block_size_, size + alignment);
+    blocks_.emplace_back(new char[block_size]);
+    current_ = blocks_.back().get();
+    remaining_ = block_size;
+    padding = -reinterpret_cast<uintptr_t>(current_) & (alignment - 1);
+  }
+
+  char* result = current_ + padding;
+  current_ = result + size;
+  remaining_ -= padding + size;
+  bytes_allocated_ += size;
+  return result;
+}
+
+} // namespace Envoy
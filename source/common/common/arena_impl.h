@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/arena.h"
+
+#include "source/common/common/non_copyable.h"
+
+#include "absl/container/inlined_vector.h"
+
+namespace Envoy {
+
+/**
+ * Arena that carves allocations out of heap blocks of a fixed size. The first block is reserved
+ * on the first allocation, so an unused arena costs no heap memory. Allocations that do not fit in
+ * the current block start a new one; allocations larger than the block size get a block of their
+ * own.
+ */
+class MonotonicArena : public Arena, NonCopyable {
+public:
+  explicit MonotonicArena(uint32_t block_size);
+
+  // Arena
+  void* allocate(size_t size, size_t alignment) override;
+  uint64_t bytesAllocated() const override { return bytes_allocated_; }
+
+  /**
+   * @return the number of heap blocks reserved by the arena.
+   */
+  uint32_t blockCount() const { return blocks_.size(); }
+
+private:
+  const uint32_t block_size_;
+  absl::InlinedVector<std::unique_ptr<char[]>, 2> blocks_;
+  char* current_{};
+  size_t remaining_{};
+  uint64_t bytes_allocated_{};
+};
+
+} // namespace Envoy
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include "source/common/common/assert.h"
 
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
@@ -109,21 +111,21 @@ public:
    * @return false when a value already exists for the given key.
    */
   bool add(absl::string_view key, Value value, bool overwrite_existing = true) {
-    int32_t current = 0;
-    for (uint8_t c : key) {
-      int32_t next = getChildIndex(current, c);
-      if (next == NoNode) {
-        next = nodes_.size();
-        nodes_.emplace_back();
-        setChildIndex(current, c, next);
-      }
-      current = next;
-    }
-    if (nodes_[current].value_ && !overwrite_existing) {
-      return false;
-    }
-    nodes_[current].value_ = std::move(value);
-    return true;
+    return addRange(key.begin(), key.end(), std::move(value), overwrite_existing);
+  }
+
+  /**
+   * Adds an entry to the Trie keyed by the reverse of the given Key. Entries added this way
+   * should be looked up with findLongestSuffix(), and must not be mixed with entries added
+   * with add() in the same table.
+   * @param key the key used to add the entry.
+   * @param value the value to be associated with the key.
+   * @param overwrite_existing will overwrite the value when the value for a given key already
+   * exists.
+   * @return false when a value already exists for the given key.
+   */
+  bool addReversed(absl::string_view key, Value value, bool overwrite_existing = true) {
+    return addRange(key.rbegin(), key.rend(), std::move(value), overwrite_existing);
   }
 
   /**
@@ -174,11 +176,49 @@ public:
    *         no keys that are a prefix of the input key, an empty-initialized Value.
    */
   Value findLongestPrefix(absl::string_view key) const {
+    return findLongestRange(key.begin(), key.end());
+  }
+
+  /**
+   * Finds the entry with the longest key that is a suffix of the specified key. Only entries
+   * added with addReversed() are considered.
+   * Complexity is O(min(longest key suffix, key length)).
+   * @param key the key used to find.
+   * @return a value whose key is a suffix of the specified key. If there are
+   *         multiple such values, the one with the longest key. If there are
+   *         no keys that are a suffix of the input key, an empty-initialized Value.
+   */
+  Value findLongestSuffix(absl::string_view key) const {
+    return findLongestRange(key.rbegin(), key.rend());
+  }
+
+private:
+  template <class Iterator>
+  bool addRange(Iterator begin, Iterator end, Value value, bool overwrite_existing) {
+    int32_t current = 0;
+    for (Iterator it = begin; it != end; ++it) {
+      const uint8_t c = *it;
+      int32_t next = getChildIndex(current, c);
+      if (next == NoNode) {
+        next = nodes_.size();
+        nodes_.emplace_back();
+        setChildIndex(current, c, next);
+      }
+      current = next;
+    }
+    if (nodes_[current].value_ && !overwrite_existing) {
+      return false;
+    }
+    nodes_[current].value_ = std::move(value);
+    return true;
+  }
+
+  template <class Iterator> Value findLongestRange(Iterator begin, Iterator end) const {
     int32_t current = 0;
     int32_t result = 0;
 
-    for (uint8_t c : key) {
-      current = getChildIndex(current, c);
+    for (Iterator it = begin; it != end; ++it) {
+      current = getChildIndex(current, static_cast<uint8_t>(*it));
 
       if (current == NoNode) {
         return nodes_[result].value_;
@@ -189,7 +229,6 @@ public:
     return nodes_[result].value_;
   }
 
-private:
   // Flat representation of the tree - each node has a vector of indices to its
   // child nodes.
   // Initialized with a single empty node as the root node.
@@ -9,6 +9,8 @@ namespace Compression {
 namespace Zstd {
 namespace Compressor {
 
+using ZstdCCtxPtr = std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)>;
+
 /**
  * Implementation of compressor's interface.
  */
@@ -19,6 +21,13 @@ public:
   ZstdCompressorImplBase(uint32_t compression_level, bool enable_checksum, uint32_t strategy,
                          uint32_t chunk_size);
 
+  /**
+   * Constructor that compresses with an existing context, e.g. one reused from an earlier stream,
+   * which must have been reset.
+   */
+  ZstdCompressorImplBase(ZstdCCtxPtr cctx, uint32_t compression_level, bool enable_checksum,
+                         uint32_t strategy, uint32_t chunk_size);
+
   // Compression::Compressor::Compressor
   void compress(Buffer::Instance& buffer, Envoy::Compression::Compressor::State state) override;
 
@@ -33,7 +42,7 @@ protected:
 
   virtual void compressPostprocess(Buffer::Instance& accumulation_buffer) PURE;
 
-  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx_;
+  ZstdCCtxPtr cctx_;
   const uint32_t compression_level_;
 };
 
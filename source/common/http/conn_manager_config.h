@@ -54,6 +54,7 @@ namespace Http {
   COUNTER(downstream_rq_3xx)                                                                       \
   COUNTER(downstream_rq_4xx)                                                                       \
   COUNTER(downstream_rq_5xx)                                                                       \
+  COUNTER(downstream_rq_arena_overflow)                                                            \
   COUNTER(downstream_rq_completed)                                                                 \
   COUNTER(downstream_rq_failed_path_normalization)                                                 \
   COUNTER(downstream_rq_http1_total)                                                               \
@@ -86,6 +87,7 @@ namespace Http {
   GAUGE(downstream_cx_http1_soft_drain, Accumulate)                                                \
   GAUGE(downstream_rq_active, Accumulate)                                                          \
   HISTOGRAM(downstream_cx_length_ms, Milliseconds)                                                 \
+  HISTOGRAM(downstream_rq_arena_bytes, Bytes)                                                      \
   HISTOGRAM(downstream_rq_time, Milliseconds)
 
 /**
@@ -560,6 +562,12 @@ public:
    *         Connection Lifetime.
    */
   virtual bool addProxyProtocolConnectionState() const PURE;
+
+  /**
+   * @return the block size of the per-stream arena that filter wrappers and arena aware filters
+   *         are allocated in, or 0 if streams do not use an arena.
+   */
+  virtual uint32_t streamArenaBlockSize() const PURE;
 };
 
 using ConnectionManagerConfigSharedPtr = std::shared_ptr<ConnectionManagerConfig>;
@@ -363,6 +363,13 @@ void ConnectionManagerImpl::doDeferredStreamDestroy(ActiveStream& stream) {
 
   stream.filter_manager_.destroyFilters();
 
+  if (stream.arena_ != nullptr) {
+    stats_.named_.downstream_rq_arena_bytes_.recordValue(stream.arena_->bytesAllocated());
+    if (stream.arena_->blockCount() > 1) {
+      stats_.named_.downstream_rq_arena_overflow_.inc();
+    }
+  }
+
   dispatcher_->deferredDelete(stream.removeFromList(streams_));
 
   // The response_encoder should never be dangling (unless we're destroying a
@@ -818,6 +825,10 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
                                              : makeOptRef<const TracingConnectionManagerConfig>(
                                                    *connection_manager_.config_->tracingConfig())),
       stream_id_(connection_manager.random_generator_.random()),
+      arena_(connection_manager_.config_->streamArenaBlockSize() > 0
+                 ? std::make_unique<MonotonicArena>(
+                       connection_manager_.config_->streamArenaBlockSize())
+                 : nullptr),
       filter_manager_(*this, *connection_manager_.dispatcher_,
                       connection_manager_.read_callbacks_->connection(), stream_id_,
                       std::move(account), connection_manager_.config_->proxy100Continue(),
@@ -37,6 +37,7 @@
 #include "envoy/upstream/upstream.h"
 
 #include "source/common/buffer/watermark_buffer.h"
+#include "source/common/common/arena_impl.h"
 #include "source/common/common/dump_state_utils.h"
 #include "source/common/common/linked_object.h"
 #include "source/common/grpc/common.h"
@@ -298,6 +299,7 @@ private:
     const ScopeTrackedObject& scope() override;
     OptRef<DownstreamStreamFilterCallbacks> downstreamCallbacks() override { return *this; }
     bool isHalfCloseEnabled() override { return connection_manager_.allow_upstream_half_close_; }
+    OptRef<Arena> streamArena() override { return makeOptRefFromPtr<Arena>(arena_.get()); }
 
     // DownstreamStreamFilterCallbacks
     void setRoute(Router::RouteConstSharedPtr route) override;
@@ -440,6 +442,10 @@ private:
     // both locations, then refer to the FM when doing stream logs.
     const uint64_t stream_id_;
 
+    // Per-stream arena, if configured. It must outlive the FM, which places the filter wrappers
+    // in it.
+    const std::unique_ptr<MonotonicArena> arena_;
+
     RequestHeaderMapSharedPtr request_headers_;
     RequestTrailerMapPtr request_trailers_;
 
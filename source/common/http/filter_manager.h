@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/common/arena.h"
 #include "envoy/common/optref.h"
 #include "envoy/extensions/filters/network/http_connection_manager/v3/http_connection_manager.pb.h"
 #include "envoy/extensions/filters/network/http_connection_manager/v3/http_connection_manager.pb.validate.h"
@@ -37,8 +38,9 @@ class DownstreamFilterManager;
 struct ActiveStreamFilterBase;
 struct ActiveStreamDecoderFilter;
 struct ActiveStreamEncoderFilter;
-using ActiveStreamDecoderFilterPtr = std::unique_ptr<ActiveStreamDecoderFilter>;
-using ActiveStreamEncoderFilterPtr = std::unique_ptr<ActiveStreamEncoderFilter>;
+// Filter wrappers are placed in the stream arena when the stream has one.
+using ActiveStreamDecoderFilterPtr = ArenaPtr<ActiveStreamDecoderFilter>;
+using ActiveStreamEncoderFilterPtr = ArenaPtr<ActiveStreamEncoderFilter>;
 
 constexpr absl::string_view LocalReplyFilterStateKey =
     "envoy.filters.network.http_connection_manager.local_reply_owner";
@@ -586,6 +588,13 @@ public:
    * Returns the DownstreamStreamFilterCallbacks for downstream HTTP filters.
    */
   virtual OptRef<DownstreamStreamFilterCallbacks> downstreamCallbacks() { return {}; }
+
+  /**
+   * Returns the arena that per-stream objects such as the filter wrappers are allocated in, if
+   * any. The arena must outlive the filter manager.
+   */
+  virtual OptRef<Arena> streamArena() { return {}; }
+
   /**
    * Returns if close from the upstream is to be handled with half-close semantics.
    * This is used for HTTP/1.1 codec.
@@ -991,24 +1000,25 @@ private:
     void addStreamDecoderFilter(Http::StreamDecoderFilterSharedPtr filter) override {
       manager_.filters_.push_back(filter.get());
 
-      manager_.decoder_filters_.entries_.emplace_back(
-          std::make_unique<ActiveStreamDecoderFilter>(manager_, std::move(filter), context_));
+      manager_.decoder_filters_.entries_.emplace_back(makeArenaPtr<ActiveStreamDecoderFilter>(
+          streamArena(), manager_, std::move(filter), context_));
     }
 
     void addStreamEncoderFilter(Http::StreamEncoderFilterSharedPtr filter) override {
       manager_.filters_.push_back(filter.get());
 
-      manager_.encoder_filters_.entries_.emplace_back(
-          std::make_unique<ActiveStreamEncoderFilter>(manager_, std::move(filter), context_));
+      manager_.encoder_filters_.entries_.emplace_back(makeArenaPtr<ActiveStreamEncoderFilter>(
+          streamArena(), manager_, std::move(filter), context_));
     }
 
     void addStreamFilter(Http::StreamFilterSharedPtr filter) override {
       manager_.filters_.push_back(filter.get());
 
+      const OptRef<Arena> arena = streamArena();
       manager_.decoder_filters_.entries_.emplace_back(
-          std::make_unique<ActiveStreamDecoderFilter>(manager_, filter, context_));
+          makeArenaPtr<ActiveStreamDecoderFilter>(arena, manager_, filter, context_));
       manager_.encoder_filters_.entries_.emplace_back(
-          std::make_unique<ActiveStreamEncoderFilter>(manager_, std::move(filter), context_));
+          makeArenaPtr<ActiveStreamEncoderFilter>(arena, manager_, std::move(filter), context_));
     }
 
     void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) override {
@@ -1017,6 +1027,10 @@ private:
 
     Event::Dispatcher& dispatcher() override { return manager_.dispatcher_; }
 
+    OptRef<Arena> streamArena() override {
+      return manager_.filter_manager_callbacks_.streamArena();
+    }
+
   private:
     FilterManager& manager_;
     const Http::FilterContext& context_;
@@ -340,6 +340,9 @@ protected:
   virtual void clearInline() PURE;
   virtual HeaderEntryImpl** inlineHeaders() PURE;
 
+  // Keeps alive codec memory that reference header values point into. Declared before headers_
+  // so that it outlives the entries referencing it.
+  HeaderStorageConstSharedPtr referenced_storage_;
   HeaderList headers_;
   // TODO(mattklein123): The formatter does not currently get copied when a header map gets
   // copied. This may be problematic in certain cases like request shadowing. This is omitted
@@ -370,6 +373,11 @@ public:
   void setFormatter(StatefulHeaderKeyFormatterPtr&& formatter) {
     formatter_ = std::move(formatter);
   }
+  // Attaches storage that reference header values added by a codec point into. The storage is
+  // released when the map is destroyed. Copies of the map copy the values and do not share it.
+  void setReferencedStorage(HeaderStorageConstSharedPtr storage) {
+    referenced_storage_ = std::move(storage);
+  }
 
   // Implementation of Http::HeaderMap that passes through to HeaderMapImpl.
   bool operator==(const HeaderMap& rhs) const override { return HeaderMapImpl::operator==(rhs); }
@@ -6,6 +6,7 @@
 
 #include "source/common/common/assert.h"
 #include "source/common/http/headers.h"
+#include "source/common/http/http1/header_scanner.h"
 #include "source/common/runtime/runtime_features.h"
 
 #include "absl/strings/ascii.h"
@@ -24,14 +25,12 @@ constexpr absl::string_view kColonSlashSlash = "://";
 // Response must start with "HTTP".
 constexpr char kResponseFirstByte = 'H';
 constexpr absl::string_view kHttpVersionPrefix = "HTTP/";
-
-// Allowed characters for field names according to Section 5.1
-// and for methods according to Section 9.1 of RFC 9110:
-// https://www.rfc-editor.org/rfc/rfc9110.html
-constexpr absl::string_view kValidCharacters =
-    "!#$%&'*+-.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ^_`abcdefghijklmnopqrstuvwxyz|~";
-constexpr absl::string_view::iterator kValidCharactersBegin = kValidCharacters.begin();
-constexpr absl::string_view::iterator kValidCharactersEnd = kValidCharacters.end();
+// Shorter header values fit in the inline storage of HeaderString and are cheaper to copy than to
+// pin the header storage of the whole message for.
+constexpr size_t kMinReferencedHeaderValueSize = 128;
+// The number of released header storage objects a parser keeps for reuse. A connection rarely
+// has more than a couple of header maps alive at a time.
+constexpr size_t kMaxPooledHeaders = 4;
 
 bool isFirstCharacterOfValidMethod(char c) {
   static constexpr char kValidFirstCharacters[] = {'A', 'B', 'C', 'D', 'G', 'H', 'L', 'M',
@@ -46,10 +45,7 @@ bool isFirstCharacterOfValidMethod(char c) {
 // enabled.
 bool isMethodValid(absl::string_view method, bool allow_custom_methods) {
   if (allow_custom_methods) {
-    return !method.empty() &&
-           std::all_of(method.begin(), method.end(), [](absl::string_view::value_type c) {
-             return std::binary_search(kValidCharactersBegin, kValidCharactersEnd, c);
-           });
+    return !method.empty() && HeaderScanner::isToken(method);
   }
 
   static constexpr absl::string_view kValidMethods[] = {
@@ -139,18 +135,17 @@ bool isVersionValid(absl::string_view version_input) {
          version_input[1] == '.' && absl::ascii_isdigit(version_input[2]);
 }
 
-bool isHeaderNameValid(absl::string_view name) {
-  return std::all_of(name.begin(), name.end(), [](absl::string_view::value_type c) {
-    return std::binary_search(kValidCharactersBegin, kValidCharactersEnd, c);
-  });
-}
+bool isHeaderNameValid(absl::string_view name) { return HeaderScanner::isToken(name); }
 
 } // anonymous namespace
 
 BalsaParser::BalsaParser(MessageType type, ParserCallbacks* connection, size_t max_header_length,
-                         bool enable_trailers, bool allow_custom_methods)
-    : message_type_(type), connection_(connection), enable_trailers_(enable_trailers),
-      allow_custom_methods_(allow_custom_methods) {
+                         bool enable_trailers, bool allow_custom_methods,
+                         bool reference_header_values)
+    : headers_pool_(std::make_shared<HeadersPool>()), headers_(acquireHeaders()),
+      message_type_(type), connection_(connection), enable_trailers_(enable_trailers),
+      allow_custom_methods_(allow_custom_methods),
+      reference_header_values_(reference_header_values) {
   ASSERT(connection_ != nullptr);
 
   quiche::HttpValidationPolicy http_validation_policy;
@@ -165,7 +160,7 @@ BalsaParser::BalsaParser(MessageType type, ParserCallbacks* connection, size_t m
       "envoy.reloadable_features.http1_balsa_disallow_lone_cr_in_chunk_extension");
   framer_.set_http_validation_policy(http_validation_policy);
 
-  framer_.set_balsa_headers(&headers_);
+  framer_.set_balsa_headers(headers_.get());
   framer_.set_balsa_visitor(this);
   framer_.set_max_header_length(max_header_length);
   framer_.set_invalid_chars_level(quiche::BalsaFrame::InvalidCharsLevel::kError);
@@ -189,7 +184,7 @@ size_t BalsaParser::execute(const char* slice, int len) {
       if (first_message_) {
         first_message_ = false;
       } else {
-        framer_.Reset();
+        resetFramer();
       }
     }
 
@@ -218,7 +213,7 @@ size_t BalsaParser::execute(const char* slice, int len) {
 
   if (len == 0 && headers_done_ && !isChunked() &&
       ((message_type_ == MessageType::Response && hasTransferEncoding()) ||
-       !headers_.content_length_valid())) {
+       !headers_->content_length_valid())) {
     MessageDone();
     return 0;
   }
@@ -246,33 +241,38 @@ CallbackResult BalsaParser::pause() {
 ParserStatus BalsaParser::getStatus() const { return status_; }
 
 Http::Code BalsaParser::statusCode() const {
-  return static_cast<Http::Code>(headers_.parsed_response_code());
+  return static_cast<Http::Code>(headers_->parsed_response_code());
 }
 
 bool BalsaParser::isHttp11() const {
   if (message_type_ == MessageType::Request) {
-    return absl::EndsWith(headers_.first_line(), Http::Headers::get().ProtocolStrings.Http11String);
+    return absl::EndsWith(headers_->first_line(),
+                          Http::Headers::get().ProtocolStrings.Http11String);
   } else {
-    return absl::StartsWith(headers_.first_line(),
+    return absl::StartsWith(headers_->first_line(),
                             Http::Headers::get().ProtocolStrings.Http11String);
   }
 }
 
 absl::optional<uint64_t> BalsaParser::contentLength() const {
-  if (!headers_.content_length_valid()) {
+  if (!headers_->content_length_valid()) {
     return absl::nullopt;
   }
-  return headers_.content_length();
+  return headers_->content_length();
 }
 
-bool BalsaParser::isChunked() const { return headers_.transfer_encoding_is_chunked(); }
+bool BalsaParser::isChunked() const { return headers_->transfer_encoding_is_chunked(); }
 
-absl::string_view BalsaParser::methodName() const { return headers_.request_method(); }
+absl::string_view BalsaParser::methodName() const { return headers_->request_method(); }
 
 absl::string_view BalsaParser::errorMessage() const { return error_message_; }
 
 int BalsaParser::hasTransferEncoding() const {
-  return headers_.HasHeader(Http::Headers::get().TransferEncoding);
+  return headers_->HasHeader(Http::Headers::get().TransferEncoding);
+}
+
+HeaderStorageConstSharedPtr BalsaParser::headerStorage() const {
+  return reference_header_values_ ? headers_ : nullptr;
 }
 
 void BalsaParser::OnRawBodyInput(absl::string_view /*input*/) {}
@@ -371,7 +371,7 @@ void BalsaParser::MessageDone() {
   }
   status_ = convertResult(connection_->onMessageComplete());
   if (!delay_reset_) {
-    framer_.Reset();
+    resetFramer();
   }
   first_byte_processed_ = false;
   headers_done_ = false;
@@ -435,17 +435,24 @@ void BalsaParser::validateAndProcessHeadersOrTrailersImpl(const quiche::BalsaHea
     }
 
     // Remove CR and LF characters to match http-parser behavior.
-    auto is_cr_or_lf = [](char c) { return c == '\r' || c == '\n'; };
-    if (std::any_of(value.begin(), value.end(), is_cr_or_lf)) {
+    size_t cr_or_lf = HeaderScanner::findCrOrLf(value);
+    if (cr_or_lf != absl::string_view::npos) {
       std::string value_without_cr_or_lf;
       value_without_cr_or_lf.reserve(value.size());
-      for (char c : value) {
-        if (!is_cr_or_lf(c)) {
-          value_without_cr_or_lf.push_back(c);
-        }
+      absl::string_view remaining = value;
+      while (cr_or_lf != absl::string_view::npos) {
+        value_without_cr_or_lf.append(remaining.data(), cr_or_lf);
+        remaining.remove_prefix(cr_or_lf + 1);
+        cr_or_lf = HeaderScanner::findCrOrLf(remaining);
       }
+      value_without_cr_or_lf.append(remaining.data(), remaining.size());
       status_ = convertResult(connection_->onHeaderValue(value_without_cr_or_lf.data(),
                                                          value_without_cr_or_lf.length()));
+    } else if (reference_header_values_ && !trailers &&
+               value.size() >= kMinReferencedHeaderValueSize) {
+      // `value` points into `headers_`, which the connection may keep alive via headerStorage().
+      header_values_referenced_ = true;
+      status_ = convertResult(connection_->onHeaderValueReference(value.data(), value.length()));
     } else {
       // No need to copy if header value does not contain CR or LF.
       status_ = convertResult(connection_->onHeaderValue(value.data(), value.length()));
@@ -457,6 +464,47 @@ ParserStatus BalsaParser::convertResult(CallbackResult result) const {
   return result == CallbackResult::Error ? ParserStatus::Error : status_;
 }
 
+std::shared_ptr<quiche::BalsaHeaders> BalsaParser::acquireHeaders() {
+  std::unique_ptr<quiche::BalsaHeaders> headers;
+  {
+    Thread::LockGuard lock(headers_pool_->mutex_);
+    if (!headers_pool_->headers_.empty()) {
+      headers = std::move(headers_pool_->headers_.back());
+      headers_pool_->headers_.pop_back();
+    }
+  }
+  if (headers == nullptr) {
+    headers = std::make_unique<quiche::BalsaHeaders>();
+  }
+  std::weak_ptr<HeadersPool> weak_pool = headers_pool_;
+  return std::shared_ptr<quiche::BalsaHeaders>(
+      headers.release(), [weak_pool](quiche::BalsaHeaders* released) {
+        std::unique_ptr<quiche::BalsaHeaders> owned(released);
+        std::shared_ptr<HeadersPool> pool = weak_pool.lock();
+        if (pool == nullptr) {
+          return;
+        }
+        // The framer clears the storage again before reusing it. Clearing it here already drops
+        // the previous message's header bytes while the storage sits in the pool.
+        owned->Clear();
+        Thread::LockGuard lock(pool->mutex_);
+        if (pool->headers_.size() < kMaxPooledHeaders) {
+          pool->headers_.push_back(std::move(owned));
+        }
+      });
+}
+
+void BalsaParser::resetFramer() {
+  if (header_values_referenced_ && headers_.use_count() > 1) {
+    // A header map still references the previous message's header bytes, so they must not be
+    // cleared and reused until the map releases them.
+    headers_ = acquireHeaders();
+    framer_.set_balsa_headers(headers_.get());
+  }
+  header_values_referenced_ = false;
+  framer_.Reset();
+}
+
 } // namespace Http1
 } // namespace Http
 } // namespace Envoy
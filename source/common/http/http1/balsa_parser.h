@@ -1,7 +1,9 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
+#include "source/common/common/thread.h"
 #include "source/common/http/http1/parser.h"
 #include "source/common/runtime/runtime_features.h"
 
@@ -19,8 +21,11 @@ namespace Http1 {
 // to be used by ConnectionImpl.
 class BalsaParser : public Parser, public quiche::BalsaVisitorInterface {
 public:
+  // If `reference_header_values` is true, long header values are delivered through
+  // ParserCallbacks::onHeaderValueReference() and point into storage returned by headerStorage().
   BalsaParser(MessageType type, ParserCallbacks* connection, size_t max_header_length,
-              bool enable_trailers, bool allow_custom_methods);
+              bool enable_trailers, bool allow_custom_methods,
+              bool reference_header_values = false);
   ~BalsaParser() override = default;
 
   // Http1::Parser implementation
@@ -35,6 +40,7 @@ public:
   absl::string_view methodName() const override;
   absl::string_view errorMessage() const override;
   int hasTransferEncoding() const override;
+  HeaderStorageConstSharedPtr headerStorage() const override;
 
 private:
   // quiche::BalsaVisitorInterface implementation
@@ -68,13 +74,34 @@ private:
   // Typical use would be `status_ = convertResult(result);`
   ABSL_MUST_USE_RESULT ParserStatus convertResult(CallbackResult result) const;
 
+  // Resets the framer for the next message. If header values of the current message were handed
+  // out as references and are still held, the next message is parsed into other header storage.
+  void resetFramer();
+
+  // Header storage that header maps no longer reference, kept for parsing later messages so that
+  // referencing header values doesn't allocate header storage per message. Shared with the
+  // storage's deleters, which may run after the parser is gone.
+  struct HeadersPool {
+    Thread::MutexBasicLockable mutex_;
+    std::vector<std::unique_ptr<quiche::BalsaHeaders>> headers_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  // Returns header storage from the pool, or new storage if the pool is empty. The storage goes
+  // back to the pool when its last reference is released.
+  std::shared_ptr<quiche::BalsaHeaders> acquireHeaders();
+
   quiche::BalsaFrame framer_;
-  quiche::BalsaHeaders headers_;
+  const std::shared_ptr<HeadersPool> headers_pool_;
+  // Shared so that header maps can keep referenced header values alive past framer_.Reset().
+  std::shared_ptr<quiche::BalsaHeaders> headers_;
 
   const MessageType message_type_ = MessageType::Request;
   ParserCallbacks* connection_ = nullptr;
   const bool enable_trailers_ = false;
   const bool allow_custom_methods_ = false;
+  const bool reference_header_values_ = false;
+  // True if a value in `headers_` has been passed to onHeaderValueReference() since the last reset.
+  bool header_values_referenced_ = false;
   bool first_byte_processed_ = false;
   bool headers_done_ = false;
   // True until the first byte of the second message arrives.
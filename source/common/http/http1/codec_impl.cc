@@ -536,8 +536,9 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stat
       deferred_end_stream_headers_(false), dispatching_(false), max_headers_kb_(max_headers_kb),
       max_headers_count_(max_headers_count) {
   if (codec_settings_.use_balsa_parser_) {
-    parser_ = std::make_unique<BalsaParser>(type, this, max_headers_kb_ * 1024, enableTrailers(),
-                                            codec_settings_.allow_custom_methods_);
+    parser_ = std::make_unique<BalsaParser>(
+        type, this, max_headers_kb_ * 1024, enableTrailers(), codec_settings_.allow_custom_methods_,
+        Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http1_reference_header_values"));
   } else {
     parser_ = std::make_unique<LegacyHttpParserImpl>(type, this);
   }
@@ -582,6 +583,11 @@ Status ConnectionImpl::completeCurrentHeader() {
         absl::StrCat("http/1.1 protocol error: ", header_type, " count exceeds limit"));
   }
 
+  if (current_header_value_.isReference()) {
+    // Moving or clearing a reference string leaves the view in place.
+    current_header_value_.setCopy(absl::string_view());
+  }
+
   header_parsing_state_ = HeaderParsingState::Field;
   ASSERT(current_header_field_.empty());
   ASSERT(current_header_value_.empty());
@@ -755,6 +761,10 @@ CallbackResult ConnectionImpl::onHeaderValue(const char* data, size_t length) {
   return setAndCheckCallbackStatus(onHeaderValueImpl(data, length));
 }
 
+CallbackResult ConnectionImpl::onHeaderValueReference(const char* data, size_t length) {
+  return setAndCheckCallbackStatus(onHeaderValueImpl(data, length, /*reference=*/true));
+}
+
 CallbackResult ConnectionImpl::onHeadersComplete() {
   return setAndCheckCallbackStatusOr(onHeadersCompleteImpl());
 }
@@ -806,7 +816,7 @@ Status ConnectionImpl::onHeaderFieldImpl(const char* data, size_t length) {
   return checkMaxHeadersSize();
 }
 
-Status ConnectionImpl::onHeaderValueImpl(const char* data, size_t length) {
+Status ConnectionImpl::onHeaderValueImpl(const char* data, size_t length, bool reference) {
   ASSERT(dispatching_);
 
   getBytesMeter().addHeaderBytesReceived(length);
@@ -832,7 +842,12 @@ Status ConnectionImpl::onHeaderValueImpl(const char* data, size_t length) {
     // whitespace as the spec requires: https://tools.ietf.org/html/rfc7230#section-3.2.4 .
     header_value = StringUtil::ltrim(header_value);
   }
-  current_header_value_.append(header_value.data(), header_value.length());
+  if (reference && current_header_value_.empty()) {
+    // The parser keeps the referenced bytes alive through the storage attached in allocHeaders().
+    current_header_value_.setReference(header_value);
+  } else {
+    current_header_value_.append(header_value.data(), header_value.length());
+  }
 
   return checkMaxHeadersSize();
 }
@@ -373,6 +373,7 @@ private:
   CallbackResult onStatus(const char* data, size_t length) override;
   CallbackResult onHeaderField(const char* data, size_t length) override;
   CallbackResult onHeaderValue(const char* data, size_t length) override;
+  CallbackResult onHeaderValueReference(const char* data, size_t length) override;
   CallbackResult onHeadersComplete() override;
   void bufferBody(const char* data, size_t length) override;
   CallbackResult onMessageComplete() override;
@@ -384,7 +385,7 @@ private:
   virtual Status onUrlBase(const char* data, size_t length) PURE;
   virtual Status onStatusBase(const char* data, size_t length) PURE;
   Status onHeaderFieldImpl(const char* data, size_t length);
-  Status onHeaderValueImpl(const char* data, size_t length);
+  Status onHeaderValueImpl(const char* data, size_t length, bool reference = false);
   StatusOr<CallbackResult> onHeadersCompleteImpl();
   virtual StatusOr<CallbackResult> onHeadersCompleteBase() PURE;
   StatusOr<CallbackResult> onMessageCompleteImpl();
@@ -545,6 +546,7 @@ private:
     ASSERT(!processing_trailers_);
     auto headers = RequestHeaderMapImpl::create(max_headers_kb_, max_headers_count_);
     headers->setFormatter(std::move(formatter));
+    headers->setReferencedStorage(parser_->headerStorage());
     headers_or_trailers_.emplace<RequestHeaderMapPtr>(std::move(headers));
   }
   void allocTrailers() override {
@@ -652,6 +654,7 @@ private:
     ASSERT(!processing_trailers_);
     auto headers = ResponseHeaderMapImpl::create(max_headers_kb_, max_headers_count_);
     headers->setFormatter(std::move(formatter));
+    headers->setReferencedStorage(parser_->headerStorage());
     headers_or_trailers_.emplace<ResponseHeaderMapPtr>(std::move(headers));
   }
   void allocTrailers() override {
@@ -0,0 +1,144 @@
+#include "source/common/http/http1/header_scanner.h"
+
+#include <array>
+#include <cstdint>
+
+// On x86-64 the vector scanners are compiled for their instruction sets with target attributes,
+// and picked at run time according to what the CPU supports, so they don't depend on -m build
+// flags. SSE2 is part of the x86-64 baseline and needs no check.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ENVOY_HEADER_SCANNER_X86_64
+#include <immintrin.h>
+#endif
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+namespace {
+
+// Allowed characters for field names according to Section 5.1
+// and for methods according to Section 9.1 of RFC 9110:
+// https://www.rfc-editor.org/rfc/rfc9110.html
+constexpr absl::string_view kValidTokenCharacters =
+    "!#$%&'*+-.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ^_`abcdefghijklmnopqrstuvwxyz|~";
+
+constexpr std::array<bool, 256> buildTokenTable() {
+  std::array<bool, 256> table{};
+  for (const char c : kValidTokenCharacters) {
+    table[static_cast<uint8_t>(c)] = true;
+  }
+  return table;
+}
+
+constexpr std::array<bool, 256> kTokenTable = buildTokenTable();
+
+size_t findInvalidTokenCharScalar(const char* data, size_t size, size_t pos) {
+  for (; pos < size; ++pos) {
+    if (!kTokenTable[static_cast<uint8_t>(data[pos])]) {
+      return pos;
+    }
+  }
+  return absl::string_view::npos;
+}
+
+size_t findCrOrLfScalar(const char* data, size_t size, size_t pos) {
+  for (; pos < size; ++pos) {
+    if (data[pos] == '\r' || data[pos] == '\n') {
+      return pos;
+    }
+  }
+  return absl::string_view::npos;
+}
+
+#ifdef ENVOY_HEADER_SCANNER_X86_64
+__attribute__((target("sse4.2"))) size_t findInvalidTokenCharSse42(const char* data, size_t size) {
+  // PCMPESTRI accepts at most eight ranges, which is not enough to describe the complement of the
+  // token set exactly. These ranges are a superset of it: the last one also covers '|' and '~',
+  // which are token characters, so every hit is confirmed with the lookup table.
+  static const char kRanges[] = "\x00 "
+                                "\"\""
+                                "()"
+                                ",,"
+                                "//"
+                                ":@"
+                                "[]"
+                                "{\xff";
+  const __m128i ranges = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kRanges));
+  size_t pos = 0;
+  while (pos + 16 <= size) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    const int found = _mm_cmpestri(ranges, sizeof(kRanges) - 1, block, 16,
+                                   _SIDD_LEAST_SIGNIFICANT | _SIDD_CMP_RANGES | _SIDD_UBYTE_OPS);
+    if (found == 16) {
+      pos += 16;
+      continue;
+    }
+    pos += found;
+    if (!kTokenTable[static_cast<uint8_t>(data[pos])]) {
+      return pos;
+    }
+    ++pos;
+  }
+  return findInvalidTokenCharScalar(data, size, pos);
+}
+
+size_t findCrOrLfSse2(const char* data, size_t size, size_t pos) {
+  const __m128i cr = _mm_set1_epi8('\r');
+  const __m128i lf = _mm_set1_epi8('\n');
+  for (; pos + 16 <= size; pos += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    const uint32_t mask = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, cr), _mm_cmpeq_epi8(block, lf))));
+    if (mask != 0) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+  return findCrOrLfScalar(data, size, pos);
+}
+
+__attribute__((target("avx2"))) size_t findCrOrLfAvx2(const char* data, size_t size) {
+  const __m256i cr = _mm256_set1_epi8('\r');
+  const __m256i lf = _mm256_set1_epi8('\n');
+  size_t pos = 0;
+  for (; pos + 32 <= size; pos += 32) {
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+    const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(block, cr), _mm256_cmpeq_epi8(block, lf))));
+    if (mask != 0) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+  return findCrOrLfSse2(data, size, pos);
+}
+#endif
+
+} // namespace
+
+bool HeaderScanner::isTokenChar(char c) { return kTokenTable[static_cast<uint8_t>(c)]; }
+
+size_t HeaderScanner::findInvalidTokenChar(absl::string_view input) {
+#ifdef ENVOY_HEADER_SCANNER_X86_64
+  static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+  if (has_sse42) {
+    return findInvalidTokenCharSse42(input.data(), input.size());
+  }
+#endif
+  return findInvalidTokenCharScalar(input.data(), input.size(), 0);
+}
+
+size_t HeaderScanner::findCrOrLf(absl::string_view input) {
+#ifdef ENVOY_HEADER_SCANNER_X86_64
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  if (has_avx2) {
+    return findCrOrLfAvx2(input.data(), input.size());
+  }
+  return findCrOrLfSse2(input.data(), input.size(), 0);
+#else
+  return findCrOrLfScalar(input.data(), input.size(), 0);
+#endif
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
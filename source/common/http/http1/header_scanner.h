@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Batch scanners used to validate HTTP/1 header fields once the parser has split them out of the
+ * receive buffer. On x86-64 each scan covers a whole field at a time using SSE4.2, AVX2 or SSE2,
+ * picked at run time according to what the CPU supports. Other platforms use a table driven scalar
+ * loop. The scanners never copy the input.
+ */
+class HeaderScanner {
+public:
+  /**
+   * @param input supplies the bytes to scan.
+   * @return the position of the first byte that is not a token character as defined in
+   *         Section 5.6.2 of RFC 9110 (used for field names and methods), or
+   *         absl::string_view::npos if every byte is a token character.
+   */
+  static size_t findInvalidTokenChar(absl::string_view input);
+
+  /**
+   * @param input supplies the bytes to scan.
+   * @return true if the input only contains token characters. An empty input is a valid token.
+   */
+  static bool isToken(absl::string_view input) {
+    return findInvalidTokenChar(input) == absl::string_view::npos;
+  }
+
+  /**
+   * @param input supplies the bytes to scan.
+   * @return the position of the first CR or LF byte, or absl::string_view::npos if there is none.
+   */
+  static size_t findCrOrLf(absl::string_view input);
+
+  /**
+   * @param c supplies the byte to check.
+   * @return true if the byte is a token character.
+   */
+  static bool isTokenChar(char c);
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -25,6 +25,7 @@ public:
   absl::string_view methodName() const override;
   absl::string_view errorMessage() const override;
   int hasTransferEncoding() const override;
+  HeaderStorageConstSharedPtr headerStorage() const override { return nullptr; }
 
 private:
   class Impl;
@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "envoy/common/pure.h"
+#include "envoy/http/header_map.h"
 
 #include "source/common/common/statusor.h"
 #include "source/common/http/status.h"
@@ -74,6 +75,18 @@ public:
    */
   virtual CallbackResult onHeaderValue(const char* data, size_t length) PURE;
 
+  /**
+   * Called instead of onHeaderValue() with a complete header value whose bytes stay valid for as
+   * long as the storage returned by Parser::headerStorage() is held. Only parsers configured to
+   * reference header values call this.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   * @return CallbackResult representing success or failure.
+   */
+  virtual CallbackResult onHeaderValueReference(const char* data, size_t length) {
+    return onHeaderValue(data, length);
+  }
+
   /**
    * Called when headers are complete. A base routine happens first then a
    * virtual dispatch is invoked. Note that this only applies to headers and NOT
@@ -150,6 +163,10 @@ public:
 
   // Returns whether the Transfer-Encoding header is present.
   virtual int hasTransferEncoding() const PURE;
+
+  // Returns the owner of the bytes passed to ParserCallbacks::onHeaderValueReference() for the
+  // current message, or nullptr if the parser does not reference header values.
+  virtual HeaderStorageConstSharedPtr headerStorage() const PURE;
 };
 
 using ParserPtr = std::unique_ptr<Parser>;
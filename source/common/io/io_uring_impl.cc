@@ -28,9 +28,20 @@ IoUringImpl::IoUringImpl(uint32_t io_uring_size, bool use_submission_queue_polli
   // with SQ ring. We will figure out better handle of entries number in the future.
   int ret = io_uring_queue_init_params(io_uring_size, &ring_, &p);
   RELEASE_ASSERT(ret == 0, fmt::format("unable to initialize io_uring: {}", errorDetails(-ret)));
+
+  struct io_uring_probe* probe = io_uring_get_probe_ring(&ring_);
+  if (probe != nullptr) {
+    zero_copy_send_supported_ = io_uring_opcode_supported(probe, IORING_OP_SENDMSG_ZC);
+    io_uring_free_probe(probe);
+  }
 }
 
-IoUringImpl::~IoUringImpl() { io_uring_queue_exit(&ring_); }
+IoUringImpl::~IoUringImpl() {
+  if (buf_ring_ != nullptr) {
+    io_uring_free_buf_ring(&ring_, buf_ring_, buffer_count_, BufferGroupId);
+  }
+  io_uring_queue_exit(&ring_);
+}
 
 os_fd_t IoUringImpl::registerEventfd() {
   ASSERT(!isEventfdRegistered());
@@ -53,6 +64,39 @@ void IoUringImpl::unregisterEventfd() {
 
 bool IoUringImpl::isEventfdRegistered() const { return SOCKET_VALID(event_fd_); }
 
+bool IoUringImpl::registerBufferRing(uint32_t buffer_count, uint32_t buffer_size) {
+  ASSERT(buf_ring_ == nullptr);
+  ASSERT(buffer_count > 0 && (buffer_count & (buffer_count - 1)) == 0 && buffer_count <= 32768);
+  int ret = 0;
+  buf_ring_ = io_uring_setup_buf_ring(&ring_, buffer_count, BufferGroupId, 0, &ret);
+  if (buf_ring_ == nullptr) {
+    ENVOY_LOG(debug, "unable to register provided buffer ring: {}", errorDetails(-ret));
+    return false;
+  }
+
+  buffer_count_ = buffer_count;
+  buffer_size_ = buffer_size;
+  buffers_ = std::make_unique<uint8_t[]>(static_cast<size_t>(buffer_count) * buffer_size);
+  const int mask = io_uring_buf_ring_mask(buffer_count_);
+  for (uint32_t i = 0; i < buffer_count_; i++) {
+    io_uring_buf_ring_add(buf_ring_, providedBuffer(i), buffer_size_, i, mask, i);
+  }
+  io_uring_buf_ring_advance(buf_ring_, buffer_count_);
+  return true;
+}
+
+uint8_t* IoUringImpl::providedBuffer(uint16_t buffer_id) {
+  ASSERT(buffer_id < buffer_count_);
+  return buffers_.get() + static_cast<size_t>(buffer_id) * buffer_size_;
+}
+
+void IoUringImpl::recycleProvidedBuffer(uint16_t buffer_id) {
+  ASSERT(buf_ring_ != nullptr);
+  io_uring_buf_ring_add(buf_ring_, providedBuffer(buffer_id), buffer_size_, buffer_id,
+                        io_uring_buf_ring_mask(buffer_count_), 0);
+  io_uring_buf_ring_advance(buf_ring_, 1);
+}
+
 void IoUringImpl::forEveryCompletion(const CompletionCb& completion_cb) {
   ASSERT(SOCKET_VALID(event_fd_));
 
@@ -69,7 +113,11 @@ void IoUringImpl::forEveryCompletion(const CompletionCb& completion_cb) {
 
   for (unsigned i = 0; i < count; ++i) {
     struct io_uring_cqe* cqe = cqes_[i];
-    completion_cb(reinterpret_cast<Request*>(cqe->user_data), cqe->res, false);
+    Request* req = reinterpret_cast<Request*>(cqe->user_data);
+    if (req != nullptr) {
+      req->setCompletionFlags(cqe->flags);
+    }
+    completion_cb(req, cqe->res, false);
   }
 
   io_uring_cq_advance(&ring_, count);
@@ -136,6 +184,27 @@ IoUringResult IoUringImpl::prepareReadv(os_fd_t fd, const struct iovec* iovecs,
   return IoUringResult::Ok;
 }
 
+IoUringResult IoUringImpl::prepareRecv(os_fd_t fd, bool multishot, Request* user_data) {
+  ENVOY_LOG(trace, "prepare recv for fd = {}, multishot = {}", fd, multishot);
+  ASSERT(buf_ring_ != nullptr);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  if (multishot) {
+    io_uring_prep_recv_multishot(sqe, fd, nullptr, 0, 0);
+  } else {
+    io_uring_prep_recv(sqe, fd, nullptr, 0, 0);
+  }
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  sqe->buf_group = BufferGroupId;
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
 IoUringResult IoUringImpl::prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                                          off_t offset, Request* user_data) {
   ENVOY_LOG(trace, "prepare writev for fd = {}", fd);
@@ -151,6 +220,21 @@ IoUringResult IoUringImpl::prepareWritev(os_fd_t fd, const struct iovec* iovecs,
   return IoUringResult::Ok;
 }
 
+IoUringResult IoUringImpl::prepareSendmsgZc(os_fd_t fd, const struct msghdr* msg,
+                                            Request* user_data) {
+  ENVOY_LOG(trace, "prepare zero copy sendmsg for fd = {}", fd);
+  // TODO (soulxu): Handling the case of CQ ring is overflow.
+  ASSERT(!(*(ring_.sq.kflags) & IORING_SQ_CQ_OVERFLOW));
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_sendmsg_zc(sqe, fd, msg, MSG_NOSIGNAL);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
 IoUringResult IoUringImpl::prepareClose(os_fd_t fd, Request* user_data) {
   ENVOY_LOG(trace, "prepare close for fd = {}", fd);
   // TODO (soulxu): Handling the case of CQ ring is overflow.
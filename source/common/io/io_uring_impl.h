@@ -31,6 +31,10 @@ public:
   os_fd_t registerEventfd() override;
   void unregisterEventfd() override;
   bool isEventfdRegistered() const override;
+  bool isZeroCopySendSupported() const override { return zero_copy_send_supported_; }
+  bool registerBufferRing(uint32_t buffer_count, uint32_t buffer_size) override;
+  uint8_t* providedBuffer(uint16_t buffer_id) override;
+  void recycleProvidedBuffer(uint16_t buffer_id) override;
   void forEveryCompletion(const CompletionCb& completion_cb) override;
   IoUringResult prepareAccept(os_fd_t fd, struct sockaddr* remote_addr, socklen_t* remote_addr_len,
                               Request* user_data) override;
@@ -38,8 +42,11 @@ public:
                                Request* user_data) override;
   IoUringResult prepareReadv(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, off_t offset,
                              Request* user_data) override;
+  IoUringResult prepareRecv(os_fd_t fd, bool multishot, Request* user_data) override;
   IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                               off_t offset, Request* user_data) override;
+  IoUringResult prepareSendmsgZc(os_fd_t fd, const struct msghdr* msg,
+                                 Request* user_data) override;
   IoUringResult prepareClose(os_fd_t fd, Request* user_data) override;
   IoUringResult prepareCancel(Request* cancelling_user_data, Request* user_data) override;
   IoUringResult prepareShutdown(os_fd_t fd, int how, Request* user_data) override;
@@ -48,7 +55,15 @@ public:
   void removeInjectedCompletion(os_fd_t fd) override;
 
 private:
+  // The id of the only buffer group registered with the ring.
+  static constexpr uint16_t BufferGroupId = 0;
+
   struct io_uring ring_ {};
+  struct io_uring_buf_ring* buf_ring_{nullptr};
+  uint32_t buffer_count_{0};
+  uint32_t buffer_size_{0};
+  std::unique_ptr<uint8_t[]> buffers_;
+  bool zero_copy_send_supported_{false};
   std::vector<struct io_uring_cqe*> cqes_;
   os_fd_t event_fd_{INVALID_SOCKET};
   std::list<InjectedCompletion> injected_completions_;
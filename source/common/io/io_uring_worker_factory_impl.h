@@ -10,6 +10,7 @@ class IoUringWorkerFactoryImpl : public IoUringWorkerFactory {
 public:
   IoUringWorkerFactoryImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
                            uint32_t read_buffer_size, uint32_t write_timeout_ms,
+                           uint32_t provided_buffer_count, uint32_t zero_copy_send_threshold,
                            ThreadLocal::SlotAllocator& tls);
 
   OptRef<IoUringWorker> getIoUringWorker() override;
@@ -22,6 +23,8 @@ private:
   const bool use_submission_queue_polling_;
   const uint32_t read_buffer_size_;
   const uint32_t write_timeout_ms_;
+  const uint32_t provided_buffer_count_;
+  const uint32_t zero_copy_send_threshold_;
   ThreadLocal::TypedSlot<IoUringWorker> tls_;
 };
 
@@ -1,5 +1,7 @@
 #include "source/common/io/io_uring_worker_impl.h"
 
+#include "absl/numeric/bits.h"
+
 namespace Envoy {
 namespace Io {
 
@@ -18,6 +20,39 @@ WriteRequest::WriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector&
   }
 }
 
+SendZcRequest::SendZcRequest(IoUringSocket& socket, Buffer::Instance& data, uint64_t length)
+    : Request(RequestType::Write, socket), buf_(std::make_shared<Buffer::OwnedImpl>()),
+      offset_(0) {
+  buf_->move(data, length);
+  initIovecs();
+}
+
+SendZcRequest::SendZcRequest(IoUringSocket& socket, std::shared_ptr<Buffer::OwnedImpl> buf,
+                             uint64_t offset)
+    : Request(RequestType::Write, socket), buf_(std::move(buf)), offset_(offset) {
+  ASSERT(offset_ < buf_->length());
+  initIovecs();
+}
+
+void SendZcRequest::initIovecs() {
+  Buffer::RawSliceVector slices = buf_->getRawSlices();
+  iov_ = std::make_unique<struct iovec[]>(slices.size());
+  size_t num_iovecs = 0;
+  uint64_t skip = offset_;
+  for (const Buffer::RawSlice& slice : slices) {
+    if (skip >= slice.len_) {
+      skip -= slice.len_;
+      continue;
+    }
+    iov_[num_iovecs].iov_base = static_cast<uint8_t*>(slice.mem_) + skip;
+    iov_[num_iovecs].iov_len = slice.len_ - skip;
+    skip = 0;
+    num_iovecs++;
+  }
+  msg_.msg_iov = iov_.get();
+  msg_.msg_iovlen = num_iovecs;
+}
+
 IoUringSocketEntry::IoUringSocketEntry(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb,
                                        bool enable_close_event)
     : fd_(fd), parent_(parent), enable_close_event_(enable_close_event), cb_(std::move(cb)) {}
@@ -60,14 +95,36 @@ void IoUringSocketEntry::onRemoteClose() {
 
 IoUringWorkerImpl::IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
                                      uint32_t read_buffer_size, uint32_t write_timeout_ms,
+                                     uint32_t provided_buffer_count,
+                                     uint32_t zero_copy_send_threshold,
                                      Event::Dispatcher& dispatcher)
     : IoUringWorkerImpl(std::make_unique<IoUringImpl>(io_uring_size, use_submission_queue_polling),
-                        read_buffer_size, write_timeout_ms, dispatcher) {}
+                        read_buffer_size, write_timeout_ms, provided_buffer_count,
+                        zero_copy_send_threshold, dispatcher) {}
 
 IoUringWorkerImpl::IoUringWorkerImpl(IoUringPtr&& io_uring, uint32_t read_buffer_size,
-                                     uint32_t write_timeout_ms, Event::Dispatcher& dispatcher)
+                                     uint32_t write_timeout_ms, uint32_t provided_buffer_count,
+                                     uint32_t zero_copy_send_threshold,
+                                     Event::Dispatcher& dispatcher)
     : io_uring_(std::move(io_uring)), read_buffer_size_(read_buffer_size),
       write_timeout_ms_(write_timeout_ms), dispatcher_(dispatcher) {
+  if (zero_copy_send_threshold > 0) {
+    if (io_uring_->isZeroCopySendSupported()) {
+      zero_copy_send_threshold_ = zero_copy_send_threshold;
+    } else {
+      ENVOY_LOG(warn, "io_uring zero copy sends are not supported, falling back to writev");
+    }
+  }
+
+  if (provided_buffer_count > 0) {
+    provided_buffers_enabled_ =
+        io_uring_->registerBufferRing(absl::bit_ceil(provided_buffer_count), read_buffer_size_);
+    if (!provided_buffers_enabled_) {
+      ENVOY_LOG(warn, "io_uring provided buffer rings are not supported, falling back to "
+                      "per-socket read buffers");
+    }
+  }
+
   const os_fd_t event_fd = io_uring_->registerEventfd();
   // We only care about the read event of Eventfd, since we only receive the
   // event here.
@@ -97,6 +154,12 @@ IoUringWorkerImpl::~IoUringWorkerImpl() {
     onFileEvent();
   }
 
+  // The kernel holds references to the pages, not to the requests, so the data can be released
+  // without waiting for the notifications.
+  for (Request* req : pending_zero_copy_sends_) {
+    delete req;
+  }
+
   dispatcher_.clearDeferredDeleteList();
 }
 
@@ -168,6 +231,40 @@ Request* IoUringWorkerImpl::submitReadRequest(IoUringSocket& socket) {
   return req;
 }
 
+Request* IoUringWorkerImpl::submitRecvRequest(IoUringSocket& socket, bool multishot) {
+  ASSERT(provided_buffers_enabled_);
+  Request* req = new Request(Request::RequestType::Read, socket);
+
+  ENVOY_LOG(trace, "submit recv request, fd = {}, multishot = {}, read req = {}", socket.fd(),
+            multishot, fmt::ptr(req));
+
+  auto res = io_uring_->prepareRecv(socket.fd(), multishot, req);
+  if (res == IoUringResult::Failed) {
+    // TODO(rojkov): handle `EBUSY` in case the completion queue is never reaped.
+    submit();
+    res = io_uring_->prepareRecv(socket.fd(), multishot, req);
+    RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare recv");
+  }
+  submit();
+  return req;
+}
+
+void IoUringWorkerImpl::moveProvidedBufferToBuffer(const Request& req, size_t data_length,
+                                                   Buffer::Instance& buffer) {
+  ASSERT(req.completionFlags() & IORING_CQE_F_BUFFER);
+  const uint16_t buffer_id = req.completionFlags() >> IORING_CQE_BUFFER_SHIFT;
+  // Copy the data out so the buffer goes back to the ring right away. Sockets that hold on to
+  // received data could otherwise drain the ring for all the other sockets of the worker.
+  buffer.add(io_uring_->providedBuffer(buffer_id), data_length);
+  io_uring_->recycleProvidedBuffer(buffer_id);
+}
+
+void IoUringWorkerImpl::releaseProvidedBuffer(const Request& req) {
+  if (req.completionFlags() & IORING_CQE_F_BUFFER) {
+    io_uring_->recycleProvidedBuffer(req.completionFlags() >> IORING_CQE_BUFFER_SHIFT);
+  }
+}
+
 Request* IoUringWorkerImpl::submitWriteRequest(IoUringSocket& socket,
                                                const Buffer::RawSliceVector& slices) {
   WriteRequest* req = new WriteRequest(socket, slices);
@@ -185,6 +282,36 @@ Request* IoUringWorkerImpl::submitWriteRequest(IoUringSocket& socket,
   return req;
 }
 
+Request* IoUringWorkerImpl::submitSendZcRequest(IoUringSocket& socket, Buffer::Instance& data) {
+  uint64_t length = 0;
+  for (const Buffer::RawSlice& slice : data.getRawSlices(IOV_MAX)) {
+    length += slice.len_;
+  }
+  return submitSendZcRequest(new SendZcRequest(socket, data, length));
+}
+
+Request* IoUringWorkerImpl::submitSendZcRequest(IoUringSocket& socket,
+                                                std::shared_ptr<Buffer::OwnedImpl> data,
+                                                uint64_t offset) {
+  return submitSendZcRequest(new SendZcRequest(socket, std::move(data), offset));
+}
+
+Request* IoUringWorkerImpl::submitSendZcRequest(SendZcRequest* req) {
+  const os_fd_t fd = req->socket().fd();
+  ENVOY_LOG(trace, "submit zero copy send request, fd = {}, length = {}, req = {}", fd,
+            req->length(), fmt::ptr(req));
+
+  auto res = io_uring_->prepareSendmsgZc(fd, &req->msg_, req);
+  if (res == IoUringResult::Failed) {
+    // TODO(rojkov): handle `EBUSY` in case the completion queue is never reaped.
+    submit();
+    res = io_uring_->prepareSendmsgZc(fd, &req->msg_, req);
+    RELEASE_ASSERT(res == IoUringResult::Ok, "unable to prepare zero copy sendmsg");
+  }
+  submit();
+  return req;
+}
+
 Request* IoUringWorkerImpl::submitCloseRequest(IoUringSocket& socket) {
   Request* req = new Request(Request::RequestType::Close, socket);
 
@@ -251,11 +378,20 @@ void IoUringWorkerImpl::injectCompletion(IoUringSocket& socket, Request::Request
 void IoUringWorkerImpl::onFileEvent() {
   ENVOY_LOG(trace, "io uring worker, on file event");
   delay_submit_ = true;
-  io_uring_->forEveryCompletion([](Request* req, int32_t result, bool injected) {
+  io_uring_->forEveryCompletion([this](Request* req, int32_t result, bool injected) {
     ENVOY_LOG(trace, "receive request completion, type = {}, req = {}",
               static_cast<uint8_t>(req->type()), fmt::ptr(req));
     ASSERT(req != nullptr);
 
+    if (req->completionFlags() & IORING_CQE_F_NOTIF) {
+      // The kernel no longer references the data of a zero copy send. The socket may be gone
+      // already, so it is not notified.
+      ENVOY_LOG(trace, "receive zero copy send notification, req = {}", fmt::ptr(req));
+      pending_zero_copy_sends_.erase(req);
+      delete req;
+      return;
+    }
+
     switch (req->type()) {
     case Request::RequestType::Accept:
       ENVOY_LOG(trace, "receive accept request completion, fd = {}, req = {}", req->socket().fd(),
@@ -294,7 +430,13 @@ void IoUringWorkerImpl::onFileEvent() {
       break;
     }
 
-    delete req;
+    // A multishot request stays armed and completes again until a completion without
+    // `IORING_CQE_F_MORE` terminates it. A zero copy send completes again with a notification.
+    if (!(req->completionFlags() & IORING_CQE_F_MORE)) {
+      delete req;
+    } else if (req->type() == Request::RequestType::Write) {
+      pending_zero_copy_sends_.insert(req);
+    }
   });
   delay_submit_ = false;
   submit();
@@ -338,7 +480,7 @@ void IoUringServerSocket::close(bool keep_fd_open, IoUringSocketOnClosedCb cb) {
     return;
   }
 
-  if (read_req_ != nullptr) {
+  if (read_req_ != nullptr && read_cancel_req_ == nullptr) {
     ENVOY_LOG(trace, "cancel the read request, fd = {}", fd_);
     read_cancel_req_ = parent_.submitCancelRequest(*this, read_req_);
   }
@@ -372,7 +514,15 @@ void IoUringServerSocket::enableRead() {
   submitReadRequest();
 }
 
-void IoUringServerSocket::disableRead() { IoUringSocketEntry::disableRead(); }
+void IoUringServerSocket::disableRead() {
+  IoUringSocketEntry::disableRead();
+  // Stop a multishot recv so that no more data is buffered while reading is disabled. Once it
+  // terminates, a single recv is submitted to detect the remote close.
+  if (read_multishot_ && read_req_ != nullptr && read_cancel_req_ == nullptr) {
+    ENVOY_LOG(trace, "cancel the multishot recv request, fd = {}", fd_);
+    read_cancel_req_ = parent_.submitCancelRequest(*this, read_req_);
+  }
+}
 
 void IoUringServerSocket::write(Buffer::Instance& data) {
   ENVOY_LOG(trace, "write, buffer size = {}, fd = {}", data.length(), fd_);
@@ -429,6 +579,11 @@ void IoUringServerSocket::onCancel(Request* req, int32_t result, bool injected)
 }
 
 void IoUringServerSocket::moveReadDataToBuffer(Request* req, size_t data_length) {
+  if (req->completionFlags() & IORING_CQE_F_BUFFER) {
+    parent_.moveProvidedBufferToBuffer(*req, data_length, read_buf_);
+    return;
+  }
+
   ReadRequest* read_req = static_cast<ReadRequest*>(req);
   Buffer::BufferFragment* fragment = new Buffer::BufferFragmentImpl(
       read_req->buf_.release(), data_length,
@@ -439,6 +594,35 @@ void IoUringServerSocket::moveReadDataToBuffer(Request* req, size_t data_length)
   read_buf_.addBufferFragment(*fragment);
 }
 
+void IoUringServerSocket::returnUnsentDataToBuffer(Request* req, size_t sent_length) {
+  SendZcRequest* send_req = static_cast<SendZcRequest*>(req);
+  if (sent_length >= send_req->length()) {
+    return;
+  }
+  const uint64_t unsent_offset = send_req->offset_ + sent_length;
+  if (sent_length > 0) {
+    // The kernel may still reference the sent part of the data until the notification, so the
+    // data is kept with the request and the next zero copy send starts from the unsent tail.
+    unsent_zero_copy_buf_ = send_req->buf_;
+    unsent_zero_copy_offset_ = unsent_offset;
+    return;
+  }
+  // The send failed. If no other request shares the data, the kernel never referenced it and
+  // it is moved back to the front of the write buffer. Otherwise an earlier request's sent
+  // part may still be referenced, so the unsent tail is copied.
+  Buffer::OwnedImpl unsent;
+  if (send_req->buf_.use_count() == 1) {
+    send_req->buf_->drain(unsent_offset);
+    unsent.move(*send_req->buf_);
+  } else {
+    const uint64_t unsent_length = send_req->length();
+    auto reservation = unsent.reserveSingleSlice(unsent_length);
+    send_req->buf_->copyOut(unsent_offset, unsent_length, reservation.slice().mem_);
+    reservation.commit(unsent_length);
+  }
+  write_buf_.prepend(unsent);
+}
+
 void IoUringServerSocket::onReadCompleted(int32_t result) {
   ENVOY_LOG(trace, "read from socket, fd = {}, result = {}", fd_, result);
   ReadParam param{read_buf_, result};
@@ -457,12 +641,18 @@ void IoUringServerSocket::onRead(Request* req, int32_t result, bool injected) {
             "onRead with result {}, fd = {}, injected = {}, status_ = {}, enable_close_event = {}",
             result, fd_, injected, static_cast<int>(status_), enable_close_event_);
   if (!injected) {
-    read_req_ = nullptr;
+    // A multishot recv stays armed until a completion without `IORING_CQE_F_MORE`.
+    if (!(req->completionFlags() & IORING_CQE_F_MORE)) {
+      read_req_ = nullptr;
+      read_multishot_ = false;
+    }
     // If the socket is going to close, discard all results.
-    if (status_ == Closed && write_or_shutdown_req_ == nullptr && read_cancel_req_ == nullptr &&
-        write_or_shutdown_cancel_req_ == nullptr) {
+    if (status_ == Closed && read_req_ == nullptr && write_or_shutdown_req_ == nullptr &&
+        read_cancel_req_ == nullptr && write_or_shutdown_cancel_req_ == nullptr) {
       if (result > 0 && keep_fd_open_) {
         moveReadDataToBuffer(req, result);
+      } else {
+        parent_.releaseProvidedBuffer(*req);
       }
       closeInternal();
       return;
@@ -473,7 +663,12 @@ void IoUringServerSocket::onRead(Request* req, int32_t result, bool injected) {
   if (result > 0) {
     moveReadDataToBuffer(req, result);
   } else {
-    if (result != -ECANCELED) {
+    parent_.releaseProvidedBuffer(*req);
+    if (result == -ENOBUFS) {
+      // The worker's buffer ring was empty. This is not an error of the socket; read again with a
+      // dedicated buffer.
+      provided_buffers_exhausted_ = true;
+    } else if (result != -ECANCELED) {
       read_error_ = result;
     }
   }
@@ -577,12 +772,23 @@ void IoUringServerSocket::onWrite(Request* req, int32_t result, bool injected) {
     return;
   }
 
-  if (result > 0) {
-    write_buf_.drain(result);
+  if (write_zero_copy_ && (result == -EOPNOTSUPP || result == -EINVAL)) {
+    // The socket doesn't support zero copy sends. Send the data again with writev.
+    ENVOY_LOG(trace, "zero copy send not supported, fd = {}", fd_);
+    zero_copy_send_enabled_ = false;
+    returnUnsentDataToBuffer(req, 0);
+  } else if (result > 0) {
+    if (write_zero_copy_) {
+      // The sent data left write_buf_ with the request.
+      returnUnsentDataToBuffer(req, result);
+    } else {
+      write_buf_.drain(result);
+    }
     ENVOY_LOG(trace, "drain write buf, drain size = {}, fd = {}", result, fd_);
   } else {
     // Drain all write buf since the write failed.
     write_buf_.drain(write_buf_.length());
+    unsent_zero_copy_buf_ = nullptr;
     if (!shutdown_.has_value() && status_ != Closed) {
       status_ = RemoteClosed;
       if (result == -EPIPE) {
@@ -622,13 +828,36 @@ void IoUringServerSocket::closeInternal() {
 
 void IoUringServerSocket::submitReadRequest() {
   if (!read_req_) {
-    read_req_ = parent_.submitReadRequest(*this);
+    if (parent_.providedBuffersEnabled() && !provided_buffers_exhausted_) {
+      // Keep a multishot recv armed while reading is enabled. Otherwise a single recv watches for
+      // the remote close. Neither holds a buffer until data arrives.
+      read_multishot_ = status_ == ReadEnabled;
+      read_req_ = parent_.submitRecvRequest(*this, read_multishot_);
+    } else {
+      provided_buffers_exhausted_ = false;
+      read_req_ = parent_.submitReadRequest(*this);
+    }
   }
 }
 
 void IoUringServerSocket::submitWriteOrShutdownRequest() {
   if (!write_or_shutdown_req_) {
-    if (write_buf_.length() > 0) {
+    if (unsent_zero_copy_buf_ != nullptr) {
+      ENVOY_LOG(trace, "submit zero copy send request for unsent data, offset = {}, fd = {}",
+                unsent_zero_copy_offset_, fd_);
+      write_zero_copy_ = true;
+      write_or_shutdown_req_ = parent_.submitSendZcRequest(
+          *this, std::move(unsent_zero_copy_buf_), unsent_zero_copy_offset_);
+      unsent_zero_copy_buf_ = nullptr;
+    } else if (write_buf_.length() > 0) {
+      write_zero_copy_ = zero_copy_send_enabled_ && parent_.zeroCopySendThreshold() > 0 &&
+                         write_buf_.length() >= parent_.zeroCopySendThreshold();
+      if (write_zero_copy_) {
+        ENVOY_LOG(trace, "submit zero copy send request, write_buf size = {}, fd = {}",
+                  write_buf_.length(), fd_);
+        write_or_shutdown_req_ = parent_.submitSendZcRequest(*this, write_buf_);
+        return;
+      }
       Buffer::RawSliceVector slices = write_buf_.getRawSlices(IOV_MAX);
       ENVOY_LOG(trace, "submit write request, write_buf size = {}, num_iovecs = {}, fd = {}",
                 write_buf_.length(), slices.size(), fd_);
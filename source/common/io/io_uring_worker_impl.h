@@ -7,6 +7,8 @@
 #include "source/common/common/logger.h"
 #include "source/common/io/io_uring_impl.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Io {
 
@@ -25,6 +27,31 @@ public:
   std::unique_ptr<struct iovec[]> iov_;
 };
 
+/**
+ * A zero copy send. The request owns the data being sent, which has to stay valid until the
+ * kernel notifies that it no longer references it, possibly after the socket is gone. After a
+ * partial send the unsent tail is sent by another request sharing the same data, so it is not
+ * copied.
+ */
+class SendZcRequest : public Request {
+public:
+  // Moves the first length bytes of data into the request.
+  SendZcRequest(IoUringSocket& socket, Buffer::Instance& data, uint64_t length);
+  // Sends the data of an earlier request from offset.
+  SendZcRequest(IoUringSocket& socket, std::shared_ptr<Buffer::OwnedImpl> buf, uint64_t offset);
+
+  // The number of bytes this request sends.
+  uint64_t length() const { return buf_->length() - offset_; }
+
+  std::shared_ptr<Buffer::OwnedImpl> buf_;
+  const uint64_t offset_;
+  std::unique_ptr<struct iovec[]> iov_;
+  struct msghdr msg_ {};
+
+private:
+  void initIovecs();
+};
+
 class IoUringSocketEntry;
 using IoUringSocketEntryPtr = std::unique_ptr<IoUringSocketEntry>;
 
@@ -32,8 +59,10 @@ class IoUringWorkerImpl : public IoUringWorker, private Logger::Loggable<Logger:
 public:
   IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
                     uint32_t read_buffer_size, uint32_t write_timeout_ms,
+                    uint32_t provided_buffer_count, uint32_t zero_copy_send_threshold,
                     Event::Dispatcher& dispatcher);
   IoUringWorkerImpl(IoUringPtr&& io_uring, uint32_t read_buffer_size, uint32_t write_timeout_ms,
+                    uint32_t provided_buffer_count, uint32_t zero_copy_send_threshold,
                     Event::Dispatcher& dispatcher);
   ~IoUringWorkerImpl() override;
 
@@ -64,22 +93,54 @@ public:
   // Return the number of sockets in this worker.
   uint32_t getNumOfSockets() const override { return sockets_.size(); }
 
+  // Whether reads receive into the buffer ring shared by all sockets of this worker.
+  bool providedBuffersEnabled() const { return provided_buffers_enabled_; }
+
+  // Submit a recv request that receives into the shared buffer ring for a socket.
+  Request* submitRecvRequest(IoUringSocket& socket, bool multishot);
+
+  // Copy the data of a recv completion into a buffer and hand the provided buffer back to the
+  // kernel.
+  void moveProvidedBufferToBuffer(const Request& req, size_t data_length,
+                                  Buffer::Instance& buffer);
+
+  // Hand the provided buffer of a recv completion back to the kernel without consuming the data,
+  // if the completion has one.
+  void releaseProvidedBuffer(const Request& req);
+
+  // The minimum number of pending bytes a socket sends with a zero copy send, or 0 if zero copy
+  // sends are disabled.
+  uint32_t zeroCopySendThreshold() const { return zero_copy_send_threshold_; }
+
+  // Submit a zero copy send of the pending data of a socket. The data is moved into the request.
+  Request* submitSendZcRequest(IoUringSocket& socket, Buffer::Instance& data);
+
+  // Submit a zero copy send of the unsent data of a partial zero copy send, from offset.
+  Request* submitSendZcRequest(IoUringSocket& socket, std::shared_ptr<Buffer::OwnedImpl> data,
+                               uint64_t offset);
+
 protected:
   // Add a socket to the worker.
   IoUringSocketEntry& addSocket(IoUringSocketEntryPtr&& socket);
   void onFileEvent();
   void submit();
+  Request* submitSendZcRequest(SendZcRequest* req);
 
   // The iouring instance.
   IoUringPtr io_uring_;
   const uint32_t read_buffer_size_;
   const uint32_t write_timeout_ms_;
+  bool provided_buffers_enabled_{false};
+  uint32_t zero_copy_send_threshold_{0};
   // The dispatcher of this worker is running on.
   Event::Dispatcher& dispatcher_;
   // The file event of iouring's eventfd.
   Event::FileEventPtr file_event_{nullptr};
   // All the sockets in this worker.
   std::list<IoUringSocketEntryPtr> sockets_;
+  // Zero copy sends that completed but whose data the kernel still references. They are released
+  // by their notification completion, or when the worker is destroyed.
+  absl::flat_hash_set<Request*> pending_zero_copy_sends_;
   // This is used to mark whether delay submit is enabled.
   // The IoUringWorker will delay the submit the requests which are submitted in request completion
   // callback.
@@ -238,6 +299,19 @@ protected:
   bool keep_fd_open_{false};
   // This is used for tracking the read's cancel request.
   Request* read_cancel_req_{nullptr};
+  // Whether read_req_ is a multishot recv, which stays armed until it is cancelled or fails.
+  bool read_multishot_{false};
+  // Set when a recv failed because the worker's buffer ring was empty. The next read uses a
+  // dedicated buffer instead.
+  bool provided_buffers_exhausted_{false};
+  // Whether write_or_shutdown_req_ is a zero copy send.
+  bool write_zero_copy_{false};
+  // The data of a partial zero copy send, which is sent from unsent_zero_copy_offset_ before
+  // write_buf_. It is shared with the request as the kernel may still reference the sent part.
+  std::shared_ptr<Buffer::OwnedImpl> unsent_zero_copy_buf_;
+  uint64_t unsent_zero_copy_offset_{0};
+  // Cleared if the socket doesn't support zero copy sends, e.g. a Unix domain socket.
+  bool zero_copy_send_enabled_{true};
   // This is used for tracking the write or shutdown's cancel request.
   Request* write_or_shutdown_cancel_req_{nullptr};
   // This is used for tracking the close request.
@@ -247,6 +321,7 @@ protected:
   void submitReadRequest();
   void submitWriteOrShutdownRequest();
   void moveReadDataToBuffer(Request* req, size_t data_length);
+  void returnUnsentDataToBuffer(Request* req, size_t sent_length);
   void onReadCompleted(int32_t result);
   void onWriteCompleted(int32_t result);
 };
@@ -1,5 +1,6 @@
 #include "source/common/memory/heap_shrinker.h"
 
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/memory/utils.h"
 #include "source/common/stats/symbol_table.h"
 
@@ -30,6 +31,8 @@ HeapShrinker::HeapShrinker(Event::Dispatcher& dispatcher, Server::OverloadManage
 
 void HeapShrinker::shrinkHeap() {
   if (active_) {
+    // Blocks cached by the buffer slice pools are free memory that the allocator can't release.
+    Buffer::SlicePool::releaseCachedBlocks();
     Utils::releaseFreeMemory();
     shrink_counter_->inc();
   }
@@ -9,8 +9,9 @@ namespace Envoy {
 namespace Memory {
 
 /**
- * A utility class to periodically attempt to shrink the heap by releasing free memory
- * to the system if the "shrink heap" overload action has been configured and triggered.
+ * A utility class to periodically attempt to shrink the heap by releasing free memory, including
+ * the blocks cached by the buffer slice pools, to the system if the "shrink heap" overload action
+ * has been configured and triggered.
  */
 class HeapShrinker {
 public:
@@ -1,5 +1,6 @@
 #include "source/common/network/io_socket_handle_impl.h"
 
+#include <cerrno>
 #include <memory>
 
 #include "envoy/buffer/buffer.h"
@@ -15,6 +16,10 @@
 #include "absl/container/fixed_array.h"
 #include "absl/types/optional.h"
 
+#if defined(__linux__)
+#include "source/common/api/os_sys_calls_impl_linux.h"
+#endif
+
 using Envoy::Api::SysCallIntResult;
 using Envoy::Api::SysCallSizeResult;
 
@@ -22,6 +27,28 @@ namespace Envoy {
 
 namespace {
 
+// The kernel limits the number of segments of a UDP GSO send, see UDP_MAX_SEGMENTS.
+constexpr uint64_t MaxUdpGsoSegments = 64;
+// The largest UDP payload of an IPv6 packet, which bounds the total size of a UDP GSO send.
+constexpr uint64_t MaxUdpGsoPayloadSize = 65535 - 40 - 8;
+
+// Whether the datagrams can be sent as the segments of a single UDP GSO message, i.e. all but the
+// last have the same size and the last isn't larger.
+bool canSendAsGsoMessage(const Buffer::RawSlice* datagrams, uint64_t num_datagrams) {
+  if (num_datagrams > MaxUdpGsoSegments || datagrams[0].len_ == 0) {
+    return false;
+  }
+  uint64_t total_size = 0;
+  for (uint64_t i = 0; i < num_datagrams; i++) {
+    if (datagrams[i].len_ > datagrams[0].len_ ||
+        (i + 1 < num_datagrams && datagrams[i].len_ != datagrams[0].len_)) {
+      return false;
+    }
+    total_size += datagrams[i].len_;
+  }
+  return total_size <= MaxUdpGsoPayloadSize;
+}
+
 constexpr int messageTypeContainsIP() {
 #ifdef IP_RECVDSTADDR
   return IP_RECVDSTADDR;
@@ -137,6 +164,26 @@ Api::IoCallUint64Result IoSocketHandleImpl::writev(const Buffer::RawSlice* slice
 }
 
 Api::IoCallUint64Result IoSocketHandleImpl::write(Buffer::Instance& buffer) {
+#if defined(__linux__)
+  // Data that was added to the buffer from a file, e.g. a cached response body, is sent straight
+  // from the file, without copying it through user space.
+  absl::optional<Buffer::FileRange> file_range = buffer.frontFileRange();
+  if (file_range.has_value()) {
+    off_t offset = file_range->offset_;
+    const Api::SysCallSizeResult sent = Api::LinuxOsSysCallsSingleton::get().sendfile(
+        fd_, file_range->fd_, &offset, file_range->length_);
+    if (sent.return_value_ > 0) {
+      buffer.drain(static_cast<uint64_t>(sent.return_value_));
+      return sysCallResultToIoCallResult(sent);
+    }
+    // If nothing was sent because the file is shorter than expected, or because the socket or the
+    // file does not support sendfile, write from memory instead.
+    if (sent.return_value_ < 0 && sent.errno_ != EINVAL && sent.errno_ != ENOSYS &&
+        sent.errno_ != EOPNOTSUPP) {
+      return sysCallResultToIoCallResult(sent);
+    }
+  }
+#endif
   constexpr uint64_t MaxSlices = 16;
   Buffer::RawSliceVector slices = buffer.getRawSlices(MaxSlices);
   Api::IoCallUint64Result result = writev(slices.begin(), slices.size());
@@ -230,6 +277,84 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slic
   }
 }
 
+Api::IoCallUint64Result IoSocketHandleImpl::sendmmsg(const Buffer::RawSlice* datagrams,
+                                                     uint64_t num_datagrams, int flags,
+                                                     const Address::Ip* self_ip,
+                                                     const Address::Instance& peer_address) {
+  auto& os_syscalls = Api::OsSysCallsSingleton::get();
+  if (num_datagrams <= 1 || self_ip != nullptr || !os_syscalls.supportsMmsg()) {
+    // Only sendmsg() attaches the source address, so the datagrams are sent one at a time.
+    uint64_t num_sent = 0;
+    for (; num_sent < num_datagrams; num_sent++) {
+      Api::IoCallUint64Result result =
+          sendmsg(&datagrams[num_sent], 1, flags, self_ip, peer_address);
+      if (!result.ok()) {
+        if (num_sent == 0) {
+          return result;
+        }
+        break;
+      }
+    }
+    return {num_sent, Api::IoError::none()};
+  }
+
+  const auto* address_base = dynamic_cast<const Address::InstanceBase*>(&peer_address);
+  sockaddr* sock_addr = const_cast<sockaddr*>(address_base->sockAddr());
+  if (sock_addr == nullptr) {
+    // Unlikely to happen unless the wrong peer address is passed.
+    return IoSocketError::ioResultSocketInvalidAddress();
+  }
+
+  absl::FixedArray<iovec> iov(num_datagrams);
+  for (uint64_t i = 0; i < num_datagrams; i++) {
+    iov[i].iov_base = datagrams[i].mem_;
+    iov[i].iov_len = datagrams[i].len_;
+  }
+
+  if (canSendAsGsoMessage(datagrams, num_datagrams) && os_syscalls.supportsUdpGso()) {
+    // The kernel splits the payload into datagrams of the first datagram's size.
+    char cbuf[CMSG_SPACE(sizeof(uint16_t))];
+    memset(cbuf, 0, sizeof(cbuf));
+    msghdr message;
+    message.msg_name = reinterpret_cast<void*>(sock_addr);
+    message.msg_namelen = address_base->sockAddrLen();
+    message.msg_iov = iov.begin();
+    message.msg_iovlen = num_datagrams;
+    message.msg_control = cbuf;
+    message.msg_controllen = sizeof(cbuf);
+    message.msg_flags = 0;
+    cmsghdr* const cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = IPPROTO_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    const uint16_t gso_size = datagrams[0].len_;
+    safeMemcpyUnsafeDst(CMSG_DATA(cmsg), &gso_size);
+    const Api::SysCallSizeResult result = os_syscalls.sendmsg(fd_, &message, flags);
+    if (result.return_value_ >= 0) {
+      return {num_datagrams, Api::IoError::none()};
+    }
+    // The kernel rejects the whole message if the segments don't fit the path MTU, or the device
+    // can't segment it. Send the datagrams separately instead, so that only those that are too
+    // large fail.
+    if (result.errno_ != EINVAL && result.errno_ != EMSGSIZE) {
+      return sysCallResultToIoCallResult(result);
+    }
+  }
+
+  absl::FixedArray<mmsghdr> mmsg(num_datagrams);
+  memset(mmsg.begin(), 0, sizeof(mmsghdr) * num_datagrams);
+  for (uint64_t i = 0; i < num_datagrams; i++) {
+    msghdr& message = mmsg[i].msg_hdr;
+    message.msg_name = reinterpret_cast<void*>(sock_addr);
+    message.msg_namelen = address_base->sockAddrLen();
+    message.msg_iov = &iov[i];
+    message.msg_iovlen = 1;
+  }
+  const Api::SysCallIntResult result =
+      os_syscalls.sendmmsg(fd_, mmsg.begin(), num_datagrams, flags);
+  return sysCallResultToIoCallResult(result);
+}
+
 Address::InstanceConstSharedPtr
 IoSocketHandleImpl::getOrCreateEnvoyAddressInstance(sockaddr_storage ss, socklen_t ss_len) {
   if (!recent_received_addresses_) {
@@ -134,6 +134,13 @@ Api::IoCallUint64Result IoUringSocketHandleImpl::sendmsg(const Buffer::RawSlice*
   return Network::IoSocketError::ioResultSocketInvalidAddress();
 }
 
+Api::IoCallUint64Result IoUringSocketHandleImpl::sendmmsg(const Buffer::RawSlice*, uint64_t, int,
+                                                          const Address::Ip*,
+                                                          const Address::Instance&) {
+  ENVOY_LOG(trace, "sendmmsg, fd = {}, type = {}", fd_, ioUringSocketTypeStr());
+  return Network::IoSocketError::ioResultSocketInvalidAddress();
+}
+
 Api::IoCallUint64Result IoUringSocketHandleImpl::recvmsg(Buffer::RawSlice*, const uint64_t,
                                                          uint32_t,
                                                          const IoHandle::UdpSaveCmsgConfig&,
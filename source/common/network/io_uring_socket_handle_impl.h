@@ -49,6 +49,9 @@ public:
                                   uint32_t self_port,
                                   const IoHandle::UdpSaveCmsgConfig& udp_save_cmsg_config,
                                   RecvMsgOutput& output) override;
+  Api::IoCallUint64Result sendmmsg(const Buffer::RawSlice* datagrams, uint64_t num_datagrams,
+                                   int flags, const Address::Ip* self_ip,
+                                   const Address::Instance& peer_address) override;
   Api::IoCallUint64Result recvmmsg(RawSliceArrays& slices, uint32_t self_port,
                                    const IoHandle::UdpSaveCmsgConfig& udp_save_cmsg_config,
                                    RecvMsgOutput& output) override;
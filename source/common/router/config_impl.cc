@@ -2067,9 +2067,45 @@ VirtualHostImpl::VirtualHostImpl(const envoy::config::route::v3::VirtualHost& vi
       SET_AND_RETURN_IF_NOT_OK(route_or_error.status(), creation_status);
       routes_.emplace_back(route_or_error.value());
     }
+    if (virtual_host.compile_route_matchers()) {
+      buildRouteMatchIndex(virtual_host);
+    }
   }
 }
 
+void VirtualHostImpl::buildRouteMatchIndex(
+    const envoy::config::route::v3::VirtualHost& virtual_host) {
+  ASSERT(static_cast<size_t>(virtual_host.routes_size()) == routes_.size());
+  auto index = std::make_unique<RouteMatchIndex>();
+  for (int i = 0; i < virtual_host.routes_size(); ++i) {
+    const auto& match = virtual_host.routes(i).match();
+    const bool case_sensitive = PROTOBUF_GET_WRAPPED_OR_DEFAULT(match, case_sensitive, true);
+    if (!case_sensitive) {
+      index->addUnindexed(i);
+      continue;
+    }
+    switch (match.path_specifier_case()) {
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPrefix:
+      index->addPrefix(match.prefix(), i);
+      break;
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPath:
+      index->addExact(match.path(), i);
+      break;
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPathSeparatedPrefix:
+      // A path separated prefix can only match paths that start with the prefix, the separator
+      // check is left to the route itself.
+      index->addPrefix(match.path_separated_prefix(), i);
+      break;
+    default:
+      index->addUnindexed(i);
+      break;
+    }
+  }
+  ENVOY_LOG(debug, "compiled route matchers for virtual host {}: {} routes, {} unindexed",
+            virtual_host.name(), routes_.size(), index->unindexedCount());
+  route_match_index_ = std::move(index);
+}
+
 const VirtualHost& SslRedirectRoute::virtualHost() const { return *virtual_host_; }
 
 RouteConstSharedPtr VirtualHostImpl::getRouteFromRoutes(
@@ -2109,6 +2145,50 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromRoutes(
   return nullptr;
 }
 
+RouteConstSharedPtr VirtualHostImpl::getRouteFromIndex(const RouteCallback& cb,
+                                                       const Http::RequestHeaderMap& headers,
+                                                       const StreamInfo::StreamInfo& stream_info,
+                                                       uint64_t random_value) const {
+  ASSERT(route_match_index_ != nullptr && headers.Path() != nullptr);
+  absl::string_view path = Http::PathUtil::removeQueryAndFragment(headers.getPathValue());
+  if (shared_virtual_host_->globalRouteConfig().ignorePathParametersInPathMatching()) {
+    path = path.substr(0, path.find_first_of(';'));
+  }
+
+  // The candidates are in route order, so the first route that matches is the same one that a
+  // linear scan of all routes would select.
+  for (const uint32_t position : route_match_index_->candidates(path)) {
+    const RouteEntryImplBaseConstSharedPtr& route = routes_[position];
+    RouteConstSharedPtr route_entry = route->matches(headers, stream_info, random_value);
+    if (route_entry == nullptr) {
+      continue;
+    }
+
+    if (cb == nullptr) {
+      return route_entry;
+    }
+
+    // Report the evaluation status relative to the full route list to keep the callback
+    // semantics identical to getRouteFromRoutes().
+    RouteEvalStatus eval_status = (position + 1 == routes_.size())
+                                      ? RouteEvalStatus::NoMoreRoutes
+                                      : RouteEvalStatus::HasMoreRoutes;
+    RouteMatchStatus match_status = cb(route_entry, eval_status);
+    if (match_status == RouteMatchStatus::Accept) {
+      return route_entry;
+    }
+    if (match_status == RouteMatchStatus::Continue &&
+        eval_status == RouteEvalStatus::NoMoreRoutes) {
+      ENVOY_LOG(debug,
+                "return null when route match status is Continue but there is no more routes");
+      return nullptr;
+    }
+  }
+
+  ENVOY_LOG(debug, "route was resolved but final route list did not match incoming request");
+  return nullptr;
+}
+
 RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb,
                                                          const Http::RequestHeaderMap& headers,
                                                          const StreamInfo::StreamInfo& stream_info,
@@ -2159,31 +2239,38 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
     return nullptr;
   }
 
+  // Pathless requests can only match routes that support them, which are never indexed.
+  if (route_match_index_ != nullptr && headers.Path() != nullptr) {
+    return getRouteFromIndex(cb, headers, stream_info, random_value);
+  }
+
   // Check for a route that matches the request.
   return getRouteFromRoutes(cb, headers, stream_info, random_value, routes_);
 }
 
-const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
-    absl::string_view host, const RouteMatcher::WildcardVirtualHosts& wildcard_virtual_hosts,
-    RouteMatcher::SubstringFunction substring_function) const {
+const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(absl::string_view host) const {
   // We do a longest wildcard match against the host that's passed in
   // (e.g. "foo-bar.baz.com" should match "*-bar.baz.com" before matching "*.baz.com" for suffix
-  // wildcards). This is done by scanning the length => wildcards map looking for every wildcard
-  // whose size is < length.
-  for (const auto& iter : wildcard_virtual_hosts) {
-    const uint32_t wildcard_length = iter.first;
-    const auto& wildcard_map = iter.second;
-    // >= because *.foo.com shouldn't match .foo.com.
-    if (wildcard_length >= host.size()) {
-      continue;
-    }
-    const auto match = wildcard_map.find(substring_function(host, wildcard_length));
-    if (match != wildcard_map.end()) {
-      return match->second.get();
+  // wildcards). Suffix wildcards take precedence over prefix wildcards. The wildcard must match
+  // at least one character, since *.foo.com shouldn't match .foo.com, so the first (for suffixes)
+  // or last (for prefixes) character of the host is excluded from the lookup.
+  if (host.size() < 2) {
+    return nullptr;
+  }
+  if (has_wildcard_virtual_host_suffixes_) {
+    const VirtualHostImpl* vhost =
+        wildcard_virtual_host_suffixes_.findLongestSuffix(host.substr(1)).get();
+    if (vhost != nullptr) {
+      return vhost;
     }
   }
+  if (has_wildcard_virtual_host_prefixes_) {
+    return wildcard_virtual_host_prefixes_.findLongestPrefix(host.substr(0, host.size() - 1))
+        .get();
+  }
   return nullptr;
 }
+
 absl::StatusOr<std::unique_ptr<RouteMatcher>>
 RouteMatcher::create(const envoy::config::route::v3::RouteConfiguration& route_config,
                      const CommonConfigSharedPtr& global_route_config,
@@ -2221,13 +2308,13 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
         }
         default_virtual_host_ = virtual_host;
       } else if (!domain.empty() && '*' == domain[0]) {
-        duplicate_found = !wildcard_virtual_host_suffixes_[domain.size() - 1]
-                               .emplace(domain.substr(1), virtual_host)
-                               .second;
+        duplicate_found = !wildcard_virtual_host_suffixes_.addReversed(domain.substr(1),
+                                                                       virtual_host, false);
+        has_wildcard_virtual_host_suffixes_ = true;
       } else if (!domain.empty() && '*' == domain[domain.size() - 1]) {
-        duplicate_found = !wildcard_virtual_host_prefixes_[domain.size() - 1]
-                               .emplace(domain.substr(0, domain.size() - 1), virtual_host)
-                               .second;
+        duplicate_found = !wildcard_virtual_host_prefixes_.add(
+            domain.substr(0, domain.size() - 1), virtual_host, false);
+        has_wildcard_virtual_host_prefixes_ = true;
       } else {
         duplicate_found = !virtual_hosts_.emplace(domain, virtual_host).second;
       }
@@ -2244,8 +2331,8 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
 
 const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::RequestHeaderMap& headers) const {
   // Fast path the case where we only have a default virtual host.
-  if (virtual_hosts_.empty() && wildcard_virtual_host_suffixes_.empty() &&
-      wildcard_virtual_host_prefixes_.empty()) {
+  if (virtual_hosts_.empty() && !has_wildcard_virtual_host_suffixes_ &&
+      !has_wildcard_virtual_host_prefixes_) {
     return default_virtual_host_.get();
   }
 
@@ -2271,21 +2358,9 @@ const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::RequestHeaderMa
   if (iter != virtual_hosts_.end()) {
     return iter->second.get();
   }
-  if (!wildcard_virtual_host_suffixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_suffixes_,
-        [](absl::string_view h, int l) -> absl::string_view { return h.substr(h.size() - l); });
-    if (vhost != nullptr) {
-      return vhost;
-    }
-  }
-  if (!wildcard_virtual_host_prefixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_prefixes_,
-        [](absl::string_view h, int l) -> absl::string_view { return h.substr(0, l); });
-    if (vhost != nullptr) {
-      return vhost;
-    }
+  const VirtualHostImpl* vhost = findWildcardVirtualHost(host);
+  if (vhost != nullptr) {
+    return vhost;
   }
   return default_virtual_host_.get();
 }
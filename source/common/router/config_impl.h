@@ -23,6 +23,7 @@
 
 #include "source/common/common/matchers.h"
 #include "source/common/common/packed_struct.h"
+#include "source/common/common/trie_lookup_table.h"
 #include "source/common/config/datasource.h"
 #include "source/common/config/metadata.h"
 #include "source/common/http/hash_policy.h"
@@ -31,6 +32,7 @@
 #include "source/common/router/config_utility.h"
 #include "source/common/router/header_parser.h"
 #include "source/common/router/metadatamatchcriteria_impl.h"
+#include "source/common/router/route_match_index.h"
 #include "source/common/router/router_ratelimit.h"
 #include "source/common/router/tls_context_match_criteria_impl.h"
 #include "source/common/stats/symbol_table.h"
@@ -410,6 +412,12 @@ public:
 private:
   enum class SslRequirements : uint8_t { None, ExternalOnly, All };
 
+  void buildRouteMatchIndex(const envoy::config::route::v3::VirtualHost& virtual_host);
+  RouteConstSharedPtr getRouteFromIndex(const RouteCallback& cb,
+                                        const Http::RequestHeaderMap& headers,
+                                        const StreamInfo::StreamInfo& stream_info,
+                                        uint64_t random_value) const;
+
   CommonVirtualHostSharedPtr shared_virtual_host_;
 
   std::shared_ptr<const SslRedirectRoute> ssl_redirect_route_;
@@ -417,6 +425,8 @@ private:
 
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
   Matcher::MatchTreeSharedPtr<Http::HttpMatchingData> matcher_;
+  // Only set if compile_route_matchers is enabled for this virtual host.
+  RouteMatchIndexConstPtr route_match_index_;
 };
 
 using VirtualHostSharedPtr = std::shared_ptr<VirtualHostImpl>;
@@ -1538,27 +1548,20 @@ private:
                ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
                absl::Status& creation_status);
 
-  using WildcardVirtualHosts =
-      std::map<int64_t, absl::node_hash_map<std::string, VirtualHostSharedPtr>, std::greater<>>;
-  using SubstringFunction = std::function<absl::string_view(absl::string_view, int)>;
-  const VirtualHostImpl* findWildcardVirtualHost(absl::string_view host,
-                                                 const WildcardVirtualHosts& wildcard_virtual_hosts,
-                                                 SubstringFunction substring_function) const;
+  using WildcardVirtualHosts = TrieLookupTable<VirtualHostSharedPtr>;
+  const VirtualHostImpl* findWildcardVirtualHost(absl::string_view host) const;
   bool ignorePortInHostMatching() const { return ignore_port_in_host_matching_; }
 
   Stats::ScopeSharedPtr vhost_scope_;
   absl::node_hash_map<std::string, VirtualHostSharedPtr> virtual_hosts_;
-  // std::greater as a minor optimization to iterate from more to less specific
-  //
-  // A note on using an unordered_map versus a vector of (string, VirtualHostSharedPtr) pairs:
-  //
-  // Based on local benchmarks, each vector entry costs around 20ns for recall and (string)
-  // comparison with a fixed cost of about 25ns. For unordered_map, the empty map costs about 65ns
-  // and climbs to about 110ns once there are any entries.
-  //
-  // The break-even is 4 entries.
+  // Wildcard domains are compiled into tries at config load so that the longest wildcard match
+  // is found in a single pass over the host, regardless of how many distinct wildcard lengths
+  // are configured. Suffix wildcards (e.g. "*.foo.com") are keyed by the reversed domain without
+  // the leading '*', prefix wildcards (e.g. "foo.*") by the domain without the trailing '*'.
   WildcardVirtualHosts wildcard_virtual_host_suffixes_;
   WildcardVirtualHosts wildcard_virtual_host_prefixes_;
+  bool has_wildcard_virtual_host_suffixes_{false};
+  bool has_wildcard_virtual_host_prefixes_{false};
 
   VirtualHostSharedPtr default_virtual_host_;
   const bool ignore_port_in_host_matching_{false};
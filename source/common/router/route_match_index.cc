@@ -0,0 +1,44 @@
+#include "source/common/router/route_match_index.h"
+
+#include <algorithm>
+
+namespace Envoy {
+namespace Router {
+
+void RouteMatchIndex::addPrefix(absl::string_view prefix, uint32_t position) {
+  if (prefix.empty()) {
+    // An empty prefix matches every path.
+    addUnindexed(position);
+    return;
+  }
+  uint32_t slot = prefixes_.find(prefix);
+  if (slot == 0) {
+    prefix_positions_.emplace_back();
+    slot = prefix_positions_.size();
+    prefixes_.add(prefix, slot);
+  }
+  prefix_positions_[slot - 1].push_back(position);
+}
+
+void RouteMatchIndex::addExact(absl::string_view path, uint32_t position) {
+  exact_paths_[path].push_back(position);
+}
+
+void RouteMatchIndex::addUnindexed(uint32_t position) { unindexed_.push_back(position); }
+
+RouteMatchIndex::Candidates RouteMatchIndex::candidates(absl::string_view path) const {
+  Candidates result(unindexed_.begin(), unindexed_.end());
+  for (const uint32_t slot : prefixes_.findMatchingPrefixes(path)) {
+    const auto& positions = prefix_positions_[slot - 1];
+    result.insert(result.end(), positions.begin(), positions.end());
+  }
+  if (const auto it = exact_paths_.find(path); it != exact_paths_.end()) {
+    result.insert(result.end(), it->second.begin(), it->second.end());
+  }
+  // Every route is stored in exactly one place, so there are no duplicates to remove.
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/common/trie_lookup_table.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * An index over the path matchers of an ordered list of routes. Given a request path, it returns
+ * the positions of the routes whose path matcher could possibly match, in their original order,
+ * so that only those routes need to be fully evaluated. First-match semantics are preserved as
+ * long as the caller evaluates the candidates in the returned order.
+ *
+ * Case sensitive prefix (including path separated prefix) matchers are stored in a trie, case
+ * sensitive exact path matchers in a hash map. Every other route (regex, URI template, case
+ * insensitive, CONNECT, ...) is always returned as a candidate.
+ */
+class RouteMatchIndex {
+public:
+  using Candidates = absl::InlinedVector<uint32_t, 8>;
+
+  /**
+   * Adds a route that can only match paths starting with the given prefix.
+   * @param prefix the path prefix of the route.
+   * @param position the position of the route in the route list.
+   */
+  void addPrefix(absl::string_view prefix, uint32_t position);
+
+  /**
+   * Adds a route that can only match the given path.
+   * @param path the exact path of the route.
+   * @param position the position of the route in the route list.
+   */
+  void addExact(absl::string_view path, uint32_t position);
+
+  /**
+   * Adds a route that is always a candidate.
+   * @param position the position of the route in the route list.
+   */
+  void addUnindexed(uint32_t position);
+
+  /**
+   * Finds the routes that may match the path.
+   * @param path the request path with query, fragment and (if configured) path parameters
+   *        already removed.
+   * @return the positions of the candidate routes in ascending order.
+   */
+  Candidates candidates(absl::string_view path) const;
+
+  /**
+   * @return the number of routes that are evaluated for every request.
+   */
+  uint64_t unindexedCount() const { return unindexed_.size(); }
+
+private:
+  // Routes sharing the same prefix, in the order they were added. Trie values are indices into
+  // this vector plus one, so that zero means "no value".
+  std::vector<std::vector<uint32_t>> prefix_positions_;
+  TrieLookupTable<uint32_t> prefixes_;
+  absl::flat_hash_map<std::string, std::vector<uint32_t>> exact_paths_;
+  std::vector<uint32_t> unindexed_;
+};
+
+using RouteMatchIndexConstPtr = std::unique_ptr<const RouteMatchIndex>;
+
+} // namespace Router
+} // namespace Envoy
@@ -5,6 +5,7 @@
 
 #include "source/common/common/utility.h"
 
+#include "absl/numeric/bits.h"
 #include "absl/strings/str_join.h"
 
 namespace Envoy {
@@ -12,7 +13,30 @@ namespace Stats {
 
 namespace {
 const ConstSupportedBuckets default_buckets{};
-}
+
+constexpr std::array<uint64_t, 20> PowersOfTen = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL,
+};
+} // namespace
 
 HistogramStatisticsImpl::HistogramStatisticsImpl()
     : supported_buckets_(default_buckets), computed_quantiles_(supportedQuantiles().size(), 0.0) {}
@@ -111,7 +135,8 @@ HistogramSettingsImpl::HistogramSettingsImpl(const envoy::config::metrics::v3::S
         }
 
         return configs;
-      }()) {}
+      }()),
+      lock_free_recording_(config.lock_free_histograms()) {}
 
 const ConstSupportedBuckets& HistogramSettingsImpl::buckets(absl::string_view stat_name) const {
   for (const auto& config : configs_) {
@@ -128,5 +153,66 @@ const ConstSupportedBuckets& HistogramSettingsImpl::defaultBuckets() {
                           60000, 300000, 600000, 1800000, 3600000});
 }
 
+AtomicLogLinearHistogram::~AtomicLogLinearHistogram() {
+  for (std::atomic<Decade*>& decade : decades_) {
+    delete decade.load();
+  }
+}
+
+void AtomicLogLinearHistogram::recordValue(uint64_t value) {
+  // There is a single writer, so a plain load and store is enough and avoids a locked
+  // read-modify-write instruction on every recorded value.
+  const auto increment = [](std::atomic<uint64_t>& count) {
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  };
+  if (value == 0) {
+    increment(zero_count_);
+    return;
+  }
+
+  // floor(log10(value)), see https://graphics.stanford.edu/~seander/bithacks.html#IntegerLog10.
+  const uint32_t bits = 64 - absl::countl_zero(value);
+  uint32_t exp = (bits * 1233) >> 12;
+  if (value < PowersOfTen[exp]) {
+    --exp;
+  }
+  // The two most significant decimal digits, as computed by hist_insert_intscale().
+  const uint64_t digits = exp == 0 ? value * 10 : value / PowersOfTen[exp - 1];
+  ASSERT(digits >= 10 && digits < 100);
+
+  Decade* decade = decades_[exp].load(std::memory_order_relaxed);
+  if (decade == nullptr) {
+    decade = new Decade();
+    decades_[exp].store(decade, std::memory_order_release);
+  }
+  increment(decade->counts_[digits - 10]);
+}
+
+void AtomicLogLinearHistogram::merge(histogram_t* target) {
+  hist_bucket_t bucket;
+  const uint64_t zero_count = zero_count_.load(std::memory_order_relaxed);
+  if (zero_count != merged_zero_count_) {
+    bucket.val = 0;
+    bucket.exp = 0;
+    hist_insert_raw(target, bucket, zero_count - merged_zero_count_);
+    merged_zero_count_ = zero_count;
+  }
+  for (uint32_t exp = 0; exp < NumDecades; ++exp) {
+    Decade* decade = decades_[exp].load(std::memory_order_acquire);
+    if (decade == nullptr) {
+      continue;
+    }
+    for (uint32_t i = 0; i < BucketsPerDecade; ++i) {
+      const uint64_t count = decade->counts_[i].load(std::memory_order_relaxed);
+      if (count != decade->merged_counts_[i]) {
+        bucket.val = static_cast<int8_t>(i + 10);
+        bucket.exp = static_cast<int8_t>(exp);
+        hist_insert_raw(target, bucket, count - decade->merged_counts_[i]);
+        decade->merged_counts_[i] = count;
+      }
+    }
+  }
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <string>
 
@@ -25,12 +27,49 @@ public:
 
   // HistogramSettings
   const ConstSupportedBuckets& buckets(absl::string_view stat_name) const override;
+  bool lockFreeRecording() const override { return lock_free_recording_; }
 
   static ConstSupportedBuckets& defaultBuckets();
 
 private:
   using Config = std::pair<Matchers::StringMatcherImpl, ConstSupportedBuckets>;
   const std::vector<Config> configs_{};
+  const bool lock_free_recording_{false};
+};
+
+/**
+ * Log-linear histogram with one atomic counter per circllhist integer bucket, so that another
+ * thread can merge the recorded values without synchronizing with the recording thread. Counters
+ * are allocated one power of ten at a time, on first use. Only one thread may record values, and
+ * only one thread at a time may merge them.
+ */
+class AtomicLogLinearHistogram : NonCopyable {
+public:
+  ~AtomicLogLinearHistogram();
+
+  void recordValue(uint64_t value);
+
+  /**
+   * Adds the values recorded since the previous merge to the target histogram.
+   * @param target the histogram to add the values to.
+   */
+  void merge(histogram_t* target);
+
+private:
+  // Two significant decimal digits, 10 to 99, for each power of ten.
+  static constexpr uint32_t BucketsPerDecade = 90;
+  // Powers of ten needed to cover all uint64_t values.
+  static constexpr uint32_t NumDecades = 20;
+
+  struct Decade {
+    std::array<std::atomic<uint64_t>, BucketsPerDecade> counts_{};
+    // Values of counts_ as of the previous merge, only accessed by the merging thread.
+    std::array<uint64_t, BucketsPerDecade> merged_counts_{};
+  };
+
+  std::atomic<uint64_t> zero_count_{0};
+  uint64_t merged_zero_count_{0};
+  std::array<std::atomic<Decade*>, NumDecades> decades_{};
 };
 
 /**
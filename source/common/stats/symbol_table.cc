@@ -1,8 +1,10 @@
 #include "source/common/stats/symbol_table.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <memory>
+#include <tuple>
 #include <vector>
 
 #include "source/common/common/assert.h"
@@ -261,11 +263,8 @@ bool StatName::startsWith(StatName prefix) const {
 
 std::vector<absl::string_view> SymbolTable::decodeStrings(StatName stat_name) const {
   std::vector<absl::string_view> strings;
-  Thread::LockGuard lock(lock_);
   Encoding::decodeTokens(
-      stat_name,
-      [this, &strings](Symbol symbol)
-          ABSL_NO_THREAD_SAFETY_ANALYSIS { strings.push_back(fromSymbol(symbol)); },
+      stat_name, [this, &strings](Symbol symbol) { strings.push_back(fromSymbol(symbol)); },
       [&strings](absl::string_view str) { strings.push_back(str); });
   return strings;
 }
@@ -312,18 +311,15 @@ void SymbolTable::addTokensToEncoding(const absl::string_view name, Encoding& en
   std::vector<Symbol> symbols;
   symbols.reserve(tokens.size());
 
-  // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
-  {
-    Thread::LockGuard lock(lock_);
-    recent_lookups_.lookup(name);
-    for (auto& token : tokens) {
-      // TODO(jmarantz): consider using StatNameDynamicStorage for tokens with
-      // length below some threshold, say 4 bytes. It might be preferable not to
-      // reserve Symbols for every 3 digit number found (for example) in ipv4
-      // addresses.
-      symbols.push_back(toSymbol(token));
-    }
+  // Now populate the Symbol objects, which involves bumping ref-counts in
+  // this. Each token only takes the lock of the shard it hashes to.
+  recordLookup(name, encodeShard(tokens[0]));
+  for (auto& token : tokens) {
+    // TODO(jmarantz): consider using StatNameDynamicStorage for tokens with
+    // length below some threshold, say 4 bytes. It might be preferable not to
+    // reserve Symbols for every 3 digit number found (for example) in ipv4
+    // addresses.
+    symbols.push_back(toSymbol(token));
   }
 
   // Now efficiently encode the array of 32-bit symbols into a uint8_t array.
@@ -331,9 +327,12 @@ void SymbolTable::addTokensToEncoding(const absl::string_view name, Encoding& en
 }
 
 uint64_t SymbolTable::numSymbols() const {
-  Thread::LockGuard lock(lock_);
-  ASSERT(encode_map_.size() == decode_map_.size());
-  return encode_map_.size();
+  uint64_t num_symbols = 0;
+  for (const DecodeShard& shard : decode_shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    num_symbols += shard.decode_map_.size();
+  }
+  return num_symbols;
 }
 
 std::string SymbolTable::toString(const StatName& stat_name) const {
@@ -344,21 +343,8 @@ void SymbolTable::incRefCount(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name);
 
-  Thread::LockGuard lock(lock_);
   for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-
-    ASSERT(decode_search != decode_map_.end(),
-           "Please see "
-           "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
-           "debugging-symbol-table-assertions");
-    auto encode_search = encode_map_.find(decode_search->second->toStringView());
-    ASSERT(encode_search != encode_map_.end(),
-           "Please see "
-           "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
-           "debugging-symbol-table-assertions");
-
-    ++encode_search->second.ref_count_;
+    findSymbolEntry(symbol).ref_count_.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
@@ -366,41 +352,73 @@ void SymbolTable::free(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name);
 
-  Thread::LockGuard lock(lock_);
   for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-    ASSERT(decode_search != decode_map_.end());
-
-    auto encode_search = encode_map_.find(decode_search->second->toStringView());
-    ASSERT(encode_search != encode_map_.end());
-
-    // If that was the last remaining client usage of the symbol, erase the
-    // current mappings and add the now-unused symbol to the reuse pool.
-    //
-    // The "if (--EXPR.ref_count_)" pattern speeds up BM_CreateRace by 20% in
-    // symbol_table_speed_test.cc, relative to breaking out the decrement into a
-    // separate step, likely due to the non-trivial dereferences in EXPR.
-    if (--encode_search->second.ref_count_ == 0) {
-      decode_map_.erase(decode_search);
-      encode_map_.erase(encode_search);
-      pool_.push(symbol);
+    releaseSymbol(findSymbolEntry(symbol));
+  }
+}
+
+void SymbolTable::releaseSymbol(SymbolEntry& entry) {
+  // Drop any reference but the last one without taking a lock. The release
+  // ordering keeps this thread's reads of the entry ahead of its erasure by
+  // whichever thread drops the last reference.
+  uint32_t count = entry.ref_count_.load(std::memory_order_relaxed);
+  while (count > 1) {
+    if (entry.ref_count_.compare_exchange_weak(count, count - 1, std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+      return;
     }
   }
+
+  // This may be the last reference. Another thread may have referenced the
+  // symbol through the encode map since, so the count is decremented again
+  // under the writer lock of the token's encode shard.
+  const absl::string_view token = entry.token();
+  EncodeShard& shard = encodeShard(token);
+  absl::MutexLock lock(&shard.mutex_);
+  if (--entry.ref_count_ != 0) {
+    return;
+  }
+
+  // That was the last remaining client usage of the symbol, so erase the
+  // current mappings and add the now-unused symbol to the reuse pool. The
+  // encode map entry must go first, as its key points into the entry owned by
+  // the decode map.
+  shard.encode_map_.erase(token);
+  const Symbol symbol = entry.symbol();
+  {
+    DecodeShard& decode_shard = decodeShard(symbol);
+    absl::MutexLock decode_lock(&decode_shard.mutex_);
+    decode_shard.decode_map_.erase(symbol);
+  }
+  Thread::LockGuard symbol_lock(symbol_lock_);
+  pool_.push(symbol);
+}
+
+void SymbolTable::recordLookup(absl::string_view name, EncodeShard& shard) {
+  if (recent_lookup_capacity_.load(std::memory_order_relaxed) == 0) {
+    shard.untracked_lookups_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Thread::LockGuard lock(recent_lookups_lock_);
+  recent_lookups_.lookup(name);
 }
 
 uint64_t SymbolTable::getRecentLookups(const RecentLookupsFn& iter) const {
   uint64_t total = 0;
   absl::flat_hash_map<std::string, uint64_t> name_count_map;
 
-  // We don't want to hold lock_ while calling the iterator, but we need it to
-  // access recent_lookups_, so we buffer in name_count_map.
+  // We don't want to hold recent_lookups_lock_ while calling the iterator, but
+  // we need it to access recent_lookups_, so we buffer in name_count_map.
   {
-    Thread::LockGuard lock(lock_);
+    Thread::LockGuard lock(recent_lookups_lock_);
     recent_lookups_.forEach(
         [&name_count_map](absl::string_view str, uint64_t count)
             ABSL_NO_THREAD_SAFETY_ANALYSIS { name_count_map[std::string(str)] += count; });
     total += recent_lookups_.total();
   }
+  for (const EncodeShard& shard : encode_shards_) {
+    total += shard.untracked_lookups_.load(std::memory_order_relaxed);
+  }
 
   // Now we have the collated name-count map data: we need to vectorize and
   // sort. We define the pair with the count first as std::pair::operator<
@@ -444,17 +462,21 @@ DynamicSpans SymbolTable::getDynamicSpans(StatName stat_name) const {
 }
 
 void SymbolTable::setRecentLookupCapacity(uint64_t capacity) {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   recent_lookups_.setCapacity(capacity);
+  recent_lookup_capacity_.store(capacity, std::memory_order_relaxed);
 }
 
 void SymbolTable::clearRecentLookups() {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   recent_lookups_.clear();
+  for (EncodeShard& shard : encode_shards_) {
+    shard.untracked_lookups_.store(0, std::memory_order_relaxed);
+  }
 }
 
 uint64_t SymbolTable::recentLookupCapacity() const {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   return recent_lookups_.capacity();
 }
 
@@ -465,39 +487,94 @@ StatNameSetPtr SymbolTable::makeSet(absl::string_view name) {
 }
 
 Symbol SymbolTable::toSymbol(absl::string_view sv) {
-  Symbol result;
-  auto encode_find = encode_map_.find(sv);
-  // If the string segment doesn't already exist,
-  if (encode_find == encode_map_.end()) {
-    // We create the actual string, place it in the decode_map_, and then insert
-    // a string_view pointing to it in the encode_map_. This allows us to only
-    // store the string once. We use unique_ptr so copies are not made as
-    // flat_hash_map moves values around.
-    InlineStringPtr str = InlineString::create(sv);
-    auto encode_insert = encode_map_.insert({str->toStringView(), SharedSymbol(next_symbol_)});
-    ASSERT(encode_insert.second);
-    auto decode_insert = decode_map_.insert({next_symbol_, std::move(str)});
-    ASSERT(decode_insert.second);
-
-    result = next_symbol_;
-    newSymbol();
-  } else {
-    // If the insertion didn't take place, return the actual value at that location and up the
-    // refcount at that location
-    result = encode_find->second.symbol_;
-    ++(encode_find->second.ref_count_);
+  EncodeShard& shard = encodeShard(sv);
+  {
+    // If the string segment already exists, up the refcount at that location and
+    // return its symbol. This is the common case, and only needs the reader lock.
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    auto encode_find = shard.encode_map_.find(sv);
+    if (encode_find != shard.encode_map_.end()) {
+      encode_find->second->ref_count_.fetch_add(1, std::memory_order_relaxed);
+      return encode_find->second->symbol();
+    }
   }
-  return result;
+  return insertSymbol(sv, shard);
 }
 
-absl::string_view SymbolTable::fromSymbol(const Symbol symbol) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
-  auto search = decode_map_.find(symbol);
-  RELEASE_ASSERT(search != decode_map_.end(), "no such symbol");
-  return search->second->toStringView();
+Symbol SymbolTable::insertSymbol(absl::string_view sv, EncodeShard& shard) {
+  absl::MutexLock lock(&shard.mutex_);
+  auto encode_find = shard.encode_map_.find(sv);
+  if (encode_find != shard.encode_map_.end()) {
+    // Another thread inserted the string segment since our lookup.
+    encode_find->second->ref_count_.fetch_add(1, std::memory_order_relaxed);
+    return encode_find->second->symbol();
+  }
+
+  // We create the entry, place it in the decode_map_, and then insert a
+  // string_view of its token and a pointer to it in the encode map. This
+  // allows us to only store the string and ref-count once. We use unique_ptr
+  // so copies are not made as flat_hash_map moves values around.
+  const Symbol symbol = allocateSymbol();
+  SymbolEntryPtr entry = SymbolEntry::create(sv, symbol);
+  auto encode_insert = shard.encode_map_.emplace(entry->token(), entry.get());
+  ASSERT(encode_insert.second);
+  DecodeShard& decode_shard = decodeShard(symbol);
+  absl::MutexLock decode_lock(&decode_shard.mutex_);
+  auto decode_insert = decode_shard.decode_map_.insert({symbol, std::move(entry)});
+  ASSERT(decode_insert.second);
+  return symbol;
+}
+
+Symbol SymbolTable::allocateSymbol() {
+  Thread::LockGuard lock(symbol_lock_);
+  const Symbol symbol = next_symbol_;
+  newSymbol();
+  return symbol;
+}
+
+SymbolTable::SymbolEntry::SymbolEntry(absl::string_view token, Symbol symbol)
+    : symbol_(symbol), size_(token.size()) {
+  memcpy(data_, token.data(), size_); // NOLINT(safe-memcpy)
+}
+
+SymbolTable::SymbolEntry& SymbolTable::findSymbolEntry(const Symbol symbol) const {
+  const DecodeShard& shard = decodeShard(symbol);
+  absl::ReaderMutexLock lock(&shard.mutex_);
+  auto search = shard.decode_map_.find(symbol);
+  RELEASE_ASSERT(search != shard.decode_map_.end(),
+                 "no such symbol. Please see "
+                 "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
+                 "debugging-symbol-table-assertions");
+  return *search->second;
+}
+
+absl::string_view SymbolTable::fromSymbol(const Symbol symbol) const {
+  return findSymbolEntry(symbol).token();
+}
+
+absl::string_view SymbolTable::fromSymbolLockHeld(const Symbol symbol) const
+    ABSL_NO_THREAD_SAFETY_ANALYSIS {
+  const DecodeShard& shard = decodeShard(symbol);
+  auto search = shard.decode_map_.find(symbol);
+  RELEASE_ASSERT(search != shard.decode_map_.end(), "no such symbol");
+  return search->second->token();
 }
 
-void SymbolTable::newSymbol() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+SymbolTable::DecodeShardsReaderLock::DecodeShardsReaderLock(const SymbolTable& symbol_table)
+    ABSL_NO_THREAD_SAFETY_ANALYSIS : symbol_table_(symbol_table) {
+  for (const DecodeShard& shard : symbol_table_.decode_shards_) {
+    shard.mutex_.ReaderLock();
+  }
+}
+
+SymbolTable::DecodeShardsReaderLock::~DecodeShardsReaderLock() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+  for (auto it = symbol_table_.decode_shards_.rbegin(); it != symbol_table_.decode_shards_.rend();
+       ++it) {
+    it->mutex_.ReaderUnlock();
+  }
+}
+
+void SymbolTable::newSymbol() ABSL_EXCLUSIVE_LOCKS_REQUIRED(symbol_lock_) {
   if (pool_.empty()) {
     next_symbol_ = ++monotonic_counter_;
   } else {
@@ -509,15 +586,18 @@ void SymbolTable::newSymbol() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
 }
 
 bool SymbolTable::lessThan(const StatName& a, const StatName& b) const {
-  // Proactively take the table lock in anticipation that we'll need to
-  // convert at least one symbol to a string_view, and it's easier not to
-  // bother to lazily take the lock.
-  Thread::LockGuard lock(lock_);
-  return lessThanLockHeld(a, b);
+  // Each symbol that has to be converted to a string_view only takes the
+  // reader lock of its own decode shard.
+  return lessThanDecoding(a, b, [this](Symbol symbol) { return fromSymbol(symbol); });
 }
 
-bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const {
+  return lessThanDecoding(a, b, [this](Symbol symbol) { return fromSymbolLockHeld(symbol); });
+}
+
+template <class FromSymbol>
+bool SymbolTable::lessThanDecoding(const StatName& a, const StatName& b,
+                                   const FromSymbol& from_symbol) const {
   Encoding::TokenIter a_iter(a), b_iter(b);
   while (true) {
     Encoding::TokenIter::TokenType a_type = a_iter.next();
@@ -534,10 +614,10 @@ bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
     }
 
     absl::string_view a_token = a_type == Encoding::TokenIter::TokenType::Symbol
-                                    ? fromSymbol(a_iter.symbol())
+                                    ? from_symbol(a_iter.symbol())
                                     : a_iter.stringView();
     absl::string_view b_token = b_type == Encoding::TokenIter::TokenType::Symbol
-                                    ? fromSymbol(b_iter.symbol())
+                                    ? from_symbol(b_iter.symbol())
                                     : b_iter.stringView();
     if (a_token != b_token) {
       return a_token < b_token;
@@ -547,16 +627,17 @@ bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTable::debugPrint() const {
-  Thread::LockGuard lock(lock_);
-  std::vector<Symbol> symbols;
-  for (const auto& p : decode_map_) {
-    symbols.push_back(p.first);
+  std::vector<std::tuple<Symbol, std::string, uint32_t>> symbols;
+  for (const DecodeShard& decode_shard : decode_shards_) {
+    absl::ReaderMutexLock lock(&decode_shard.mutex_);
+    for (const auto& p : decode_shard.decode_map_) {
+      symbols.emplace_back(p.first, std::string(p.second->token()),
+                           p.second->ref_count_.load(std::memory_order_relaxed));
+    }
   }
   std::sort(symbols.begin(), symbols.end());
-  for (Symbol symbol : symbols) {
-    const InlineString& token = *decode_map_.find(symbol)->second;
-    const SharedSymbol& shared_symbol = encode_map_.find(token.toStringView())->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.ref_count_);
+  for (const auto& [symbol, token, ref_count] : symbols) {
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token, ref_count);
   }
 }
 #endif
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <memory>
 #include <stack>
 #include <string>
@@ -14,11 +16,14 @@
 #include "source/common/common/utility.h"
 #include "source/common/stats/recent_lookups.h"
 
+#include "absl/base/optimization.h"
 #include "absl/container/fixed_array.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/hash/hash.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Stats {
@@ -324,6 +329,9 @@ public:
    */
   DynamicSpans getDynamicSpans(StatName stat_name) const;
 
+  /**
+   * Like lessThan(), for callers holding the reader locks of all decode shards.
+   */
   bool lessThanLockHeld(const StatName& a, const StatName& b) const;
 
   template <class GetStatName, class Obj> struct StatNameCompare {
@@ -338,7 +346,7 @@ public:
 
   /**
    * Sorts a range by StatName. This API is more efficient than
-   * calling std::sort directly as it takes a single lock for the
+   * calling std::sort directly as it takes a single reader lock for the
    * entire sort, rather than locking on each comparison.
    *
    * @param begin the beginning of the range to sort
@@ -347,9 +355,9 @@ public:
    */
   template <class Obj, class Iter, class GetStatName>
   void sortByStatNames(Iter begin, Iter end, GetStatName get_stat_name) const {
-    // Grab the lock once before sorting begins, so we don't have to re-take
-    // it on every comparison.
-    Thread::LockGuard lock(lock_);
+    // Grab the decode locks once before sorting begins, so we don't have to
+    // re-take them on every comparison.
+    DecodeShardsReaderLock lock(*this);
     StatNameCompare<GetStatName, Obj> compare(*this, get_stat_name);
     std::sort(begin, end, compare);
   }
@@ -395,15 +403,55 @@ private:
    */
   void incRefCount(const StatName& stat_name);
 
-  struct SharedSymbol {
-    SharedSymbol(Symbol symbol) : symbol_(symbol) {}
+  // A symbol's token and ref-count, allocated once and owned by the decode
+  // map. The encode map is keyed by a view of the token, so referencing or
+  // releasing a symbol only looks up its decode shard. The ref-count is
+  // atomic so that this only takes the shard's reader lock; the count only
+  // drops to zero with the token's encode shard writer lock held, at which
+  // point the entry is erased, so encode lookups never observe a dead symbol.
+  class SymbolEntry;
+  using SymbolEntryPtr = std::unique_ptr<SymbolEntry>;
+  class SymbolEntry : public InlineStorage {
+  public:
+    static SymbolEntryPtr create(absl::string_view token, Symbol symbol) {
+      return SymbolEntryPtr(new (token.size()) SymbolEntry(token, symbol));
+    }
 
-    Symbol symbol_;
-    uint32_t ref_count_{1};
+    absl::string_view token() const { return {data_, size_}; }
+    Symbol symbol() const { return symbol_; }
+
+    std::atomic<uint32_t> ref_count_{1};
+
+  private:
+    SymbolEntry(absl::string_view token, Symbol symbol);
+
+    const Symbol symbol_;
+    const uint32_t size_;
+    char data_[];
   };
 
-  // This must be held during both encode() and free().
-  mutable Thread::MutexBasicLockable lock_;
+  // Number of independently locked partitions of the encode map. Tokens are
+  // assigned to a shard by hash, so that concurrent encodes of different
+  // tokens do not contend.
+  static constexpr uint32_t NumEncodeShards = 16;
+  struct EncodeShard;
+
+  // Number of independently locked partitions of the decode map. Symbols are
+  // assigned to a shard by value, so that decoding, referencing and freeing
+  // existing symbols do not share a lock across the whole table.
+  static constexpr uint32_t NumDecodeShards = 16;
+  struct DecodeShard;
+
+  // Holds the reader locks of all decode shards, in index order, for the
+  // lifetime of the object. Writers only lock one decode shard at a time.
+  class DecodeShardsReaderLock {
+  public:
+    explicit DecodeShardsReaderLock(const SymbolTable& symbol_table);
+    ~DecodeShardsReaderLock();
+
+  private:
+    const SymbolTable& symbol_table_;
+  };
 
   /**
    * Decodes a uint8_t array into an array of period-delimited strings. Note
@@ -426,20 +474,83 @@ private:
    * @param sv the individual string to be encoded as a symbol.
    * @return Symbol the encoded string.
    */
-  Symbol toSymbol(absl::string_view sv) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  Symbol toSymbol(absl::string_view sv);
 
   /**
-   * Convenience function for decode(), decoding one symbol at a time.
+   * Convenience function for decode(), decoding one symbol at a time. This
+   * takes the reader lock of the symbol's decode shard. The caller must hold
+   * a reference to the symbol, which keeps the returned string valid after the
+   * lock is released.
    *
    * @param symbol the individual symbol to be decoded.
    * @return absl::string_view the decoded string.
    */
-  absl::string_view fromSymbol(Symbol symbol) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  absl::string_view fromSymbol(Symbol symbol) const;
+
+  /**
+   * Like fromSymbol(), for callers holding the reader locks of all decode
+   * shards.
+   */
+  absl::string_view fromSymbolLockHeld(Symbol symbol) const;
+
+  /**
+   * Finds the entry for a symbol, which stays valid after the shard's reader
+   * lock is released for as long as the caller holds a reference to it.
+   *
+   * @param symbol the symbol to find.
+   * @return SymbolEntry& the symbol's entry.
+   */
+  SymbolEntry& findSymbolEntry(Symbol symbol) const;
+
+  /**
+   * Compares two stat names, decoding symbols with from_symbol.
+   */
+  template <class FromSymbol>
+  bool lessThanDecoding(const StatName& a, const StatName& b, const FromSymbol& from_symbol) const;
+
+  /**
+   * Inserts a new token into the table, or references it if another thread
+   * inserted it since the caller's lookup under the reader lock.
+   *
+   * @param sv the token to insert.
+   * @param shard the shard the token hashes to.
+   * @return Symbol the symbol for the token.
+   */
+  Symbol insertSymbol(absl::string_view sv, EncodeShard& shard);
+
+  /**
+   * Drops a reference to a symbol, erasing it when it was the last reference.
+   *
+   * @param entry the entry of the symbol to release.
+   */
+  void releaseSymbol(SymbolEntry& entry);
+
+  /**
+   * Returns the symbol to use for the next insertion, and stages a new one.
+   */
+  Symbol allocateSymbol();
 
   /**
    * Stages a new symbol for use. To be called after a successful insertion.
    */
-  void newSymbol();
+  void newSymbol() ABSL_EXCLUSIVE_LOCKS_REQUIRED(symbol_lock_);
+
+  /**
+   * Records a lookup of name for getRecentLookups().
+   *
+   * @param name the name looked up.
+   * @param shard the encode shard of the name's first token.
+   */
+  void recordLookup(absl::string_view name, EncodeShard& shard);
+
+  static uint32_t encodeShardIndex(absl::string_view sv) {
+    return absl::HashOf(sv) % NumEncodeShards;
+  }
+  EncodeShard& encodeShard(absl::string_view sv) { return encode_shards_[encodeShardIndex(sv)]; }
+  const DecodeShard& decodeShard(Symbol symbol) const {
+    return decode_shards_[symbol % NumDecodeShards];
+  }
+  DecodeShard& decodeShard(Symbol symbol) { return decode_shards_[symbol % NumDecodeShards]; }
 
   /**
    * Tokenizes name, finds or allocates symbols for each token, and adds them
@@ -451,30 +562,55 @@ private:
   void addTokensToEncoding(absl::string_view name, Encoding& encoding);
 
   Symbol monotonicCounter() {
-    Thread::LockGuard lock(lock_);
+    Thread::LockGuard lock(symbol_lock_);
     return monotonic_counter_;
   }
 
+  // Bitmap implementation.
+  // Both maps point at the same entry, which stores the token once.
+  using EncodeMap = absl::flat_hash_map<absl::string_view, SymbolEntry*>;
+  using DecodeMap = absl::flat_hash_map<Symbol, SymbolEntryPtr>;
+
+  // An encode shard's lock is always acquired before a decode shard's lock or
+  // symbol_lock_. Shards are cache line aligned so that threads using
+  // different shards do not write to the same cache line.
+  struct ABSL_CACHELINE_ALIGNED EncodeShard {
+    mutable absl::Mutex mutex_;
+    EncodeMap encode_map_ ABSL_GUARDED_BY(mutex_);
+    // Lookups made while recent-lookup tracking is disabled, counted in the
+    // shard of the name's first token, whose lock the lookup takes anyway.
+    std::atomic<uint64_t> untracked_lookups_{0};
+  };
+  std::array<EncodeShard, NumEncodeShards> encode_shards_;
+
+  // Decoding only takes a reader lock. The writer lock is only taken to add
+  // and remove symbols.
+  struct ABSL_CACHELINE_ALIGNED DecodeShard {
+    mutable absl::Mutex mutex_;
+    DecodeMap decode_map_ ABSL_GUARDED_BY(mutex_);
+  };
+  std::array<DecodeShard, NumDecodeShards> decode_shards_;
+
+  // Guards the allocation of symbols.
+  mutable Thread::MutexBasicLockable symbol_lock_;
+
   // Stores the symbol to be used at next insertion. This should exist ahead of insertion time so
   // that if insertion succeeds, the value written is the correct one.
-  Symbol next_symbol_ ABSL_GUARDED_BY(lock_);
+  Symbol next_symbol_ ABSL_GUARDED_BY(symbol_lock_);
 
   // If the free pool is exhausted, we monotonically increase this counter.
-  Symbol monotonic_counter_;
-
-  // Bitmap implementation.
-  // The encode map stores both the symbol and the ref count of that symbol.
-  // Using absl::string_view lets us only store the complete string once, in the decode map.
-  using EncodeMap = absl::flat_hash_map<absl::string_view, SharedSymbol>;
-  using DecodeMap = absl::flat_hash_map<Symbol, InlineStringPtr>;
-  EncodeMap encode_map_ ABSL_GUARDED_BY(lock_);
-  DecodeMap decode_map_ ABSL_GUARDED_BY(lock_);
+  Symbol monotonic_counter_ ABSL_GUARDED_BY(symbol_lock_);
 
   // Free pool of symbols for re-use.
   // TODO(ambuc): There might be an optimization here relating to storing ranges of freed symbols
   // using an Envoy::IntervalSet.
-  std::stack<Symbol> pool_ ABSL_GUARDED_BY(lock_);
-  RecentLookups recent_lookups_ ABSL_GUARDED_BY(lock_);
+  std::stack<Symbol> pool_ ABSL_GUARDED_BY(symbol_lock_);
+
+  // Recent lookups are only locked when tracking is enabled; otherwise only the
+  // number of lookups is counted, in the encode shards.
+  mutable Thread::MutexBasicLockable recent_lookups_lock_;
+  RecentLookups recent_lookups_ ABSL_GUARDED_BY(recent_lookups_lock_);
+  std::atomic<uint64_t> recent_lookup_capacity_{0};
 };
 
 // Base class for holding the backing-storing for a StatName. The two derived
@@ -34,7 +34,8 @@ namespace Stats {
 class ThreadLocalHistogramImpl : public HistogramImplHelper {
 public:
   ThreadLocalHistogramImpl(StatName name, Histogram::Unit unit, StatName tag_extracted_name,
-                           const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table);
+                           const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table,
+                           bool lock_free = false);
   ~ThreadLocalHistogramImpl() override;
 
   void merge(histogram_t* target);
@@ -44,6 +45,10 @@ public:
    * not have to lock the histogram in high throughput TLS writes.
    */
   void beginMerge() {
+    if (atomic_histogram_ != nullptr) {
+      // Lock-free histograms are merged while values are being recorded.
+      return;
+    }
     // This switches the current_active_ between 1 and 0.
     ASSERT(std::this_thread::get_id() == created_thread_id_);
     current_active_ = otherHistogramIndex();
@@ -66,7 +71,9 @@ private:
   Histogram::Unit unit_;
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
   uint64_t current_active_{0};
-  histogram_t* histograms_[2];
+  histogram_t* histograms_[2]{};
+  // Set instead of histograms_ when values are recorded lock-free.
+  std::unique_ptr<AtomicLogLinearHistogram> atomic_histogram_;
   std::atomic<bool> used_;
   std::thread::id created_thread_id_;
   SymbolTable& symbol_table_;
@@ -86,10 +86,15 @@ void LoadStatsReporter::sendLoadStatsRequest() {
         uint64_t rq_issued = 0;
         LoadMetricStats::StatMap load_metrics;
         for (const HostSharedPtr& host : hosts) {
-          uint64_t host_rq_success = host->stats().rq_success_.latch();
-          uint64_t host_rq_error = host->stats().rq_error_.latch();
-          uint64_t host_rq_active = host->stats().rq_active_.value();
-          uint64_t host_rq_issued = host->stats().rq_total_.latch();
+          // Hosts that never saw traffic have no stats allocated, and nothing to report.
+          HostStats* host_stats = host->statsIfAllocated();
+          if (host_stats == nullptr) {
+            continue;
+          }
+          uint64_t host_rq_success = host_stats->rq_success_.latch();
+          uint64_t host_rq_error = host_stats->rq_error_.latch();
+          uint64_t host_rq_active = host_stats->rq_active_.value();
+          uint64_t host_rq_issued = host_stats->rq_total_.latch();
           rq_success += host_rq_success;
           rq_error += host_rq_error;
           rq_active += host_rq_active;
@@ -223,9 +228,12 @@ void LoadStatsReporter::startLoadReportPeriod() {
     auto& cluster = it->second.get();
     for (auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
       for (const auto& host : host_set->hosts()) {
-        host->stats().rq_success_.latch();
-        host->stats().rq_error_.latch();
-        host->stats().rq_total_.latch();
+        HostStats* host_stats = host->statsIfAllocated();
+        if (host_stats != nullptr) {
+          host_stats->rq_success_.latch();
+          host_stats->rq_error_.latch();
+          host_stats->rq_total_.latch();
+        }
       }
     }
     cluster.info()->loadReportStats().upstream_rq_dropped_.latch();
@@ -432,9 +432,11 @@ absl::StatusOr<std::unique_ptr<HostDescriptionImpl>> HostDescriptionImpl::create
     const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
     uint32_t priority, TimeSource& time_source, const AddressVector& address_list) {
   absl::Status creation_status = absl::OkStatus();
+  auto host_locality =
+      std::make_shared<const HostLocality>(locality, cluster->statsScope().symbolTable());
   auto ret = std::unique_ptr<HostDescriptionImpl>(new HostDescriptionImpl(
       creation_status, cluster, hostname, dest_address, endpoint_metadata, locality_metadata,
-      locality, health_check_config, priority, time_source, address_list));
+      std::move(host_locality), health_check_config, priority, time_source, address_list));
   RETURN_IF_NOT_OK(creation_status);
   return ret;
 }
@@ -442,11 +444,11 @@ absl::StatusOr<std::unique_ptr<HostDescriptionImpl>> HostDescriptionImpl::create
 HostDescriptionImpl::HostDescriptionImpl(
     absl::Status& creation_status, ClusterInfoConstSharedPtr cluster, const std::string& hostname,
     Network::Address::InstanceConstSharedPtr dest_address, MetadataConstSharedPtr endpoint_metadata,
-    MetadataConstSharedPtr locality_metadata, const envoy::config::core::v3::Locality& locality,
+    MetadataConstSharedPtr locality_metadata, HostLocalityConstSharedPtr locality,
     const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
     uint32_t priority, TimeSource& time_source, const AddressVector& address_list)
     : HostDescriptionImplBase(cluster, hostname, dest_address, endpoint_metadata, locality_metadata,
-                              locality, health_check_config, priority, time_source,
+                              std::move(locality), health_check_config, priority, time_source,
                               creation_status),
       address_(dest_address),
       address_list_or_null_(makeAddressListOrNull(dest_address, address_list)),
@@ -455,7 +457,7 @@ HostDescriptionImpl::HostDescriptionImpl(
 HostDescriptionImplBase::HostDescriptionImplBase(
     ClusterInfoConstSharedPtr cluster, const std::string& hostname,
     Network::Address::InstanceConstSharedPtr dest_address, MetadataConstSharedPtr endpoint_metadata,
-    MetadataConstSharedPtr locality_metadata, const envoy::config::core::v3::Locality& locality,
+    MetadataConstSharedPtr locality_metadata, HostLocalityConstSharedPtr locality,
     const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
     uint32_t priority, TimeSource& time_source, absl::Status& creation_status)
     : cluster_(cluster), hostname_(hostname),
@@ -465,9 +467,7 @@ HostDescriptionImplBase::HostDescriptionImplBase(
                                               Config::MetadataEnvoyLbKeys::get().CANARY)
                   .bool_value()),
       endpoint_metadata_(endpoint_metadata), locality_metadata_(locality_metadata),
-      locality_(locality),
-      locality_zone_stat_name_(locality.zone(), cluster->statsScope().symbolTable()),
-      priority_(priority),
+      locality_(std::move(locality)), priority_(priority),
       socket_factory_(resolveTransportSocketFactory(dest_address, endpoint_metadata_.get())),
       creation_time_(time_source.monotonicTime()) {
   if (health_check_config.port_value() != 0 && dest_address->type() != Network::Address::Type::Ip) {
@@ -476,6 +476,38 @@ HostDescriptionImplBase::HostDescriptionImplBase(
     creation_status = absl::InvalidArgumentError(
         fmt::format("Invalid host configuration: non-zero port for non-IP address"));
   }
+  // Per endpoint stats are flushed for every host, so there is nothing to gain from deferring.
+  if (cluster_->perEndpointStatsEnabled()) {
+    createStats();
+  }
+}
+
+HostStats& HostDescriptionImplBase::zeroStats() { MUTABLE_CONSTRUCT_ON_FIRST_USE(HostStats); }
+
+HostStats& HostDescriptionImplBase::createStats() const {
+  auto stats = std::make_unique<HostStats>();
+  HostStats* existing = nullptr;
+  // Another thread may be creating the stats concurrently, in which case its stats are kept.
+  if (stats_.compare_exchange_strong(existing, stats.get(), std::memory_order_acq_rel)) {
+    return *stats.release();
+  }
+  return *existing;
+}
+
+HostLocalityConstSharedPtr HostLocalityPool::get(const envoy::config::core::v3::Locality& locality,
+                                                 Stats::SymbolTable& symbol_table) {
+  absl::MutexLock lock(&mutex_);
+  std::weak_ptr<const HostLocality>& entry = localities_[locality];
+  if (HostLocalityConstSharedPtr existing = entry.lock(); existing != nullptr) {
+    return existing;
+  }
+  auto host_locality = std::make_shared<const HostLocality>(locality, symbol_table);
+  entry = host_locality;
+  if (localities_.size() >= purge_threshold_) {
+    absl::erase_if(localities_, [](const auto& entry) { return entry.second.expired(); });
+    purge_threshold_ = std::max<size_t>(16, 2 * localities_.size());
+  }
+  return host_locality;
 }
 
 HostDescription::SharedConstAddressVector HostDescriptionImplBase::makeAddressListOrNull(
@@ -662,11 +694,26 @@ absl::StatusOr<std::unique_ptr<HostImpl>> HostImpl::create(
     const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
     uint32_t priority, const envoy::config::core::v3::HealthStatus health_status,
     TimeSource& time_source, const AddressVector& address_list) {
+  auto host_locality =
+      std::make_shared<const HostLocality>(locality, cluster->statsScope().symbolTable());
+  return create(std::move(cluster), hostname, std::move(address), std::move(endpoint_metadata),
+                std::move(locality_metadata), initial_weight, std::move(host_locality),
+                health_check_config, priority, health_status, time_source, address_list);
+}
+
+absl::StatusOr<std::unique_ptr<HostImpl>> HostImpl::create(
+    ClusterInfoConstSharedPtr cluster, const std::string& hostname,
+    Network::Address::InstanceConstSharedPtr address, MetadataConstSharedPtr endpoint_metadata,
+    MetadataConstSharedPtr locality_metadata, uint32_t initial_weight,
+    HostLocalityConstSharedPtr locality,
+    const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
+    uint32_t priority, const envoy::config::core::v3::HealthStatus health_status,
+    TimeSource& time_source, const AddressVector& address_list) {
   absl::Status creation_status = absl::OkStatus();
   auto ret = std::unique_ptr<HostImpl>(
       new HostImpl(creation_status, cluster, hostname, address, endpoint_metadata,
-                   locality_metadata, initial_weight, locality, health_check_config, priority,
-                   health_status, time_source, address_list));
+                   locality_metadata, initial_weight, std::move(locality), health_check_config,
+                   priority, health_status, time_source, address_list));
   RETURN_IF_NOT_OK(creation_status);
   return ret;
 }
@@ -1200,14 +1247,19 @@ ClusterInfoImpl::ClusterInfoImpl(
       endpoint_stats_(
           factory_context.serverFactoryContext().clusterManager().clusterEndpointStatNames(),
           *stats_scope_),
-      load_report_stats_store_(stats_scope_->symbolTable()),
-      load_report_stats_(generateLoadReportStats(
-          *load_report_stats_store_.rootScope(),
-          factory_context.serverFactoryContext().clusterManager().clusterLoadReportStatNames())),
+      load_report_stat_names_(
+          factory_context.serverFactoryContext().clusterManager().clusterLoadReportStatNames()),
       optional_cluster_stats_(
           (config.has_track_cluster_stats() || config.track_timeout_budgets())
               ? std::make_unique<OptionalClusterStats>(
-                    config, *stats_scope_, factory_context.serverFactoryContext().clusterManager())
+                    config,
+                    config.track_cluster_stats().histogram_aggregation_name().empty()
+                        ? stats_scope_
+                        : stats_scope_->store().createScope(fmt::format(
+                              "cluster.{}.",
+                              config.track_cluster_stats().histogram_aggregation_name())),
+                    factory_context.serverFactoryContext().clusterManager(),
+                    server_context.statsConfig().enableDeferredCreationStats())
               : nullptr),
       features_(ClusterInfoImpl::HttpProtocolOptionsConfigImpl::parseFeatures(
           config, *http_protocol_options_)),
@@ -1290,6 +1342,10 @@ ClusterInfoImpl::ClusterInfoImpl(
   }
 #endif
 
+  if (!server_context.statsConfig().enableDeferredCreationStats()) {
+    ClusterInfoImpl::loadReportStats();
+  }
+
   // Both LoadStatsReporter and per_endpoint_stats need to `latch()` the counters, so if both are
   // configured they will interfere with each other and both get incorrect values.
   // TODO(ggreenway): Verify that bypassing virtual dispatch here was intentional
@@ -1958,18 +2014,22 @@ absl::Status ClusterImplBase::validateEndpointsForZoneAwareRouting(
 }
 
 ClusterInfoImpl::OptionalClusterStats::OptionalClusterStats(
-    const envoy::config::cluster::v3::Cluster& config, Stats::Scope& stats_scope,
-    const ClusterManager& manager)
-    : timeout_budget_stats_(
-          (config.track_cluster_stats().timeout_budgets() || config.track_timeout_budgets())
-              ? std::make_unique<ClusterTimeoutBudgetStats>(generateTimeoutBudgetStats(
-                    stats_scope, manager.clusterTimeoutBudgetStatNames()))
-              : nullptr),
-      request_response_size_stats_(
-          (config.track_cluster_stats().request_response_sizes()
-               ? std::make_unique<ClusterRequestResponseSizeStats>(generateRequestResponseSizeStats(
-                     stats_scope, manager.clusterRequestResponseSizeStatNames()))
-               : nullptr)) {}
+    const envoy::config::cluster::v3::Cluster& config, Stats::ScopeSharedPtr stats_scope,
+    const ClusterManager& manager, bool defer_creation) {
+  if (config.track_cluster_stats().timeout_budgets() || config.track_timeout_budgets()) {
+    timeout_budget_stats_.emplace(Stats::createDeferredCompatibleStats<ClusterTimeoutBudgetStats>(
+        stats_scope, manager.clusterTimeoutBudgetStatNames(), defer_creation));
+  }
+  if (config.track_cluster_stats().request_response_sizes()) {
+    request_response_size_stats_.emplace(
+        Stats::createDeferredCompatibleStats<ClusterRequestResponseSizeStats>(
+            stats_scope, manager.clusterRequestResponseSizeStatNames(), defer_creation));
+  }
+}
+
+ClusterInfoImpl::LoadReportStats::LoadReportStats(Stats::SymbolTable& symbol_table,
+                                                  const ClusterLoadReportStatNames& stat_names)
+    : store_(symbol_table), stats_(generateLoadReportStats(*store_.rootScope(), stat_names)) {}
 
 ClusterInfoImpl::ResourceManagers::ResourceManagers(
     const envoy::config::cluster::v3::Cluster& config, Runtime::Loader& runtime,
@@ -2191,9 +2251,11 @@ void PriorityStateManager::registerHostForPriority(
       locality_lb_endpoint.has_metadata()
           ? parent_.constMetadataSharedPool()->getObject(locality_lb_endpoint.metadata())
           : nullptr;
+  auto locality = parent_.hostLocalityPool().get(locality_lb_endpoint.locality(),
+                                                 parent_.info()->statsScope().symbolTable());
   const auto host = std::shared_ptr<HostImpl>(THROW_OR_RETURN_VALUE(
       HostImpl::create(parent_.info(), hostname, address, endpoint_metadata, locality_metadata,
-                       lb_endpoint.load_balancing_weight().value(), locality_lb_endpoint.locality(),
+                       lb_endpoint.load_balancing_weight().value(), std::move(locality),
                        lb_endpoint.endpoint().health_check_config(),
                        locality_lb_endpoint.priority(), lb_endpoint.health_status(), time_source,
                        address_list),
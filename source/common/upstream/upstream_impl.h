@@ -67,6 +67,7 @@
 #include "source/extensions/upstreams/tcp/config.h"
 #include "source/server/transport_socket_config_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_set.h"
 #include "absl/synchronization/mutex.h"
 
@@ -136,6 +137,44 @@ private:
   const absl::optional<MonotonicTime> time_{};
 };
 
+/**
+ * The locality of a host together with its zone stat name. The hosts of a cluster that share a
+ * locality also share one instance of this, see HostLocalityPool.
+ */
+class HostLocality {
+public:
+  HostLocality(const envoy::config::core::v3::Locality& locality, Stats::SymbolTable& symbol_table)
+      : locality_(locality), zone_stat_name_(locality.zone(), symbol_table) {}
+
+  const envoy::config::core::v3::Locality& locality() const { return locality_; }
+  Stats::StatName zoneStatName() const { return zone_stat_name_.statName(); }
+
+private:
+  const envoy::config::core::v3::Locality locality_;
+  Stats::StatNameDynamicStorage zone_stat_name_;
+};
+
+using HostLocalityConstSharedPtr = std::shared_ptr<const HostLocality>;
+
+/**
+ * Interns the localities of the hosts of a cluster. Unlike the metadata pool, this may be used from
+ * any thread, as hosts can be constructed off the main thread. Entries only hold weak references,
+ * a locality is released when the last host referencing it is destroyed.
+ */
+class HostLocalityPool {
+public:
+  HostLocalityConstSharedPtr get(const envoy::config::core::v3::Locality& locality,
+                                 Stats::SymbolTable& symbol_table);
+
+private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<envoy::config::core::v3::Locality, std::weak_ptr<const HostLocality>,
+                      LocalityHash, LocalityEqualTo>
+      localities_ ABSL_GUARDED_BY(mutex_);
+  // Expired entries are purged once the pool grows past this size.
+  size_t purge_threshold_ ABSL_GUARDED_BY(mutex_){16};
+};
+
 /**
  * Base implementation of most of Upstream::HostDescription, shared between
  * HostDescriptionImpl and LogicalHost, which is in
@@ -209,15 +248,22 @@ public:
     static DetectorHostMonitorNullImpl* null_outlier_detector = new DetectorHostMonitorNullImpl();
     return *null_outlier_detector;
   }
-  HostStats& stats() const override { return stats_; }
+  HostStats& stats() const override {
+    HostStats* stats = stats_.load(std::memory_order_acquire);
+    return stats != nullptr ? *stats : createStats();
+  }
+  HostStats* statsIfAllocated() const override { return stats_.load(std::memory_order_acquire); }
+  // Stats that are all zero, which read only paths report for hosts whose stats have not been
+  // allocated yet. They are shared by all such hosts, so they must never be written to.
+  static HostStats& zeroStats();
   LoadMetricStats& loadMetricStats() const override { return load_metric_stats_; }
   const std::string& hostnameForHealthChecks() const override { return health_checks_hostname_; }
   const std::string& hostname() const override { return hostname_; }
-  const envoy::config::core::v3::Locality& locality() const override { return locality_; }
-  const MetadataConstSharedPtr localityMetadata() const override { return locality_metadata_; }
-  Stats::StatName localityZoneStatName() const override {
-    return locality_zone_stat_name_.statName();
+  const envoy::config::core::v3::Locality& locality() const override {
+    return locality_->locality();
   }
+  const MetadataConstSharedPtr localityMetadata() const override { return locality_metadata_; }
+  Stats::StatName localityZoneStatName() const override { return locality_->zoneStatName(); }
   uint32_t priority() const override { return priority_; }
   void priority(uint32_t priority) override { priority_ = priority; }
   Network::UpstreamTransportSocketFactory&
@@ -244,12 +290,14 @@ public:
     return makeOptRefFromPtr(lb_policy_data_.get());
   }
 
+  ~HostDescriptionImplBase() override { delete stats_.load(); }
+
 protected:
   HostDescriptionImplBase(
       ClusterInfoConstSharedPtr cluster, const std::string& hostname,
       Network::Address::InstanceConstSharedPtr dest_address,
       MetadataConstSharedPtr endpoint_metadata, MetadataConstSharedPtr locality_metadata,
-      const envoy::config::core::v3::Locality& locality,
+      HostLocalityConstSharedPtr locality,
       const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
       uint32_t priority, TimeSource& time_source, absl::Status& creation_status);
 
@@ -261,6 +309,8 @@ protected:
                         const AddressVector& address_list);
 
 private:
+  HostStats& createStats() const;
+
   ClusterInfoConstSharedPtr cluster_;
   const std::string hostname_;
   const std::string health_checks_hostname_;
@@ -268,9 +318,10 @@ private:
   mutable absl::Mutex metadata_mutex_;
   MetadataConstSharedPtr endpoint_metadata_ ABSL_GUARDED_BY(metadata_mutex_);
   const MetadataConstSharedPtr locality_metadata_;
-  const envoy::config::core::v3::Locality locality_;
-  Stats::StatNameDynamicStorage locality_zone_stat_name_;
-  mutable HostStats stats_;
+  const HostLocalityConstSharedPtr locality_;
+  // Allocated on first use unless per endpoint stats are enabled. Most hosts of large clusters
+  // never see any traffic from a given Envoy, and so never need their stats.
+  mutable std::atomic<HostStats*> stats_{};
   mutable LoadMetricStatsImpl load_metric_stats_;
   Outlier::DetectorHostMonitorPtr outlier_detector_;
   HealthCheckHostMonitorPtr health_checker_;
@@ -312,7 +363,7 @@ protected:
       absl::Status& creation_status, ClusterInfoConstSharedPtr cluster, const std::string& hostname,
       Network::Address::InstanceConstSharedPtr dest_address,
       MetadataConstSharedPtr endpoint_metadata, MetadataConstSharedPtr locality_metadata,
-      const envoy::config::core::v3::Locality& locality,
+      HostLocalityConstSharedPtr locality,
       const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
       uint32_t priority, TimeSource& time_source, const AddressVector& address_list = {});
 
@@ -351,7 +402,9 @@ public:
   // Upstream::Host
   std::vector<std::pair<absl::string_view, Stats::PrimitiveCounterReference>>
   counters() const override {
-    return stats().counters();
+    HostStats* stats = statsIfAllocated();
+    return stats != nullptr ? stats->counters()
+                            : HostDescriptionImplBase::zeroStats().counters();
   }
   CreateConnectionData createConnection(
       Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
@@ -363,7 +416,8 @@ public:
 
   std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>>
   gauges() const override {
-    return stats().gauges();
+    HostStats* stats = statsIfAllocated();
+    return stats != nullptr ? stats->gauges() : HostDescriptionImplBase::zeroStats().gauges();
   }
   void healthFlagClear(HealthFlag flag) override { health_flags_ &= ~enumToInt(flag); }
   bool healthFlagGet(HealthFlag flag) const override { return health_flags_ & enumToInt(flag); }
@@ -484,18 +538,30 @@ public:
          uint32_t priority, const envoy::config::core::v3::HealthStatus health_status,
          TimeSource& time_source, const AddressVector& address_list = {});
 
+  /**
+   * Same as above, but shares an interned locality, see HostLocalityPool.
+   */
+  static absl::StatusOr<std::unique_ptr<HostImpl>>
+  create(ClusterInfoConstSharedPtr cluster, const std::string& hostname,
+         Network::Address::InstanceConstSharedPtr address, MetadataConstSharedPtr endpoint_metadata,
+         MetadataConstSharedPtr locality_metadata, uint32_t initial_weight,
+         HostLocalityConstSharedPtr locality,
+         const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
+         uint32_t priority, const envoy::config::core::v3::HealthStatus health_status,
+         TimeSource& time_source, const AddressVector& address_list = {});
+
 protected:
   HostImpl(absl::Status& creation_status, ClusterInfoConstSharedPtr cluster,
            const std::string& hostname, Network::Address::InstanceConstSharedPtr address,
            MetadataConstSharedPtr endpoint_metadata, MetadataConstSharedPtr locality_metadata,
-           uint32_t initial_weight, const envoy::config::core::v3::Locality& locality,
+           uint32_t initial_weight, HostLocalityConstSharedPtr locality,
            const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
            uint32_t priority, const envoy::config::core::v3::HealthStatus health_status,
            TimeSource& time_source, const AddressVector& address_list = {})
       : HostImplBase(initial_weight, health_check_config, health_status),
         HostDescriptionImpl(creation_status, cluster, hostname, address, endpoint_metadata,
-                            locality_metadata, locality, health_check_config, priority, time_source,
-                            address_list) {}
+                            locality_metadata, std::move(locality), health_check_config, priority,
+                            time_source, address_list) {}
 };
 
 class HostsPerLocalityImpl : public HostsPerLocality {
@@ -956,22 +1022,28 @@ public:
 
   ClusterRequestResponseSizeStatsOptRef requestResponseSizeStats() const override {
     if (optional_cluster_stats_ == nullptr ||
-        optional_cluster_stats_->request_response_size_stats_ == nullptr) {
+        !optional_cluster_stats_->request_response_size_stats_.has_value()) {
       return absl::nullopt;
     }
 
-    return std::ref(*(optional_cluster_stats_->request_response_size_stats_));
+    return std::ref(**optional_cluster_stats_->request_response_size_stats_);
   }
 
-  ClusterLoadReportStats& loadReportStats() const override { return load_report_stats_; }
+  ClusterLoadReportStats& loadReportStats() const override {
+    return load_report_stats_
+        .get([this]() {
+          return new LoadReportStats(stats_scope_->symbolTable(), load_report_stat_names_);
+        })
+        ->stats_;
+  }
 
   ClusterTimeoutBudgetStatsOptRef timeoutBudgetStats() const override {
     if (optional_cluster_stats_ == nullptr ||
-        optional_cluster_stats_->timeout_budget_stats_ == nullptr) {
+        !optional_cluster_stats_->timeout_budget_stats_.has_value()) {
       return absl::nullopt;
     }
 
-    return std::ref(*(optional_cluster_stats_->timeout_budget_stats_));
+    return std::ref(**optional_cluster_stats_->timeout_budget_stats_);
   }
 
   bool perEndpointStatsEnabled() const override { return per_endpoint_stats_; }
@@ -1091,11 +1163,27 @@ private:
     const ClusterCircuitBreakersStatNames& circuit_breakers_stat_names_;
   };
 
+  // The optional histograms are created on first use when deferred stats creation is enabled. They
+  // are created in stats_scope, which may be shared with other clusters, see
+  // TrackClusterStats.histogram_aggregation_name.
   struct OptionalClusterStats {
     OptionalClusterStats(const envoy::config::cluster::v3::Cluster& config,
-                         Stats::Scope& stats_scope, const ClusterManager& manager);
-    const ClusterTimeoutBudgetStatsPtr timeout_budget_stats_;
-    const ClusterRequestResponseSizeStatsPtr request_response_size_stats_;
+                         Stats::ScopeSharedPtr stats_scope, const ClusterManager& manager,
+                         bool defer_creation);
+    absl::optional<Stats::DeferredCreationCompatibleStats<ClusterTimeoutBudgetStats>>
+        timeout_budget_stats_;
+    absl::optional<Stats::DeferredCreationCompatibleStats<ClusterRequestResponseSizeStats>>
+        request_response_size_stats_;
+  };
+
+  // Load report stats are kept out of the server stats store, as they are latched and reset by the
+  // load stats reporter. Most clusters never report load, so the isolated store holding them is
+  // only created on first use when deferred stats creation is enabled.
+  struct LoadReportStats {
+    LoadReportStats(Stats::SymbolTable& symbol_table, const ClusterLoadReportStatNames& stat_names);
+
+    Stats::IsolatedStoreImpl store_;
+    ClusterLoadReportStats stats_;
   };
 
 #ifdef ENVOY_ENABLE_UHV
@@ -1121,8 +1209,9 @@ private:
   mutable ClusterConfigUpdateStats config_update_stats_;
   mutable ClusterLbStats lb_stats_;
   mutable ClusterEndpointStats endpoint_stats_;
-  Stats::IsolatedStoreImpl load_report_stats_store_;
-  mutable ClusterLoadReportStats load_report_stats_;
+  const ClusterLoadReportStatNames& load_report_stat_names_;
+  mutable Thread::AtomicPtr<LoadReportStats, Thread::AtomicPtrAllocMode::DeleteOnDestruct>
+      load_report_stats_;
   const std::unique_ptr<OptionalClusterStats> optional_cluster_stats_;
   const uint64_t features_;
   mutable ResourceManagers resource_managers_;
@@ -1225,6 +1314,7 @@ public:
   Config::ConstMetadataSharedPoolSharedPtr constMetadataSharedPool() {
     return const_metadata_shared_pool_;
   }
+  HostLocalityPool& hostLocalityPool() { return host_locality_pool_; }
 
   // Upstream::Cluster
   HealthChecker* healthChecker() override { return health_checker_.get(); }
@@ -1304,6 +1394,7 @@ private:
   uint64_t pending_initialize_health_checks_{};
   const bool local_cluster_;
   Config::ConstMetadataSharedPoolSharedPtr const_metadata_shared_pool_;
+  HostLocalityPool host_locality_pool_;
   Common::CallbackHandlePtr priority_update_cb_;
   UnitFloat drop_overload_{0};
   std::string drop_category_;
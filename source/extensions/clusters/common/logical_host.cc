@@ -33,7 +33,9 @@ LogicalHost::LogicalHost(
           std::make_shared<const envoy::config::core::v3::Metadata>(lb_endpoint.metadata()),
           std::make_shared<const envoy::config::core::v3::Metadata>(
               locality_lb_endpoint.metadata()),
-          locality_lb_endpoint.locality(), lb_endpoint.endpoint().health_check_config(),
+          std::make_shared<const HostLocality>(locality_lb_endpoint.locality(),
+                                               cluster->statsScope().symbolTable()),
+          lb_endpoint.endpoint().health_check_config(),
           locality_lb_endpoint.priority(), time_source, creation_status),
       override_transport_socket_options_(override_transport_socket_options), address_(address),
       address_list_or_null_(makeAddressListOrNull(address, address_list)) {
@@ -1,5 +1,7 @@
 #include "source/extensions/clusters/eds/eds.h"
 
+#include <algorithm>
+
 #include "envoy/common/exception.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/config/core/v3/config_source.pb.h"
@@ -10,9 +12,23 @@
 #include "source/common/config/api_version.h"
 #include "source/common/config/decoded_resource_impl.h"
 #include "source/common/grpc/common.h"
+#include "source/common/network/resolver_impl.h"
 
 namespace Envoy {
 namespace Upstream {
+namespace {
+
+// Splitting host construction across threads only pays off for large updates, so each thread is
+// given at least this many endpoints.
+constexpr uint64_t MinEndpointsPerHostConstructionThread = 1024;
+
+// Whether the address can be resolved off the main thread. Only the built-in IP resolver is known
+// to be thread safe and to never throw.
+bool resolvableOffMainThread(const envoy::config::core::v3::Address& address) {
+  return address.has_socket_address() && address.socket_address().resolver_name().empty();
+}
+
+} // namespace
 
 absl::StatusOr<std::unique_ptr<EdsClusterImpl>>
 EdsClusterImpl::create(const envoy::config::cluster::v3::Cluster& cluster,
@@ -31,11 +47,16 @@ EdsClusterImpl::EdsClusterImpl(const envoy::config::cluster::v3::Cluster& cluste
       Envoy::Config::SubscriptionBase<envoy::config::endpoint::v3::ClusterLoadAssignment>(
           cluster_context.messageValidationVisitor(), "cluster_name"),
       local_info_(cluster_context.serverFactoryContext().localInfo()),
+      host_construction_concurrency_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          cluster.eds_cluster_config(), host_construction_concurrency, 1)),
       eds_resources_cache_(
           Runtime::runtimeFeatureEnabled("envoy.restart_features.use_eds_cache_for_ads")
               ? cluster_context.clusterManager().edsResourcesCache()
               : absl::nullopt) {
   RETURN_ONLY_IF_NOT_OK_REF(creation_status);
+  if (host_construction_concurrency_ > 1) {
+    thread_factory_ = &cluster_context.serverFactoryContext().api().threadFactory();
+  }
   Event::Dispatcher& dispatcher = cluster_context.serverFactoryContext().mainThreadDispatcher();
   assignment_timeout_ = dispatcher.createTimer([this]() -> void { onAssignmentTimeout(); });
   const auto& eds_config = cluster.eds_cluster_config().eds_config();
@@ -66,6 +87,11 @@ void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& h
   absl::flat_hash_set<std::string> all_new_hosts;
   PriorityStateManager priority_state_manager(parent_, parent_.local_info_, &host_update_cb,
                                               parent_.random_);
+  // Large updates collect their endpoints first so that the hosts can be constructed in parallel.
+  const bool construct_in_parallel =
+      parent_.host_construction_concurrency_ > 1 &&
+      endpointCount() >= 2 * MinEndpointsPerHostConstructionThread;
+  std::vector<PendingHost> pending_hosts;
   for (const auto& locality_lb_endpoint : cluster_load_assignment_.endpoints()) {
     THROW_IF_NOT_OK(parent_.validateEndpointsForZoneAwareRouting(locality_lb_endpoint));
 
@@ -82,16 +108,29 @@ void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& h
              parent_.leds_localities_[leds_config]->isUpdated());
       for (const auto& [_, lb_endpoint] :
            parent_.leds_localities_[leds_config]->getEndpointsMap()) {
+        if (construct_in_parallel) {
+          pending_hosts.push_back(
+              {&lb_endpoint, &locality_lb_endpoint, nullptr, nullptr, nullptr, nullptr});
+          continue;
+        }
         updateLocalityEndpoints(lb_endpoint, locality_lb_endpoint, priority_state_manager,
                                 all_new_hosts);
       }
     } else {
       for (const auto& lb_endpoint : locality_lb_endpoint.lb_endpoints()) {
+        if (construct_in_parallel) {
+          pending_hosts.push_back(
+              {&lb_endpoint, &locality_lb_endpoint, nullptr, nullptr, nullptr, nullptr});
+          continue;
+        }
         updateLocalityEndpoints(lb_endpoint, locality_lb_endpoint, priority_state_manager,
                                 all_new_hosts);
       }
     }
   }
+  if (!pending_hosts.empty()) {
+    constructAndRegisterHosts(pending_hosts, priority_state_manager, all_new_hosts);
+  }
 
   // Track whether we rebuilt any LB structures.
   bool cluster_rebuilt = false;
@@ -150,6 +189,128 @@ void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& h
   parent_.onPreInitComplete();
 }
 
+uint64_t EdsClusterImpl::BatchUpdateHelper::endpointCount() const {
+  uint64_t count = 0;
+  for (const auto& locality_lb_endpoint : cluster_load_assignment_.endpoints()) {
+    if (locality_lb_endpoint.has_leds_cluster_locality_config()) {
+      const auto it =
+          parent_.leds_localities_.find(locality_lb_endpoint.leds_cluster_locality_config());
+      if (it != parent_.leds_localities_.end()) {
+        count += it->second->getEndpointsMap().size();
+      }
+    } else {
+      count += locality_lb_endpoint.lb_endpoints_size();
+    }
+  }
+  return count;
+}
+
+void EdsClusterImpl::BatchUpdateHelper::constructAndRegisterHosts(
+    std::vector<PendingHost>& pending_hosts, PriorityStateManager& priority_state_manager,
+    absl::flat_hash_set<std::string>& all_new_hosts) {
+  // The shared metadata pool is not thread safe, so intern the metadata up front. Localities are
+  // interned here too, once per locality rather than once per host.
+  const auto& metadata_pool = parent_.constMetadataSharedPool();
+  const envoy::config::endpoint::v3::LocalityLbEndpoints* last_locality = nullptr;
+  MetadataConstSharedPtr locality_metadata;
+  HostLocalityConstSharedPtr locality;
+  for (PendingHost& pending : pending_hosts) {
+    if (pending.locality_lb_endpoint_ != last_locality) {
+      last_locality = pending.locality_lb_endpoint_;
+      locality_metadata = last_locality->has_metadata()
+                              ? metadata_pool->getObject(last_locality->metadata())
+                              : nullptr;
+      locality = parent_.hostLocalityPool().get(last_locality->locality(),
+                                                parent_.info()->statsScope().symbolTable());
+    }
+    pending.locality_metadata_ = locality_metadata;
+    pending.locality_ = locality;
+    if (pending.lb_endpoint_->has_metadata()) {
+      pending.endpoint_metadata_ = metadata_pool->getObject(pending.lb_endpoint_->metadata());
+    }
+  }
+
+  // The main thread constructs the first chunk itself while the other threads construct the rest.
+  const uint64_t num_threads =
+      std::clamp<uint64_t>(pending_hosts.size() / MinEndpointsPerHostConstructionThread, 1,
+                           parent_.host_construction_concurrency_);
+  const size_t chunk_size = (pending_hosts.size() + num_threads - 1) / num_threads;
+  std::vector<Thread::ThreadPtr> threads;
+  threads.reserve(num_threads - 1);
+  for (uint64_t i = 1; i < num_threads; ++i) {
+    const size_t begin = i * chunk_size;
+    const size_t end = std::min(begin + chunk_size, pending_hosts.size());
+    threads.push_back(parent_.thread_factory_->createThread(
+        [this, &pending_hosts, begin, end]() { constructHosts(pending_hosts, begin, end); },
+        Thread::Options{"eds_hosts"}));
+  }
+  constructHosts(pending_hosts, 0, std::min(chunk_size, pending_hosts.size()));
+  for (auto& thread : threads) {
+    thread->join();
+  }
+
+  // Register the hosts in the order of the update, so that duplicates are resolved exactly as if
+  // the hosts had been constructed one by one.
+  for (const PendingHost& pending : pending_hosts) {
+    if (pending.host_ == nullptr) {
+      // Construct the host on the main thread, which also reports any error.
+      updateLocalityEndpoints(*pending.lb_endpoint_, *pending.locality_lb_endpoint_,
+                              priority_state_manager, all_new_hosts);
+      continue;
+    }
+    auto address_as_string = pending.host_->address()->asString();
+    if (all_new_hosts.contains(address_as_string)) {
+      continue;
+    }
+    priority_state_manager.registerHostForPriority(pending.host_, *pending.locality_lb_endpoint_);
+    all_new_hosts.emplace(std::move(address_as_string));
+  }
+}
+
+void EdsClusterImpl::BatchUpdateHelper::constructHosts(std::vector<PendingHost>& pending_hosts,
+                                                       size_t begin, size_t end) const {
+  for (size_t i = begin; i < end; ++i) {
+    PendingHost& pending = pending_hosts[i];
+    const auto& endpoint = pending.lb_endpoint_->endpoint();
+    if (!resolvableOffMainThread(endpoint.address())) {
+      continue;
+    }
+    auto address_or_error = Network::Address::resolveProtoAddress(endpoint.address());
+    if (!address_or_error.ok()) {
+      continue;
+    }
+    const Network::Address::InstanceConstSharedPtr address = std::move(address_or_error.value());
+    std::vector<Network::Address::InstanceConstSharedPtr> address_list;
+    if (!endpoint.additional_addresses().empty()) {
+      address_list.push_back(address);
+      for (const auto& additional_address : endpoint.additional_addresses()) {
+        if (!resolvableOffMainThread(additional_address.address())) {
+          break;
+        }
+        auto additional_or_error =
+            Network::Address::resolveProtoAddress(additional_address.address());
+        if (!additional_or_error.ok() || additional_or_error.value()->ip() == nullptr) {
+          break;
+        }
+        address_list.push_back(std::move(additional_or_error.value()));
+      }
+      if (address_list.size() != static_cast<size_t>(endpoint.additional_addresses_size()) + 1) {
+        continue;
+      }
+    }
+
+    auto host_or_error = HostImpl::create(
+        parent_.info(), endpoint.hostname(), address, pending.endpoint_metadata_,
+        pending.locality_metadata_, pending.lb_endpoint_->load_balancing_weight().value(),
+        pending.locality_, endpoint.health_check_config(),
+        pending.locality_lb_endpoint_->priority(), pending.lb_endpoint_->health_status(),
+        parent_.time_source_, address_list);
+    if (host_or_error.ok()) {
+      pending.host_ = std::move(host_or_error.value());
+    }
+  }
+}
+
 void EdsClusterImpl::BatchUpdateHelper::updateLocalityEndpoints(
     const envoy::config::endpoint::v3::LbEndpoint& lb_endpoint,
     const envoy::config::endpoint::v3::LocalityLbEndpoints& locality_lb_endpoint,
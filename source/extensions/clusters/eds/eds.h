@@ -15,6 +15,7 @@
 #include "envoy/secret/secret_manager.h"
 #include "envoy/service/discovery/v3/discovery.pb.h"
 #include "envoy/stats/scope.h"
+#include "envoy/thread/thread.h"
 #include "envoy/upstream/locality.h"
 
 #include "source/common/config/subscription_base.h"
@@ -94,6 +95,22 @@ private:
     void batchUpdate(PrioritySet::HostUpdateCb& host_update_cb) override;
 
   private:
+    // An endpoint whose host is constructed by the parallel host construction stage.
+    struct PendingHost {
+      const envoy::config::endpoint::v3::LbEndpoint* lb_endpoint_;
+      const envoy::config::endpoint::v3::LocalityLbEndpoints* locality_lb_endpoint_;
+      MetadataConstSharedPtr endpoint_metadata_;
+      MetadataConstSharedPtr locality_metadata_;
+      HostLocalityConstSharedPtr locality_;
+      // Left null if the host could not be constructed off the main thread.
+      HostSharedPtr host_;
+    };
+
+    uint64_t endpointCount() const;
+    void constructAndRegisterHosts(std::vector<PendingHost>& pending_hosts,
+                                   PriorityStateManager& priority_state_manager,
+                                   absl::flat_hash_set<std::string>& all_new_hosts);
+    void constructHosts(std::vector<PendingHost>& pending_hosts, size_t begin, size_t end) const;
     void updateLocalityEndpoints(
         const envoy::config::endpoint::v3::LbEndpoint& lb_endpoint,
         const envoy::config::endpoint::v3::LocalityLbEndpoints& locality_lb_endpoint,
@@ -106,6 +123,9 @@ private:
 
   Config::SubscriptionPtr subscription_;
   const LocalInfo::LocalInfo& local_info_;
+  // Only set when hosts may be constructed on more than one thread.
+  Thread::ThreadFactory* thread_factory_{};
+  const uint32_t host_construction_concurrency_;
   std::vector<LocalityWeightsMap> locality_weights_map_;
   Event::TimerPtr assignment_timeout_;
   InitializePhase initialize_phase_;
@@ -166,7 +166,8 @@ private:
               std::make_shared<envoy::config::core::v3::Metadata>(
                   parent.localityLbEndpoint().metadata()),
               parent.lbEndpoint().load_balancing_weight().value(),
-              parent.localityLbEndpoint().locality(),
+              std::make_shared<const Upstream::HostLocality>(
+                  parent.localityLbEndpoint().locality(), cluster->statsScope().symbolTable()),
               parent.lbEndpoint().endpoint().health_check_config(),
               parent.localityLbEndpoint().priority(), parent.lbEndpoint().health_status(),
               time_source),
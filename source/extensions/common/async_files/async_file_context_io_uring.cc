@@ -0,0 +1,431 @@
+#include "source/extensions/common/async_files/async_file_context_io_uring.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/common/async_files/async_file_action.h"
+#include "source/extensions/common/async_files/async_file_context_base.h"
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+#include "source/extensions/common/async_files/file_range_fragment.h"
+#include "source/extensions/common/async_files/status_after_file_error.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+namespace {
+
+template <typename T> class AsyncFileActionIoUring : public AsyncFileActionWithResult<T> {
+public:
+  explicit AsyncFileActionIoUring(AsyncFileHandle handle, absl::AnyInvocable<void(T)> on_complete)
+      : AsyncFileActionWithResult<T>(std::move(on_complete)), handle_(std::move(handle)) {}
+
+protected:
+  int& fileDescriptor() { return context()->fileDescriptor(); }
+  AsyncFileContextIoUring* context() const {
+    return static_cast<AsyncFileContextIoUring*>(handle_.get());
+  }
+
+  Api::OsSysCalls& posix() const {
+    return static_cast<AsyncFileManagerIoUring&>(context()->manager()).posix();
+  }
+
+  AsyncFileHandle handle_;
+};
+
+// The result of an operation that returns nothing but success or failure.
+absl::Status statusFromResult(int32_t result) {
+  return result < 0 ? statusAfterFileError(-result) : absl::OkStatus();
+}
+
+class ActionStat : public AsyncFileActionIoUring<absl::StatusOr<struct stat>>,
+                   public IoUringOperation {
+public:
+  ActionStat(AsyncFileHandle handle,
+             absl::AnyInvocable<void(absl::StatusOr<struct stat>)> on_complete)
+      : AsyncFileActionIoUring<absl::StatusOr<struct stat>>(handle, std::move(on_complete)) {}
+
+  uint8_t opcode() const override { return IORING_OP_STATX; }
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    ASSERT(fileDescriptor() != -1);
+    io_uring_prep_statx(sqe, fileDescriptor(), "", AT_EMPTY_PATH, STATX_BASIC_STATS, &statx_);
+  }
+
+  bool onCompletion(int32_t result) override {
+    if (result < 0) {
+      result_ = statusAfterFileError(-result);
+    } else {
+      result_ = statxToStat(statx_);
+    }
+    return false;
+  }
+
+  absl::StatusOr<struct stat> executeImpl() override {
+    ASSERT(fileDescriptor() != -1);
+    struct stat stat_result;
+    auto result = posix().fstat(fileDescriptor(), &stat_result);
+    if (result.return_value_ != 0) {
+      return statusAfterFileError(result);
+    }
+    return stat_result;
+  }
+
+private:
+  struct statx statx_ {};
+};
+
+class ActionCreateHardLink : public AsyncFileActionIoUring<absl::Status>, public IoUringOperation {
+public:
+  ActionCreateHardLink(AsyncFileHandle handle, absl::string_view filename,
+                       absl::AnyInvocable<void(absl::Status)> on_complete)
+      : AsyncFileActionIoUring<absl::Status>(handle, std::move(on_complete)), filename_(filename),
+        procfile_(absl::StrCat("/proc/self/fd/", fileDescriptor())) {}
+
+  uint8_t opcode() const override { return IORING_OP_LINKAT; }
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    io_uring_prep_linkat(sqe, AT_FDCWD, procfile_.c_str(), AT_FDCWD, filename_.c_str(),
+                         AT_SYMLINK_FOLLOW);
+  }
+
+  bool onCompletion(int32_t result) override {
+    result_ = statusFromResult(result);
+    return false;
+  }
+
+  absl::Status executeImpl() override {
+    ASSERT(fileDescriptor() != -1);
+    auto result = posix().linkat(fileDescriptor(), procfile_.c_str(), AT_FDCWD, filename_.c_str(),
+                                 AT_SYMLINK_FOLLOW);
+    if (result.return_value_ == -1) {
+      return statusAfterFileError(result);
+    }
+    return absl::OkStatus();
+  }
+
+  void onCancelledBeforeCallback() override {
+    if (result_.value().ok()) {
+      posix().unlink(filename_.c_str());
+    }
+  }
+  bool hasActionIfCancelledBeforeCallback() const override { return true; }
+
+private:
+  const std::string filename_;
+  const std::string procfile_;
+};
+
+class ActionCloseFile : public AsyncFileActionIoUring<absl::Status>, public IoUringOperation {
+public:
+  // As in the thread pool implementation, take a copy of the file descriptor, because close sets
+  // the AsyncFileContext's file descriptor to -1.
+  explicit ActionCloseFile(AsyncFileHandle handle,
+                           absl::AnyInvocable<void(absl::Status)> on_complete)
+      : AsyncFileActionIoUring<absl::Status>(handle, std::move(on_complete)),
+        file_descriptor_(fileDescriptor()) {}
+
+  uint8_t opcode() const override { return IORING_OP_CLOSE; }
+
+  void prepare(struct io_uring_sqe* sqe) override { io_uring_prep_close(sqe, file_descriptor_); }
+
+  bool onCompletion(int32_t result) override {
+    result_ = statusFromResult(result);
+    return false;
+  }
+
+  absl::Status executeImpl() override {
+    auto result = posix().close(file_descriptor_);
+    if (result.return_value_ == -1) {
+      return statusAfterFileError(result);
+    }
+    return absl::OkStatus();
+  }
+
+  bool executesEvenIfCancelled() const override { return true; }
+
+private:
+  const int file_descriptor_;
+};
+
+class ActionReadFile : public AsyncFileActionIoUring<absl::StatusOr<Buffer::InstancePtr>>,
+                       public IoUringOperation {
+public:
+  ActionReadFile(AsyncFileHandle handle, off_t offset, size_t length,
+                 absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete)
+      : AsyncFileActionIoUring<absl::StatusOr<Buffer::InstancePtr>>(handle,
+                                                                    std::move(on_complete)),
+        offset_(offset), length_(length) {}
+
+  uint8_t opcode() const override { return IORING_OP_READ; }
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    ASSERT(fileDescriptor() != -1);
+    // The kernel reads straight into the buffer that is handed to the callback.
+    reservation_.emplace(buffer_->reserveSingleSlice(length_));
+    io_uring_prep_read(sqe, fileDescriptor(), reservation_->slice().mem_, length_, offset_);
+  }
+
+  bool onCompletion(int32_t result) override {
+    if (result < 0) {
+      result_ = statusAfterFileError(-result);
+      return false;
+    }
+    result_ = commit(result);
+    return false;
+  }
+
+  absl::StatusOr<Buffer::InstancePtr> executeImpl() override {
+    ASSERT(fileDescriptor() != -1);
+    reservation_.emplace(buffer_->reserveSingleSlice(length_));
+    auto bytes_read =
+        posix().pread(fileDescriptor(), reservation_->slice().mem_, length_, offset_);
+    if (bytes_read.return_value_ == -1) {
+      return statusAfterFileError(bytes_read);
+    }
+    return commit(bytes_read.return_value_);
+  }
+
+private:
+  Buffer::InstancePtr commit(size_t bytes_read) {
+    if (bytes_read != length_) {
+      // Don't hold on to a mostly empty reservation.
+      return std::make_unique<Buffer::OwnedImpl>(reservation_->slice().mem_, bytes_read);
+    }
+    reservation_->commit(bytes_read);
+    return std::move(buffer_);
+  }
+
+  const off_t offset_;
+  const size_t length_;
+  Buffer::InstancePtr buffer_ = std::make_unique<Buffer::OwnedImpl>();
+  absl::optional<Buffer::ReservationSingleSlice> reservation_;
+};
+
+// Mapping the range reads all of it into the page cache, which blocks on disk I/O, so like the
+// other file operations it is kept off the caller's thread.
+class ActionReadFileBacked : public AsyncFileActionIoUring<absl::StatusOr<Buffer::InstancePtr>> {
+public:
+  ActionReadFileBacked(AsyncFileHandle handle, off_t offset, size_t length,
+                       absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete)
+      : AsyncFileActionIoUring<absl::StatusOr<Buffer::InstancePtr>>(handle,
+                                                                    std::move(on_complete)),
+        offset_(offset), length_(length) {}
+
+  absl::StatusOr<Buffer::InstancePtr> executeImpl() override {
+    ASSERT(fileDescriptor() != -1);
+    return readFileRange(posix(), fileDescriptor(), offset_, length_);
+  }
+
+private:
+  const off_t offset_;
+  const size_t length_;
+};
+
+class ActionWriteFile : public AsyncFileActionIoUring<absl::StatusOr<size_t>>,
+                        public IoUringOperation {
+public:
+  ActionWriteFile(AsyncFileHandle handle, Buffer::Instance& contents, off_t offset,
+                  absl::AnyInvocable<void(absl::StatusOr<size_t>)> on_complete)
+      : AsyncFileActionIoUring<absl::StatusOr<size_t>>(handle, std::move(on_complete)),
+        offset_(offset) {
+    contents_.move(contents);
+  }
+
+  uint8_t opcode() const override { return IORING_OP_WRITEV; }
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    ASSERT(fileDescriptor() != -1);
+    // Writes every slice with one operation; whatever a short write leaves is submitted again.
+    iovecs_.clear();
+    for (const Buffer::RawSlice& slice : contents_.getRawSlices(IOV_MAX)) {
+      iovecs_.push_back({slice.mem_, slice.len_});
+    }
+    io_uring_prep_writev(sqe, fileDescriptor(), iovecs_.data(), iovecs_.size(),
+                         offset_ + total_bytes_written_);
+  }
+
+  bool onCompletion(int32_t result) override {
+    if (result < 0) {
+      result_ = statusAfterFileError(-result);
+      return false;
+    }
+    contents_.drain(result);
+    total_bytes_written_ += result;
+    if (result > 0 && contents_.length() > 0) {
+      return true;
+    }
+    result_ = total_bytes_written_;
+    return false;
+  }
+
+  absl::StatusOr<size_t> executeImpl() override {
+    ASSERT(fileDescriptor() != -1);
+    auto slices = contents_.getRawSlices();
+    for (const auto& slice : slices) {
+      size_t slice_bytes_written = 0;
+      while (slice_bytes_written < slice.len_) {
+        auto bytes_just_written =
+            posix().pwrite(fileDescriptor(), static_cast<char*>(slice.mem_) + slice_bytes_written,
+                           slice.len_ - slice_bytes_written, offset_ + total_bytes_written_);
+        if (bytes_just_written.return_value_ == -1) {
+          return statusAfterFileError(bytes_just_written);
+        }
+        slice_bytes_written += bytes_just_written.return_value_;
+        total_bytes_written_ += bytes_just_written.return_value_;
+      }
+    }
+    return total_bytes_written_;
+  }
+
+private:
+  Buffer::OwnedImpl contents_;
+  const off_t offset_;
+  size_t total_bytes_written_ = 0;
+  std::vector<struct iovec> iovecs_;
+};
+
+class ActionTruncateFile : public AsyncFileActionIoUring<absl::Status>, public IoUringOperation {
+public:
+  ActionTruncateFile(AsyncFileHandle handle, size_t length,
+                     absl::AnyInvocable<void(absl::Status)> on_complete)
+      : AsyncFileActionIoUring<absl::Status>(handle, std::move(on_complete)), length_(length) {}
+
+  // Only supported by recent kernels; older ones truncate synchronously with executeImpl.
+  uint8_t opcode() const override { return IORING_OP_FTRUNCATE; }
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    ASSERT(fileDescriptor() != -1);
+    io_uring_prep_ftruncate(sqe, fileDescriptor(), length_);
+  }
+
+  bool onCompletion(int32_t result) override {
+    result_ = statusFromResult(result);
+    return false;
+  }
+
+  absl::Status executeImpl() override {
+    ASSERT(fileDescriptor() != -1);
+    Api::SysCallIntResult result = posix().ftruncate(fileDescriptor(), length_);
+    if (result.return_value_ == -1) {
+      return statusAfterFileError(result);
+    }
+    return absl::OkStatus();
+  }
+
+private:
+  const size_t length_;
+};
+
+// There is no io_uring operation to duplicate a file descriptor, and dup() does not block, so it
+// is performed synchronously on the ring's thread.
+class ActionDuplicateFile : public AsyncFileActionIoUring<absl::StatusOr<AsyncFileHandle>> {
+public:
+  ActionDuplicateFile(AsyncFileHandle handle,
+                      absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : AsyncFileActionIoUring<absl::StatusOr<AsyncFileHandle>>(handle, std::move(on_complete)) {}
+
+  absl::StatusOr<AsyncFileHandle> executeImpl() override {
+    ASSERT(fileDescriptor() != -1);
+    auto newfd = posix().duplicate(fileDescriptor());
+    if (newfd.return_value_ == -1) {
+      return statusAfterFileError(newfd);
+    }
+    return std::make_shared<AsyncFileContextIoUring>(context()->manager(), newfd.return_value_);
+  }
+
+  void onCancelledBeforeCallback() override {
+    if (result_.value().ok()) {
+      result_.value().value()->close(nullptr, [](absl::Status) {}).IgnoreError();
+    }
+  }
+  bool hasActionIfCancelledBeforeCallback() const override { return true; }
+};
+
+} // namespace
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::stat(
+    Event::Dispatcher* dispatcher,
+    absl::AnyInvocable<void(absl::StatusOr<struct stat>)> on_complete) {
+  return checkFileAndEnqueue(dispatcher,
+                             std::make_unique<ActionStat>(handle(), std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::createHardLink(Event::Dispatcher* dispatcher, absl::string_view filename,
+                                        absl::AnyInvocable<void(absl::Status)> on_complete) {
+  return checkFileAndEnqueue(dispatcher, std::make_unique<ActionCreateHardLink>(
+                                             handle(), filename, std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::close(Event::Dispatcher* dispatcher,
+                               absl::AnyInvocable<void(absl::Status)> on_complete) {
+  auto ret = checkFileAndEnqueue(
+      dispatcher, std::make_unique<ActionCloseFile>(handle(), std::move(on_complete)));
+  fileDescriptor() = -1;
+  return ret;
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::read(
+    Event::Dispatcher* dispatcher, off_t offset, size_t length,
+    absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) {
+  return checkFileAndEnqueue(dispatcher, std::make_unique<ActionReadFile>(handle(), offset, length,
+                                                                          std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::readFileBacked(
+    Event::Dispatcher* dispatcher, off_t offset, size_t length,
+    absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) {
+  return checkFileAndEnqueue(dispatcher, std::make_unique<ActionReadFileBacked>(
+                                             handle(), offset, length, std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::write(Event::Dispatcher* dispatcher, Buffer::Instance& contents,
+                               off_t offset,
+                               absl::AnyInvocable<void(absl::StatusOr<size_t>)> on_complete) {
+  return checkFileAndEnqueue(dispatcher, std::make_unique<ActionWriteFile>(
+                                             handle(), contents, offset, std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::duplicate(
+    Event::Dispatcher* dispatcher,
+    absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  return checkFileAndEnqueue(
+      dispatcher, std::make_unique<ActionDuplicateFile>(handle(), std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::truncate(Event::Dispatcher* dispatcher, size_t length,
+                                  absl::AnyInvocable<void(absl::Status)> on_complete) {
+  return checkFileAndEnqueue(
+      dispatcher, std::make_unique<ActionTruncateFile>(handle(), length, std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::checkFileAndEnqueue(Event::Dispatcher* dispatcher,
+                                             std::unique_ptr<AsyncFileAction> action) {
+  if (fileDescriptor() == -1) {
+    return absl::FailedPreconditionError("file was already closed");
+  }
+  return enqueue(dispatcher, std::move(action));
+}
+
+AsyncFileContextIoUring::AsyncFileContextIoUring(AsyncFileManager& manager, int fd)
+    : AsyncFileContextBase(manager), file_descriptor_(fd) {}
+
+AsyncFileContextIoUring::~AsyncFileContextIoUring() { ASSERT(file_descriptor_ == -1); }
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
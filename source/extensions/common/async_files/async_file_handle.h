@@ -52,6 +52,20 @@ public:
   read(Event::Dispatcher* dispatcher, off_t offset, size_t length,
        absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) PURE;
 
+  // Like read, but rather than copying the data, the buffer passed to on_complete refers to the
+  // range of the file, which a plain socket connection can send directly from the file, e.g.
+  // with sendfile. Anything else reading the buffer reads the file through a memory mapping. The
+  // whole range is read into the page cache before on_complete is called, so neither waits for the
+  // disk unless the kernel evicts the pages in between. The file must not be truncated while the
+  // buffer, or any buffer its data is moved to, is alive.
+  //
+  // Each call costs a dup and an mmap, and the buffer's release costs an munmap and a close on the
+  // thread that releases it, usually a worker. The munmap flushes the TLB of every CPU running a
+  // thread of the process, so this only pays off over copying for large ranges.
+  virtual absl::StatusOr<CancelFunction> readFileBacked(
+      Event::Dispatcher* dispatcher, off_t offset, size_t length,
+      absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) PURE;
+
   // Enqueues an action to write to the currently open file, at position offset, the bytes contained
   // by contents. It is an error to call write on an AsyncFileContext that does not have a file
   // open.
@@ -7,6 +7,10 @@
 #include "source/common/protobuf/utility.h"
 #include "source/extensions/common/async_files/async_file_manager_thread_pool.h"
 
+#if defined(__linux__) && !defined(__ANDROID_API__) && defined(ENVOY_ENABLE_IO_URING)
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+#endif
+
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 
@@ -24,7 +28,8 @@ struct ManagerAndConfig {
 
 SINGLETON_MANAGER_REGISTRATION(async_file_manager_factory_singleton);
 
-class AsyncFileManagerFactoryImpl : public AsyncFileManagerFactory {
+class AsyncFileManagerFactoryImpl : public AsyncFileManagerFactory,
+                                    protected Logger::Loggable<Logger::Id::main> {
 public:
   static std::shared_ptr<AsyncFileManagerFactory> singleton(Singleton::Manager* singleton_manager);
   std::shared_ptr<AsyncFileManager> getAsyncFileManager(
@@ -33,6 +38,11 @@ public:
       ABSL_LOCKS_EXCLUDED(mu_) override;
 
 private:
+  // Creates an io_uring manager, or a default thread pool if io_uring is not available.
+  std::shared_ptr<AsyncFileManager> createIoUringManager(
+      const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
+      Api::OsSysCalls& posix);
+
   absl::Mutex mu_;
   absl::flat_hash_map<std::string, ManagerAndConfig> managers_ ABSL_GUARDED_BY(mu_);
 };
@@ -61,6 +71,11 @@ std::shared_ptr<AsyncFileManager> AsyncFileManagerFactoryImpl::getAsyncFileManag
                             std::make_shared<AsyncFileManagerThreadPool>(config, posix), config}})
                .first;
       break;
+    case envoy::extensions::common::async_files::v3::AsyncFileManagerConfig::kIoUring:
+      it = managers_
+               .insert({config.id(), ManagerAndConfig{createIoUringManager(config, posix), config}})
+               .first;
+      break;
     case envoy::extensions::common::async_files::v3::AsyncFileManagerConfig::MANAGER_TYPE_NOT_SET:
       // This is theoretically unreachable due to proto validation 'required', but it's possible
       // for code to have modified the proto post-validation.
@@ -72,6 +87,27 @@ std::shared_ptr<AsyncFileManager> AsyncFileManagerFactoryImpl::getAsyncFileManag
   return it->second.manager;
 }
 
+std::shared_ptr<AsyncFileManager> AsyncFileManagerFactoryImpl::createIoUringManager(
+    const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
+    Api::OsSysCalls& posix) {
+#if defined(__linux__) && !defined(__ANDROID_API__) && defined(ENVOY_ENABLE_IO_URING)
+  if (AsyncFileManagerIoUring::isSupported()) {
+    return std::make_shared<AsyncFileManagerIoUring>(config, posix);
+  }
+  ENVOY_LOG(warn, "io_uring is not supported by the kernel, AsyncFileManager '{}' falls back to a "
+                  "thread pool",
+            config.id());
+#else
+  ENVOY_LOG(warn, "io_uring is not enabled in this build, AsyncFileManager '{}' falls back to a "
+                  "thread pool",
+            config.id());
+#endif
+  envoy::extensions::common::async_files::v3::AsyncFileManagerConfig thread_pool_config;
+  thread_pool_config.set_id(config.id());
+  thread_pool_config.mutable_thread_pool();
+  return std::make_shared<AsyncFileManagerThreadPool>(thread_pool_config, posix);
+}
+
 } // namespace AsyncFiles
 } // namespace Common
 } // namespace Extensions
@@ -0,0 +1,521 @@
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/sysmacros.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "source/common/common/utility.h"
+#include "source/extensions/common/async_files/async_file_action.h"
+#include "source/extensions/common/async_files/async_file_context_io_uring.h"
+#include "source/extensions/common/async_files/status_after_file_error.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+namespace {
+constexpr uint32_t DefaultSubmissionQueueSize = 256;
+} // namespace
+
+struct stat statxToStat(const struct statx& statx_result) {
+  struct stat ret {};
+  ret.st_dev = makedev(statx_result.stx_dev_major, statx_result.stx_dev_minor);
+  ret.st_ino = statx_result.stx_ino;
+  ret.st_mode = statx_result.stx_mode;
+  ret.st_nlink = statx_result.stx_nlink;
+  ret.st_uid = statx_result.stx_uid;
+  ret.st_gid = statx_result.stx_gid;
+  ret.st_rdev = makedev(statx_result.stx_rdev_major, statx_result.stx_rdev_minor);
+  ret.st_size = statx_result.stx_size;
+  ret.st_blksize = statx_result.stx_blksize;
+  ret.st_blocks = statx_result.stx_blocks;
+  ret.st_atim.tv_sec = statx_result.stx_atime.tv_sec;
+  ret.st_atim.tv_nsec = statx_result.stx_atime.tv_nsec;
+  ret.st_mtim.tv_sec = statx_result.stx_mtime.tv_sec;
+  ret.st_mtim.tv_nsec = statx_result.stx_mtime.tv_nsec;
+  ret.st_ctim.tv_sec = statx_result.stx_ctime.tv_sec;
+  ret.st_ctim.tv_nsec = statx_result.stx_ctime.tv_nsec;
+  return ret;
+}
+
+bool AsyncFileManagerIoUring::isSupported() {
+  struct io_uring ring;
+  if (io_uring_queue_init(2, &ring, 0) != 0) {
+    return false;
+  }
+  io_uring_queue_exit(&ring);
+  return true;
+}
+
+AsyncFileManagerIoUring::AsyncFileManagerIoUring(
+    const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
+    Api::OsSysCalls& posix)
+    : submission_queue_size_(config.io_uring().submission_queue_size() == 0
+                                 ? DefaultSubmissionQueueSize
+                                 : config.io_uring().submission_queue_size()),
+      posix_(posix) {
+  if (!posix.supportsAllPosixFileOperations()) {
+    throw EnvoyException("AsyncFileManagerIoUring not supported");
+  }
+  int ret = io_uring_queue_init(submission_queue_size_, &ring_, 0);
+  if (ret != 0) {
+    throw EnvoyException(fmt::format("AsyncFileManagerIoUring unable to initialize io_uring: {}",
+                                     errorDetails(-ret)));
+  }
+  supported_opcodes_.resize(IORING_OP_LAST, false);
+  struct io_uring_probe* probe = io_uring_get_probe_ring(&ring_);
+  if (probe != nullptr) {
+    for (int op = 0; op < IORING_OP_LAST; op++) {
+      supported_opcodes_[op] = io_uring_opcode_supported(probe, op);
+    }
+    io_uring_free_probe(probe);
+  }
+  // Non-blocking, so that the ring polls it rather than blocking one of its workers in a read.
+  wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  RELEASE_ASSERT(wakeup_fd_ != -1,
+                 fmt::format("unable to create eventfd: {}", errorDetails(errno)));
+  ENVOY_LOG(info,
+            fmt::format("AsyncFileManagerIoUring created with id '{}', with {} submission entries",
+                        config.id(), submission_queue_size_));
+  thread_ = std::thread([this]() { run(); });
+}
+
+AsyncFileManagerIoUring::~AsyncFileManagerIoUring() ABSL_LOCKS_EXCLUDED(queue_mutex_) {
+  {
+    absl::MutexLock lock(&queue_mutex_);
+    terminate_ = true;
+  }
+  wakeup();
+  // This destructor will be blocked until all queued file actions are complete.
+  thread_.join();
+  io_uring_queue_exit(&ring_);
+  ::close(wakeup_fd_);
+}
+
+std::string AsyncFileManagerIoUring::describe() const {
+  return absl::StrCat("io_uring_submission_queue_size = ", submission_queue_size_);
+}
+
+void AsyncFileManagerIoUring::waitForIdle() {
+  const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(queue_mutex_) {
+    return in_flight_ == 0 && queue_.empty() && cleanup_queue_.empty();
+  };
+  absl::MutexLock lock(&queue_mutex_);
+  queue_mutex_.Await(absl::Condition(&condition));
+}
+
+absl::AnyInvocable<void()>
+AsyncFileManagerIoUring::enqueue(Event::Dispatcher* dispatcher,
+                                 std::unique_ptr<AsyncFileAction> action) {
+  QueuedAction entry{std::move(action), dispatcher};
+  auto cancel_func = [dispatcher, state = entry.state_]() {
+    ASSERT(dispatcher == nullptr || dispatcher->isThreadSafe());
+    state->store(QueuedAction::State::Cancelled);
+  };
+  bool was_empty;
+  {
+    absl::MutexLock lock(&queue_mutex_);
+    was_empty = queue_.empty() && cleanup_queue_.empty();
+    queue_.push_back(std::move(entry));
+  }
+  // Actions queued while the ring's thread is already due to wake up are picked up in the same
+  // batch, without another wakeup.
+  if (was_empty) {
+    wakeup();
+  }
+  return cancel_func;
+}
+
+void AsyncFileManagerIoUring::postCancelledActionForCleanup(
+    std::unique_ptr<AsyncFileAction> action) {
+  bool was_empty;
+  {
+    absl::MutexLock lock(&queue_mutex_);
+    was_empty = queue_.empty() && cleanup_queue_.empty();
+    cleanup_queue_.push_back(std::move(action));
+  }
+  if (was_empty) {
+    wakeup();
+  }
+}
+
+void AsyncFileManagerIoUring::wakeup() {
+  RELEASE_ASSERT(eventfd_write(wakeup_fd_, 1) == 0,
+                 fmt::format("unable to wake io_uring thread: {}", errorDetails(errno)));
+}
+
+void AsyncFileManagerIoUring::armWakeup() {
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    // Retried once completions have made room.
+    return;
+  }
+  io_uring_prep_read(sqe, wakeup_fd_, &wakeup_value_, sizeof(wakeup_value_), 0);
+  io_uring_sqe_set_data(sqe, nullptr);
+  wakeup_armed_ = true;
+}
+
+void AsyncFileManagerIoUring::run() {
+  while (true) {
+    std::vector<QueuedAction> actions;
+    std::vector<std::unique_ptr<AsyncFileAction>> cleanup_actions;
+    {
+      absl::MutexLock lock(&queue_mutex_);
+      in_flight_ -= completed_;
+      completed_ = 0;
+      if (terminate_ && queue_.empty() && cleanup_queue_.empty() && in_flight_ == 0) {
+        return;
+      }
+      actions.swap(queue_);
+      cleanup_actions.swap(cleanup_queue_);
+      in_flight_ += actions.size() + cleanup_actions.size();
+    }
+    for (std::unique_ptr<AsyncFileAction>& cleanup_action : cleanup_actions) {
+      std::move(cleanup_action)->onCancelledBeforeCallback();
+      completed_++;
+    }
+    for (QueuedAction& action : actions) {
+      start(std::move(action));
+    }
+    if (!wakeup_armed_) {
+      armWakeup();
+    }
+    preparePending();
+    if (completed_ > 0) {
+      // Some actions were performed synchronously; account for them before blocking.
+      io_uring_submit(&ring_);
+      reapCompletions();
+      continue;
+    }
+    // Submits the whole batch and waits for at least one completion with a single system call.
+    int ret = io_uring_submit_and_wait(&ring_, 1);
+    if (ret < 0 && ret != -EINTR && ret != -EBUSY) {
+      ENVOY_LOG(error, "AsyncFileManagerIoUring failed to submit: {}", errorDetails(-ret));
+    }
+    reapCompletions();
+  }
+}
+
+void AsyncFileManagerIoUring::start(QueuedAction&& queued_action) {
+  using State = QueuedAction::State;
+  State expected = State::Queued;
+  auto entry = std::make_unique<InFlightAction>();
+  entry->queued_ = std::move(queued_action);
+  AsyncFileAction& action = *entry->queued_.action_;
+  if (!entry->queued_.state_->compare_exchange_strong(expected, State::Executing)) {
+    ASSERT(expected == State::Cancelled);
+    if (!action.executesEvenIfCancelled()) {
+      completed_++;
+      return;
+    }
+    // The action is still performed, but complete() will find it cancelled and skip its callback.
+  }
+  entry->operation_ = dynamic_cast<IoUringOperation*>(&action);
+  if (entry->operation_ == nullptr || !supported_opcodes_[entry->operation_->opcode()]) {
+    action.execute();
+    complete(std::move(entry));
+    return;
+  }
+  pending_.push_back(std::move(entry));
+}
+
+void AsyncFileManagerIoUring::preparePending() {
+  // Keep the number of operations in the kernel within the size of the completion queue, which
+  // is twice that of the submission queue, so that completions can never overflow it.
+  while (!pending_.empty() && submitted_ < submission_queue_size_) {
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+    if (sqe == nullptr) {
+      io_uring_submit(&ring_);
+      sqe = io_uring_get_sqe(&ring_);
+      if (sqe == nullptr) {
+        return;
+      }
+    }
+    InFlightAction* entry = pending_.front().release();
+    pending_.pop_front();
+    entry->operation_->prepare(sqe);
+    io_uring_sqe_set_data(sqe, entry);
+    submitted_++;
+  }
+}
+
+void AsyncFileManagerIoUring::reapCompletions() {
+  unsigned head;
+  unsigned count = 0;
+  struct io_uring_cqe* cqe;
+  io_uring_for_each_cqe(&ring_, head, cqe) {
+    count++;
+    void* user_data = io_uring_cqe_get_data(cqe);
+    if (user_data == nullptr) {
+      wakeup_armed_ = false;
+      continue;
+    }
+    submitted_--;
+    InFlightActionPtr entry(static_cast<InFlightAction*>(user_data));
+    if (entry->operation_->onCompletion(cqe->res)) {
+      pending_.push_back(std::move(entry));
+    } else {
+      complete(std::move(entry));
+    }
+  }
+  io_uring_cq_advance(&ring_, count);
+}
+
+void AsyncFileManagerIoUring::complete(InFlightActionPtr entry) {
+  using State = QueuedAction::State;
+  completed_++;
+  std::shared_ptr<std::atomic<State>> state = std::move(entry->queued_.state_);
+  std::unique_ptr<AsyncFileAction> action = std::move(entry->queued_.action_);
+  State expected = State::Executing;
+  if (!state->compare_exchange_strong(expected, State::InCallback)) {
+    ASSERT(expected == State::Cancelled);
+    action->onCancelledBeforeCallback();
+    return;
+  }
+  if (entry->queued_.dispatcher_ == nullptr) {
+    // No need to bother arranging the callback, because a dispatcher was not provided.
+    return;
+  }
+  // As in AsyncFileManagerThreadPool, only hold a reference to the manager if a cancellation
+  // posted with the callback may have to be undone on the ring's thread.
+  std::shared_ptr<AsyncFileManagerIoUring> manager;
+  if (action->hasActionIfCancelledBeforeCallback()) {
+    manager = shared_from_this();
+  }
+  entry->queued_.dispatcher_->post([manager = std::move(manager), action = std::move(action),
+                                    state = std::move(state)]() mutable {
+    // This callback runs on the caller's thread.
+    State expected = State::InCallback;
+    if (state->compare_exchange_strong(expected, State::Done)) {
+      action->onComplete();
+      return;
+    }
+    ASSERT(expected == State::Cancelled);
+    if (manager == nullptr) {
+      return;
+    }
+    manager->postCancelledActionForCleanup(std::move(action));
+  });
+}
+
+namespace {
+
+class ActionWithFileResult : public AsyncFileActionWithResult<absl::StatusOr<AsyncFileHandle>>,
+                             public IoUringOperation {
+public:
+  ActionWithFileResult(AsyncFileManagerIoUring& manager,
+                       absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : AsyncFileActionWithResult(std::move(on_complete)), manager_(manager) {}
+
+  uint8_t opcode() const override { return IORING_OP_OPENAT; }
+
+  bool onCompletion(int32_t result) override {
+    if (result < 0) {
+      result_ = statusAfterFileError(-result);
+    } else {
+      result_ = std::make_shared<AsyncFileContextIoUring>(manager_, result);
+    }
+    return false;
+  }
+
+protected:
+  void onCancelledBeforeCallback() override {
+    if (result_.value().ok()) {
+      result_.value().value()->close(nullptr, [](absl::Status) {}).IgnoreError();
+    }
+  }
+  bool hasActionIfCancelledBeforeCallback() const override { return true; }
+
+  AsyncFileManagerIoUring& manager_;
+  Api::OsSysCalls& posix() { return manager_.posix(); }
+};
+
+class ActionCreateAnonymousFile : public ActionWithFileResult {
+public:
+  ActionCreateAnonymousFile(AsyncFileManagerIoUring& manager, absl::string_view path,
+                            absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : ActionWithFileResult(manager, std::move(on_complete)), path_(path) {}
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    io_uring_prep_openat(sqe, AT_FDCWD, path_.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC,
+                         S_IRUSR | S_IWUSR);
+  }
+
+  bool onCompletion(int32_t result) override {
+    // Filesystems without O_TMPFILE support fail with EOPNOTSUPP, or EISDIR on older kernels; fall
+    // back to creating and unlinking a named file, synchronously as this is rare.
+    if (result == -EOPNOTSUPP || result == -EISDIR) {
+      result_ = executeImpl();
+      return false;
+    }
+    return ActionWithFileResult::onCompletion(result);
+  }
+
+  absl::StatusOr<AsyncFileHandle> executeImpl() override {
+    char filename[4096];
+    static const char file_suffix[] = "/buffer.XXXXXX";
+    if (path_.size() + sizeof(file_suffix) > sizeof(filename)) {
+      return absl::InvalidArgumentError(
+          "AsyncFileManagerIoUring::createAnonymousFile: pathname too long for tmpfile");
+    }
+    snprintf(filename, sizeof(filename), "%s%s", path_.c_str(), file_suffix);
+    Api::SysCallIntResult open_result = posix().mkstemp(filename);
+    if (open_result.return_value_ == -1) {
+      return statusAfterFileError(open_result);
+    }
+    if (posix().unlink(filename).return_value_ != 0) {
+      posix().close(open_result.return_value_);
+      posix().unlink(filename);
+      return absl::UnimplementedError(
+          "AsyncFileManagerIoUring::createAnonymousFile: not supported for "
+          "target filesystem (failed to unlink an open file)");
+    }
+    return std::make_shared<AsyncFileContextIoUring>(manager_, open_result.return_value_);
+  }
+
+private:
+  const std::string path_;
+};
+
+class ActionOpenExistingFile : public ActionWithFileResult {
+public:
+  ActionOpenExistingFile(AsyncFileManagerIoUring& manager, absl::string_view filename,
+                         AsyncFileManager::Mode mode,
+                         absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : ActionWithFileResult(manager, std::move(on_complete)), filename_(filename), mode_(mode) {}
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    io_uring_prep_openat(sqe, AT_FDCWD, filename_.c_str(), openFlags() | O_CLOEXEC, 0);
+  }
+
+  absl::StatusOr<AsyncFileHandle> executeImpl() override {
+    auto open_result = posix().open(filename_.c_str(), openFlags());
+    if (open_result.return_value_ == -1) {
+      return statusAfterFileError(open_result);
+    }
+    return std::make_shared<AsyncFileContextIoUring>(manager_, open_result.return_value_);
+  }
+
+private:
+  int openFlags() const {
+    switch (mode_) {
+    case AsyncFileManager::Mode::ReadOnly:
+      return O_RDONLY;
+    case AsyncFileManager::Mode::WriteOnly:
+      return O_WRONLY;
+    case AsyncFileManager::Mode::ReadWrite:
+      return O_RDWR;
+    }
+    PANIC_DUE_TO_CORRUPT_ENUM;
+  }
+  const std::string filename_;
+  const AsyncFileManager::Mode mode_;
+};
+
+class ActionStat : public AsyncFileActionWithResult<absl::StatusOr<struct stat>>,
+                   public IoUringOperation {
+public:
+  ActionStat(Api::OsSysCalls& posix, absl::string_view filename,
+             absl::AnyInvocable<void(absl::StatusOr<struct stat>)> on_complete)
+      : AsyncFileActionWithResult(std::move(on_complete)), posix_(posix), filename_(filename) {}
+
+  uint8_t opcode() const override { return IORING_OP_STATX; }
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    io_uring_prep_statx(sqe, AT_FDCWD, filename_.c_str(), 0, STATX_BASIC_STATS, &statx_);
+  }
+
+  bool onCompletion(int32_t result) override {
+    if (result < 0) {
+      result_ = statusAfterFileError(-result);
+    } else {
+      result_ = statxToStat(statx_);
+    }
+    return false;
+  }
+
+  absl::StatusOr<struct stat> executeImpl() override {
+    struct stat ret;
+    Api::SysCallIntResult stat_result = posix_.stat(filename_.c_str(), &ret);
+    if (stat_result.return_value_ == -1) {
+      return statusAfterFileError(stat_result);
+    }
+    return ret;
+  }
+
+private:
+  Api::OsSysCalls& posix_;
+  const std::string filename_;
+  struct statx statx_ {};
+};
+
+class ActionUnlink : public AsyncFileActionWithResult<absl::Status>, public IoUringOperation {
+public:
+  ActionUnlink(Api::OsSysCalls& posix, absl::string_view filename,
+               absl::AnyInvocable<void(absl::Status)> on_complete)
+      : AsyncFileActionWithResult(std::move(on_complete)), posix_(posix), filename_(filename) {}
+
+  uint8_t opcode() const override { return IORING_OP_UNLINKAT; }
+
+  void prepare(struct io_uring_sqe* sqe) override {
+    io_uring_prep_unlinkat(sqe, AT_FDCWD, filename_.c_str(), 0);
+  }
+
+  bool onCompletion(int32_t result) override {
+    result_ = result < 0 ? statusAfterFileError(-result) : absl::OkStatus();
+    return false;
+  }
+
+  absl::Status executeImpl() override {
+    Api::SysCallIntResult unlink_result = posix_.unlink(filename_.c_str());
+    if (unlink_result.return_value_ == -1) {
+      return statusAfterFileError(unlink_result);
+    }
+    return absl::OkStatus();
+  }
+
+private:
+  Api::OsSysCalls& posix_;
+  const std::string filename_;
+};
+
+} // namespace
+
+CancelFunction AsyncFileManagerIoUring::createAnonymousFile(
+    Event::Dispatcher* dispatcher, absl::string_view path,
+    absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  return enqueue(dispatcher,
+                 std::make_unique<ActionCreateAnonymousFile>(*this, path, std::move(on_complete)));
+}
+
+CancelFunction AsyncFileManagerIoUring::openExistingFile(
+    Event::Dispatcher* dispatcher, absl::string_view filename, Mode mode,
+    absl::AnyInvocable<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  return enqueue(dispatcher, std::make_unique<ActionOpenExistingFile>(*this, filename, mode,
+                                                                      std::move(on_complete)));
+}
+
+CancelFunction
+AsyncFileManagerIoUring::stat(Event::Dispatcher* dispatcher, absl::string_view filename,
+                              absl::AnyInvocable<void(absl::StatusOr<struct stat>)> on_complete) {
+  return enqueue(dispatcher,
+                 std::make_unique<ActionStat>(posix(), filename, std::move(on_complete)));
+}
+
+CancelFunction
+AsyncFileManagerIoUring::unlink(Event::Dispatcher* dispatcher, absl::string_view filename,
+                                absl::AnyInvocable<void(absl::Status)> on_complete) {
+  return enqueue(dispatcher,
+                 std::make_unique<ActionUnlink>(posix(), filename, std::move(on_complete)));
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
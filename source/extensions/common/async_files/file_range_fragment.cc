@@ -0,0 +1,90 @@
+#include "source/extensions/common/async_files/file_range_fragment.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/common/async_files/status_after_file_error.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+absl::StatusOr<std::unique_ptr<FileRangeFragment>>
+FileRangeFragment::create(Api::OsSysCalls& posix, int fd, off_t offset, size_t length) {
+  struct stat stat_result;
+  Api::SysCallIntResult stat_call = posix.fstat(fd, &stat_result);
+  if (stat_call.return_value_ == -1) {
+    return statusAfterFileError(stat_call);
+  }
+  // Touching a mapped page beyond the end of the file is a SIGBUS, so only map what exists.
+  if (offset >= stat_result.st_size) {
+    length = 0;
+  } else {
+    length = std::min<size_t>(length, stat_result.st_size - offset);
+  }
+  if (length == 0) {
+    return absl::OutOfRangeError("FileRangeFragment: range is beyond the end of the file");
+  }
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  const size_t skip = offset % page_size;
+  // The range is read in here, on the file thread, so that neither sendfile nor anything reading
+  // the mapping on a worker thread waits for the disk.
+#ifdef MAP_POPULATE
+  constexpr int flags = MAP_SHARED | MAP_POPULATE;
+#else
+  constexpr int flags = MAP_SHARED;
+#endif
+  Api::SysCallPtrResult mapping =
+      posix.mmap(nullptr, skip + length, PROT_READ, flags, fd, offset - skip);
+  if (mapping.return_value_ == MAP_FAILED) {
+    return statusAfterFileError(mapping);
+  }
+#ifndef MAP_POPULATE
+  const volatile uint8_t* pages = static_cast<const volatile uint8_t*>(mapping.return_value_);
+  for (size_t i = 0; i < skip + length; i += page_size) {
+    (void)pages[i];
+  }
+#endif
+  Api::SysCallSocketResult dup_fd = posix.duplicate(fd);
+  if (dup_fd.return_value_ == -1) {
+    ::munmap(mapping.return_value_, skip + length);
+    return statusAfterFileError(dup_fd);
+  }
+  return std::unique_ptr<FileRangeFragment>(new FileRangeFragment(
+      posix, dup_fd.return_value_, offset, length, mapping.return_value_, skip));
+}
+
+FileRangeFragment::FileRangeFragment(Api::OsSysCalls& posix, int fd, off_t offset, size_t length,
+                                     void* mapping, size_t skip)
+    : posix_(posix), fd_(fd), offset_(offset), length_(length), mapping_(mapping), skip_(skip) {}
+
+FileRangeFragment::~FileRangeFragment() {
+  ::munmap(mapping_, skip_ + length_);
+  posix_.close(fd_);
+}
+
+absl::StatusOr<Buffer::InstancePtr> readFileRange(Api::OsSysCalls& posix, int fd, off_t offset,
+                                                  size_t length) {
+  auto result = std::make_unique<Buffer::OwnedImpl>();
+  absl::StatusOr<std::unique_ptr<FileRangeFragment>> fragment =
+      FileRangeFragment::create(posix, fd, offset, length);
+  if (!fragment.ok()) {
+    if (fragment.status().code() == absl::StatusCode::kOutOfRange) {
+      return result;
+    }
+    return fragment.status();
+  }
+  // The fragment deletes itself when the buffer is done with it.
+  result->addBufferFragment(*fragment.value().release());
+  return result;
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/buffer/buffer.h"
+
+#include "source/common/common/non_copyable.h"
+
+#include "absl/status/statusor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+// A BufferFragment that refers to a range of a file rather than holding a copy of its bytes.
+// Connections over plain sockets write such fragments with sendfile; anything else that reads the
+// buffer sees the range through a read-only memory mapping.
+//
+// The fragment owns a duplicate of the file descriptor, so it remains valid after the file it was
+// created from is closed, or unlinked. The file must not be truncated while the fragment exists.
+class FileRangeFragment : public Buffer::BufferFragment, NonCopyable {
+public:
+  // Creates a fragment for the range of the file starting at offset, of up to length bytes; the
+  // range is clipped to the end of the file. Performs blocking system calls and reads the range
+  // into the page cache, so is intended to be called from an AsyncFileManager's threads.
+  static absl::StatusOr<std::unique_ptr<FileRangeFragment>>
+  create(Api::OsSysCalls& posix, int fd, off_t offset, size_t length);
+
+  ~FileRangeFragment() override;
+
+  // Buffer::BufferFragment
+  const void* data() const override { return static_cast<const uint8_t*>(mapping_) + skip_; }
+  size_t size() const override { return length_; }
+  void done() override { delete this; }
+  absl::optional<Buffer::FileRange> fileRange() const override {
+    return Buffer::FileRange{fd_, offset_, length_};
+  }
+
+private:
+  FileRangeFragment(Api::OsSysCalls& posix, int fd, off_t offset, size_t length, void* mapping,
+                    size_t skip);
+
+  Api::OsSysCalls& posix_;
+  const int fd_;
+  const off_t offset_;
+  const size_t length_;
+  // The mapping starts at the page containing offset, skip_ bytes before the data.
+  void* const mapping_;
+  const size_t skip_;
+};
+
+// Reads the range of the file like pread, but into a FileRangeFragment rather than a copy. Returns
+// an empty buffer if the range is beyond the end of the file.
+absl::StatusOr<Buffer::InstancePtr> readFileRange(Api::OsSysCalls& posix, int fd, off_t offset,
+                                                  size_t length);
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -4,6 +4,7 @@
 
 #include "source/extensions/compression/brotli/common/base.h"
 
+#include "absl/status/statusor.h"
 #include "brotli/encode.h"
 
 namespace Envoy {
@@ -12,6 +13,34 @@ namespace Compression {
 namespace Brotli {
 namespace Compressor {
 
+/**
+ * A raw pre-trained dictionary, prepared for the encoder once and then shared by the compressors
+ * of all streams on all workers, which only read it.
+ */
+class BrotliCompressorDictionary : NonCopyable {
+public:
+  /**
+   * @param data the content of the dictionary.
+   * @param quality the quality the dictionary is prepared for, which should be the compressors'.
+   * @return the prepared dictionary, or an error if brotli cannot prepare it.
+   */
+  static absl::StatusOr<std::shared_ptr<const BrotliCompressorDictionary>>
+  create(std::string data, uint32_t quality);
+
+  const BrotliEncoderPreparedDictionary* prepared() const { return prepared_.get(); }
+
+private:
+  BrotliCompressorDictionary(std::string data, uint32_t quality);
+
+  // The prepared dictionary refers to the data rather than copying it.
+  const std::string data_;
+  const std::unique_ptr<BrotliEncoderPreparedDictionary,
+                        decltype(&BrotliEncoderDestroyPreparedDictionary)>
+      prepared_;
+};
+
+using BrotliCompressorDictionarySharedPtr = std::shared_ptr<const BrotliCompressorDictionary>;
+
 /**
  * Implementation of compressor's interface.
  */
@@ -44,10 +73,12 @@ public:
    * feature. This flag is a "decoding-speed vs compression ratio" trade-off.
    * @param mode tunes encoder for specific input. @see EncoderMode enum.
    * @param chunk_size amount of memory reserved for the compressor output.
+   * @param dictionary an optional dictionary to compress with.
    */
   BrotliCompressorImpl(const uint32_t quality, const uint32_t window_bits,
                        const uint32_t input_block_bits, const bool disable_literal_context_modeling,
-                       const EncoderMode mode, const uint32_t chunk_size);
+                       const EncoderMode mode, const uint32_t chunk_size,
+                       BrotliCompressorDictionarySharedPtr dictionary = nullptr);
 
   // Compression::Compressor::Compressor
   void compress(Buffer::Instance& buffer, Envoy::Compression::Compressor::State state) override;
@@ -57,6 +88,8 @@ private:
                const BrotliEncoderOperation op);
 
   const uint32_t chunk_size_;
+  // The encoder refers to the dictionary, so it must outlive the encoder's state.
+  const BrotliCompressorDictionarySharedPtr dictionary_;
   std::unique_ptr<BrotliEncoderState, decltype(&BrotliEncoderDestroyInstance)> state_;
 };
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "envoy/api/api.h"
 #include "envoy/compression/compressor/factory.h"
 #include "envoy/extensions/compression/brotli/compressor/v3/brotli.pb.h"
 #include "envoy/extensions/compression/brotli/compressor/v3/brotli.pb.validate.h"
@@ -38,7 +39,7 @@ const std::string& brotliExtensionName() {
 class BrotliCompressorFactory : public Envoy::Compression::Compressor::CompressorFactory {
 public:
   BrotliCompressorFactory(
-      const envoy::extensions::compression::brotli::compressor::v3::Brotli& brotli);
+      const envoy::extensions::compression::brotli::compressor::v3::Brotli& brotli, Api::Api& api);
 
   // Envoy::Compression::Compressor::CompressorFactory
   Envoy::Compression::Compressor::CompressorPtr createCompressor() override;
@@ -56,6 +57,7 @@ private:
   const uint32_t input_block_bits_;
   const uint32_t quality_;
   const uint32_t window_bits_;
+  BrotliCompressorDictionarySharedPtr dictionary_;
 };
 
 class BrotliCompressorLibraryFactory
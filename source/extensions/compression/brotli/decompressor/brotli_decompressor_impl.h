@@ -40,9 +40,11 @@ public:
    * @param disable_ring_buffer_reallocation if true disables "canny" ring buffer allocation
    * strategy. Ring buffer is allocated according to window size, despite the real size of the
    * content.
+   * @param dictionary an optional raw dictionary the input was compressed with.
    */
   BrotliDecompressorImpl(Stats::Scope& scope, const std::string& stats_prefix,
-                         const uint32_t chunk_size, bool disable_ring_buffer_reallocation);
+                         const uint32_t chunk_size, bool disable_ring_buffer_reallocation,
+                         std::shared_ptr<const std::string> dictionary = nullptr);
 
   // Envoy::Compression::Decompressor::Decompressor
   void decompress(const Buffer::Instance& input_buffer, Buffer::Instance& output_buffer) override;
@@ -56,6 +58,8 @@ private:
   bool process(Common::BrotliContext& ctx, Buffer::Instance& output_buffer);
 
   const uint32_t chunk_size_;
+  // The decoder refers to the dictionary, so it must outlive the decoder's state.
+  const std::shared_ptr<const std::string> dictionary_;
   std::unique_ptr<BrotliDecoderState, decltype(&BrotliDecoderDestroyInstance)> state_;
   const BrotliDecompressorStats stats_;
 };
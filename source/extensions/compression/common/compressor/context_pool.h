@@ -0,0 +1,94 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Common {
+namespace Compressor {
+
+/**
+ * A pool of idle compression contexts, e.g. initialized zlib streams or zstd `CCtx`s, that
+ * compressors take when they are created and give back when they are destroyed, so that a new
+ * stream skips allocating and initializing the context. A pool is not thread safe: it belongs to
+ * one worker, and compressors must be created and destroyed on that worker.
+ * @param ContextPtr an owning pointer to a context, which frees the context when destroyed.
+ */
+template <class ContextPtr> class ContextPool {
+public:
+  explicit ContextPool(uint32_t max_size) : max_size_(max_size) { contexts_.reserve(max_size); }
+
+  /**
+   * @return ContextPtr an idle context. The pool must not be empty.
+   */
+  ContextPtr acquire() {
+    ASSERT(!contexts_.empty());
+    ContextPtr context = std::move(contexts_.back());
+    contexts_.pop_back();
+    return context;
+  }
+
+  /**
+   * Keeps a context, which must have been reset, for reuse. If the pool is full the context is
+   * freed instead.
+   * @param context the context to keep.
+   */
+  void release(ContextPtr context) {
+    if (contexts_.size() < max_size_) {
+      contexts_.push_back(std::move(context));
+    }
+  }
+
+  bool empty() const { return contexts_.empty(); }
+  size_t size() const { return contexts_.size(); }
+
+private:
+  const uint32_t max_size_;
+  std::vector<ContextPtr> contexts_;
+};
+
+template <class ContextPtr> using ContextPoolSharedPtr = std::shared_ptr<ContextPool<ContextPtr>>;
+
+/**
+ * A ContextPool per worker. Compressors hold a reference to the pool of the worker that created
+ * them, so contexts in flight outlive the pools if the compressor factory is destroyed first.
+ */
+template <class ContextPtr> class ThreadLocalContextPool {
+public:
+  ThreadLocalContextPool(ThreadLocal::SlotAllocator& tls, uint32_t max_size)
+      : tls_slot_(ThreadLocal::TypedSlot<ThreadLocalPool>::makeUnique(tls)) {
+    tls_slot_->set([max_size](Event::Dispatcher&) {
+      return std::make_shared<ThreadLocalPool>(max_size);
+    });
+  }
+
+  /**
+   * @return ContextPoolSharedPtr the pool of the calling worker.
+   */
+  ContextPoolSharedPtr<ContextPtr> get() { return (*tls_slot_)->pool_; }
+
+private:
+  struct ThreadLocalPool : public ThreadLocal::ThreadLocalObject {
+    explicit ThreadLocalPool(uint32_t max_size)
+        : pool_(std::make_shared<ContextPool<ContextPtr>>(max_size)) {}
+
+    const ContextPoolSharedPtr<ContextPtr> pool_;
+  };
+
+  ThreadLocal::TypedSlotPtr<ThreadLocalPool> tls_slot_;
+};
+
+template <class ContextPtr>
+using ThreadLocalContextPoolPtr = std::unique_ptr<ThreadLocalContextPool<ContextPtr>>;
+
+} // namespace Compressor
+} // namespace Common
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
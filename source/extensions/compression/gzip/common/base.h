@@ -36,7 +36,7 @@ protected:
   bool initialized_{false};
 
   const std::unique_ptr<unsigned char[]> chunk_char_ptr_;
-  const std::unique_ptr<z_stream, std::function<void(z_stream*)>> zstream_ptr_;
+  std::unique_ptr<z_stream, std::function<void(z_stream*)>> zstream_ptr_;
 };
 
 } // namespace Common
@@ -17,10 +17,15 @@ namespace Compressor {
 ZlibCompressorImpl::ZlibCompressorImpl() : ZlibCompressorImpl(4096) {}
 
 ZlibCompressorImpl::ZlibCompressorImpl(uint64_t chunk_size)
-    : Common::Base(chunk_size, [](z_stream* z) {
-        deflateEnd(z);
-        delete z;
-      }) {
+    : ZlibCompressorImpl(chunk_size, nullptr) {}
+
+ZlibCompressorImpl::ZlibCompressorImpl(uint64_t chunk_size, ZlibContextPoolSharedPtr context_pool)
+    : Common::Base(chunk_size,
+                   [](z_stream* z) {
+                     deflateEnd(z);
+                     delete z;
+                   }),
+      context_pool_(std::move(context_pool)) {
   zstream_ptr_->zalloc = Z_NULL;
   zstream_ptr_->zfree = Z_NULL;
   zstream_ptr_->opaque = Z_NULL;
@@ -31,12 +36,27 @@ ZlibCompressorImpl::ZlibCompressorImpl(uint64_t chunk_size)
 void ZlibCompressorImpl::init(CompressionLevel comp_level, CompressionStrategy comp_strategy,
                               int64_t window_bits, uint64_t memory_level = 8) {
   ASSERT(initialized_ == false);
+  if (context_pool_ != nullptr && !context_pool_->empty()) {
+    // The pooled stream was initialized with the same parameters, and reset when released.
+    zstream_ptr_ = context_pool_->acquire();
+    zstream_ptr_->avail_out = chunk_size_;
+    zstream_ptr_->next_out = chunk_char_ptr_.get();
+    initialized_ = true;
+    return;
+  }
   const int result = deflateInit2(zstream_ptr_.get(), static_cast<int64_t>(comp_level), Z_DEFLATED,
                                   window_bits, memory_level, static_cast<uint64_t>(comp_strategy));
   RELEASE_ASSERT(result >= 0, "");
   initialized_ = true;
 }
 
+ZlibCompressorImpl::~ZlibCompressorImpl() {
+  // deflateReset() keeps the stream's allocated state, so the next stream only has to reset it.
+  if (context_pool_ != nullptr && initialized_ && deflateReset(zstream_ptr_.get()) == Z_OK) {
+    context_pool_->release(std::move(zstream_ptr_));
+  }
+}
+
 void ZlibCompressorImpl::compress(Buffer::Instance& buffer,
                                   Envoy::Compression::Compressor::State state) {
   for (const Buffer::RawSlice& input_slice : buffer.getRawSlices()) {
@@ -2,6 +2,7 @@
 
 #include "envoy/compression/compressor/compressor.h"
 
+#include "source/extensions/compression/common/compressor/context_pool.h"
 #include "source/extensions/compression/gzip/common/base.h"
 
 #include "zlib.h"
@@ -12,6 +13,11 @@ namespace Compression {
 namespace Gzip {
 namespace Compressor {
 
+using ZlibContextPtr = std::unique_ptr<z_stream, std::function<void(z_stream*)>>;
+using ZlibContextPool = Compression::Common::Compressor::ContextPool<ZlibContextPtr>;
+using ZlibContextPoolSharedPtr =
+    Compression::Common::Compressor::ContextPoolSharedPtr<ZlibContextPtr>;
+
 /**
  * Implementation of compressor's interface.
  */
@@ -29,6 +35,17 @@ public:
    */
   ZlibCompressorImpl(uint64_t chunk_size);
 
+  /**
+   * Constructor that takes an initialized stream from a pool, if there is one, rather than
+   * initializing a new one, and gives it back to the pool when destroyed. All the compressors that
+   * share a pool must be initialized with the same parameters.
+   * @param chunk_size amount of memory reserved for the compressor output.
+   * @param context_pool the pool of deflate streams of the calling thread.
+   */
+  ZlibCompressorImpl(uint64_t chunk_size, ZlibContextPoolSharedPtr context_pool);
+
+  ~ZlibCompressorImpl() override;
+
   /**
    * Enum values used to set compression level during initialization.
    * best: gives best compression.
@@ -88,6 +105,8 @@ public:
 private:
   bool deflateNext(int64_t flush_state);
   void process(Buffer::Instance& output_buffer, int64_t flush_state);
+
+  const ZlibContextPoolSharedPtr context_pool_;
 };
 
 } // namespace Compressor
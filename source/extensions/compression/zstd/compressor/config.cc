@@ -22,11 +22,17 @@ ZstdCompressorFactory::ZstdCompressorFactory(
           return ZSTD_createCDict(dict_buffer, dict_size, compression_level_);
         });
   }
+  if (zstd.context_pool_size() > 0) {
+    context_pool_ =
+        std::make_unique<Compression::Common::Compressor::ThreadLocalContextPool<ZstdCCtxPtr>>(
+            tls, zstd.context_pool_size());
+  }
 }
 
 Envoy::Compression::Compressor::CompressorPtr ZstdCompressorFactory::createCompressor() {
-  return std::make_unique<ZstdCompressorImpl>(compression_level_, enable_checksum_, strategy_,
-                                              cdict_manager_, chunk_size_);
+  return std::make_unique<ZstdCompressorImpl>(
+      compression_level_, enable_checksum_, strategy_, cdict_manager_, chunk_size_,
+      context_pool_ != nullptr ? context_pool_->get() : nullptr);
 }
 
 Envoy::Compression::Compressor::CompressorFactoryPtr
@@ -42,6 +42,7 @@ private:
   const uint32_t strategy_;
   const uint32_t chunk_size_;
   ZstdCDictManagerPtr cdict_manager_{nullptr};
+  Compression::Common::Compressor::ThreadLocalContextPoolPtr<ZstdCCtxPtr> context_pool_;
 };
 
 class ZstdCompressorLibraryFactory
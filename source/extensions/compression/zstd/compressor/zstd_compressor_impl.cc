@@ -6,11 +6,23 @@ namespace Compression {
 namespace Zstd {
 namespace Compressor {
 
+namespace {
+
+ZstdCCtxPtr pooledOrNewContext(const ZstdCCtxPoolSharedPtr& context_pool) {
+  if (context_pool != nullptr && !context_pool->empty()) {
+    return context_pool->acquire();
+  }
+  return {ZSTD_createCCtx(), &ZSTD_freeCCtx};
+}
+
+} // namespace
+
 ZstdCompressorImpl::ZstdCompressorImpl(uint32_t compression_level, bool enable_checksum,
                                        uint32_t strategy, const ZstdCDictManagerPtr& cdict_manager,
-                                       uint32_t chunk_size)
-    : ZstdCompressorImplBase(compression_level, enable_checksum, strategy, chunk_size),
-      cdict_manager_(cdict_manager) {
+                                       uint32_t chunk_size, ZstdCCtxPoolSharedPtr context_pool)
+    : ZstdCompressorImplBase(pooledOrNewContext(context_pool), compression_level, enable_checksum,
+                             strategy, chunk_size),
+      cdict_manager_(cdict_manager), context_pool_(std::move(context_pool)) {
   size_t result;
   if (cdict_manager_) {
     ZSTD_CDict* cdict = cdict_manager_->getFirstDictionary();
@@ -21,6 +33,15 @@ ZstdCompressorImpl::ZstdCompressorImpl(uint32_t compression_level, bool enable_c
   RELEASE_ASSERT(!ZSTD_isError(result), "");
 }
 
+ZstdCompressorImpl::~ZstdCompressorImpl() {
+  // Resetting the session and parameters keeps the context's workspace allocated, which is what
+  // makes creating a context expensive, and the next compressor sets its parameters again.
+  if (context_pool_ != nullptr &&
+      !ZSTD_isError(ZSTD_CCtx_reset(cctx_.get(), ZSTD_reset_session_and_parameters))) {
+    context_pool_->release(std::move(cctx_));
+  }
+}
+
 void ZstdCompressorImpl::compressPreprocess(Buffer::Instance&,
                                             Envoy::Compression::Compressor::State) {}
 
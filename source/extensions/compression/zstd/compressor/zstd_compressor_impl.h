@@ -4,6 +4,7 @@
 
 #include "source/common/compression/zstd/common/base.h"
 #include "source/common/compression/zstd/compressor/zstd_compressor_impl_base.h"
+#include "source/extensions/compression/common/compressor/context_pool.h"
 #include "source/extensions/compression/zstd/common/dictionary_manager.h"
 
 namespace Envoy {
@@ -15,14 +16,24 @@ namespace Compressor {
 using ZstdCDictManager =
     Common::DictionaryManager<ZSTD_CDict, ZSTD_freeCDict, ZSTD_getDictID_fromCDict>;
 using ZstdCDictManagerPtr = std::unique_ptr<ZstdCDictManager>;
+using ZstdCCtxPtr = Envoy::Compression::Zstd::Compressor::ZstdCCtxPtr;
+using ZstdCCtxPool = Compression::Common::Compressor::ContextPool<ZstdCCtxPtr>;
+using ZstdCCtxPoolSharedPtr = Compression::Common::Compressor::ContextPoolSharedPtr<ZstdCCtxPtr>;
 
 /**
  * Implementation of compressor's interface.
  */
 class ZstdCompressorImpl : public Envoy::Compression::Zstd::Compressor::ZstdCompressorImplBase {
 public:
+  /**
+   * @param context_pool if not nullptr, the compressor takes its context from the pool, if there
+   * is one, and gives it back when destroyed. The pool must only be used on the calling thread.
+   */
   ZstdCompressorImpl(uint32_t compression_level, bool enable_checksum, uint32_t strategy,
-                     const ZstdCDictManagerPtr& cdict_manager, uint32_t chunk_size);
+                     const ZstdCDictManagerPtr& cdict_manager, uint32_t chunk_size,
+                     ZstdCCtxPoolSharedPtr context_pool = nullptr);
+
+  ~ZstdCompressorImpl() override;
 
 private:
   void compressPreprocess(Buffer::Instance& buffer,
@@ -34,6 +45,7 @@ private:
   void compressPostprocess(Buffer::Instance& accumulation_buffer) override;
 
   const ZstdCDictManagerPtr& cdict_manager_;
+  const ZstdCCtxPoolSharedPtr context_pool_;
 };
 
 } // namespace Compressor
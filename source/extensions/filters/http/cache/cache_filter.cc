@@ -2,6 +2,7 @@
 
 #include "envoy/http/header_map.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/enum_to_int.h"
 #include "source/common/http/headers.h"
 #include "source/common/http/utility.h"
@@ -30,6 +31,21 @@ namespace {
 //
 // And everyone knows 64MB should be enough for anyone.
 static const size_t MAX_BYTES_TO_FETCH_FROM_CACHE_PER_REQUEST = 64 * 1024 * 1024;
+
+constexpr uint64_t DEFAULT_REQUEST_COALESCING_TIMEOUT_MS = 5000;
+constexpr uint32_t DEFAULT_REQUEST_COALESCING_MAX_RETAINED_BODY_BYTES = 1024 * 1024;
+
+std::shared_ptr<RequestCoalescer>
+createRequestCoalescer(const envoy::extensions::filters::http::cache::v3::CacheConfig& config) {
+  if (!config.has_request_coalescing()) {
+    return nullptr;
+  }
+  return std::make_shared<RequestCoalescer>(
+      std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(
+          config.request_coalescing(), timeout, DEFAULT_REQUEST_COALESCING_TIMEOUT_MS)),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.request_coalescing(), max_retained_body_bytes,
+                                      DEFAULT_REQUEST_COALESCING_MAX_RETAINED_BODY_BYTES));
+}
 } // namespace
 
 struct CacheResponseCodeDetailValues {
@@ -43,7 +59,8 @@ CacheFilterConfig::CacheFilterConfig(
     Server::Configuration::CommonFactoryContext& context)
     : vary_allow_list_(config.allowed_vary_headers(), context), time_source_(context.timeSource()),
       ignore_request_cache_control_header_(config.ignore_request_cache_control_header()),
-      cluster_manager_(context.clusterManager()) {}
+      cluster_manager_(context.clusterManager()),
+      request_coalescer_(createRequestCoalescer(config)) {}
 
 CacheFilter::CacheFilter(std::shared_ptr<const CacheFilterConfig> config,
                          std::shared_ptr<HttpCache> http_cache)
@@ -54,6 +71,18 @@ void CacheFilter::onDestroy() {
   if (lookup_ != nullptr) {
     lookup_->onDestroy();
   }
+  if (coalescing_timer_ != nullptr) {
+    coalescing_timer_->disableTimer();
+  }
+  if (awaited_response_ != nullptr) {
+    awaited_response_->removeWatcher(*this);
+    awaited_response_ = nullptr;
+  }
+  if (filling_response_ != nullptr) {
+    // The upstream request was never sent, so requests waiting for it must send their own.
+    filling_response_->abort();
+    filling_response_ = nullptr;
+  }
   if (upstream_request_ != nullptr) {
     upstream_request_->disconnectFilter();
     upstream_request_ = nullptr;
@@ -77,6 +106,98 @@ void CacheFilter::sendUpstreamRequest(Http::RequestHeaderMap& request_headers) {
   upstream_request_->sendHeaders(request_headers);
 }
 
+void CacheFilter::handleCacheMiss(Http::RequestHeaderMap& request_headers) {
+  const std::shared_ptr<RequestCoalescer>& coalescer = config_->requestCoalescer();
+  // Only responses that may be cached are shared, as those are the ones that can be served to
+  // other requests.
+  if (coalescer == nullptr || !coalescing_key_.has_value() || is_head_request_ ||
+      !request_allows_inserts_) {
+    sendUpstreamRequest(request_headers);
+    return;
+  }
+  auto [response, is_filler] = coalescer->getOrCreate(coalescing_key_.value(), request_headers);
+  if (is_filler) {
+    // Handed over to the UpstreamRequest.
+    filling_response_ = std::move(response);
+    sendUpstreamRequest(request_headers);
+    return;
+  }
+  ENVOY_STREAM_LOG(debug, "CacheFilter waiting for a concurrent request for the same key",
+                   *decoder_callbacks_);
+  awaited_response_ = std::move(response);
+  request_headers_ = &request_headers;
+  coalescing_timer_ = decoder_callbacks_->dispatcher().createTimer([this]() {
+    ENVOY_STREAM_LOG(debug, "CacheFilter timed out waiting for a coalesced response",
+                     *decoder_callbacks_);
+    stopWaitingForCoalescedResponse();
+  });
+  coalescing_timer_->enableTimer(coalescer->timeout());
+  awaited_response_->addWatcher(decoder_callbacks_->dispatcher(), weak_from_this());
+}
+
+void CacheFilter::stopWaitingForCoalescedResponse() {
+  coalescing_timer_->disableTimer();
+  awaited_response_->removeWatcher(*this);
+  awaited_response_ = nullptr;
+  sendUpstreamRequest(*request_headers_);
+}
+
+void CacheFilter::onCoalescedResponseProgress() {
+  if (awaited_response_ == nullptr || filter_state_ == FilterState::Destroyed) {
+    return;
+  }
+  CoalescedResponse::Update update = awaited_response_->read(*this);
+  // Once the whole response has been read, there is nothing more to wait for.
+  const CoalescedResponseSharedPtr response =
+      update.end_stream_ ? std::move(awaited_response_) : awaited_response_;
+  if (update.aborted_) {
+    if (!coalesced_) {
+      stopWaitingForCoalescedResponse();
+      return;
+    }
+    // Part of the response has already been sent downstream, so it cannot be retried.
+    awaited_response_ = nullptr;
+    decoder_callbacks_->resetStream();
+    return;
+  }
+  if (update.headers_ != nullptr) {
+    if (!response->sameVariant(config_->varyAllowList(), *request_headers_, *update.headers_)) {
+      ENVOY_STREAM_LOG(debug, "CacheFilter coalesced response is for a different variant",
+                       *decoder_callbacks_);
+      stopWaitingForCoalescedResponse();
+      return;
+    }
+    coalescing_timer_->disableTimer();
+    lookup_->onDestroy();
+    lookup_ = nullptr;
+    coalesced_ = true;
+    filter_state_ = FilterState::NotServingFromCache;
+    insert_status_ = InsertStatus::NoInsertCoalesced;
+    const bool end_stream_after_headers =
+        update.end_stream_ && update.body_ == nullptr && update.trailers_ == nullptr;
+    decoder_callbacks_->encodeHeaders(std::move(update.headers_), end_stream_after_headers,
+                                      StreamInfo::ResponseCodeDetails::get().ViaUpstream);
+    // Filter can potentially be destroyed during encodeHeaders.
+    if (filter_state_ == FilterState::Destroyed || end_stream_after_headers) {
+      return;
+    }
+  }
+  const bool end_stream_after_body = update.end_stream_ && update.trailers_ == nullptr;
+  if (update.body_ != nullptr) {
+    decoder_callbacks_->encodeData(*update.body_, end_stream_after_body);
+  } else if (end_stream_after_body) {
+    // The last chunk of the response was empty.
+    Buffer::OwnedImpl empty;
+    decoder_callbacks_->encodeData(empty, true);
+  }
+  if (filter_state_ == FilterState::Destroyed) {
+    return;
+  }
+  if (update.trailers_ != nullptr) {
+    decoder_callbacks_->encodeTrailers(std::move(update.trailers_));
+  }
+}
+
 void CacheFilter::sendNoRouteResponse() {
   decoder_callbacks_->sendLocalReply(Http::Code::NotFound, "", nullptr, absl::nullopt,
                                      "cache_no_route");
@@ -127,6 +248,9 @@ Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::RequestHeaderMap& hea
                                config_->ignoreRequestCacheControlHeader());
   request_allows_inserts_ = !lookup_request.requestCacheControl().no_store_;
   is_head_request_ = headers.getMethodValue() == Http::Headers::get().MethodValues.Head;
+  if (config_->requestCoalescer() != nullptr) {
+    coalescing_key_ = lookup_request.key();
+  }
   lookup_ = cache_->makeLookupContext(std::move(lookup_request), *decoder_callbacks_);
 
   ASSERT(lookup_);
@@ -152,6 +276,17 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     return Http::FilterHeadersStatus::Continue;
   }
 
+  if (awaited_response_ != nullptr && !coalesced_) {
+    // A local reply was generated while waiting for a coalesced response, e.g. because the
+    // downstream idle timeout fired; stop waiting.
+    coalescing_timer_->disableTimer();
+    awaited_response_->removeWatcher(*this);
+    awaited_response_ = nullptr;
+    lookup_->onDestroy();
+    lookup_ = nullptr;
+    return Http::FilterHeadersStatus::Continue;
+  }
+
   // If lookup_ is null, the request wasn't cacheable, so the response isn't either.
   if (!lookup_) {
     return Http::FilterHeadersStatus::Continue;
@@ -327,7 +462,7 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
     handleCacheHit(/* end_stream_after_headers = */ end_stream);
     return;
   case CacheEntryStatus::Unusable:
-    sendUpstreamRequest(request_headers);
+    handleCacheMiss(request_headers);
     return;
   case CacheEntryStatus::LookupError:
     filter_state_ = FilterState::NotServingFromCache;
@@ -541,6 +676,9 @@ void CacheFilter::finalizeEncodingCachedResponse() {
 }
 
 LookupStatus CacheFilter::lookupStatus() const {
+  if (coalesced_) {
+    return LookupStatus::CoalescedMiss;
+  }
   if (lookup_result_ == nullptr && lookup_ != nullptr) {
     return LookupStatus::RequestIncomplete;
   }
@@ -10,6 +10,7 @@
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 #include "source/extensions/filters/http/cache/filter_state.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/filters/http/cache/request_coalescer.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
 
 namespace Envoy {
@@ -30,6 +31,8 @@ public:
   const Http::AsyncClient::StreamOptions& upstreamOptions() const { return upstream_options_; }
   Upstream::ClusterManager& clusterManager() const { return cluster_manager_; }
   bool ignoreRequestCacheControlHeader() const { return ignore_request_cache_control_header_; }
+  // Null unless concurrent misses for the same key are to be collapsed into one upstream request.
+  const std::shared_ptr<RequestCoalescer>& requestCoalescer() const { return request_coalescer_; }
 
 private:
   const VaryAllowList vary_allow_list_;
@@ -37,12 +40,14 @@ private:
   const bool ignore_request_cache_control_header_;
   Upstream::ClusterManager& cluster_manager_;
   Http::AsyncClient::StreamOptions upstream_options_;
+  const std::shared_ptr<RequestCoalescer> request_coalescer_;
 };
 
 /**
  * A filter that caches responses and attempts to satisfy requests from cache.
  */
 class CacheFilter : public Http::PassThroughFilter,
+                    public CoalescedResponseWatcher,
                     public Logger::Loggable<Logger::Id::cache_filter>,
                     public std::enable_shared_from_this<CacheFilter> {
 public:
@@ -58,6 +63,9 @@ public:
   Http::FilterHeadersStatus encodeHeaders(Http::ResponseHeaderMap& headers,
                                           bool end_stream) override;
 
+  // CoalescedResponseWatcher
+  void onCoalescedResponseProgress() override;
+
   static LookupStatus resolveLookupStatus(absl::optional<CacheEntryStatus> cache_entry_status,
                                           FilterState filter_state);
 
@@ -66,6 +74,15 @@ private:
   // filter chain so that the request can continue even if the downstream client disconnects.
   void sendUpstreamRequest(Http::RequestHeaderMap& request_headers);
 
+  // For a cache miss that may be cacheable, either starts tracking the response so that concurrent
+  // misses for the same key can wait for it, and sends the upstream request, or waits for the
+  // response already being fetched.
+  void handleCacheMiss(Http::RequestHeaderMap& request_headers);
+
+  // Gives up on the coalesced response being waited for, e.g. because it is not for the same
+  // variant or is taking too long, and sends the request upstream instead.
+  void stopWaitingForCoalescedResponse();
+
   // In the event that there is no matching route when attempting to sendUpstreamRequest,
   // send a 404 locally.
   void sendNoRouteResponse();
@@ -143,6 +160,19 @@ private:
   LookupResultPtr lookup_result_;
   absl::optional<CacheEntryStatus> cache_entry_status_;
 
+  // The cache key of the request, if concurrent misses are being coalesced.
+  absl::optional<Key> coalescing_key_;
+  // The response this request is fetching on behalf of concurrent misses for the same key, until
+  // it is handed over to the UpstreamRequest.
+  CoalescedResponseSharedPtr filling_response_;
+  // The response fetched by another request that this request is waiting for.
+  CoalescedResponseSharedPtr awaited_response_;
+  Event::TimerPtr coalescing_timer_;
+  // The request headers, kept while waiting in case the request must be sent upstream after all.
+  Http::RequestHeaderMap* request_headers_ = nullptr;
+  // True if the response was taken from another request's upstream response.
+  bool coalesced_ = false;
+
   // Tracks what body bytes still need to be read from the cache. This is
   // currently only one Range, but will expand when full range support is added. Initialized by
   // onHeaders for Range Responses, otherwise initialized by encodeCachedResponse.
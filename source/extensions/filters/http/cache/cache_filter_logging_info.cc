@@ -27,6 +27,8 @@ absl::string_view lookupStatusToString(LookupStatus status) {
     return "RequestIncomplete";
   case LookupStatus::LookupError:
     return "LookupError";
+  case LookupStatus::CoalescedMiss:
+    return "CoalescedMiss";
   }
   IS_ENVOY_BUG(absl::StrCat("Unexpected LookupStatus: ", status));
   return "UnexpectedLookupStatus";
@@ -64,6 +66,8 @@ absl::string_view insertStatusToString(InsertStatus status) {
     return "NoInsertResponseVaryDisallowed";
   case InsertStatus::NoInsertLookupError:
     return "NoInsertLookupError";
+  case InsertStatus::NoInsertCoalesced:
+    return "NoInsertCoalesced";
   }
   IS_ENVOY_BUG(absl::StrCat("Unexpected InsertStatus: ", status));
   return "UnexpectedInsertStatus";
@@ -37,6 +37,10 @@ enum class LookupStatus {
   // The CacheFilter couldn't determine whether there was a response in cache,
   // e.g. because the cache was unreachable or the lookup RPC timed out.
   LookupError,
+  // The CacheFilter didn't find a response in cache, and served the response
+  // to a concurrent request for the same key instead of sending its own
+  // request upstream.
+  CoalescedMiss,
 };
 
 absl::string_view lookupStatusToString(LookupStatus status);
@@ -83,6 +87,9 @@ enum class InsertStatus {
   // The CacheFilter couldn't determine whether the request was in cache and
   // didn't try to insert it.
   NoInsertLookupError,
+  // The CacheFilter served the response to a concurrent request for the same
+  // key, which that request inserts.
+  NoInsertCoalesced,
 };
 
 absl::string_view insertStatusToString(InsertStatus status);
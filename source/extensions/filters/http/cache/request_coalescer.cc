@@ -0,0 +1,237 @@
+#include "source/extensions/filters/http/cache/request_coalescer.h"
+
+#include <algorithm>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/header_map_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+CoalescedResponse::CoalescedResponse(std::shared_ptr<RequestCoalescer> coalescer, Key key,
+                                     const Http::RequestHeaderMap& request_headers,
+                                     uint64_t max_retained_bytes)
+    : coalescer_(std::move(coalescer)), key_(std::move(key)),
+      request_headers_(Http::createHeaderMap<Http::RequestHeaderMapImpl>(request_headers)),
+      max_retained_bytes_(max_retained_bytes) {}
+
+CoalescedResponse::~CoalescedResponse() { coalescer_->remove(key_, this); }
+
+void CoalescedResponse::setHeaders(const Http::ResponseHeaderMap& headers, bool end_stream) {
+  {
+    absl::MutexLock lock(&mutex_);
+    ASSERT(headers_ == nullptr && !aborted_);
+    headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(headers);
+    complete_ = end_stream;
+  }
+  notifyWatchers();
+}
+
+void CoalescedResponse::addBody(const Buffer::Instance& data, bool end_stream) {
+  bool stop_joining = false;
+  {
+    absl::MutexLock lock(&mutex_);
+    ASSERT(headers_ != nullptr && !complete_ && !aborted_);
+    if (data.length() > 0) {
+      body_bytes_ += data.length();
+      if (joinable_ && (watchers_.empty() || body_bytes_ > max_retained_bytes_)) {
+        joinable_ = false;
+        stop_joining = true;
+        releaseReadChunks();
+      }
+      if (watchers_.empty()) {
+        // Nobody will read the chunk, so there is no need to copy it.
+        ++released_chunks_;
+      } else {
+        body_.push_back(std::make_shared<const std::string>(data.toString()));
+      }
+    }
+    complete_ = end_stream;
+  }
+  if (stop_joining) {
+    // Requests that miss from now on should not wait for this response.
+    coalescer_->remove(key_, this);
+  }
+  notifyWatchers();
+}
+
+void CoalescedResponse::setTrailers(const Http::ResponseTrailerMap& trailers) {
+  {
+    absl::MutexLock lock(&mutex_);
+    ASSERT(headers_ != nullptr && !complete_ && !aborted_);
+    trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(trailers);
+    complete_ = true;
+  }
+  notifyWatchers();
+}
+
+void CoalescedResponse::abort() {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (complete_ || aborted_) {
+      return;
+    }
+    aborted_ = true;
+  }
+  // Requests that miss from now on should not wait for this response.
+  coalescer_->remove(key_, this);
+  notifyWatchers();
+}
+
+void CoalescedResponse::addWatcher(Event::Dispatcher& dispatcher,
+                                   std::weak_ptr<CoalescedResponseWatcher> watcher) {
+  bool progressed;
+  {
+    absl::MutexLock lock(&mutex_);
+    const CoalescedResponseWatcher* key = watcher.lock().get();
+    ASSERT(key != nullptr && !watchers_.contains(key));
+    watchers_.emplace(key, Watcher{&dispatcher, watcher, {}});
+    progressed = headers_ != nullptr || aborted_;
+  }
+  if (progressed) {
+    dispatcher.post([watcher = std::move(watcher)]() {
+      if (auto locked = watcher.lock()) {
+        locked->onCoalescedResponseProgress();
+      }
+    });
+  }
+}
+
+void CoalescedResponse::removeWatcher(const CoalescedResponseWatcher& watcher) {
+  absl::MutexLock lock(&mutex_);
+  watchers_.erase(&watcher);
+  releaseReadChunks();
+}
+
+void CoalescedResponse::notifyWatchers() {
+  std::vector<std::pair<Event::Dispatcher*, std::weak_ptr<CoalescedResponseWatcher>>> watchers;
+  {
+    absl::MutexLock lock(&mutex_);
+    watchers.reserve(watchers_.size());
+    for (const auto& [key, watcher] : watchers_) {
+      watchers.emplace_back(watcher.dispatcher_, watcher.watcher_);
+    }
+  }
+  for (const auto& [dispatcher, watcher] : watchers) {
+    // The watcher is destroyed on its own dispatcher, so it can only be locked there.
+    dispatcher->post([watcher = watcher]() {
+      if (auto locked = watcher.lock()) {
+        locked->onCoalescedResponseProgress();
+      }
+    });
+  }
+}
+
+void CoalescedResponse::releaseReadChunks() {
+  if (joinable_) {
+    return;
+  }
+  size_t read_by_all = released_chunks_ + body_.size();
+  for (const auto& [key, watcher] : watchers_) {
+    read_by_all = std::min(read_by_all, watcher.cursor_.chunks_read_);
+  }
+  for (; released_chunks_ < read_by_all; ++released_chunks_) {
+    body_.pop_front();
+  }
+}
+
+CoalescedResponse::Update CoalescedResponse::read(const CoalescedResponseWatcher& watcher) {
+  absl::MutexLock lock(&mutex_);
+  Update update;
+  auto it = watchers_.find(&watcher);
+  if (it == watchers_.end()) {
+    return update;
+  }
+  Cursor& cursor = it->second.cursor_;
+  if (aborted_ || cursor.chunks_read_ < released_chunks_) {
+    update.aborted_ = true;
+    watchers_.erase(it);
+    releaseReadChunks();
+    return update;
+  }
+  if (headers_ == nullptr) {
+    return update;
+  }
+  // Only the waiters that are furthest behind hold back releasing chunks.
+  const bool was_furthest_behind = cursor.chunks_read_ == released_chunks_;
+  if (!cursor.headers_read_) {
+    update.headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*headers_);
+    cursor.headers_read_ = true;
+  }
+  if (cursor.chunks_read_ < released_chunks_ + body_.size()) {
+    // Reference the retained chunks rather than copying them for every waiter.
+    update.body_ = std::make_unique<Buffer::OwnedImpl>();
+    for (; cursor.chunks_read_ < released_chunks_ + body_.size(); ++cursor.chunks_read_) {
+      const std::shared_ptr<const std::string>& chunk =
+          body_[cursor.chunks_read_ - released_chunks_];
+      auto* fragment = new Buffer::BufferFragmentImpl(
+          chunk->data(), chunk->size(),
+          [chunk](const void*, size_t, const Buffer::BufferFragmentImpl* this_fragment) {
+            delete this_fragment;
+          });
+      update.body_->addBufferFragment(*fragment);
+    }
+  }
+  if (trailers_ != nullptr && !cursor.trailers_read_) {
+    update.trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*trailers_);
+    cursor.trailers_read_ = true;
+  }
+  update.end_stream_ = complete_;
+  if (complete_) {
+    watchers_.erase(it);
+  }
+  if (was_furthest_behind) {
+    releaseReadChunks();
+  }
+  return update;
+}
+
+bool CoalescedResponse::sameVariant(const VaryAllowList& vary_allow_list,
+                                    const Http::RequestHeaderMap& request_headers,
+                                    const Http::ResponseHeaderMap& response_headers) const {
+  if (!VaryHeaderUtils::hasVary(response_headers)) {
+    return true;
+  }
+  const absl::btree_set<absl::string_view> vary_header_values =
+      VaryHeaderUtils::getVaryValues(response_headers);
+  const absl::optional<std::string> variant =
+      VaryHeaderUtils::createVaryIdentifier(vary_allow_list, vary_header_values, request_headers);
+  return variant.has_value() &&
+         variant == VaryHeaderUtils::createVaryIdentifier(vary_allow_list, vary_header_values,
+                                                          *request_headers_);
+}
+
+std::pair<CoalescedResponseSharedPtr, bool>
+RequestCoalescer::getOrCreate(const Key& key, const Http::RequestHeaderMap& request_headers) {
+  absl::MutexLock lock(&mutex_);
+  std::weak_ptr<CoalescedResponse>& slot = responses_[key];
+  if (CoalescedResponseSharedPtr existing = slot.lock()) {
+    return {std::move(existing), false};
+  }
+  auto response = std::make_shared<CoalescedResponse>(shared_from_this(), key, request_headers,
+                                                      max_retained_bytes_);
+  slot = response;
+  return {std::move(response), true};
+}
+
+void RequestCoalescer::remove(const Key& key, const CoalescedResponse* response) {
+  // Declared outside the lock, as dropping what may be the last reference to another
+  // response destroys it, which calls back into remove().
+  CoalescedResponseSharedPtr current;
+  absl::MutexLock lock(&mutex_);
+  auto it = responses_.find(key);
+  if (it == responses_.end()) {
+    return;
+  }
+  current = it->second.lock();
+  if (current == nullptr || current.get() == response) {
+    responses_.erase(it);
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/header_map.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/filters/http/cache/cache_headers_utils.h"
+#include "source/extensions/filters/http/cache/http_cache.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+class RequestCoalescer;
+
+/**
+ * Notified, on its own dispatcher, when a CoalescedResponse it waits on has progressed.
+ */
+class CoalescedResponseWatcher {
+public:
+  virtual ~CoalescedResponseWatcher() = default;
+  virtual void onCoalescedResponseProgress() PURE;
+};
+
+/**
+ * A cacheable response that is being fetched from upstream by one request, the filler, and
+ * streamed to any number of requests for the same key that missed the cache while it was in
+ * flight, the waiters. The filler and the waiters may be on different workers: the filler
+ * publishes the response as it arrives, and each waiter reads what it has not seen yet on
+ * its own thread when notified.
+ *
+ * Body chunks are copied only while there are waiters, and shared between them rather than copied
+ * for each of them. Up to a limit, the body is retained from its start, so that waiters that arrive
+ * late still receive all of it. Past the limit, or once a chunk arrives while there are no waiters,
+ * the response stops taking new waiters and chunks are released as soon as every waiter has read
+ * them.
+ */
+class CoalescedResponse {
+public:
+  // The part of the response a waiter had not read yet.
+  struct Update {
+    Http::ResponseHeaderMapPtr headers_;
+    Buffer::InstancePtr body_;
+    Http::ResponseTrailerMapPtr trailers_;
+    // True if the update includes the end of the response.
+    bool end_stream_ = false;
+    // True if the response will not be completed for the waiter, e.g. because the upstream
+    // request was reset, because it turned out not to be cacheable and so cannot be shared, or
+    // because the waiter arrived after the start of the body was released.
+    bool aborted_ = false;
+  };
+
+  CoalescedResponse(std::shared_ptr<RequestCoalescer> coalescer, Key key,
+                    const Http::RequestHeaderMap& request_headers, uint64_t max_retained_bytes);
+  ~CoalescedResponse();
+
+  // Called by the filler as the response arrives.
+  void setHeaders(const Http::ResponseHeaderMap& headers, bool end_stream);
+  void addBody(const Buffer::Instance& data, bool end_stream);
+  void setTrailers(const Http::ResponseTrailerMap& trailers);
+  // Called by the filler if the response will not be completed. Does nothing if it has been.
+  void abort();
+
+  /**
+   * Registers a waiter to be notified on the given dispatcher whenever the response progresses,
+   * including immediately if it already has.
+   */
+  void addWatcher(Event::Dispatcher& dispatcher, std::weak_ptr<CoalescedResponseWatcher> watcher);
+
+  /**
+   * Unregisters a waiter that gives up on the response, so that body chunks are no longer retained
+   * for it. Waiters that read the end of the response, or that it was aborted, are unregistered
+   * by read().
+   */
+  void removeWatcher(const CoalescedResponseWatcher& watcher);
+
+  /**
+   * @return what the waiter has not read yet, which is nothing if it is not registered.
+   */
+  Update read(const CoalescedResponseWatcher& watcher);
+
+  /**
+   * @return true if response headers with a vary header select the same variant for the
+   *         waiter's request as for the filler's.
+   */
+  bool sameVariant(const VaryAllowList& vary_allow_list,
+                   const Http::RequestHeaderMap& request_headers,
+                   const Http::ResponseHeaderMap& response_headers) const;
+
+private:
+  // How far a waiter has read the response.
+  struct Cursor {
+    bool headers_read_ = false;
+    size_t chunks_read_ = 0;
+    bool trailers_read_ = false;
+  };
+
+  struct Watcher {
+    Event::Dispatcher* dispatcher_;
+    std::weak_ptr<CoalescedResponseWatcher> watcher_;
+    Cursor cursor_;
+  };
+
+  void notifyWatchers() ABSL_LOCKS_EXCLUDED(mutex_);
+  // Releases the chunks every waiter has read, unless new waiters may still join.
+  void releaseReadChunks() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const std::shared_ptr<RequestCoalescer> coalescer_;
+  const Key key_;
+  // Immutable after construction, so may be read without the lock.
+  const Http::RequestHeaderMapPtr request_headers_;
+  const uint64_t max_retained_bytes_;
+
+  absl::Mutex mutex_;
+  Http::ResponseHeaderMapPtr headers_ ABSL_GUARDED_BY(mutex_);
+  // The chunks of the body that have not been released, which are all but the first
+  // released_chunks_.
+  std::deque<std::shared_ptr<const std::string>> body_ ABSL_GUARDED_BY(mutex_);
+  size_t released_chunks_ ABSL_GUARDED_BY(mutex_) = 0;
+  uint64_t body_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  Http::ResponseTrailerMapPtr trailers_ ABSL_GUARDED_BY(mutex_);
+  bool complete_ ABSL_GUARDED_BY(mutex_) = false;
+  bool aborted_ ABSL_GUARDED_BY(mutex_) = false;
+  // False once waiters that arrive now could not be given the whole body.
+  bool joinable_ ABSL_GUARDED_BY(mutex_) = true;
+  absl::flat_hash_map<const CoalescedResponseWatcher*, Watcher> watchers_ ABSL_GUARDED_BY(mutex_);
+};
+
+using CoalescedResponseSharedPtr = std::shared_ptr<CoalescedResponse>;
+
+/**
+ * Tracks the responses being fetched for cache misses, so that concurrent misses for the same
+ * key, on any worker, can wait for one upstream request instead of each sending their own.
+ * Shared by all workers using the same filter config.
+ */
+class RequestCoalescer : public std::enable_shared_from_this<RequestCoalescer> {
+public:
+  RequestCoalescer(std::chrono::milliseconds timeout, uint64_t max_retained_bytes)
+      : timeout_(timeout), max_retained_bytes_(max_retained_bytes) {}
+
+  /**
+   * Returns the response already being fetched for the key, or starts tracking a new one,
+   * which the caller must then fill.
+   * @param key the key of the request that missed the cache.
+   * @param request_headers the headers of the request, used to match vary headers.
+   * @return the response, and true if the caller is its filler.
+   */
+  std::pair<CoalescedResponseSharedPtr, bool>
+  getOrCreate(const Key& key, const Http::RequestHeaderMap& request_headers);
+
+  // How long a waiter waits for the response headers before sending its own request upstream.
+  std::chrono::milliseconds timeout() const { return timeout_; }
+
+private:
+  friend class CoalescedResponse;
+
+  // Stops tracking the response for the key, if it is the given one or has been destroyed.
+  void remove(const Key& key, const CoalescedResponse* response);
+
+  const std::chrono::milliseconds timeout_;
+  const uint64_t max_retained_bytes_;
+  absl::Mutex mutex_;
+  // Responses are owned by their filler and waiters, and remove themselves when destroyed.
+  absl::flat_hash_map<Key, std::weak_ptr<CoalescedResponse>, MessageUtil, MessageUtil>
+      responses_ ABSL_GUARDED_BY(mutex_);
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -129,7 +129,8 @@ UpstreamRequest::UpstreamRequest(CacheFilter* filter, LookupContextPtr lookup,
       is_head_request_(filter->is_head_request_),
       request_allows_inserts_(filter->request_allows_inserts_), config_(filter->config_),
       filter_state_(filter->filter_state_), cache_(std::move(cache)),
-      stream_(async_client.start(*this, options)) {
+      stream_(async_client.start(*this, options)),
+      coalesced_response_(std::move(filter->filling_response_)) {
   ASSERT(stream_ != nullptr);
 }
 
@@ -165,6 +166,10 @@ UpstreamRequest::~UpstreamRequest() {
   if (filter_ != nullptr) {
     filter_->onUpstreamRequestReset();
   }
+  if (coalesced_response_ != nullptr) {
+    // Does nothing if the whole response was received.
+    coalesced_response_->abort();
+  }
   if (lookup_) {
     lookup_->onDestroy();
     lookup_ = nullptr;
@@ -224,8 +229,16 @@ void UpstreamRequest::onHeaders(Http::ResponseHeaderMapPtr&& headers, bool end_s
         setInsertStatus(InsertStatus::InsertSucceeded);
       }
     }
+    if (coalesced_response_ != nullptr) {
+      coalesced_response_->setHeaders(*headers, end_stream);
+    }
   } else {
     setInsertStatus(InsertStatus::NoInsertResponseNotCacheable);
+    if (coalesced_response_ != nullptr) {
+      // Requests waiting for this response must send their own upstream requests.
+      coalesced_response_->abort();
+      coalesced_response_ = nullptr;
+    }
   }
   setFilterState(FilterState::NotServingFromCache);
   if (filter_) {
@@ -238,6 +251,9 @@ void UpstreamRequest::onData(Buffer::Instance& body, bool end_stream) {
   if (insert_queue_ != nullptr) {
     insert_queue_->insertBody(body, end_stream);
   }
+  if (coalesced_response_ != nullptr) {
+    coalesced_response_->addBody(body, end_stream);
+  }
   if (filter_) {
     ENVOY_STREAM_LOG(debug, "UpstreamRequest::onData inserted body", *filter_->decoder_callbacks_);
     filter_->decoder_callbacks_->encodeData(body, end_stream);
@@ -256,6 +272,9 @@ void UpstreamRequest::onTrailers(Http::ResponseTrailerMapPtr&& trailers) {
   if (insert_queue_ != nullptr) {
     insert_queue_->insertTrailers(*trailers);
   }
+  if (coalesced_response_ != nullptr) {
+    coalesced_response_->setTrailers(*trailers);
+  }
   if (filter_ != nullptr) {
     ENVOY_STREAM_LOG(debug, "UpstreamRequest::onTrailers inserting trailers",
                      *filter_->decoder_callbacks_);
@@ -3,6 +3,7 @@
 #include "source/common/common/logger.h"
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
 #include "source/extensions/filters/http/cache/cache_insert_queue.h"
+#include "source/extensions/filters/http/cache/request_coalescer.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -76,6 +77,9 @@ private:
   std::shared_ptr<HttpCache> cache_;
   Http::AsyncClient::Stream* stream_ = nullptr;
   std::unique_ptr<CacheInsertQueue> insert_queue_;
+  // Set if concurrent misses for the same key are waiting for this response; the response is
+  // published to them as it arrives, as long as it is cacheable.
+  CoalescedResponseSharedPtr coalesced_response_;
 };
 
 } // namespace Cache
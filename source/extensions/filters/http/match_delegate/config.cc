@@ -73,6 +73,7 @@ struct DelegatingFactoryCallbacks : public Envoy::Http::FilterChainFactoryCallba
       : delegated_callbacks_(delegated_callbacks), match_tree_(match_tree) {}
 
   Event::Dispatcher& dispatcher() override { return delegated_callbacks_.dispatcher(); }
+  OptRef<Arena> streamArena() override { return delegated_callbacks_.streamArena(); }
   void addStreamDecoderFilter(Envoy::Http::StreamDecoderFilterSharedPtr filter) override {
     auto delegating_filter =
         std::make_shared<DelegatingStreamFilter>(match_tree_, std::move(filter), nullptr);
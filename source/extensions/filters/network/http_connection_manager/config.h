@@ -274,6 +274,7 @@ public:
   bool addProxyProtocolConnectionState() const override {
     return add_proxy_protocol_connection_state_;
   }
+  uint32_t streamArenaBlockSize() const override { return stream_arena_block_size_; }
 
 private:
   enum class CodecType { HTTP1, HTTP2, HTTP3, AUTO };
@@ -370,6 +371,7 @@ private:
   const bool append_local_overload_;
   const bool append_x_forwarded_port_;
   const bool add_proxy_protocol_connection_state_;
+  const uint32_t stream_arena_block_size_;
 };
 
 /**
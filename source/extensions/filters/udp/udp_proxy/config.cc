@@ -111,6 +111,8 @@ UdpProxyFilterConfigImpl::UdpProxyFilterConfigImpl(
       stats_(generateStats(config.stat_prefix(), context.scope())),
       // Default prefer_gro to true for upstream client traffic.
       upstream_socket_config_(config.upstream_socket_config(), true),
+      upstream_write_batch_size_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, upstream_write_batch_size, 1)),
       udp_session_filter_config_provider_manager_(
           createSingletonUdpSessionFilterConfigProviderManager(context.serverFactoryContext())),
       random_generator_(context.serverFactoryContext().api().randomGenerator()) {
@@ -141,6 +141,7 @@ public:
   const Network::ResolvedUdpSocketConfig& upstreamSocketConfig() const override {
     return upstream_socket_config_;
   }
+  uint32_t upstreamWriteBatchSize() const override { return upstream_write_batch_size_; }
   const AccessLog::InstanceSharedPtrVector& sessionAccessLogs() const override {
     return session_access_logs_;
   }
@@ -178,7 +179,8 @@ private:
                                                Stats::Scope& scope) {
     const auto final_prefix = absl::StrCat("udp.", stat_prefix);
     return {ALL_UDP_PROXY_DOWNSTREAM_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
-                                           POOL_GAUGE_PREFIX(scope, final_prefix))};
+                                           POOL_GAUGE_PREFIX(scope, final_prefix),
+                                           POOL_HISTOGRAM_PREFIX(scope, final_prefix))};
   }
 
   std::shared_ptr<UdpSessionFilterConfigProviderManager>
@@ -196,6 +198,7 @@ private:
   std::unique_ptr<const HashPolicyImpl> hash_policy_;
   mutable UdpProxyDownstreamStats stats_;
   const Network::ResolvedUdpSocketConfig upstream_socket_config_;
+  const uint32_t upstream_write_batch_size_;
   AccessLog::InstanceSharedPtrVector session_access_logs_;
   AccessLog::InstanceSharedPtrVector proxy_access_logs_;
   UdpTunnelingConfigPtr tunneling_config_;
@@ -4,6 +4,9 @@
 
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/network/socket_option_factory.h"
+#include "source/common/runtime/runtime_features.h"
+
+#include "absl/container/fixed_array.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -527,6 +530,52 @@ void UdpProxyFilter::UdpActiveSession::writeUpstream(Network::UdpRecvData& data)
   }
   ASSERT(cluster_);
 
+  if (!connectUpstream()) {
+    return;
+  }
+
+  const uint64_t tx_buffer_length = data.buffer_->length();
+  const uint32_t batch_size = filter_.config_->upstreamWriteBatchSize();
+  if (batch_size > 1) {
+    ENVOY_LOG(trace, "buffering {} byte datagram for upstream: downstream={} local={} upstream={}",
+              tx_buffer_length, addresses_.peer_->asStringView(),
+              addresses_.local_->asStringView(), host_->address()->asStringView());
+    // The slices are moved rather than the buffer since callers may still reference it.
+    auto datagram = std::make_unique<Buffer::OwnedImpl>();
+    datagram->move(*data.buffer_);
+    pending_upstream_datagrams_.push_back(std::move(datagram));
+    if (pending_upstream_datagrams_.size() >= batch_size) {
+      flushUpstream();
+      return;
+    }
+    if (flush_upstream_cb_ == nullptr) {
+      flush_upstream_cb_ =
+          filter_.read_callbacks_->udpListener().dispatcher().createSchedulableCallback(
+              [this]() { flushUpstream(); });
+    }
+    if (!flush_upstream_cb_->enabled()) {
+      flush_upstream_cb_->scheduleCallbackCurrentIteration();
+    }
+    return;
+  }
+
+  ENVOY_LOG(trace, "writing {} byte datagram upstream: downstream={} local={} upstream={}",
+            tx_buffer_length, addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
+            host_->address()->asStringView());
+
+  const Network::Address::Ip* local_ip = use_original_src_ip_ ? addresses_.peer_->ip() : nullptr;
+  Api::IoCallUint64Result rc = Network::Utility::writeToSocket(
+      udp_socket_->ioHandle(), *data.buffer_, local_ip, *host_->address());
+
+  if (!rc.ok()) {
+    cluster_->cluster_stats_.sess_tx_errors_.inc();
+  } else {
+    cluster_->cluster_stats_.sess_tx_datagrams_.inc();
+    cluster_->cluster_info_->trafficStats()->upstream_cx_tx_bytes_total_.add(tx_buffer_length);
+  }
+}
+
+bool UdpProxyFilter::UdpActiveSession::connectUpstream() {
   // NOTE: On the first write, a local ephemeral port is bound, and thus this write can fail due to
   //       port exhaustion. To avoid exhaustion, UDP sockets will be connected and associated with
   //       a 4-tuple including the local IP, and the UDP port may be reused for multiple
@@ -540,29 +589,62 @@ void UdpProxyFilter::UdpActiveSession::writeUpstream(Network::UdpRecvData& data)
     if (SOCKET_FAILURE(rc.return_value_)) {
       ENVOY_LOG(debug, "cannot connect: ({}) {}", rc.errno_, errorDetails(rc.errno_));
       cluster_->cluster_stats_.sess_tx_errors_.inc();
-      return;
+      return false;
     }
 
     connected_ = true;
   }
 
   ASSERT((connected_ || use_original_src_ip_) && udp_socket_ && host_);
+  return true;
+}
 
-  const uint64_t tx_buffer_length = data.buffer_->length();
-  ENVOY_LOG(trace, "writing {} byte datagram upstream: downstream={} local={} upstream={}",
-            tx_buffer_length, addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
+void UdpProxyFilter::UdpActiveSession::flushUpstream() {
+  if (flush_upstream_cb_ != nullptr) {
+    flush_upstream_cb_->cancel();
+  }
+  const size_t num_datagrams = pending_upstream_datagrams_.size();
+  if (num_datagrams == 0) {
+    return;
+  }
+
+  absl::FixedArray<Buffer::RawSlice> datagrams(num_datagrams);
+  for (size_t i = 0; i < num_datagrams; i++) {
+    const uint64_t length = pending_upstream_datagrams_[i]->length();
+    datagrams[i] = {pending_upstream_datagrams_[i]->linearize(length), length};
+  }
+  ENVOY_LOG(trace, "writing {} datagrams upstream: downstream={} local={} upstream={}",
+            num_datagrams, addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host_->address()->asStringView());
 
   const Network::Address::Ip* local_ip = use_original_src_ip_ ? addresses_.peer_->ip() : nullptr;
-  Api::IoCallUint64Result rc = Network::Utility::writeToSocket(
-      udp_socket_->ioHandle(), *data.buffer_, local_ip, *host_->address());
+  size_t num_sent = 0;
+  while (num_sent < num_datagrams) {
+    Api::IoCallUint64Result rc = udp_socket_->ioHandle().sendmmsg(
+        &datagrams[num_sent], num_datagrams - num_sent, 0, local_ip, *host_->address());
+    if (!rc.ok() && rc.err_->getErrorCode() != Api::IoError::IoErrorCode::Again) {
+      // Only the first datagram was rejected, e.g. for being larger than the path MTU; the rest
+      // may still be sent.
+      cluster_->cluster_stats_.sess_tx_errors_.inc();
+      ++num_sent;
+      continue;
+    }
+    if (!rc.ok() || rc.return_value_ == 0) {
+      // Like single writes, datagrams that can't be written right away are dropped.
+      cluster_->cluster_stats_.sess_tx_errors_.add(num_datagrams - num_sent);
+      break;
+    }
 
-  if (!rc.ok()) {
-    cluster_->cluster_stats_.sess_tx_errors_.inc();
-  } else {
-    cluster_->cluster_stats_.sess_tx_datagrams_.inc();
-    cluster_->cluster_info_->trafficStats()->upstream_cx_tx_bytes_total_.add(tx_buffer_length);
+    filter_.config_->stats().upstream_tx_batch_size_.recordValue(rc.return_value_);
+    uint64_t tx_bytes = 0;
+    for (size_t i = num_sent; i < num_sent + rc.return_value_; i++) {
+      tx_bytes += datagrams[i].len_;
+    }
+    cluster_->cluster_stats_.sess_tx_datagrams_.add(rc.return_value_);
+    cluster_->cluster_info_->trafficStats()->upstream_cx_tx_bytes_total_.add(tx_bytes);
+    num_sent += rc.return_value_;
   }
+  pending_upstream_datagrams_.clear();
 }
 
 bool UdpProxyFilter::ActiveSession::onContinueFilterChain(ActiveReadFilter* filter) {
@@ -654,6 +736,19 @@ void UdpProxyFilter::UdpActiveSession::createUdpSocket(const Upstream::HostConst
               addresses_.peer_->asStringView());
   }
 
+  if (filter_.config_->upstreamSocketConfig().prefer_gro_ &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.udp_proxy_upstream_gro") &&
+      Api::OsSysCallsSingleton::get().supportsUdpGro()) {
+    // Let the kernel coalesce datagrams from the upstream host, which are split up again when
+    // read. Without the option, reads with GRO only ever return a single datagram.
+    if (!Network::Socket::applyOptions(Network::SocketOptionFactory::buildUdpGroOptions(),
+                                       *udp_socket_,
+                                       envoy::config::core::v3::SocketOption::STATE_BOUND)) {
+      ENVOY_LOG(debug, "cannot enable GRO on the upstream socket: downstream={} upstream={}",
+                addresses_.peer_->asStringView(), host->address()->asStringView());
+    }
+  }
+
   // TODO(mattklein123): Enable dropped packets socket option. In general the Socket abstraction
   // does not work well right now for client sockets. It's too heavy weight and is aimed at listener
   // sockets. We need to figure out how to either refactor Socket into something that works better
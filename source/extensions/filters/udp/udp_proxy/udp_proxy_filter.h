@@ -43,7 +43,7 @@ namespace UdpProxy {
 /**
  * All UDP proxy downstream stats. @see stats_macros.h
  */
-#define ALL_UDP_PROXY_DOWNSTREAM_STATS(COUNTER, GAUGE)                                             \
+#define ALL_UDP_PROXY_DOWNSTREAM_STATS(COUNTER, GAUGE, HISTOGRAM)                                  \
   COUNTER(downstream_sess_no_route)                                                                \
   COUNTER(downstream_sess_rx_bytes)                                                                \
   COUNTER(downstream_sess_rx_datagrams)                                                            \
@@ -54,13 +54,15 @@ namespace UdpProxy {
   COUNTER(downstream_sess_tx_errors)                                                               \
   COUNTER(idle_timeout)                                                                            \
   COUNTER(session_filter_config_missing)                                                           \
-  GAUGE(downstream_sess_active, Accumulate)
+  GAUGE(downstream_sess_active, Accumulate)                                                        \
+  HISTOGRAM(upstream_tx_batch_size, Unspecified)
 
 /**
  * Struct definition for all UDP proxy downstream stats. @see stats_macros.h
  */
 struct UdpProxyDownstreamStats {
-  ALL_UDP_PROXY_DOWNSTREAM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  ALL_UDP_PROXY_DOWNSTREAM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                                 GENERATE_HISTOGRAM_STRUCT)
 };
 
 /**
@@ -131,6 +133,7 @@ public:
   virtual UdpProxyDownstreamStats& stats() const PURE;
   virtual TimeSource& timeSource() const PURE;
   virtual const Network::ResolvedUdpSocketConfig& upstreamSocketConfig() const PURE;
+  virtual uint32_t upstreamWriteBatchSize() const PURE;
   virtual const AccessLog::InstanceSharedPtrVector& sessionAccessLogs() const PURE;
   virtual const AccessLog::InstanceSharedPtrVector& proxyAccessLogs() const PURE;
   virtual const UdpSessionFilterChainFactory& sessionFilterFactory() const PURE;
@@ -718,6 +721,8 @@ protected:
   private:
     void onReadReady();
     void createUdpSocket(const Upstream::HostConstSharedPtr& host);
+    bool connectUpstream();
+    void flushUpstream();
 
     // The socket is used for writing packets to the selected upstream host as well as receiving
     // packets from the upstream host. Note that a a local ephemeral port is bound on the first
@@ -726,6 +731,10 @@ protected:
     // The socket has been connected to avoid port exhaustion.
     bool connected_{};
     const bool use_original_src_ip_;
+    // Datagrams waiting to be written upstream together, at the end of the current event loop
+    // iteration or once a full batch is buffered.
+    std::vector<Buffer::InstancePtr> pending_upstream_datagrams_;
+    Event::SchedulableCallbackPtr flush_upstream_cb_;
   };
 
   /**
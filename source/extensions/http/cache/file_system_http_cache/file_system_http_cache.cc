@@ -21,6 +21,11 @@ namespace FileSystemHttpCache {
 // memory usage. Since UpdateHeaders is unlikely to be a common operation it is most likely
 // not worthwhile to carefully tune this.
 const size_t FileSystemHttpCache::max_update_headers_copy_chunk_size_ = 128 * 1024;
+// Per chunk, reading the file with pread took 2.4us at 16K, 19us at 128K and 34us at 256K, while
+// dup, mmap with MAP_POPULATE, munmap and close took 7.6us, 18us and 14us, with the file in the
+// page cache on a single CPU. On a multi-core worker the munmap also costs a TLB shootdown, so
+// the threshold is set above the break-even point.
+const size_t FileSystemHttpCache::min_file_backed_body_chunk_size_ = 256 * 1024;
 
 const CacheStats& FileSystemHttpCache::stats() const { return shared_->stats_; }
 const ConfigProto& FileSystemHttpCache::config() const { return shared_->config_; }
@@ -184,6 +184,11 @@ public:
   // is totally irrelevant to the outward-facing API.
   static const size_t max_update_headers_copy_chunk_size_;
 
+  // With serve_body_from_file, body chunks smaller than this are still read into memory, as
+  // duplicating the descriptor and mapping and unmapping the range cost more than copying a
+  // small chunk.
+  static const size_t min_file_backed_body_chunk_size_;
+
   using PostEvictionCallback = std::function<void(uint64_t size_bytes, uint64_t count)>;
 
   // Waits for all queued actions to be completed.
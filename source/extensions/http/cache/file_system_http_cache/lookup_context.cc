@@ -138,21 +138,29 @@ void FileLookupContext::getBody(const AdjustedByteRange& range, LookupBodyCallba
   ASSERT(cb);
   ASSERT(!cancel_action_in_flight_);
   ASSERT(file_handle_);
-  auto queued = file_handle_->read(
-      dispatcher(), header_block_.offsetToBody() + range.begin(), range.length(),
-      [this, cb = std::move(cb), range](absl::StatusOr<Buffer::InstancePtr> read_result) mutable {
-        ASSERT(dispatcher()->isThreadSafe());
-        cancel_action_in_flight_ = nullptr;
-        if (!read_result.ok() || read_result.value()->length() != range.length()) {
-          invalidateCacheEntry();
-          // Calling callback with nullptr fails the request.
-          std::move(cb)(nullptr, /* end_stream (ignored) = */ false);
-          return;
-        }
-        std::move(cb)(std::move(read_result.value()),
-                      /* end_stream = */ range.end() == header_block_.bodySize() &&
-                          header_block_.trailerSize() == 0);
-      });
+  auto on_read = [this, cb = std::move(cb),
+                  range](absl::StatusOr<Buffer::InstancePtr> read_result) mutable {
+    ASSERT(dispatcher()->isThreadSafe());
+    cancel_action_in_flight_ = nullptr;
+    if (!read_result.ok() || read_result.value()->length() != range.length()) {
+      invalidateCacheEntry();
+      // Calling callback with nullptr fails the request.
+      std::move(cb)(nullptr, /* end_stream (ignored) = */ false);
+      return;
+    }
+    std::move(cb)(std::move(read_result.value()),
+                  /* end_stream = */ range.end() == header_block_.bodySize() &&
+                      header_block_.trailerSize() == 0);
+  };
+  const off_t offset = header_block_.offsetToBody() + range.begin();
+  absl::StatusOr<CancelFunction> queued;
+  if (cache_.config().serve_body_from_file() &&
+      range.length() >= FileSystemHttpCache::min_file_backed_body_chunk_size_) {
+    // The chunk refers to the cache file, so it can be sent to the client straight from the file.
+    queued = file_handle_->readFileBacked(dispatcher(), offset, range.length(), std::move(on_read));
+  } else {
+    queued = file_handle_->read(dispatcher(), offset, range.length(), std::move(on_read));
+  }
   ASSERT(queued.ok(), queued.status().ToString());
   cancel_action_in_flight_ = std::move(queued.value());
 }
@@ -0,0 +1,77 @@
+#include "source/extensions/http/cache/memory_http_cache/frequency_sketch.h"
+
+#include <algorithm>
+
+#include "absl/numeric/bits.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+namespace {
+
+// One odd multiplier per row of the sketch, so that each row spreads keys differently.
+constexpr uint64_t RowSeeds[] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL,
+                                 0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL};
+constexpr uint32_t Rows = sizeof(RowSeeds) / sizeof(RowSeeds[0]);
+
+// Clears the bit that would be shifted into the top of each 4-bit counter when halving.
+constexpr uint64_t HalveMask = 0x7777777777777777ULL;
+
+// The bit offset within a word of the counter for the given row.
+uint32_t counterOffset(uint64_t hash, uint32_t row) {
+  // Each key uses a group of four consecutive counters, chosen by the low bits of its hash.
+  const uint32_t start = (hash & 3) << 2;
+  return (start + row) << 2;
+}
+
+} // namespace
+
+FrequencySketch::FrequencySketch(uint64_t expected_entries)
+    : table_(absl::bit_ceil(std::max<uint64_t>(expected_entries, 16))), mask_(table_.size() - 1),
+      sample_size_(10 * table_.size()) {}
+
+uint64_t FrequencySketch::wordIndex(uint64_t hash, uint32_t row) const {
+  uint64_t h = (hash + RowSeeds[row]) * RowSeeds[row];
+  h += h >> 32;
+  return h & mask_;
+}
+
+void FrequencySketch::increment(uint64_t hash) {
+  bool incremented = false;
+  for (uint32_t row = 0; row < Rows; ++row) {
+    uint64_t& word = table_[wordIndex(hash, row)];
+    const uint32_t offset = counterOffset(hash, row);
+    if (((word >> offset) & MaxFrequency) != MaxFrequency) {
+      word += uint64_t{1} << offset;
+      incremented = true;
+    }
+  }
+  if (incremented && ++increments_ >= sample_size_) {
+    halve();
+  }
+}
+
+uint32_t FrequencySketch::frequency(uint64_t hash) const {
+  uint32_t frequency = MaxFrequency;
+  for (uint32_t row = 0; row < Rows; ++row) {
+    const uint64_t word = table_[wordIndex(hash, row)];
+    frequency =
+        std::min<uint32_t>(frequency, (word >> counterOffset(hash, row)) & MaxFrequency);
+  }
+  return frequency;
+}
+
+void FrequencySketch::halve() {
+  for (uint64_t& word : table_) {
+    word = (word >> 1) & HalveMask;
+  }
+  increments_ /= 2;
+}
+
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+
+/**
+ * A count-min sketch of 4-bit saturating counters, which estimates how often a key has been
+ * requested recently. This is the frequency filter of TinyLFU admission
+ * (https://arxiv.org/abs/1512.00727): a new cache entry is only admitted in place of an
+ * existing one if it is estimated to be more popular.
+ *
+ * Every 16 counters share a 64-bit word, and each key maps to one counter in each of four words.
+ * Once the number of recorded increments reaches ten times the number of counters per row, all
+ * counters are halved, so that the estimates age and favour recent popularity.
+ *
+ * Not thread safe.
+ */
+class FrequencySketch {
+public:
+  /**
+   * @param expected_entries the number of distinct keys the sketch is expected to track. This
+   *        determines the size of the sketch, at 8 bytes per expected entry rounded up to a
+   *        power of two.
+   */
+  explicit FrequencySketch(uint64_t expected_entries);
+
+  /**
+   * Records an occurrence of the key with the given hash.
+   */
+  void increment(uint64_t hash);
+
+  /**
+   * @return the estimated number of recent occurrences of the key with the given hash, at most 15.
+   */
+  uint32_t frequency(uint64_t hash) const;
+
+  static constexpr uint32_t MaxFrequency = 15;
+
+private:
+  uint64_t wordIndex(uint64_t hash, uint32_t row) const;
+  void halve();
+
+  std::vector<uint64_t> table_;
+  const uint64_t mask_;
+  const uint64_t sample_size_;
+  uint64_t increments_{0};
+};
+
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
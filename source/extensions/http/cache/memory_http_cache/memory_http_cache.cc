@@ -0,0 +1,495 @@
+#include "source/extensions/http/cache/memory_http_cache/memory_http_cache.h"
+
+#include <algorithm>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/str_join.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+namespace {
+
+constexpr uint32_t DefaultShards = 16;
+
+// Used to size the frequency sketch of a shard from its byte budget. Overestimating the
+// number of entries only costs memory; underestimating it makes the estimates noisier.
+constexpr uint64_t ExpectedEntrySizeBytes = 4096;
+
+// Returns a Key with the vary header added to custom_fields.
+// It is an error to call this with headers that don't include vary.
+// Returns nullopt if the vary headers in the response are not
+// compatible with the VaryAllowList in the LookupRequest.
+absl::optional<Key> variedRequestKey(const LookupRequest& request,
+                                     const Http::ResponseHeaderMap& response_headers) {
+  absl::btree_set<absl::string_view> vary_header_values =
+      VaryHeaderUtils::getVaryValues(response_headers);
+  ASSERT(!vary_header_values.empty());
+  const absl::optional<std::string> vary_identifier = VaryHeaderUtils::createVaryIdentifier(
+      request.varyAllowList(), vary_header_values, request.requestHeaders());
+  if (!vary_identifier.has_value()) {
+    return absl::nullopt;
+  }
+  Key varied_request_key = request.key();
+  varied_request_key.add_custom_fields(vary_identifier.value());
+  return varied_request_key;
+}
+
+// Copies the headers and trailers of an entry, which the filter may modify, and shares its body.
+Entry copyEntry(const Entry& entry) {
+  Http::ResponseTrailerMapPtr trailers;
+  if (entry.trailers_) {
+    trailers = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*entry.trailers_);
+  }
+  return Entry{Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*entry.response_headers_),
+               entry.metadata_, entry.body_, std::move(trailers)};
+}
+
+// The number of bytes an entry is charged against the budget of its shard.
+uint64_t entrySize(const Key& key, const Entry& entry) {
+  return key.ByteSizeLong() + entry.response_headers_->byteSize() +
+         (entry.body_ ? entry.body_->size() : 0) +
+         (entry.trailers_ ? entry.trailers_->byteSize() : 0);
+}
+
+class MemoryLookupContext : public LookupContext {
+public:
+  MemoryLookupContext(Event::Dispatcher& dispatcher, MemoryHttpCache& cache,
+                      LookupRequest&& request)
+      : dispatcher_(dispatcher), cache_(cache), request_(std::move(request)) {}
+
+  void getHeaders(LookupHeadersCallback&& cb) override {
+    Entry entry = cache_.lookup(request_);
+    body_ = std::move(entry.body_);
+    trailers_ = std::move(entry.trailers_);
+    const uint64_t body_size = body_ ? body_->size() : 0;
+    LookupResult result = entry.response_headers_
+                              ? request_.makeLookupResult(std::move(entry.response_headers_),
+                                                          std::move(entry.metadata_), body_size)
+                              : LookupResult{};
+    bool end_stream = body_size == 0 && trailers_ == nullptr;
+    dispatcher_.post([result = std::move(result), cb = std::move(cb), end_stream,
+                      cancelled = cancelled_]() mutable {
+      if (!*cancelled) {
+        std::move(cb)(std::move(result), end_stream);
+      }
+    });
+  }
+
+  void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
+    ASSERT(body_ != nullptr && range.end() <= body_->length(), "Attempt to read past end of body.");
+    // The buffer references the cached body rather than copying it. The fragment keeps the body
+    // alive until the buffer is drained, even if the entry is evicted in the meantime.
+    auto result = std::make_unique<Buffer::OwnedImpl>();
+    auto* fragment = new Buffer::BufferFragmentImpl(
+        body_->data() + range.begin(), range.length(),
+        [body = body_](const void*, size_t, const Buffer::BufferFragmentImpl* this_fragment) {
+          delete this_fragment;
+        });
+    result->addBufferFragment(*fragment);
+    bool end_stream = trailers_ == nullptr && range.end() == body_->length();
+    dispatcher_.post([result = std::move(result), cb = std::move(cb), end_stream,
+                      cancelled = cancelled_]() mutable {
+      if (!*cancelled) {
+        std::move(cb)(std::move(result), end_stream);
+      }
+    });
+  }
+
+  // The cache must call cb with the cached trailers.
+  void getTrailers(LookupTrailersCallback&& cb) override {
+    ASSERT(trailers_);
+    dispatcher_.post(
+        [cb = std::move(cb), trailers = std::move(trailers_), cancelled = cancelled_]() mutable {
+          if (!*cancelled) {
+            std::move(cb)(std::move(trailers));
+          }
+        });
+  }
+
+  const LookupRequest& request() const { return request_; }
+  void onDestroy() override { *cancelled_ = true; }
+  Event::Dispatcher& dispatcher() const { return dispatcher_; }
+
+private:
+  Event::Dispatcher& dispatcher_;
+  std::shared_ptr<bool> cancelled_ = std::make_shared<bool>(false);
+  MemoryHttpCache& cache_;
+  const LookupRequest request_;
+  std::shared_ptr<const std::string> body_;
+  Http::ResponseTrailerMapPtr trailers_;
+};
+
+class MemoryInsertContext : public InsertContext {
+public:
+  MemoryInsertContext(MemoryLookupContext& lookup_context, MemoryHttpCache& cache)
+      : dispatcher_(lookup_context.dispatcher()), key_(lookup_context.request().key()),
+        request_headers_(lookup_context.request().requestHeaders()),
+        vary_allow_list_(lookup_context.request().varyAllowList()), cache_(cache) {}
+
+  void post(InsertCallback cb, bool result) {
+    dispatcher_.post([cb = std::move(cb), result = result, cancelled = cancelled_]() mutable {
+      if (!*cancelled) {
+        std::move(cb)(result);
+      }
+    });
+  }
+
+  void insertHeaders(const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata, InsertCallback insert_success,
+                     bool end_stream) override {
+    ASSERT(!committed_);
+    response_headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+    metadata_ = metadata;
+    if (end_stream) {
+      post(std::move(insert_success), commit());
+    } else {
+      post(std::move(insert_success), true);
+    }
+  }
+
+  void insertBody(const Buffer::Instance& chunk, InsertCallback ready_for_next_chunk,
+                  bool end_stream) override {
+    ASSERT(!committed_);
+    ASSERT(ready_for_next_chunk || end_stream);
+
+    body_.add(chunk);
+    if (body_.length() > cache_.maxEntrySizeBytes()) {
+      // Stop buffering a response that could never be stored.
+      committed_ = true;
+      cache_.stats().insert_rejections_.inc();
+      post(std::move(ready_for_next_chunk), false);
+    } else if (end_stream) {
+      post(std::move(ready_for_next_chunk), commit());
+    } else {
+      post(std::move(ready_for_next_chunk), true);
+    }
+  }
+
+  void insertTrailers(const Http::ResponseTrailerMap& trailers,
+                      InsertCallback insert_complete) override {
+    ASSERT(!committed_);
+    trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(trailers);
+    post(std::move(insert_complete), commit());
+  }
+
+  void onDestroy() override { *cancelled_ = true; }
+
+private:
+  bool commit() {
+    committed_ = true;
+    return cache_.insert(key_,
+                         Entry{std::move(response_headers_), std::move(metadata_),
+                               std::make_shared<const std::string>(body_.toString()),
+                               std::move(trailers_)},
+                         request_headers_, vary_allow_list_);
+  }
+
+  Event::Dispatcher& dispatcher_;
+  std::shared_ptr<bool> cancelled_ = std::make_shared<bool>(false);
+  Key key_;
+  const Http::RequestHeaderMap& request_headers_;
+  const VaryAllowList& vary_allow_list_;
+  Http::ResponseHeaderMapPtr response_headers_;
+  ResponseMetadata metadata_;
+  MemoryHttpCache& cache_;
+  Buffer::OwnedImpl body_;
+  bool committed_ = false;
+  Http::ResponseTrailerMapPtr trailers_;
+};
+
+} // namespace
+
+CacheShard::CacheShard(uint64_t max_size_bytes, uint64_t max_entry_size_bytes, CacheStats& stats)
+    : max_size_bytes_(max_size_bytes),
+      max_entry_size_bytes_(std::min(max_entry_size_bytes, max_size_bytes)),
+      max_protected_bytes_(max_size_bytes - max_size_bytes / 5), stats_(stats),
+      sketch_(max_size_bytes / ExpectedEntrySizeBytes) {}
+
+CacheShard::~CacheShard() {
+  absl::MutexLock lock(&mutex_);
+  stats_.size_bytes_.sub(size_bytes_);
+  stats_.size_count_.sub(map_.size());
+}
+
+Entry CacheShard::lookup(const Key& key, uint64_t hash) {
+  absl::MutexLock lock(&mutex_);
+  // Misses count too, so that a response that is requested often is admitted once it is
+  // inserted, even if the cache is full of entries that have been hit a few times.
+  sketch_.increment(hash);
+  auto it = map_.find(KeyRef{&key, hash});
+  if (it == map_.end()) {
+    return Entry{};
+  }
+  touch(it->second);
+  return copyEntry(it->second->entry_);
+}
+
+Http::ResponseHeaderMapPtr CacheShard::responseHeaders(const Key& key, uint64_t hash) {
+  absl::MutexLock lock(&mutex_);
+  auto it = map_.find(KeyRef{&key, hash});
+  if (it == map_.end()) {
+    return nullptr;
+  }
+  return Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*it->second->entry_.response_headers_);
+}
+
+bool CacheShard::insert(const Key& key, uint64_t hash, Entry&& entry) {
+  const uint64_t size_bytes = entrySize(key, entry);
+  if (size_bytes > max_entry_size_bytes_) {
+    stats_.insert_rejections_.inc();
+    return false;
+  }
+  absl::MutexLock lock(&mutex_);
+  auto existing = map_.find(KeyRef{&key, hash});
+  if (existing != map_.end()) {
+    // A fresh response for a cached key is always admitted.
+    erase(existing->second);
+  } else if (!admit(hash, size_bytes)) {
+    stats_.insert_rejections_.inc();
+    return false;
+  }
+  evictToFit(size_bytes);
+  probation_.push_front(Node{key, hash, std::move(entry), size_bytes, false});
+  map_.emplace(KeyRef{&probation_.front().key_, hash}, probation_.begin());
+  size_bytes_ += size_bytes;
+  stats_.size_bytes_.add(size_bytes);
+  stats_.size_count_.inc();
+  stats_.inserts_.inc();
+  return true;
+}
+
+bool CacheShard::updateHeaders(const Key& key, uint64_t hash,
+                               const Http::ResponseHeaderMap& response_headers,
+                               const ResponseMetadata& metadata) {
+  absl::MutexLock lock(&mutex_);
+  auto it = map_.find(KeyRef{&key, hash});
+  if (it == map_.end()) {
+    return false;
+  }
+  Node& node = *it->second;
+  applyHeaderUpdate(response_headers, *node.entry_.response_headers_);
+  node.entry_.metadata_ = metadata;
+  const uint64_t size_bytes = entrySize(node.key_, node.entry_);
+  size_bytes_ = size_bytes_ - node.size_bytes_ + size_bytes;
+  if (node.protected_) {
+    protected_bytes_ = protected_bytes_ - node.size_bytes_ + size_bytes;
+  }
+  stats_.size_bytes_.sub(node.size_bytes_);
+  stats_.size_bytes_.add(size_bytes);
+  node.size_bytes_ = size_bytes;
+  touch(it->second);
+  // The updated headers may have grown the entry past the budget.
+  evictToFit(0);
+  return true;
+}
+
+void CacheShard::touch(NodeList::iterator it) {
+  if (it->protected_) {
+    protected_.splice(protected_.begin(), protected_, it);
+    return;
+  }
+  // A hit promotes a probationary entry, demoting the least recently used protected entries
+  // to make room for it. Splicing keeps the iterators in map_ valid.
+  it->protected_ = true;
+  protected_bytes_ += it->size_bytes_;
+  protected_.splice(protected_.begin(), probation_, it);
+  while (protected_bytes_ > max_protected_bytes_ && protected_.size() > 1) {
+    auto demoted = std::prev(protected_.end());
+    demoted->protected_ = false;
+    protected_bytes_ -= demoted->size_bytes_;
+    probation_.splice(probation_.begin(), protected_, demoted);
+  }
+}
+
+void CacheShard::erase(NodeList::iterator it) {
+  map_.erase(KeyRef{&it->key_, it->hash_});
+  size_bytes_ -= it->size_bytes_;
+  if (it->protected_) {
+    protected_bytes_ -= it->size_bytes_;
+  }
+  stats_.size_bytes_.sub(it->size_bytes_);
+  stats_.size_count_.dec();
+  listFor(*it).erase(it);
+}
+
+void CacheShard::evictToFit(uint64_t incoming_bytes) {
+  while (size_bytes_ + incoming_bytes > max_size_bytes_) {
+    NodeList& victims = probation_.empty() ? protected_ : probation_;
+    ASSERT(!victims.empty());
+    erase(std::prev(victims.end()));
+    stats_.evictions_.inc();
+  }
+}
+
+bool CacheShard::admit(uint64_t hash, uint64_t incoming_bytes) {
+  if (size_bytes_ + incoming_bytes <= max_size_bytes_) {
+    return true;
+  }
+  // Walk the entries in eviction order until enough would have been freed, rejecting the
+  // candidate if any of them is at least as popular.
+  const uint32_t frequency = sketch_.frequency(hash);
+  uint64_t freed_bytes = 0;
+  for (NodeList* victims : {&probation_, &protected_}) {
+    for (auto it = victims->rbegin(); it != victims->rend(); ++it) {
+      if (sketch_.frequency(it->hash_) >= frequency) {
+        return false;
+      }
+      freed_bytes += it->size_bytes_;
+      if (size_bytes_ - freed_bytes + incoming_bytes <= max_size_bytes_) {
+        return true;
+      }
+    }
+  }
+  // Unreachable, as entries larger than the whole shard are rejected before admission.
+  return true;
+}
+
+MemoryHttpCache::MemoryHttpCache(Singleton::InstanceSharedPtr owner, ConfigProto config,
+                                 Stats::Scope& stats_scope)
+    : owner_(std::move(owner)), config_(std::move(config)), stat_names_(stats_scope.symbolTable()),
+      stats_(generateStats(stat_names_, stats_scope, config_.name())) {
+  const uint32_t num_shards = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_, shards, DefaultShards);
+  const uint64_t shard_size_bytes =
+      std::max<uint64_t>(config_.max_cache_size_bytes() / num_shards, 1);
+  max_entry_size_bytes_ = std::min<uint64_t>(
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_, max_individual_cache_entry_size_bytes,
+                                      shard_size_bytes),
+      shard_size_bytes);
+  shards_.reserve(num_shards);
+  for (uint32_t i = 0; i < num_shards; ++i) {
+    shards_.push_back(
+        std::make_unique<CacheShard>(shard_size_bytes, max_entry_size_bytes_, stats_));
+  }
+  stats_.size_limit_bytes_.add(config_.max_cache_size_bytes());
+}
+
+MemoryHttpCache::~MemoryHttpCache() {
+  stats_.size_limit_bytes_.sub(config_.max_cache_size_bytes());
+}
+
+LookupContextPtr MemoryHttpCache::makeLookupContext(LookupRequest&& request,
+                                                    Http::StreamFilterCallbacks& callbacks) {
+  return std::make_unique<MemoryLookupContext>(callbacks.dispatcher(), *this, std::move(request));
+}
+
+InsertContextPtr MemoryHttpCache::makeInsertContext(LookupContextPtr&& lookup_context,
+                                                    Http::StreamFilterCallbacks&) {
+  ASSERT(lookup_context != nullptr);
+  auto ret = std::make_unique<MemoryInsertContext>(
+      dynamic_cast<MemoryLookupContext&>(*lookup_context), *this);
+  lookup_context->onDestroy();
+  return ret;
+}
+
+void MemoryHttpCache::updateHeaders(const LookupContext& lookup_context,
+                                    const Http::ResponseHeaderMap& response_headers,
+                                    const ResponseMetadata& metadata,
+                                    UpdateHeadersCallback on_complete) {
+  const auto& memory_lookup_context = static_cast<const MemoryLookupContext&>(lookup_context);
+  const bool result = updateHeaders(memory_lookup_context.request(), response_headers, metadata);
+  memory_lookup_context.dispatcher().post(
+      [on_complete = std::move(on_complete), result]() mutable { std::move(on_complete)(result); });
+}
+
+bool MemoryHttpCache::updateHeaders(const LookupRequest& request,
+                                    const Http::ResponseHeaderMap& response_headers,
+                                    const ResponseMetadata& metadata) {
+  const uint64_t hash = stableHashKey(request.key());
+  Http::ResponseHeaderMapPtr stored_headers = shardFor(hash).responseHeaders(request.key(), hash);
+  if (stored_headers == nullptr) {
+    return false;
+  }
+  if (!VaryHeaderUtils::hasVary(*stored_headers)) {
+    return shardFor(hash).updateHeaders(request.key(), hash, response_headers, metadata);
+  }
+  const absl::optional<Key> varied_key = variedRequestKey(request, *stored_headers);
+  if (!varied_key.has_value()) {
+    return false;
+  }
+  const uint64_t varied_hash = stableHashKey(varied_key.value());
+  return shardFor(varied_hash)
+      .updateHeaders(varied_key.value(), varied_hash, response_headers, metadata);
+}
+
+Entry MemoryHttpCache::lookup(const LookupRequest& request) {
+  const uint64_t hash = stableHashKey(request.key());
+  Entry entry = shardFor(hash).lookup(request.key(), hash);
+  if (entry.response_headers_ != nullptr && VaryHeaderUtils::hasVary(*entry.response_headers_)) {
+    // The entry only flags that responses vary; look for the one that matches the request.
+    // The lock of the first shard has been released, so shards are never locked together.
+    const absl::optional<Key> varied_key = variedRequestKey(request, *entry.response_headers_);
+    if (varied_key.has_value()) {
+      const uint64_t varied_hash = stableHashKey(varied_key.value());
+      entry = shardFor(varied_hash).lookup(varied_key.value(), varied_hash);
+    } else {
+      entry = Entry{};
+    }
+  }
+  if (entry.response_headers_ != nullptr) {
+    stats_.cache_hit_.inc();
+  } else {
+    stats_.cache_miss_.inc();
+  }
+  return entry;
+}
+
+bool MemoryHttpCache::insert(const Key& key, Entry&& entry,
+                             const Http::RequestHeaderMap& request_headers,
+                             const VaryAllowList& vary_allow_list) {
+  if (!VaryHeaderUtils::hasVary(*entry.response_headers_)) {
+    const uint64_t hash = stableHashKey(key);
+    return shardFor(hash).insert(key, hash, std::move(entry));
+  }
+
+  absl::btree_set<absl::string_view> vary_header_values =
+      VaryHeaderUtils::getVaryValues(*entry.response_headers_);
+  ASSERT(!vary_header_values.empty());
+  const absl::optional<std::string> vary_identifier =
+      VaryHeaderUtils::createVaryIdentifier(vary_allow_list, vary_header_values, request_headers);
+  if (!vary_identifier.has_value()) {
+    // Skip the insert if we are unable to create a vary key.
+    return false;
+  }
+  // The vary values refer into the entry's headers, which belong to the cache once inserted.
+  const std::string vary_value = absl::StrJoin(vary_header_values, ",");
+
+  // Insert the varied response.
+  Key varied_key = key;
+  varied_key.add_custom_fields(vary_identifier.value());
+  const uint64_t varied_hash = stableHashKey(varied_key);
+  if (!shardFor(varied_hash).insert(varied_key, varied_hash, std::move(entry))) {
+    return false;
+  }
+
+  // Add a special entry to flag that this request generates varied responses.
+  const uint64_t hash = stableHashKey(key);
+  CacheShard& shard = shardFor(hash);
+  if (shard.responseHeaders(key, hash) != nullptr) {
+    return true;
+  }
+  Http::ResponseHeaderMapPtr vary_only_map =
+      Http::createHeaderMap<Http::ResponseHeaderMapImpl>({});
+  vary_only_map->setCopy(Http::CustomHeaders::get().Vary, vary_value);
+  return shard.insert(key, hash,
+                      Entry{std::move(vary_only_map), {}, std::make_shared<const std::string>(),
+                            nullptr});
+}
+
+CacheInfo MemoryHttpCache::cacheInfo() const {
+  CacheInfo cache_info;
+  cache_info.name_ = name();
+  cache_info.supports_range_requests_ = true;
+  return cache_info;
+}
+
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
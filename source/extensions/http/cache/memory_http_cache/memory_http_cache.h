@@ -0,0 +1,196 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/http/cache/memory_http_cache/v3/memory_http_cache.pb.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/protobuf/protobuf.h"
+#include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/http/cache/memory_http_cache/frequency_sketch.h"
+#include "source/extensions/http/cache/memory_http_cache/stats.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+
+using ConfigProto = envoy::extensions::http::cache::memory_http_cache::v3::MemoryHttpCacheConfig;
+
+/**
+ * A cached response. The body is shared between the cache and any lookups that are
+ * streaming it, so that neither copies it and an evicted body stays valid until the
+ * last reader is done with it.
+ */
+struct Entry {
+  Http::ResponseHeaderMapPtr response_headers_;
+  ResponseMetadata metadata_;
+  std::shared_ptr<const std::string> body_;
+  Http::ResponseTrailerMapPtr trailers_;
+};
+
+/**
+ * One independently locked part of a MemoryHttpCache, holding the entries whose keys
+ * hash to it within its share of the byte budget.
+ *
+ * Entries are kept in a segmented LRU: new entries go into a probationary segment, and are
+ * promoted to a protected segment, which holds up to 80% of the budget, when they are hit.
+ * Entries demoted from the protected segment go back to the probationary segment, and
+ * eviction always takes the least recently used probationary entries first. When an insert
+ * requires evictions, it is only admitted if the frequency sketch estimates the new entry
+ * to be requested more often than every entry it would evict.
+ */
+class CacheShard {
+public:
+  CacheShard(uint64_t max_size_bytes, uint64_t max_entry_size_bytes, CacheStats& stats);
+  ~CacheShard();
+
+  /**
+   * Records a request for the key and returns a copy of its entry, or an empty Entry if
+   * there is none.
+   */
+  Entry lookup(const Key& key, uint64_t hash);
+
+  /**
+   * Stores the entry under the key, replacing any previous entry.
+   * @return false if the entry was rejected by the size limits or the admission policy.
+   */
+  bool insert(const Key& key, uint64_t hash, Entry&& entry);
+
+  /**
+   * @return a copy of the response headers of the entry for the key, or nullptr if there is
+   *         none. Does not count as a request for the key.
+   */
+  Http::ResponseHeaderMapPtr responseHeaders(const Key& key, uint64_t hash);
+
+  /**
+   * Applies updated headers and metadata to the entry for the key.
+   * @return false if there is no entry for the key.
+   */
+  bool updateHeaders(const Key& key, uint64_t hash,
+                     const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata);
+
+private:
+  struct Node {
+    Key key_;
+    uint64_t hash_;
+    Entry entry_;
+    uint64_t size_bytes_;
+    bool protected_;
+  };
+  using NodeList = std::list<Node>;
+
+  // Refers to the key of a node along with its precomputed stableHashKey, so that the map
+  // neither copies keys nor hashes them a second time.
+  struct KeyRef {
+    const Key* key_;
+    uint64_t hash_;
+  };
+  struct KeyRefHash {
+    size_t operator()(const KeyRef& ref) const { return ref.hash_; }
+  };
+  struct KeyRefEq {
+    bool operator()(const KeyRef& lhs, const KeyRef& rhs) const {
+      return lhs.hash_ == rhs.hash_ &&
+             Protobuf::util::MessageDifferencer::Equals(*lhs.key_, *rhs.key_);
+    }
+  };
+
+  NodeList& listFor(const Node& node) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return node.protected_ ? protected_ : probation_;
+  }
+  void touch(NodeList::iterator it) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void erase(NodeList::iterator it) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void evictToFit(uint64_t incoming_bytes) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  bool admit(uint64_t hash, uint64_t incoming_bytes) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const uint64_t max_size_bytes_;
+  const uint64_t max_entry_size_bytes_;
+  const uint64_t max_protected_bytes_;
+  CacheStats& stats_;
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<KeyRef, NodeList::iterator, KeyRefHash, KeyRefEq>
+      map_ ABSL_GUARDED_BY(mutex_);
+  // Most recently used first.
+  NodeList probation_ ABSL_GUARDED_BY(mutex_);
+  NodeList protected_ ABSL_GUARDED_BY(mutex_);
+  uint64_t size_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  uint64_t protected_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  FrequencySketch sketch_ ABSL_GUARDED_BY(mutex_);
+};
+
+/**
+ * A bounded in-memory cache, split into CacheShards by the hash of the key so that
+ * workers rarely contend for the same lock.
+ */
+class MemoryHttpCache : public HttpCache, public Logger::Loggable<Logger::Id::cache_filter> {
+public:
+  /**
+   * @param owner a shared_ptr to the singleton that tracks caches by name, kept alive
+   *        until the last cache it created is destroyed.
+   * @param config the configuration for this cache.
+   * @param stats_scope the scope in which to create the cache's stats.
+   */
+  MemoryHttpCache(Singleton::InstanceSharedPtr owner, ConfigProto config,
+                  Stats::Scope& stats_scope);
+  ~MemoryHttpCache() override;
+
+  // HttpCache
+  LookupContextPtr makeLookupContext(LookupRequest&& request,
+                                     Http::StreamFilterCallbacks& callbacks) override;
+  InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context,
+                                     Http::StreamFilterCallbacks& callbacks) override;
+  void updateHeaders(const LookupContext& lookup_context,
+                     const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata, UpdateHeadersCallback on_complete) override;
+  CacheInfo cacheInfo() const override;
+
+  /**
+   * @return a copy of the entry that answers the request, following vary markers, or an
+   *         empty Entry if there is none.
+   */
+  Entry lookup(const LookupRequest& request);
+
+  /**
+   * Stores a complete response. Responses with a vary header are stored under a key that
+   * includes the varied request headers, alongside a marker entry under the plain key.
+   * @return false if the response was not stored.
+   */
+  bool insert(const Key& key, Entry&& entry, const Http::RequestHeaderMap& request_headers,
+              const VaryAllowList& vary_allow_list);
+
+  const ConfigProto& config() const { return config_; }
+  uint64_t maxEntrySizeBytes() const { return max_entry_size_bytes_; }
+  const CacheStats& stats() const { return stats_; }
+
+  static absl::string_view name() { return "envoy.extensions.http.cache.memory_http_cache"; }
+
+private:
+  CacheShard& shardFor(uint64_t hash) { return *shards_[(hash >> 32) % shards_.size()]; }
+  bool updateHeaders(const LookupRequest& request, const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata);
+
+  // A shared_ptr to the singleton that created this cache; see config.cc.
+  const Singleton::InstanceSharedPtr owner_;
+  const ConfigProto config_;
+  uint64_t max_entry_size_bytes_;
+  CacheStatNames stat_names_;
+  CacheStats stats_;
+  std::vector<std::unique_ptr<CacheShard>> shards_;
+};
+
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
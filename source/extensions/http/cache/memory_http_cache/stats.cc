@@ -0,0 +1,22 @@
+#include "source/extensions/http/cache/memory_http_cache/stats.h"
+
+#include "absl/strings/str_replace.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+
+CacheStats generateStats(CacheStatNames& stat_names, Stats::Scope& scope,
+                         absl::string_view cache_name) {
+  Stats::StatName cache_name_statname =
+      stat_names.pool_.add(absl::StrReplaceAll(cache_name, {{".", "_"}}));
+  return {stat_names, scope, cache_name_statname};
+}
+
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
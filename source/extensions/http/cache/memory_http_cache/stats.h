@@ -0,0 +1,84 @@
+#pragma once
+
+#include "envoy/stats/stats_macros.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+
+/**
+ * All cache stats. @see stats_macros.h
+ *
+ * insert_rejections counts responses that were not stored, either because they were larger than
+ * the configured limits, or because the admission policy estimated them to be less popular than
+ * the entries they would have evicted.
+ *
+ * There are also cache_hit_ and cache_miss_, defined separately to accommodate extra tags;
+ * these two both go into the stat with key `event`, and with tag `event_type=(hit|miss)`
+ **/
+
+#define ALL_CACHE_STATS(COUNTER, GAUGE, HISTOGRAM, TEXT_READOUT, STATNAME)                         \
+  COUNTER(evictions)                                                                               \
+  COUNTER(inserts)                                                                                 \
+  COUNTER(insert_rejections)                                                                       \
+  GAUGE(size_bytes, NeverImport)                                                                   \
+  GAUGE(size_count, NeverImport)                                                                   \
+  GAUGE(size_limit_bytes, NeverImport)                                                             \
+  STATNAME(cache)                                                                                  \
+  STATNAME(cache_name)                                                                             \
+  STATNAME(event)                                                                                  \
+  STATNAME(event_type)                                                                             \
+  STATNAME(hit)                                                                                    \
+  STATNAME(miss)
+
+#define COUNTER_HELPER_(NAME)                                                                      \
+  , NAME##_(                                                                                       \
+        Envoy::Stats::Utility::counterFromStatNames(scope, {prefix_, stat_names.NAME##_}, tags_))
+#define GAUGE_HELPER_(NAME, MODE)                                                                  \
+  , NAME##_(Envoy::Stats::Utility::gaugeFromStatNames(                                             \
+        scope, {prefix_, stat_names.NAME##_}, Envoy::Stats::Gauge::ImportMode::MODE, tags_))
+#define STATNAME_HELPER_(NAME)
+
+MAKE_STAT_NAMES_STRUCT(CacheStatNames, ALL_CACHE_STATS);
+
+struct CacheStats {
+  CacheStats(const CacheStatNames& stat_names, Envoy::Stats::Scope& scope,
+             Stats::StatName cache_name)
+      : stat_names_(stat_names), prefix_(stat_names_.cache_), cache_name_(cache_name),
+        tags_({{stat_names_.cache_name_, cache_name_}}),
+        tags_hit_(
+            {{stat_names_.cache_name_, cache_name_}, {stat_names_.event_type_, stat_names_.hit_}}),
+        tags_miss_(
+            {{stat_names_.cache_name_, cache_name_}, {stat_names_.event_type_, stat_names_.miss_}})
+            ALL_CACHE_STATS(COUNTER_HELPER_, GAUGE_HELPER_, HISTOGRAM_HELPER_, TEXT_READOUT_HELPER_,
+                            STATNAME_HELPER_),
+        cache_hit_(Envoy::Stats::Utility::counterFromStatNames(scope, {prefix_, stat_names.event_},
+                                                               tags_hit_)),
+        cache_miss_(Envoy::Stats::Utility::counterFromStatNames(scope, {prefix_, stat_names.event_},
+                                                                tags_miss_)) {}
+
+private:
+  const CacheStatNames& stat_names_;
+  const Stats::StatName prefix_;
+  const Stats::StatName cache_name_;
+  Stats::StatNameTagVector tags_;
+  Stats::StatNameTagVector tags_hit_;
+  Stats::StatNameTagVector tags_miss_;
+
+public:
+  ALL_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT,
+                  GENERATE_TEXT_READOUT_STRUCT, GENERATE_STATNAME_STRUCT);
+  Stats::Counter& cache_hit_;
+  Stats::Counter& cache_miss_;
+};
+
+CacheStats generateStats(CacheStatNames& stat_names, Stats::Scope& scope,
+                         absl::string_view cache_name);
+
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
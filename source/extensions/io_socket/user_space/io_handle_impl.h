@@ -63,6 +63,9 @@ public:
                                   uint32_t self_port,
                                   const Network::IoHandle::UdpSaveCmsgConfig& udp_save_cmsg_config,
                                   RecvMsgOutput& output) override;
+  Api::IoCallUint64Result sendmmsg(const Buffer::RawSlice* datagrams, uint64_t num_datagrams,
+                                   int flags, const Network::Address::Ip* self_ip,
+                                   const Network::Address::Instance& peer_address) override;
   Api::IoCallUint64Result recvmmsg(RawSliceArrays& slices, uint32_t self_port,
                                    const Network::IoHandle::UdpSaveCmsgConfig& udp_save_cmsg_config,
                                    RecvMsgOutput& output) override;
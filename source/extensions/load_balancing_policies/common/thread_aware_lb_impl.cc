@@ -1,6 +1,7 @@
 #include "source/extensions/load_balancing_policies/common/thread_aware_lb_impl.h"
 
 #include <memory>
+#include <numeric>
 #include <random>
 
 namespace Envoy {
@@ -132,8 +133,9 @@ absl::Status ThreadAwareLoadBalancerBase::refresh() {
                                            normalized_host_weights, min_normalized_weight,
                                            max_normalized_weight, locality_weighted_balancing_);
     RETURN_IF_NOT_OK(status);
-    per_priority_state->current_lb_ = createLoadBalancer(
-        std::move(normalized_host_weights), min_normalized_weight, max_normalized_weight);
+    per_priority_state->current_lb_ =
+        createLoadBalancer(priority, std::move(normalized_host_weights), min_normalized_weight,
+                           max_normalized_weight);
   }
 
   {
@@ -203,20 +205,52 @@ double ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::hostOverload
   // and alert the user if that's the case.
 
   const uint32_t overall_active = host.cluster().trafficStats()->upstream_rq_active_.value();
-  const uint32_t host_active = host.stats().rq_active_.value();
+  const HostStats* host_stats = host.statsIfAllocated();
+  const uint32_t host_active = host_stats != nullptr ? host_stats->rq_active_.value() : 0;
 
   const uint32_t total_slots = ((overall_active + 1) * hash_balance_factor_ + 99) / 100;
   const uint32_t slots =
       std::max(static_cast<uint32_t>(std::ceil(total_slots * weight)), static_cast<uint32_t>(1));
 
-  if (host.stats().rq_active_.value() > slots) {
+  if (host_active > slots) {
     ENVOY_LOG_MISC(
         debug,
         "ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost: "
         "host {} overloaded; overall_active {}, host_weight {}, host_active {} > slots {}",
         host.address()->asString(), overall_active, weight, host_active, slots);
   }
-  return static_cast<double>(host.stats().rq_active_.value()) / slots;
+  return static_cast<double>(host_active) / slots;
+}
+
+absl::flat_hash_map<const Host*, uint32_t>
+ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::initHostIndices(
+    const NormalizedHostWeightVector& normalized_host_weights) {
+  absl::flat_hash_map<const Host*, uint32_t> host_indices;
+  host_indices.reserve(normalized_host_weights.size());
+  for (uint32_t i = 0; i < normalized_host_weights.size(); i++) {
+    host_indices[normalized_host_weights[i].first.get()] = i;
+  }
+  return host_indices;
+}
+
+std::vector<uint32_t>
+ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::initStrides(uint32_t num_hosts) {
+  // Spread the strides over the whole host list, so that requests that spill over from the same
+  // host probe unrelated sequences of hosts. num_hosts - 1 is always coprime with num_hosts, so
+  // the search for a coprime stride ends before reaching num_hosts.
+  static constexpr uint32_t MaxStrides = 16;
+  std::vector<uint32_t> strides;
+  if (num_hosts < 2) {
+    return strides;
+  }
+  for (uint64_t i = 1; i <= MaxStrides; i++) {
+    uint32_t stride = std::max<uint32_t>(i * num_hosts / (MaxStrides + 1), 1);
+    while (std::gcd(stride, num_hosts) != 1) {
+      stride++;
+    }
+    strides.push_back(stride);
+  }
+  return strides;
 }
 
 HostSelectionResponse
@@ -246,8 +280,9 @@ ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t
   if (host == nullptr) {
     return {nullptr};
   }
-  const double weight = normalized_host_weights_map_.at(host);
-  double overload_factor = hostOverloadFactor(*host, weight);
+  const uint32_t host_index = host_indices_.at(host.get());
+  const double overload_factor =
+      hostOverloadFactor(*host, normalized_host_weights_[host_index].second);
   if (overload_factor <= 1.0) {
     ENVOY_LOG_MISC(debug,
                    "ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost: "
@@ -256,6 +291,14 @@ ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t
     return host;
   }
 
+  if (strides_.empty()) {
+    return chooseShuffledHost(hash, host, overload_factor);
+  }
+  return chooseStridedHost(hash, host_index, overload_factor);
+}
+
+HostConstSharedPtr ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseShuffledHost(
+    uint64_t hash, const HostConstSharedPtr& host, double overload_factor) const {
   // When a host is overloaded, we choose the next host in a random manner rather than picking the
   // next one in the ring. The random sequence is seeded by the hash, so the same input gets the
   // same sequence of hosts all the time.
@@ -314,5 +357,41 @@ ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t
   return least_overloaded_host;
 }
 
+HostConstSharedPtr ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseStridedHost(
+    uint64_t hash, uint32_t host_index, double overload_factor) const {
+  // Step through the host list from the overloaded host. The stride is coprime with the number of
+  // hosts, so the walk visits every other host exactly once before coming back. Choosing the
+  // stride by hash spreads the requests of an overloaded host over several walks, which avoids the
+  // cascading overflow of plain linear probing.
+  const uint32_t num_hosts = normalized_host_weights_.size();
+  const uint32_t stride = strides_[hash % strides_.size()];
+  uint32_t least_overloaded_index = host_index;
+  double least_overload_factor = overload_factor;
+  uint32_t k = host_index;
+  for (uint32_t i = 1; i < num_hosts; i++) {
+    k += stride;
+    if (k >= num_hosts) {
+      k -= num_hosts;
+    }
+
+    const auto& alt_host = normalized_host_weights_[k];
+    overload_factor = hostOverloadFactor(*alt_host.first, alt_host.second);
+    if (overload_factor <= 1.0) {
+      ENVOY_LOG_MISC(debug,
+                     "ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost: "
+                     "selected host #{}:{} (attempt:{})",
+                     k, alt_host.first->address()->asString(), i + 1);
+      return alt_host.first;
+    }
+
+    if (least_overload_factor > overload_factor) {
+      least_overloaded_index = k;
+      least_overload_factor = overload_factor;
+    }
+  }
+
+  return normalized_host_weights_[least_overloaded_index].first;
+}
+
 } // namespace Upstream
 } // namespace Envoy
@@ -10,6 +10,7 @@
 #include "source/common/config/well_known_names.h"
 #include "source/extensions/load_balancing_policies/common/load_balancer_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 
@@ -33,7 +34,7 @@ public:
   public:
     virtual ~HashingLoadBalancer() = default;
     virtual HostSelectionResponse chooseHost(uint64_t hash, uint32_t attempt) const PURE;
-    const absl::string_view hashKey(HostConstSharedPtr host, bool use_hostname) const {
+    static absl::string_view hashKey(const HostConstSharedPtr& host, bool use_hostname) {
       const ProtobufWkt::Value& val = Config::Metadata::metadataValue(
           host->metadata().get(), Config::MetadataFilters::get().ENVOY_LB,
           Config::MetadataEnvoyLbKeys::get().HASH_KEY);
@@ -57,13 +58,20 @@ public:
    */
   class BoundedLoadHashingLoadBalancer : public HashingLoadBalancer {
   public:
+    /**
+     * @param probe_with_stride if true, overloaded hosts spill over to the hosts found by stepping
+     *        through the host list with a stride chosen by the hash. Otherwise hosts are probed in
+     *        a random order seeded by the hash.
+     */
     BoundedLoadHashingLoadBalancer(HashingLoadBalancerSharedPtr hashing_lb_ptr,
                                    NormalizedHostWeightVector normalized_host_weights,
-                                   uint32_t hash_balance_factor)
-        : normalized_host_weights_map_(initNormalizedHostWeightMap(normalized_host_weights)),
+                                   uint32_t hash_balance_factor, bool probe_with_stride = false)
+        : host_indices_(initHostIndices(normalized_host_weights)),
           hashing_lb_ptr_(std::move(hashing_lb_ptr)),
           normalized_host_weights_(std::move(normalized_host_weights)),
-          hash_balance_factor_(hash_balance_factor) {
+          hash_balance_factor_(hash_balance_factor),
+          strides_(probe_with_stride ? initStrides(normalized_host_weights_.size())
+                                     : std::vector<uint32_t>()) {
       ASSERT(hashing_lb_ptr_ != nullptr);
       ASSERT(hash_balance_factor > 0);
     }
@@ -71,20 +79,24 @@ public:
 
   protected:
     virtual double hostOverloadFactor(const Host& host, double weight) const;
-    const NormalizedHostWeightMap normalized_host_weights_map_;
+    // Index of each host in normalized_host_weights_.
+    const absl::flat_hash_map<const Host*, uint32_t> host_indices_;
 
   private:
-    const NormalizedHostWeightMap
-    initNormalizedHostWeightMap(const NormalizedHostWeightVector& normalized_host_weights) {
-      NormalizedHostWeightMap normalized_host_weights_map;
-      for (auto const& item : normalized_host_weights) {
-        normalized_host_weights_map[item.first] = item.second;
-      }
-      return normalized_host_weights_map;
-    }
+    static absl::flat_hash_map<const Host*, uint32_t>
+    initHostIndices(const NormalizedHostWeightVector& normalized_host_weights);
+    static std::vector<uint32_t> initStrides(uint32_t num_hosts);
+
+    HostConstSharedPtr chooseShuffledHost(uint64_t hash, const HostConstSharedPtr& host,
+                                          double overload_factor) const;
+    HostConstSharedPtr chooseStridedHost(uint64_t hash, uint32_t host_index,
+                                         double overload_factor) const;
+
     const HashingLoadBalancerSharedPtr hashing_lb_ptr_;
     const NormalizedHostWeightVector normalized_host_weights_;
     const uint32_t hash_balance_factor_;
+    // Strides that are coprime with the number of hosts, if hosts are probed with a stride.
+    const std::vector<uint32_t> strides_;
   };
   // Upstream::ThreadAwareLoadBalancer
   LoadBalancerFactorySharedPtr factory() override { return factory_; }
@@ -164,7 +176,7 @@ private:
   };
 
   virtual HashingLoadBalancerSharedPtr
-  createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+  createLoadBalancer(uint32_t priority, const NormalizedHostWeightVector& normalized_host_weights,
                      double min_normalized_weight, double max_normalized_weight) PURE;
   absl::Status refresh();
 
@@ -1,5 +1,9 @@
 #include "source/extensions/load_balancing_policies/least_request/least_request_lb.h"
 
+#include <algorithm>
+#include <array>
+#include <limits>
+
 namespace Envoy {
 namespace Upstream {
 
@@ -27,10 +31,11 @@ double LeastRequestLoadBalancer::hostWeight(const Host& host) const {
   // If the value of active requests is the max value, adding +1 will overflow
   // it and cause a divide by zero. This won't happen in normal cases but stops
   // failing fuzz tests
-  const uint64_t active_request_value =
-      host.stats().rq_active_.value() != std::numeric_limits<uint64_t>::max()
-          ? host.stats().rq_active_.value() + 1
-          : host.stats().rq_active_.value();
+  const HostStats* host_stats = host.statsIfAllocated();
+  const uint64_t active_requests = host_stats != nullptr ? host_stats->rq_active_.value() : 0;
+  const uint64_t active_request_value = active_requests != std::numeric_limits<uint64_t>::max()
+                                            ? active_requests + 1
+                                            : active_requests;
 
   if (active_request_bias_ == 1.0) {
     host_weight = static_cast<double>(host.weight()) / active_request_value;
@@ -54,16 +59,34 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPeek(const HostVector
   return nullptr;
 }
 
+void LeastRequestLoadBalancer::refreshHostSource(const HostsSource& source) {
+  const HostVector& hosts = hostSourceToHosts(source);
+  ActiveRequestGauges& active_requests = active_request_gauges_[source];
+  active_requests.clear();
+  active_requests.reserve(hosts.size());
+  for (const auto& host : hosts) {
+    // Hosts whose stats have not been allocated yet get a null gauge, which picks resolve later.
+    const HostStats* host_stats = host->statsIfAllocated();
+    active_requests.push_back(host_stats != nullptr ? &host_stats->rq_active_ : nullptr);
+  }
+}
+
 HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector& hosts_to_use,
-                                                                const HostsSource&) {
+                                                                const HostsSource& source) {
+  // The gauges are refreshed whenever the hosts change, so they should always match.
+  const auto it = active_request_gauges_.find(source);
+  ActiveRequestGauges* active_requests =
+      it != active_request_gauges_.end() && it->second.size() == hosts_to_use.size() ? &it->second
+                                                                                    : nullptr;
+
   HostSharedPtr candidate_host = nullptr;
 
   switch (selection_method_) {
   case envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest::FULL_SCAN:
-    candidate_host = unweightedHostPickFullScan(hosts_to_use);
+    candidate_host = unweightedHostPickFullScan(hosts_to_use, active_requests);
     break;
   case envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest::N_CHOICES:
-    candidate_host = unweightedHostPickNChoices(hosts_to_use);
+    candidate_host = unweightedHostPickNChoices(hosts_to_use, active_requests);
     break;
   default:
     IS_ENVOY_BUG("unknown selection method specified for least request load balancer");
@@ -72,30 +95,56 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector
   return candidate_host;
 }
 
-HostSharedPtr LeastRequestLoadBalancer::unweightedHostPickFullScan(const HostVector& hosts_to_use) {
-  HostSharedPtr candidate_host = nullptr;
+namespace {
+
+// Returns the active requests of hosts[index]. If the host's gauge is not cached, because there
+// are no cached gauges or because its stats were not allocated when they were refreshed, the host
+// is asked for its stats without allocating them, and the gauge is cached once they exist.
+uint64_t activeRequests(const HostVector& hosts,
+                        std::vector<const Stats::PrimitiveGauge*>* active_requests, size_t index) {
+  const Stats::PrimitiveGauge* gauge =
+      active_requests != nullptr ? (*active_requests)[index] : nullptr;
+  if (gauge == nullptr) {
+    const HostStats* host_stats = hosts[index]->statsIfAllocated();
+    if (host_stats == nullptr) {
+      return 0;
+    }
+    gauge = &host_stats->rq_active_;
+    if (active_requests != nullptr) {
+      (*active_requests)[index] = gauge;
+    }
+  }
+  return gauge->value();
+}
+
+} // namespace
+
+HostSharedPtr
+LeastRequestLoadBalancer::unweightedHostPickFullScan(const HostVector& hosts_to_use,
+                                                     ActiveRequestGauges* active_requests) {
+  size_t candidate_index = 0;
+  uint64_t candidate_active_rq = 0;
 
   size_t num_hosts_known_tied_for_least = 0;
 
   const size_t num_hosts = hosts_to_use.size();
 
   for (size_t i = 0; i < num_hosts; ++i) {
-    const HostSharedPtr& sampled_host = hosts_to_use[i];
+    const uint64_t sampled_active_rq = activeRequests(hosts_to_use, active_requests, i);
 
-    if (candidate_host == nullptr) {
+    if (i == 0) {
       // Make a first choice to start the comparisons.
       num_hosts_known_tied_for_least = 1;
-      candidate_host = sampled_host;
+      candidate_index = i;
+      candidate_active_rq = sampled_active_rq;
       continue;
     }
 
-    const auto candidate_active_rq = candidate_host->stats().rq_active_.value();
-    const auto sampled_active_rq = sampled_host->stats().rq_active_.value();
-
     if (sampled_active_rq < candidate_active_rq) {
       // Reset the count of known tied hosts.
       num_hosts_known_tied_for_least = 1;
-      candidate_host = sampled_host;
+      candidate_index = i;
+      candidate_active_rq = sampled_active_rq;
     } else if (sampled_active_rq == candidate_active_rq) {
       ++num_hosts_known_tied_for_least;
 
@@ -108,36 +157,53 @@ HostSharedPtr LeastRequestLoadBalancer::unweightedHostPickFullScan(const HostVec
       // candidate_host returned by this function.
       const size_t random_tied_host_index = random_.random() % num_hosts_known_tied_for_least;
       if (random_tied_host_index == 0) {
-        candidate_host = sampled_host;
+        candidate_index = i;
       }
     }
   }
 
-  return candidate_host;
+  return num_hosts == 0 ? nullptr : hosts_to_use[candidate_index];
 }
 
-HostSharedPtr LeastRequestLoadBalancer::unweightedHostPickNChoices(const HostVector& hosts_to_use) {
-  HostSharedPtr candidate_host = nullptr;
-
-  for (uint32_t choice_idx = 0; choice_idx < choice_count_; ++choice_idx) {
-    const int rand_idx = random_.random() % hosts_to_use.size();
-    const HostSharedPtr& sampled_host = hosts_to_use[rand_idx];
-
-    if (candidate_host == nullptr) {
-      // Make a first choice to start the comparisons.
-      candidate_host = sampled_host;
-      continue;
+HostSharedPtr
+LeastRequestLoadBalancer::unweightedHostPickNChoices(const HostVector& hosts_to_use,
+                                                     ActiveRequestGauges* active_requests) {
+  // Sample the choices in batches. The active requests of a batch are loaded together, so that
+  // their cache misses overlap, and their minimum is found with a branch free loop that compilers
+  // vectorize. Only then is the first sample with the minimum looked up. As when comparing the
+  // samples one by one, the earliest sample with the fewest active requests is selected.
+  static constexpr uint32_t BatchSize = 16;
+  std::array<size_t, BatchSize> indices;
+  std::array<uint64_t, BatchSize> active_rq;
+
+  size_t candidate_index = 0;
+  uint64_t candidate_active_rq = std::numeric_limits<uint64_t>::max();
+  bool have_candidate = false;
+  for (uint32_t sampled = 0; sampled < choice_count_; sampled += BatchSize) {
+    const uint32_t batch_size = std::min(BatchSize, choice_count_ - sampled);
+    for (uint32_t i = 0; i < batch_size; ++i) {
+      indices[i] = random_.random() % hosts_to_use.size();
+    }
+    for (uint32_t i = 0; i < batch_size; ++i) {
+      active_rq[i] = activeRequests(hosts_to_use, active_requests, indices[i]);
+    }
+    uint64_t batch_min = active_rq[0];
+    for (uint32_t i = 1; i < batch_size; ++i) {
+      batch_min = std::min(batch_min, active_rq[i]);
     }
 
-    const auto candidate_active_rq = candidate_host->stats().rq_active_.value();
-    const auto sampled_active_rq = sampled_host->stats().rq_active_.value();
-
-    if (sampled_active_rq < candidate_active_rq) {
-      candidate_host = sampled_host;
+    if (!have_candidate || batch_min < candidate_active_rq) {
+      uint32_t i = 0;
+      while (active_rq[i] != batch_min) {
+        ++i;
+      }
+      candidate_index = indices[i];
+      candidate_active_rq = batch_min;
+      have_candidate = true;
     }
   }
 
-  return candidate_host;
+  return have_candidate ? hosts_to_use[candidate_index] : nullptr;
 }
 
 } // namespace Upstream
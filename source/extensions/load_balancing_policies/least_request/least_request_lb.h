@@ -1,7 +1,13 @@
 #pragma once
 
+#include <vector>
+
+#include "envoy/stats/primitive_stats.h"
+
 #include "source/extensions/load_balancing_policies/common/load_balancer_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -57,21 +63,36 @@ protected:
       active_request_bias_ = 1.0;
     }
 
+    // Drop the gauges of this priority, including those of localities that are gone. Refreshing
+    // the host sources below recreates the ones that remain.
+    absl::erase_if(active_request_gauges_,
+                   [priority](const auto& entry) { return entry.first.priority_ == priority; });
     EdfLoadBalancerBase::refresh(priority);
   }
 
 private:
-  void refreshHostSource(const HostsSource&) override {}
+  // The active request gauges of the hosts of a host source, in the same order as the hosts. A
+  // gauge is null while the host's stats have not been allocated.
+  using ActiveRequestGauges = std::vector<const Stats::PrimitiveGauge*>;
+
+  void refreshHostSource(const HostsSource& source) override;
   double hostWeight(const Host& host) const override;
   HostConstSharedPtr unweightedHostPeek(const HostVector& hosts_to_use,
                                         const HostsSource& source) override;
   HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
                                         const HostsSource& source) override;
-  HostSharedPtr unweightedHostPickFullScan(const HostVector& hosts_to_use);
-  HostSharedPtr unweightedHostPickNChoices(const HostVector& hosts_to_use);
+  HostSharedPtr unweightedHostPickFullScan(const HostVector& hosts_to_use,
+                                           ActiveRequestGauges* active_requests);
+  HostSharedPtr unweightedHostPickNChoices(const HostVector& hosts_to_use,
+                                           ActiveRequestGauges* active_requests);
 
   const uint32_t choice_count_;
 
+  // Unweighted picks compare the active requests of candidates through these gauges, rather than
+  // by dereferencing each candidate host and calling its stats() method. Refreshed along with the
+  // host sources.
+  absl::flat_hash_map<HostsSource, ActiveRequestGauges, HostsSourceHash> active_request_gauges_;
+
   // The exponent used to calculate host weights can be configured via runtime. We cache it for
   // performance reasons and refresh it in `LeastRequestLoadBalancer::refresh(uint32_t priority)`
   // whenever a `HostSet` is updated.
@@ -1,5 +1,9 @@
 #include "source/extensions/load_balancing_policies/maglev/maglev_lb.h"
 
+#include <algorithm>
+#include <functional>
+#include <utility>
+
 #include "envoy/config/cluster/v3/cluster.pb.h"
 
 #include "source/common/runtime/runtime_features.h"
@@ -57,8 +61,32 @@ public:
 
     return maglev_table;
   }
+
+  static MaglevTableSharedPtr createMaglevTable(const MaglevTableBuilder& builder,
+                                                MaglevLoadBalancerStats& stats) {
+    if (shouldUseCompactTable(builder.hosts().size(), builder.tableSize())) {
+      return std::make_shared<CompactMaglevTable>(builder, stats);
+    }
+    return std::make_shared<OriginalMaglevTable>(builder, stats);
+  }
 };
 
+// Returns the inverse of value modulo the prime modulus.
+uint64_t modularInverse(uint64_t value, uint64_t modulus) {
+  // Extended Euclidean algorithm.
+  int64_t t = 0;
+  int64_t new_t = 1;
+  int64_t r = modulus;
+  int64_t new_r = value;
+  while (new_r != 0) {
+    const int64_t quotient = r / new_r;
+    t = std::exchange(new_t, t - quotient * new_t);
+    r = std::exchange(new_r, r - quotient * new_r);
+  }
+  ASSERT(r == 1);
+  return t < 0 ? t + modulus : t;
+}
+
 } // namespace
 
 TypedMaglevLbConfig::TypedMaglevLbConfig(const CommonLbConfigProto& common_lb_config,
@@ -76,19 +104,41 @@ TypedMaglevLbConfig::TypedMaglevLbConfig(const CommonLbConfigProto& common_lb_co
 TypedMaglevLbConfig::TypedMaglevLbConfig(const MaglevLbProto& lb_config) : lb_config_(lb_config) {}
 
 ThreadAwareLoadBalancerBase::HashingLoadBalancerSharedPtr
-MaglevLoadBalancer::createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+MaglevLoadBalancer::createLoadBalancer(uint32_t priority,
+                                       const NormalizedHostWeightVector& normalized_host_weights,
                                        double /* min_normalized_weight */,
                                        double max_normalized_weight) {
-  HashingLoadBalancerSharedPtr maglev_lb =
-      MaglevFactory::createMaglevTable(normalized_host_weights, max_normalized_weight, table_size_,
-                                       use_hostname_for_hashing_, stats_);
+  HashingLoadBalancerSharedPtr maglev_lb;
+  if (incremental_table_build_) {
+    if (priority >= table_builders_.size()) {
+      table_builders_.resize(priority + 1);
+    }
+    auto& builder = table_builders_[priority];
+    if (builder == nullptr) {
+      builder = std::make_unique<MaglevTableBuilder>(table_size_, use_hostname_for_hashing_);
+    }
+    const uint64_t reassigned_entries = builder->build(normalized_host_weights);
+    ENVOY_LOG(debug, "maglev: incremental build for priority {} reassigned {} of {} entries",
+              priority, reassigned_entries, table_size_);
+    stats_.min_entries_per_host_.set(builder->minEntriesPerHost());
+    stats_.max_entries_per_host_.set(builder->maxEntriesPerHost());
+    MaglevTableSharedPtr table = MaglevFactory::createMaglevTable(*builder, stats_);
+    if (ENVOY_LOG_CHECK_LEVEL(trace) && !builder->hosts().empty()) {
+      table->logMaglevTable(use_hostname_for_hashing_);
+    }
+    maglev_lb = std::move(table);
+  } else {
+    maglev_lb = MaglevFactory::createMaglevTable(normalized_host_weights, max_normalized_weight,
+                                                 table_size_, use_hostname_for_hashing_, stats_);
+  }
 
   if (hash_balance_factor_ == 0) {
     return maglev_lb;
   }
 
   return std::make_shared<BoundedLoadHashingLoadBalancer>(
-      maglev_lb, std::move(normalized_host_weights), hash_balance_factor_);
+      maglev_lb, std::move(normalized_host_weights), hash_balance_factor_,
+      bounded_load_stride_probe_);
 }
 
 void MaglevTable::constructMaglevTableInternal(
@@ -232,6 +282,209 @@ void CompactMaglevTable::constructImplementationInternals(
   }
 }
 
+OriginalMaglevTable::OriginalMaglevTable(const MaglevTableBuilder& builder,
+                                         MaglevLoadBalancerStats& stats)
+    : MaglevTable(builder.tableSize(), stats) {
+  const std::vector<HostConstSharedPtr>& hosts = builder.hosts();
+  if (hosts.empty()) {
+    return;
+  }
+  table_.reserve(table_size_);
+  for (const uint32_t index : builder.entries()) {
+    table_.push_back(hosts[index]);
+  }
+}
+
+CompactMaglevTable::CompactMaglevTable(const MaglevTableBuilder& builder,
+                                       MaglevLoadBalancerStats& stats)
+    : MaglevTable(builder.tableSize(), stats),
+      table_(absl::bit_width(builder.hosts().size()), builder.tableSize()),
+      host_table_(builder.hosts()) {
+  if (host_table_.empty()) {
+    return;
+  }
+  const std::vector<uint32_t>& entries = builder.entries();
+  for (uint64_t i = 0; i < table_size_; ++i) {
+    table_.set(i, entries[i]);
+  }
+}
+
+MaglevTableBuilder::MaglevTableBuilder(uint64_t table_size, bool use_hostname_for_hashing)
+    : use_hostname_for_hashing_(use_hostname_for_hashing), entries_(table_size, UnassignedEntry) {}
+
+uint64_t MaglevTableBuilder::permutation(const BuildHost& host) const {
+  return (host.offset_ + (host.skip_ * host.next_)) % tableSize();
+}
+
+uint64_t MaglevTableBuilder::preference(const BuildHost& host, uint64_t entry) const {
+  // Solves offset + skip * next = entry (mod table size) for next. Table sizes are limited to
+  // 5000011, so the product can't overflow.
+  const uint64_t table_size = tableSize();
+  return ((entry + table_size - host.offset_) % table_size) * host.skip_inverse_ % table_size;
+}
+
+void MaglevTableBuilder::setTargets(std::vector<BuildHost>& build_hosts) const {
+  const uint64_t table_size = tableSize();
+  double total_weight = 0;
+  for (const BuildHost& host : build_hosts) {
+    total_weight += host.weight_;
+  }
+
+  // Give each host the integral part of its share of the table, and hand out the remaining entries
+  // to the hosts with the largest fractional parts.
+  std::vector<std::pair<double, uint32_t>> remainders;
+  remainders.reserve(build_hosts.size());
+  uint64_t assigned = 0;
+  for (uint32_t i = 0; i < build_hosts.size(); ++i) {
+    BuildHost& host = build_hosts[i];
+    const double share = total_weight > 0 ? table_size * (host.weight_ / total_weight)
+                                          : static_cast<double>(table_size) / build_hosts.size();
+    host.target_ = std::min(static_cast<uint64_t>(share), table_size - assigned);
+    assigned += host.target_;
+    remainders.emplace_back(share - host.target_, i);
+  }
+  std::sort(remainders.begin(), remainders.end(), [](const auto& a, const auto& b) {
+    return a.first != b.first ? a.first > b.first : a.second < b.second;
+  });
+  for (uint64_t i = 0; assigned < table_size; i = (i + 1) % remainders.size()) {
+    build_hosts[remainders[i].second].target_++;
+    assigned++;
+  }
+}
+
+uint64_t MaglevTableBuilder::build(const NormalizedHostWeightVector& normalized_host_weights) {
+  const uint64_t table_size = tableSize();
+  if (normalized_host_weights.empty()) {
+    const uint64_t assigned_entries = hosts_.empty() ? 0 : table_size;
+    std::fill(entries_.begin(), entries_.end(), UnassignedEntry);
+    keys_.clear();
+    hosts_.clear();
+    min_entries_per_host_ = 0;
+    max_entries_per_host_ = 0;
+    return assigned_entries;
+  }
+
+  // Sort by hash key like a full build does, so that hosts are visited in a stable order.
+  std::vector<BuildHost> build_hosts;
+  build_hosts.reserve(normalized_host_weights.size());
+  for (const auto& host_weight : normalized_host_weights) {
+    const absl::string_view key = ThreadAwareLoadBalancerBase::HashingLoadBalancer::hashKey(
+        host_weight.first, use_hostname_for_hashing_);
+    ASSERT(!key.empty());
+    build_hosts.push_back({std::string(key), host_weight.first, host_weight.second});
+  }
+  std::sort(build_hosts.begin(), build_hosts.end(),
+            [](const BuildHost& a, const BuildHost& b) { return a.key_ < b.key_; });
+  for (BuildHost& host : build_hosts) {
+    host.offset_ = HashUtil::xxHash64(host.key_) % table_size;
+    host.skip_ = (HashUtil::xxHash64(host.key_, 1) % (table_size - 1)) + 1;
+  }
+  setTargets(build_hosts);
+
+  // Map the hosts of the previous build to the current ones by hash key. Both are sorted.
+  std::vector<uint32_t> new_index(keys_.size(), UnassignedEntry);
+  for (uint32_t old_i = 0, new_i = 0; old_i < keys_.size() && new_i < build_hosts.size();) {
+    if (keys_[old_i] < build_hosts[new_i].key_) {
+      old_i++;
+    } else if (build_hosts[new_i].key_ < keys_[old_i]) {
+      new_i++;
+    } else {
+      new_index[old_i++] = new_i++;
+    }
+  }
+
+  // Carry over the entries of hosts that are still present.
+  uint64_t free_entries = 0;
+  for (uint32_t& entry : entries_) {
+    if (entry != UnassignedEntry) {
+      entry = new_index[entry];
+    }
+    if (entry == UnassignedEntry) {
+      free_entries++;
+    } else {
+      build_hosts[entry].count_++;
+    }
+  }
+
+  // Free the least preferred entries of hosts holding more than their share of the table. The
+  // candidates are grouped by host, so each host only needs a partial sort of its own entries.
+  std::vector<uint64_t> group_begin(build_hosts.size() + 1, 0);
+  for (uint32_t i = 0; i < build_hosts.size(); ++i) {
+    BuildHost& host = build_hosts[i];
+    const bool evicting = host.count_ > host.target_;
+    if (evicting) {
+      host.skip_inverse_ = modularInverse(host.skip_, table_size);
+    }
+    group_begin[i + 1] = group_begin[i] + (evicting ? host.count_ : 0);
+  }
+  if (group_begin.back() > 0) {
+    // Pairs of (preference, entry).
+    std::vector<std::pair<uint64_t, uint64_t>> candidates(group_begin.back());
+    std::vector<uint64_t> group_end(group_begin.begin(), group_begin.end() - 1);
+    for (uint64_t entry = 0; entry < table_size; ++entry) {
+      const uint32_t i = entries_[entry];
+      if (i != UnassignedEntry && build_hosts[i].count_ > build_hosts[i].target_) {
+        candidates[group_end[i]++] = {preference(build_hosts[i], entry), entry};
+      }
+    }
+    for (uint32_t i = 0; i < build_hosts.size(); ++i) {
+      BuildHost& host = build_hosts[i];
+      if (host.count_ <= host.target_) {
+        continue;
+      }
+      const uint64_t excess = host.count_ - host.target_;
+      const auto begin = candidates.begin() + group_begin[i];
+      std::nth_element(begin, begin + (excess - 1), candidates.begin() + group_begin[i + 1],
+                       std::greater<>());
+      for (auto it = begin; it != begin + excess; ++it) {
+        entries_[it->second] = UnassignedEntry;
+      }
+      host.count_ = host.target_;
+      free_entries += excess;
+    }
+  }
+
+  // Hand out the free entries like a full build does: hosts take turns claiming the next free
+  // entry of their permutation until they hold their share of the table.
+  std::vector<uint32_t> filling;
+  for (uint32_t i = 0; i < build_hosts.size(); ++i) {
+    if (build_hosts[i].count_ < build_hosts[i].target_) {
+      filling.push_back(i);
+    }
+  }
+  while (!filling.empty()) {
+    size_t still_filling = 0;
+    for (const uint32_t i : filling) {
+      BuildHost& host = build_hosts[i];
+      uint64_t c = permutation(host);
+      while (entries_[c] != UnassignedEntry) {
+        host.next_++;
+        c = permutation(host);
+      }
+      entries_[c] = i;
+      host.next_++;
+      if (++host.count_ < host.target_) {
+        filling[still_filling++] = i;
+      }
+    }
+    filling.resize(still_filling);
+  }
+
+  min_entries_per_host_ = table_size;
+  max_entries_per_host_ = 0;
+  keys_.clear();
+  hosts_.clear();
+  keys_.reserve(build_hosts.size());
+  hosts_.reserve(build_hosts.size());
+  for (BuildHost& host : build_hosts) {
+    min_entries_per_host_ = std::min(host.count_, min_entries_per_host_);
+    max_entries_per_host_ = std::max(host.count_, max_entries_per_host_);
+    keys_.push_back(std::move(host.key_));
+    hosts_.push_back(std::move(host.host_));
+  }
+  return free_entries;
+}
+
 void OriginalMaglevTable::logMaglevTable(bool use_hostname_for_hashing) const {
   for (uint64_t i = 0; i < table_.size(); ++i) {
     const absl::string_view key_to_hash = hashKey(table_[i], use_hostname_for_hashing);
@@ -306,7 +559,12 @@ MaglevLoadBalancer::MaglevLoadBalancer(
               ? config.consistent_hashing_lb_config().use_hostname_for_hashing()
               : false),
       hash_balance_factor_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.consistent_hashing_lb_config(),
-                                                           hash_balance_factor, 0)) {
+                                                           hash_balance_factor, 0)),
+      bounded_load_stride_probe_(
+          config.consistent_hashing_lb_config().bounded_load_probe() ==
+          envoy::extensions::load_balancing_policies::common::v3::ConsistentHashingLbConfig::
+              HASHED_STRIDE),
+      incremental_table_build_(config.incremental_table_build()) {
   ENVOY_LOG(debug, "maglev table size: {}", table_size_);
   // The table size must be prime number.
   if (!Primes::isPrime(table_size_)) {
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <limits>
+#include <string>
+#include <vector>
+
 #include "envoy/common/pure.h"
 #include "envoy/common/random_generator.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
@@ -50,6 +54,64 @@ struct MaglevLoadBalancerStats {
 class MaglevTable;
 using MaglevTableSharedPtr = std::shared_ptr<MaglevTable>;
 
+/**
+ * Builds Maglev tables incrementally from the table of the previous build. Rather than refilling
+ * the whole table, a build frees the entries of removed hosts and the least preferred entries of
+ * hosts that hold more than their share of the table, then hands the free entries to hosts that
+ * hold less than their share, in the order of their Maglev permutations. This keeps the number of
+ * reassigned entries close to the minimum, but the table then depends on the history of updates
+ * and not only on the current hosts.
+ *
+ * Builders are used on the main thread only. The tables created from them are immutable.
+ */
+class MaglevTableBuilder {
+public:
+  MaglevTableBuilder(uint64_t table_size, bool use_hostname_for_hashing);
+
+  /**
+   * Updates the table for the given hosts and weights.
+   * @return the number of table entries assigned to a different host than before.
+   */
+  uint64_t build(const NormalizedHostWeightVector& normalized_host_weights);
+
+  uint64_t tableSize() const { return entries_.size(); }
+  // Hosts sorted by hash key.
+  const std::vector<HostConstSharedPtr>& hosts() const { return hosts_; }
+  // For each table entry, the index into hosts() of the host it is assigned to.
+  const std::vector<uint32_t>& entries() const { return entries_; }
+  uint64_t minEntriesPerHost() const { return min_entries_per_host_; }
+  uint64_t maxEntriesPerHost() const { return max_entries_per_host_; }
+
+private:
+  static constexpr uint32_t UnassignedEntry = std::numeric_limits<uint32_t>::max();
+
+  struct BuildHost {
+    std::string key_;
+    HostConstSharedPtr host_;
+    double weight_;
+    uint64_t offset_{};
+    uint64_t skip_{};
+    // Only computed for hosts that give up entries.
+    uint64_t skip_inverse_{};
+    // Number of entries the host should hold, and holds.
+    uint64_t target_{};
+    uint64_t count_{};
+    uint64_t next_{};
+  };
+
+  uint64_t permutation(const BuildHost& host) const;
+  // Position of the given entry in the permutation of the host, lower is more preferred.
+  uint64_t preference(const BuildHost& host, uint64_t entry) const;
+  void setTargets(std::vector<BuildHost>& build_hosts) const;
+
+  const bool use_hostname_for_hashing_;
+  std::vector<std::string> keys_;
+  std::vector<HostConstSharedPtr> hosts_;
+  std::vector<uint32_t> entries_;
+  uint64_t min_entries_per_host_{};
+  uint64_t max_entries_per_host_{};
+};
+
 /**
  * This is an implementation of Maglev consistent hashing as described in:
  * https://static.googleusercontent.com/media/research.google.com/en//pubs/archive/44824.pdf
@@ -118,6 +180,7 @@ public:
     constructMaglevTableInternal(normalized_host_weights, max_normalized_weight,
                                  use_hostname_for_hashing);
   }
+  OriginalMaglevTable(const MaglevTableBuilder& builder, MaglevLoadBalancerStats& stats);
   ~OriginalMaglevTable() override = default;
 
   // ThreadAwareLoadBalancerBase::HashingLoadBalancer
@@ -143,6 +206,7 @@ public:
   CompactMaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                      double max_normalized_weight, uint64_t table_size,
                      bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats);
+  CompactMaglevTable(const MaglevTableBuilder& builder, MaglevLoadBalancerStats& stats);
   ~CompactMaglevTable() override = default;
 
   // ThreadAwareLoadBalancerBase::HashingLoadBalancer
@@ -184,7 +248,7 @@ public:
 private:
   // ThreadAwareLoadBalancerBase
   HashingLoadBalancerSharedPtr
-  createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+  createLoadBalancer(uint32_t priority, const NormalizedHostWeightVector& normalized_host_weights,
                      double /* min_normalized_weight */, double max_normalized_weight) override;
 
   Stats::ScopeSharedPtr scope_;
@@ -192,6 +256,10 @@ private:
   const uint64_t table_size_;
   const bool use_hostname_for_hashing_;
   const uint32_t hash_balance_factor_;
+  const bool bounded_load_stride_probe_;
+  const bool incremental_table_build_;
+  // Table builders indexed by priority, if tables are built incrementally.
+  std::vector<std::unique_ptr<MaglevTableBuilder>> table_builders_;
 };
 
 } // namespace Upstream
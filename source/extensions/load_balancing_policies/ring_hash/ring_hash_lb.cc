@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <iostream>
+#include <limits>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -9,7 +11,10 @@
 
 #include "source/common/common/assert.h"
 
-#include "absl/container/inlined_vector.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/numeric/bits.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
@@ -56,7 +61,11 @@ RingHashLoadBalancer::RingHashLoadBalancer(
       hash_balance_factor_(config.has_consistent_hashing_lb_config()
                                ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(
                                      config.consistent_hashing_lb_config(), hash_balance_factor, 0)
-                               : PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, hash_balance_factor, 0)) {
+                               : PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, hash_balance_factor, 0)),
+      bounded_load_stride_probe_(
+          config.consistent_hashing_lb_config().bounded_load_probe() ==
+          envoy::extensions::load_balancing_policies::common::v3::ConsistentHashingLbConfig::
+              HASHED_STRIDE) {
   // It's important to do any config validation here, rather than deferring to Ring's ctor,
   // because any exceptions thrown here will be caught and handled properly.
   if (min_ring_size_ > max_ring_size_) {
@@ -69,60 +78,92 @@ RingHashLoadBalancerStats RingHashLoadBalancer::generateStats(Stats::Scope& scop
   return {ALL_RING_HASH_LOAD_BALANCER_STATS(POOL_GAUGE(scope))};
 }
 
+HashingLoadBalancerSharedPtr RingHashLoadBalancer::createLoadBalancer(
+    uint32_t priority, const NormalizedHostWeightVector& normalized_host_weights,
+    double min_normalized_weight, double /* max_normalized_weight */) {
+  if (rings_.size() <= priority) {
+    rings_.resize(priority + 1);
+  }
+  auto ring = std::make_shared<Ring>(normalized_host_weights, min_normalized_weight,
+                                     min_ring_size_, max_ring_size_, hash_function_,
+                                     use_hostname_for_hashing_, stats_, rings_[priority].get());
+  // Workers may still be using the previous ring. It is never modified, and is released once the
+  // last of them picks up the new one.
+  rings_[priority] = ring;
+  if (hash_balance_factor_ == 0) {
+    return ring;
+  }
+
+  return std::make_shared<BoundedLoadHashingLoadBalancer>(
+      ring, normalized_host_weights, hash_balance_factor_, bounded_load_stride_probe_);
+}
+
 HostSelectionResponse RingHashLoadBalancer::Ring::chooseHost(uint64_t h, uint32_t attempt) const {
-  if (ring_.empty()) {
+  if (hashes_.empty()) {
     return {nullptr};
   }
 
-  // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c (ketama_get_server)
-  // I've generally kept the variable names to make the code easier to compare.
-  // NOTE: The algorithm depends on using signed integers for lowp, midp, and highp. Do not
-  //       change them!
-  int64_t lowp = 0;
-  int64_t highp = ring_.size();
-  int64_t midp = 0;
-  while (true) {
-    midp = (lowp + highp) / 2;
+  // Select the first ring point with a hash >= h, wrapping around to the first point of the ring,
+  // as ketama does (https://github.com/RJ/ketama/blob/master/libketama/ketama.c). All points
+  // before index_[bucket] have smaller hashes and all points from index_[bucket + 1] on have
+  // larger ones, so only the points in between need to be searched.
+  const uint64_t bucket = h >> index_shift_;
+  const auto begin = hashes_.begin() + index_[bucket];
+  const auto end = hashes_.begin() + index_[bucket + 1];
+  uint64_t pos = std::lower_bound(begin, end, h) - hashes_.begin();
+  if (pos == hashes_.size()) {
+    pos = 0;
+  }
 
-    if (midp == static_cast<int64_t>(ring_.size())) {
-      midp = 0;
-      break;
-    }
+  // If a retry host predicate is being applied, behave as if this host was not in the ring.
+  // Note that this does not guarantee a different host: e.g., attempt == ring size or
+  // when the offset causes us to select the same host at another location in the ring.
+  if (attempt > 0) {
+    pos = (pos + attempt) % hashes_.size();
+  }
 
-    uint64_t midval = ring_[midp].hash_;
-    uint64_t midval1 = midp == 0 ? 0 : ring_[midp - 1].hash_;
+  return hosts_[host_indices_[pos]];
+}
 
-    if (h <= midval && h > midval1) {
-      break;
-    }
+namespace {
 
-    if (midval < h) {
-      lowp = midp + 1;
-    } else {
-      highp = midp - 1;
-    }
+/**
+ * Computes the hashes of the ring points of a host, which are the hashes of "<key>_<i>".
+ */
+class RingPointHasher : Logger::Loggable<Logger::Id::upstream> {
+public:
+  RingPointHasher(RingHashLbProto::HashFunction hash_function) : hash_function_(hash_function) {}
 
-    if (lowp > highp) {
-      midp = 0;
-      break;
-    }
+  void setKey(absl::string_view key) {
+    buffer_.assign(key.data(), key.size());
+    buffer_.push_back('_');
+    key_size_ = buffer_.size();
   }
 
-  // If a retry host predicate is being applied, behave as if this host was not in the ring.
-  // Note that this does not guarantee a different host: e.g., attempt == ring_.size() or
-  // when the offset causes us to select the same host at another location in the ring.
-  if (attempt > 0) {
-    midp = (midp + attempt) % ring_.size();
+  uint64_t hash(uint64_t i) {
+    buffer_.resize(key_size_);
+    absl::StrAppend(&buffer_, i);
+    const uint64_t hash = (hash_function_ == RingHashLbProto::MURMUR_HASH_2)
+                              ? MurmurHash::murmurHash2(buffer_, MurmurHash::STD_HASH_SEED)
+                              : HashUtil::xxHash64(buffer_);
+    ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", buffer_, hash);
+    return hash;
   }
 
-  return ring_[midp].host_;
-}
+private:
+  const RingHashLbProto::HashFunction hash_function_;
+  std::string buffer_;
+  size_t key_size_{};
+};
+
+} // namespace
 
 using HashFunction = envoy::config::cluster::v3::Cluster::RingHashLbConfig::HashFunction;
 RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_host_weights,
                                  double min_normalized_weight, uint64_t min_ring_size,
                                  uint64_t max_ring_size, HashFunction hash_function,
-                                 bool use_hostname_for_hashing, RingHashLoadBalancerStats& stats)
+                                 bool use_hostname_for_hashing, RingHashLoadBalancerStats& stats,
+                                 const Ring* previous)
     : stats_(stats) {
   ENVOY_LOG(trace, "ring hash: building ring");
 
@@ -139,13 +180,10 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
   const double scale =
       std::min(std::ceil(min_normalized_weight * min_ring_size) / min_normalized_weight,
                static_cast<double>(max_ring_size));
-
-  // Reserve memory for the entire ring up front.
   const uint64_t ring_size = std::ceil(scale);
-  ring_.reserve(ring_size);
 
-  // Populate the hash ring by walking through the (host, weight) pairs in
-  // normalized_host_weights, and generating (scale * weight) hashes for each host. Since these
+  // Determine the number of hashes of each host by walking through the (host, weight) pairs in
+  // normalized_host_weights, and assigning (scale * weight) hashes to each host. Since these
   // aren't necessarily whole numbers, we maintain running sums -- current_hashes and
   // target_hashes -- which allows us to populate the ring in a mostly stable way.
   //
@@ -161,8 +199,9 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
   // For stats reporting, keep track of the minimum and maximum actual number of hashes per host.
   // Users should hopefully pay attention to these numbers and alert if min_hashes_per_host is too
   // low, since that implies an inaccurate request distribution.
-
-  absl::InlinedVector<char, 196> hash_key_buffer;
+  hosts_.reserve(normalized_host_weights.size());
+  host_keys_.reserve(normalized_host_weights.size());
+  host_hashes_.reserve(normalized_host_weights.size());
   double current_hashes = 0.0;
   double target_hashes = 0.0;
   uint64_t min_hashes_per_host = ring_size;
@@ -172,42 +211,28 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
     const absl::string_view key_to_hash = hashKey(host, use_hostname_for_hashing);
     ASSERT(!key_to_hash.empty());
 
-    hash_key_buffer.assign(key_to_hash.begin(), key_to_hash.end());
-    hash_key_buffer.emplace_back('_');
-    auto offset_start = hash_key_buffer.end();
-
-    // As noted above: maintain current_hashes and target_hashes as running sums across the entire
-    // host set. `i` is needed only to construct the hash key, and tally min/max hashes per host.
     target_hashes += scale * entry.second;
     uint64_t i = 0;
     while (current_hashes < target_hashes) {
-      const std::string i_str = absl::StrCat("", i);
-      hash_key_buffer.insert(offset_start, i_str.begin(), i_str.end());
-
-      absl::string_view hash_key(static_cast<char*>(hash_key_buffer.data()),
-                                 hash_key_buffer.size());
-
-      const uint64_t hash = (hash_function == HashFunction::RingHash_HashFunction_MURMUR_HASH_2)
-                                ? MurmurHash::murmurHash2(hash_key, MurmurHash::STD_HASH_SEED)
-                                : HashUtil::xxHash64(hash_key);
-
-      ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key, hash);
-      ring_.push_back({hash, host});
       ++i;
       ++current_hashes;
-      hash_key_buffer.erase(offset_start, hash_key_buffer.end());
     }
+    hosts_.push_back(host);
+    host_keys_.emplace_back(key_to_hash);
+    host_hashes_.push_back(i);
     min_hashes_per_host = std::min(i, min_hashes_per_host);
     max_hashes_per_host = std::max(i, max_hashes_per_host);
   }
 
-  std::sort(ring_.begin(), ring_.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
-    return lhs.hash_ < rhs.hash_;
-  });
+  if (previous == nullptr || previous->hashes_.empty() ||
+      !buildRingFrom(*previous, hash_function)) {
+    buildRing(hash_function);
+  }
+  buildIndex();
+
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
-    for (const auto& entry : ring_) {
-      const absl::string_view key_to_hash = hashKey(entry.host_, use_hostname_for_hashing);
-      ENVOY_LOG(trace, "ring hash: host={} hash={}", key_to_hash, entry.hash_);
+    for (uint64_t pos = 0; pos < hashes_.size(); ++pos) {
+      ENVOY_LOG(trace, "ring hash: host={} hash={}", host_keys_[host_indices_[pos]], hashes_[pos]);
     }
   }
 
@@ -216,5 +241,128 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
   stats_.max_hashes_per_host_.set(max_hashes_per_host);
 }
 
+void RingHashLoadBalancer::Ring::buildRing(HashFunction hash_function) {
+  const uint64_t size = std::accumulate(host_hashes_.begin(), host_hashes_.end(), uint64_t(0));
+  std::vector<std::pair<uint64_t, uint32_t>> points;
+  points.reserve(size);
+
+  RingPointHasher hasher(hash_function);
+  for (uint32_t host_index = 0; host_index < hosts_.size(); ++host_index) {
+    hasher.setKey(host_keys_[host_index]);
+    for (uint64_t i = 0; i < host_hashes_[host_index]; ++i) {
+      points.emplace_back(hasher.hash(i), host_index);
+    }
+  }
+
+  std::sort(points.begin(), points.end(),
+            [](const auto& lhs, const auto& rhs) -> bool { return lhs.first < rhs.first; });
+
+  hashes_.reserve(size);
+  host_indices_.reserve(size);
+  for (const auto& point : points) {
+    hashes_.push_back(point.first);
+    host_indices_.push_back(point.second);
+  }
+}
+
+bool RingHashLoadBalancer::Ring::buildRingFrom(const Ring& previous, HashFunction hash_function) {
+  // Hosts are matched with the hosts of the previous ring by hash key. Hosts that share a hash key
+  // have the same ring points, which can't be told apart, so such rings are built from scratch.
+  absl::flat_hash_map<absl::string_view, uint32_t> previous_host_indices;
+  previous_host_indices.reserve(previous.hosts_.size());
+  for (uint32_t i = 0; i < previous.host_keys_.size(); ++i) {
+    if (!previous_host_indices.try_emplace(previous.host_keys_[i], i).second) {
+      return false;
+    }
+  }
+  absl::flat_hash_set<absl::string_view> host_keys;
+  host_keys.reserve(host_keys_.size());
+  for (const std::string& key : host_keys_) {
+    if (!host_keys.insert(key).second) {
+      return false;
+    }
+  }
+
+  // For each host of the previous ring, its index in this ring, or RemovedHost. Hosts that keep
+  // fewer points than before drop their highest numbered points, and hosts that get more points
+  // add the next ones, so only the points that differ need to be hashed.
+  static constexpr uint32_t RemovedHost = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> new_host_indices(previous.hosts_.size(), RemovedHost);
+  std::vector<bool> shrunk(previous.hosts_.size(), false);
+  absl::flat_hash_set<std::pair<uint64_t, uint32_t>> removed_points;
+  std::vector<std::pair<uint64_t, uint32_t>> added_points;
+  RingPointHasher hasher(hash_function);
+  for (uint32_t host_index = 0; host_index < hosts_.size(); ++host_index) {
+    const uint64_t hashes = host_hashes_[host_index];
+    uint64_t previous_hashes = 0;
+    const auto it = previous_host_indices.find(host_keys_[host_index]);
+    if (it != previous_host_indices.end()) {
+      new_host_indices[it->second] = host_index;
+      previous_hashes = previous.host_hashes_[it->second];
+    }
+    if (hashes == previous_hashes) {
+      continue;
+    }
+
+    hasher.setKey(host_keys_[host_index]);
+    for (uint64_t i = previous_hashes; i < hashes; ++i) {
+      added_points.emplace_back(hasher.hash(i), host_index);
+    }
+    for (uint64_t i = hashes; i < previous_hashes; ++i) {
+      removed_points.emplace(hasher.hash(i), it->second);
+      shrunk[it->second] = true;
+    }
+  }
+
+  std::sort(added_points.begin(), added_points.end(),
+            [](const auto& lhs, const auto& rhs) -> bool { return lhs.first < rhs.first; });
+
+  // Merge the points that remain from the previous ring with the added points, both of which are
+  // sorted by hash.
+  const uint64_t size = std::accumulate(host_hashes_.begin(), host_hashes_.end(), uint64_t(0));
+  hashes_.reserve(size);
+  host_indices_.reserve(size);
+  auto added = added_points.begin();
+  for (uint64_t pos = 0; pos < previous.hashes_.size(); ++pos) {
+    const uint64_t hash = previous.hashes_[pos];
+    const uint32_t previous_host_index = previous.host_indices_[pos];
+    const uint32_t host_index = new_host_indices[previous_host_index];
+    if (host_index == RemovedHost ||
+        (shrunk[previous_host_index] &&
+         removed_points.contains(std::make_pair(hash, previous_host_index)))) {
+      continue;
+    }
+    for (; added != added_points.end() && added->first < hash; ++added) {
+      hashes_.push_back(added->first);
+      host_indices_.push_back(added->second);
+    }
+    hashes_.push_back(hash);
+    host_indices_.push_back(host_index);
+  }
+  for (; added != added_points.end(); ++added) {
+    hashes_.push_back(added->first);
+    host_indices_.push_back(added->second);
+  }
+  ASSERT(hashes_.size() == size);
+  return true;
+}
+
+void RingHashLoadBalancer::Ring::buildIndex() {
+  // Use an index slot for every two to four ring points, which keeps the index at a fraction of
+  // the size of the ring and the search within a slot to a single cache line.
+  const int index_bits = std::max(absl::bit_width(hashes_.size()) - 2, 1);
+  const uint64_t slots = uint64_t(1) << index_bits;
+  index_shift_ = 64 - index_bits;
+  index_.resize(slots + 1);
+  uint32_t pos = 0;
+  for (uint64_t slot = 0; slot < slots; ++slot) {
+    while (pos < hashes_.size() && (hashes_[pos] >> index_shift_) < slot) {
+      ++pos;
+    }
+    index_[slot] = pos;
+  }
+  index_[slots] = hashes_.size();
+}
+
 } // namespace Upstream
 } // namespace Envoy
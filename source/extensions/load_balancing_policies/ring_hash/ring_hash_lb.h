@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
@@ -70,39 +71,54 @@ public:
 private:
   using HashFunction = RingHashLbProto::HashFunction;
 
-  struct RingEntry {
-    uint64_t hash_;
-    HostConstSharedPtr host_;
-  };
-
+  /**
+   * An immutable ketama ring, shared by all workers. The ring points are kept sorted in a dense
+   * array of hashes with a parallel array of host indices, so that lookups only touch the 8 byte
+   * hashes. A two-level index over the top bits of the hashes narrows each lookup down to a few
+   * adjacent ring points.
+   *
+   * A ring can be built from the previous ring of the same priority. Hosts are matched by hash key,
+   * so only the hashes of added hosts and of hosts whose number of hashes changed are computed,
+   * and the new ring is the merge of the surviving points of the previous ring with the sorted new
+   * points. The result is the same as a full build.
+   */
   struct Ring : public HashingLoadBalancer {
     Ring(const NormalizedHostWeightVector& normalized_host_weights, double min_normalized_weight,
          uint64_t min_ring_size, uint64_t max_ring_size, HashFunction hash_function,
-         bool use_hostname_for_hashing, RingHashLoadBalancerStats& stats);
+         bool use_hostname_for_hashing, RingHashLoadBalancerStats& stats,
+         const Ring* previous = nullptr);
 
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
     HostSelectionResponse chooseHost(uint64_t hash, uint32_t attempt) const override;
 
-    std::vector<RingEntry> ring_;
+    uint64_t size() const { return hashes_.size(); }
+
+    // Hash of each ring point, in ascending order.
+    std::vector<uint64_t> hashes_;
+    // For each ring point, the index into hosts_ of its host.
+    std::vector<uint32_t> host_indices_;
+    // Hosts in the order of the normalized host weights, with their hash keys and the number of
+    // ring points each of them has.
+    std::vector<HostConstSharedPtr> hosts_;
+    std::vector<std::string> host_keys_;
+    std::vector<uint64_t> host_hashes_;
+    // index_[b] is the position of the first ring point whose hash has top bits >= b.
+    std::vector<uint32_t> index_;
+    uint32_t index_shift_{};
 
     RingHashLoadBalancerStats& stats_;
+
+  private:
+    void buildRing(HashFunction hash_function);
+    bool buildRingFrom(const Ring& previous, HashFunction hash_function);
+    void buildIndex();
   };
   using RingConstSharedPtr = std::shared_ptr<const Ring>;
 
   // ThreadAwareLoadBalancerBase
   HashingLoadBalancerSharedPtr
-  createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
-                     double min_normalized_weight, double /* max_normalized_weight */) override {
-    HashingLoadBalancerSharedPtr ring_hash_lb =
-        std::make_shared<Ring>(normalized_host_weights, min_normalized_weight, min_ring_size_,
-                               max_ring_size_, hash_function_, use_hostname_for_hashing_, stats_);
-    if (hash_balance_factor_ == 0) {
-      return ring_hash_lb;
-    }
-
-    return std::make_shared<BoundedLoadHashingLoadBalancer>(
-        ring_hash_lb, std::move(normalized_host_weights), hash_balance_factor_);
-  }
+  createLoadBalancer(uint32_t priority, const NormalizedHostWeightVector& normalized_host_weights,
+                     double min_normalized_weight, double /* max_normalized_weight */) override;
 
   static RingHashLoadBalancerStats generateStats(Stats::Scope& scope);
 
@@ -116,6 +132,9 @@ private:
   const HashFunction hash_function_;
   const bool use_hostname_for_hashing_;
   const uint32_t hash_balance_factor_;
+  const bool bounded_load_stride_probe_;
+  // The most recent ring of each priority, from which the next ring of the priority is built.
+  std::vector<RingConstSharedPtr> rings_;
 };
 
 } // namespace Upstream
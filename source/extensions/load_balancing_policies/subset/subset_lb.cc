@@ -58,9 +58,11 @@ SubsetLoadBalancer::SubsetLoadBalancer(const SubsetLoadBalancerConfig& lb_config
                                lb_config_.subsetInfo().defaultSubset().fields().end()),
       subset_selectors_(lb_config_.subsetInfo().subsetSelectors()),
       original_priority_set_(priority_set), original_local_priority_set_(local_priority_set),
+      max_lazy_subsets_(lb_config_.subsetInfo().maxLazySubsets()),
       locality_weight_aware_(lb_config_.subsetInfo().localityWeightAware()),
       scale_locality_weight_(lb_config_.subsetInfo().scaleLocalityWeight()),
       list_as_any_(lb_config_.subsetInfo().listAsAny()),
+      lazy_subsets_(lb_config_.subsetInfo().lazySubsets()),
       allow_redundant_keys_(lb_config_.subsetInfo().allowRedundantKeys()) {
   ASSERT(lb_config_.subsetInfo().isEnabled());
 
@@ -84,6 +86,10 @@ SubsetLoadBalancer::SubsetLoadBalancer(const SubsetLoadBalancerConfig& lb_config
 
   initSubsetSelectorMap();
 
+  if (lazy_subsets_) {
+    initLazySubsets();
+  }
+
   // Create filtered default subset (if necessary) and other subsets based on current hosts.
   refreshSubsets();
 
@@ -104,6 +110,9 @@ SubsetLoadBalancer::~SubsetLoadBalancer() {
       stats_.lb_subsets_active_.dec();
     }
   });
+  if (lazy_subsets_active_stat_ != nullptr) {
+    lazy_subsets_active_stat_->sub(lazy_subsets_list_.size());
+  }
 }
 
 void SubsetLoadBalancer::refreshSubsets() {
@@ -372,6 +381,13 @@ HostConstSharedPtr SubsetLoadBalancer::tryChooseHostFromContext(LoadBalancerCont
 
   // Route has metadata match criteria defined, see if we have a matching subset.
   LbSubsetEntryPtr entry = findSubset(match_criteria->metadataMatchCriteria());
+  if (lazy_subsets_) {
+    if (entry == nullptr || !entry->initialized()) {
+      entry = materializeSubset(match_criteria->metadataMatchCriteria());
+    } else {
+      touchLazySubset(entry.get());
+    }
+  }
   if (entry == nullptr || !entry->active()) {
     // No matching subset or subset not active: use fallback policy.
     return {nullptr};
@@ -480,6 +496,10 @@ void SubsetLoadBalancer::processSubsets(uint32_t priority, const HostVector& all
 
   for (const auto& host : all_hosts) {
     for (const auto& subset_selector : subset_selectors_) {
+      if (lazy_subsets_ && !subset_selector->singleHostPerSubset()) {
+        // Built on first use from the host index instead.
+        continue;
+      }
       const auto& keys = subset_selector->selectorKeys();
       // For each host, for each subset key, attempt to extract the metadata corresponding to the
       // key from the host.
@@ -514,6 +534,10 @@ void SubsetLoadBalancer::processSubsets(uint32_t priority, const HostVector& all
   }
   single_duplicate_stat_->set(collision_count_of_single_host_entries);
 
+  if (lazy_subsets_) {
+    updateLazySubsets(priority, all_hosts);
+  }
+
   // Finalize updates after all the hosts are evaluated.
   forEachSubset(subsets_, [priority, this](LbSubsetEntryPtr entry) {
     if (entry->initialized()) {
@@ -522,6 +546,240 @@ void SubsetLoadBalancer::processSubsets(uint32_t priority, const HostVector& all
   });
 }
 
+void SubsetLoadBalancer::initLazySubsets() {
+  for (const auto& subset_selector : subset_selectors_) {
+    if (subset_selector->singleHostPerSubset()) {
+      continue;
+    }
+    const auto& keys = subset_selector->selectorKeys();
+    lazy_selector_keys_.emplace(keys.begin(), keys.end());
+    lazy_index_keys_.insert(keys.begin(), keys.end());
+  }
+
+  // Like lb_subsets_single_host_per_subset_duplicate, these stats are only needed by the few
+  // clusters opting into lazy subsets and so are not part of `ClusterLbStats`.
+  Stats::StatNameManagedStorage active_name("lb_subsets_lazy_active", scope_.symbolTable());
+  lazy_subsets_active_stat_ = &Stats::Utility::gaugeFromElements(
+      scope_, {active_name.statName()}, Stats::Gauge::ImportMode::Accumulate);
+  Stats::StatNameManagedStorage evicted_name("lb_subsets_lazy_evicted", scope_.symbolTable());
+  lazy_subsets_evicted_stat_ =
+      &Stats::Utility::counterFromElements(scope_, {evicted_name.statName()});
+  Stats::StatNameManagedStorage rebuild_name("lb_subsets_lazy_rebuild_us", scope_.symbolTable());
+  lazy_subsets_rebuild_stat_ = &Stats::Utility::histogramFromElements(
+      scope_, {rebuild_name.statName()}, Stats::Histogram::Unit::Microseconds);
+}
+
+// Rebuilds the host index of the priority and pushes the matching hosts of every lazily built
+// subset. The hosts are then applied by the same finalize pass as the eagerly built subsets.
+void SubsetLoadBalancer::updateLazySubsets(uint32_t priority, const HostVector& all_hosts) {
+  const MonotonicTime start = time_source_.monotonicTime();
+
+  rebuildHostIndex(priority, all_hosts);
+  for (const auto& lazy_subset : lazy_subsets_list_) {
+    for (auto& host : findIndexedHosts(priority, lazy_subset.kvs_)) {
+      lazy_subset.entry_->lb_subset_->pushHost(priority, std::move(host));
+    }
+  }
+
+  lazy_subsets_rebuild_stat_->recordValue(std::chrono::duration_cast<std::chrono::microseconds>(
+                                              time_source_.monotonicTime() - start)
+                                              .count());
+}
+
+void SubsetLoadBalancer::rebuildHostIndex(uint32_t priority, const HostVector& all_hosts) {
+  if (host_indices_.size() <= priority) {
+    host_indices_.resize(priority + 1);
+  }
+  HostIndex& index = host_indices_[priority];
+  index.hosts_ = all_hosts;
+  index.bitmaps_.clear();
+
+  for (uint32_t i = 0; i < all_hosts.size(); ++i) {
+    const auto& metadata = all_hosts[i]->metadata();
+    if (metadata == nullptr) {
+      continue;
+    }
+    const auto& filter_it =
+        metadata->filter_metadata().find(Config::MetadataFilters::get().ENVOY_LB);
+    if (filter_it == metadata->filter_metadata().end()) {
+      continue;
+    }
+
+    const auto& fields = filter_it->second.fields();
+    for (const auto& key : lazy_index_keys_) {
+      const auto it = fields.find(key);
+      if (it == fields.end()) {
+        continue;
+      }
+      auto& value_bitmaps = index.bitmaps_[key];
+      if (list_as_any_ && it->second.kind_case() == ProtobufWkt::Value::kListValue) {
+        for (const auto& value : it->second.list_value().values()) {
+          value_bitmaps[HashedValue(value)].add(i);
+        }
+      } else {
+        value_bitmaps[HashedValue(it->second)].add(i);
+      }
+    }
+  }
+
+  for (auto& [key, value_bitmaps] : index.bitmaps_) {
+    for (auto& [value, bitmap] : value_bitmaps) {
+      bitmap.seal(all_hosts.size());
+    }
+  }
+}
+
+// Returns the hosts of the priority matching all the given key-values by intersecting their
+// bitmaps.
+HostVector SubsetLoadBalancer::findIndexedHosts(uint32_t priority,
+                                                const HashedSubsetMetadata& kvs) const {
+  HostVector hosts;
+  if (priority >= host_indices_.size()) {
+    return hosts;
+  }
+  const HostIndex& index = host_indices_[priority];
+
+  std::vector<const HostBitmap*> bitmaps;
+  bitmaps.reserve(kvs.size());
+  for (const auto& [key, value] : kvs) {
+    const auto key_it = index.bitmaps_.find(key);
+    if (key_it == index.bitmaps_.end()) {
+      return hosts;
+    }
+    const auto value_it = key_it->second.find(value);
+    if (value_it == key_it->second.end()) {
+      return hosts;
+    }
+    bitmaps.push_back(&value_it->second);
+  }
+  ASSERT(!bitmaps.empty());
+
+  // Walk the smallest set and probe the others.
+  std::sort(bitmaps.begin(), bitmaps.end(),
+            [](const HostBitmap* a, const HostBitmap* b) { return a->size() < b->size(); });
+  bitmaps.front()->forEach([&](uint32_t position) {
+    for (size_t i = 1; i < bitmaps.size(); ++i) {
+      if (!bitmaps[i]->contains(position)) {
+        return;
+      }
+    }
+    hosts.push_back(index.hosts_[position]);
+  });
+  return hosts;
+}
+
+// Builds the subset selected by the match criteria from the host index. Returns nullptr if the
+// criteria keys don't form a lazily built selector or no host matches, which is when no subset
+// would have been built eagerly either.
+SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::materializeSubset(
+    const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& match_criteria) {
+  std::vector<std::string> keys;
+  keys.reserve(match_criteria.size());
+  for (const auto& criterion : match_criteria) {
+    keys.push_back(criterion->name());
+  }
+  if (!lazy_selector_keys_.contains(keys)) {
+    return nullptr;
+  }
+
+  HashedSubsetMetadata kvs;
+  kvs.reserve(match_criteria.size());
+  for (const auto& criterion : match_criteria) {
+    kvs.emplace_back(criterion->name(), criterion->value());
+  }
+
+  std::vector<HostVector> hosts_per_priority;
+  bool found = false;
+  for (uint32_t priority = 0; priority < host_indices_.size(); ++priority) {
+    hosts_per_priority.push_back(findIndexedHosts(priority, kvs));
+    found |= !hosts_per_priority.back().empty();
+  }
+  if (!found) {
+    return nullptr;
+  }
+
+  SubsetMetadata metadata;
+  metadata.reserve(kvs.size());
+  for (const auto& [key, value] : kvs) {
+    metadata.emplace_back(key, value.value());
+  }
+  LbSubsetEntryPtr entry = findOrCreateLbSubsetEntry(subsets_, metadata, 0);
+  initLbSubsetEntryOnce(entry, false);
+  for (uint32_t priority = 0; priority < hosts_per_priority.size(); ++priority) {
+    for (auto& host : hosts_per_priority[priority]) {
+      entry->lb_subset_->pushHost(priority, std::move(host));
+    }
+    entry->lb_subset_->finalize(priority, random_.random());
+  }
+
+  lazy_subsets_list_.push_front({entry, std::move(kvs)});
+  lazy_subsets_lookup_[entry.get()] = lazy_subsets_list_.begin();
+  lazy_subsets_active_stat_->inc();
+  evictLazySubsets();
+  return entry;
+}
+
+void SubsetLoadBalancer::touchLazySubset(const LbSubsetEntry* entry) {
+  const auto it = lazy_subsets_lookup_.find(entry);
+  if (it != lazy_subsets_lookup_.end()) {
+    lazy_subsets_list_.splice(lazy_subsets_list_.begin(), lazy_subsets_list_, it->second);
+  }
+}
+
+void SubsetLoadBalancer::removeLazySubset(const LbSubsetEntry* entry) {
+  const auto it = lazy_subsets_lookup_.find(entry);
+  if (it != lazy_subsets_lookup_.end()) {
+    lazy_subsets_list_.erase(it->second);
+    lazy_subsets_lookup_.erase(it);
+    lazy_subsets_active_stat_->dec();
+  }
+}
+
+void SubsetLoadBalancer::evictLazySubsets() {
+  while (lazy_subsets_list_.size() > max_lazy_subsets_) {
+    LbSubsetEntryPtr entry = lazy_subsets_list_.back().entry_;
+    // The entry stays in the subset map uninitialized. It is either built again on its next use
+    // or purged by the next host update.
+    entry->lb_subset_.reset();
+    stats_.lb_subsets_active_.dec();
+    stats_.lb_subsets_removed_.inc();
+    lazy_subsets_evicted_stat_->inc();
+    removeLazySubset(entry.get());
+  }
+}
+
+void SubsetLoadBalancer::HostBitmap::add(uint32_t position) {
+  ASSERT(words_.empty());
+  ASSERT(positions_.empty() || positions_.back() <= position);
+  // A list value may carry the same value more than once.
+  if (positions_.empty() || positions_.back() != position) {
+    positions_.push_back(position);
+    size_++;
+  }
+}
+
+void SubsetLoadBalancer::HostBitmap::seal(uint32_t num_hosts) {
+  // The position list takes 32 bits per host in the set while the bitmap takes one bit per host
+  // in the priority.
+  if (uint64_t(size_) * 32 <= num_hosts) {
+    positions_.shrink_to_fit();
+    return;
+  }
+  words_.assign((num_hosts + 63) / 64, 0);
+  for (const uint32_t position : positions_) {
+    words_[position / 64] |= uint64_t(1) << (position % 64);
+  }
+  positions_.clear();
+  positions_.shrink_to_fit();
+}
+
+bool SubsetLoadBalancer::HostBitmap::contains(uint32_t position) const {
+  if (words_.empty()) {
+    return std::binary_search(positions_.begin(), positions_.end(), position);
+  }
+  return (words_[position / 64] >> (position % 64)) & 1;
+}
+
 // Given the latest all hosts, update all subsets for this priority level, creating new subsets as
 // necessary.
 void SubsetLoadBalancer::update(uint32_t priority, const HostVector& all_hosts) {
@@ -689,6 +947,9 @@ void SubsetLoadBalancer::purgeEmptySubsets(LbSubsetMap& subsets) {
       if (entry->initialized()) {
         stats_.lb_subsets_active_.dec();
         stats_.lb_subsets_removed_.inc();
+        if (lazy_subsets_) {
+          removeLazySubset(entry.get());
+        }
       }
 
       auto next_it = std::next(it);
@@ -4,6 +4,7 @@
 #include <bitset>
 #include <cstdint>
 #include <functional>
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
@@ -13,6 +14,7 @@
 #include "envoy/extensions/load_balancing_policies/subset/v3/subset.pb.h"
 #include "envoy/extensions/load_balancing_policies/subset/v3/subset.pb.validate.h"
 #include "envoy/runtime/runtime.h"
+#include "envoy/stats/histogram.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stream_info/stream_info.h"
 #include "envoy/upstream/load_balancer.h"
@@ -24,7 +26,10 @@
 #include "source/common/upstream/upstream_impl.h"
 #include "source/extensions/load_balancing_policies/subset/subset_lb_config.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/numeric/bits.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -310,8 +315,66 @@ private:
     bool single_host_subset_{};
   };
 
+  // Set of host positions in the host vector of one priority. Small sets are kept as a sorted
+  // position list and are converted to a dense bitmap when that is the more compact form, so an
+  // index over many distinct metadata values costs memory proportional to the hosts carrying them.
+  class HostBitmap {
+  public:
+    // Positions must be added in non-decreasing order.
+    void add(uint32_t position);
+    // Called once all the positions are added to pick the compact representation.
+    void seal(uint32_t num_hosts);
+    bool contains(uint32_t position) const;
+    uint32_t size() const { return size_; }
+
+    template <class Callback> void forEach(Callback cb) const {
+      if (words_.empty()) {
+        for (const uint32_t position : positions_) {
+          cb(position);
+        }
+        return;
+      }
+      for (uint32_t i = 0; i < words_.size(); ++i) {
+        for (uint64_t word = words_[i]; word != 0; word &= word - 1) {
+          cb(i * 64 + absl::countr_zero(word));
+        }
+      }
+    }
+
+  private:
+    std::vector<uint32_t> positions_;
+    std::vector<uint64_t> words_;
+    uint32_t size_{};
+  };
+
+  // Inverted index from the metadata keys of the lazily built selectors and their values to the
+  // hosts of one priority.
+  struct HostIndex {
+    HostVector hosts_;
+    absl::flat_hash_map<std::string, absl::flat_hash_map<HashedValue, HostBitmap>> bitmaps_;
+  };
+
+  using HashedSubsetMetadata = std::vector<std::pair<std::string, HashedValue>>;
+
+  // A subset built on first use from the host index.
+  struct LazySubset {
+    LbSubsetEntryPtr entry_;
+    HashedSubsetMetadata kvs_;
+  };
+  using LazySubsetList = std::list<LazySubset>;
+
   void initLbSubsetEntryOnce(LbSubsetEntryPtr& entry, bool single_host_subset);
 
+  void initLazySubsets();
+  void updateLazySubsets(uint32_t priority, const HostVector& all_hosts);
+  void rebuildHostIndex(uint32_t priority, const HostVector& all_hosts);
+  HostVector findIndexedHosts(uint32_t priority, const HashedSubsetMetadata& kvs) const;
+  LbSubsetEntryPtr
+  materializeSubset(const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& matches);
+  void touchLazySubset(const LbSubsetEntry* entry);
+  void removeLazySubset(const LbSubsetEntry* entry);
+  void evictLazySubsets();
+
   // Create filtered default subset (if necessary) and other subsets based on current hosts.
   void refreshSubsets();
   void refreshSubsets(uint32_t priority);
@@ -378,10 +441,23 @@ private:
 
   Stats::Gauge* single_duplicate_stat_{};
 
+  // Only used when lazy subsets are enabled. lazy_subsets_list_ is kept in most recently used
+  // order and holds every subset built from host_indices_.
+  absl::flat_hash_set<std::vector<std::string>> lazy_selector_keys_;
+  std::set<std::string> lazy_index_keys_;
+  std::vector<HostIndex> host_indices_;
+  LazySubsetList lazy_subsets_list_;
+  absl::flat_hash_map<const LbSubsetEntry*, LazySubsetList::iterator> lazy_subsets_lookup_;
+  const uint32_t max_lazy_subsets_;
+  Stats::Gauge* lazy_subsets_active_stat_{};
+  Stats::Counter* lazy_subsets_evicted_stat_{};
+  Stats::Histogram* lazy_subsets_rebuild_stat_{};
+
   // Keep small members (bools and enums) at the end of class, to reduce alignment overhead.
   const bool locality_weight_aware_ : 1;
   const bool scale_locality_weight_ : 1;
   const bool list_as_any_ : 1;
+  const bool lazy_subsets_ : 1;
   const bool allow_redundant_keys_{};
 };
 
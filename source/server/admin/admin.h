@@ -239,6 +239,7 @@ public:
   bool appendLocalOverload() const override { return false; }
   bool appendXForwardedPort() const override { return false; }
   bool addProxyProtocolConnectionState() const override { return true; }
+  uint32_t streamArenaBlockSize() const override { return 0; }
 
 private:
   friend class AdminTestingPeer;
@@ -26,6 +26,7 @@
 
 #include "source/common/api/api_impl.h"
 #include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/common/enum_to_int.h"
 #include "source/common/common/mutex_tracer_impl.h"
 #include "source/common/common/utility.h"
@@ -284,6 +285,19 @@ void InstanceBase::updateServerStats() {
       enumToInt(Utility::serverState(initManager().state(), healthCheckFailed())));
   server_stats_->stats_recent_lookups_.set(
       stats_store_.symbolTable().getRecentLookups([](absl::string_view, uint64_t) {}));
+
+  // The slice pools count since process start; bring the counters up to date.
+  const Buffer::SlicePoolStats slice_pool_stats = Buffer::SlicePool::stats();
+  server_stats_->buffer_slice_pool_hits_.add(slice_pool_stats.hits_ -
+                                             server_stats_->buffer_slice_pool_hits_.value());
+  server_stats_->buffer_slice_pool_misses_.add(slice_pool_stats.misses_ -
+                                               server_stats_->buffer_slice_pool_misses_.value());
+  server_stats_->buffer_slice_pool_overflows_.add(
+      slice_pool_stats.overflows_ - server_stats_->buffer_slice_pool_overflows_.value());
+  server_stats_->buffer_slice_pool_cross_thread_releases_.add(
+      slice_pool_stats.cross_thread_releases_ -
+      server_stats_->buffer_slice_pool_cross_thread_releases_.value());
+  server_stats_->buffer_slice_pool_cached_bytes_.set(slice_pool_stats.cached_bytes_);
 }
 
 void InstanceBase::flushStatsInternal() {
@@ -747,6 +761,21 @@ absl::Status InstanceBase::initializeOrThrow(Network::Address::InstanceConstShar
   InstanceUtil::raiseFileLimits();
 #endif
 
+  // The buffer slice pools are configured once runtime is loaded, so that the runtime guard can
+  // turn them off.
+  Buffer::SlicePoolConfig slice_pool_config;
+  if (!Runtime::runtimeFeatureEnabled("envoy.reloadable_features.buffer_slice_pool")) {
+    slice_pool_config.max_blocks_per_class_ = 0;
+  } else if (bootstrap_.has_buffer_slice_pool()) {
+    slice_pool_config.max_blocks_per_class_ =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(bootstrap_.buffer_slice_pool(), max_blocks_per_size_class,
+                                        Buffer::SlicePoolConfig::DefaultMaxBlocksPerClass);
+    slice_pool_config.max_cached_bytes_ =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(bootstrap_.buffer_slice_pool(), max_cached_bytes_per_thread,
+                                        Buffer::SlicePoolConfig::DefaultMaxCachedBytes);
+  }
+  Buffer::SlicePool::setConfig(slice_pool_config);
+
   if (!runtime().snapshot().getBoolean("envoy.disallow_global_stats", false)) {
     assert_action_registration_ = Assert::addDebugAssertionFailureRecordAction(
         [this](const char*) { server_stats_->debug_assertion_failures_.inc(); });
@@ -76,6 +76,11 @@ struct ServerCompilationSettingsStats {
   COUNTER(static_unknown_fields)                                                                   \
   COUNTER(wip_protos)                                                                              \
   COUNTER(dropped_stat_flushes)                                                                    \
+  COUNTER(buffer_slice_pool_hits)                                                                  \
+  COUNTER(buffer_slice_pool_misses)                                                                \
+  COUNTER(buffer_slice_pool_overflows)                                                             \
+  COUNTER(buffer_slice_pool_cross_thread_releases)                                                 \
+  GAUGE(buffer_slice_pool_cached_bytes, NeverImport)                                               \
   GAUGE(concurrency, NeverImport)                                                                  \
   GAUGE(days_until_first_cert_expiring, NeverImport)                                               \
   GAUGE(seconds_until_first_ocsp_response_expiring, NeverImport)                                   \
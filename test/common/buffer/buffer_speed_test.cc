@@ -2,6 +2,7 @@
 #include "envoy/http/stream_reset_handler.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/buffer/watermark_buffer.h"
 #include "source/common/common/assert.h"
 
@@ -558,4 +559,40 @@ BENCHMARK(bufferAddVsAddFragments)
     ->Args({1, 1, 64, 5})
     ->Args({1, 1, 4096, 5});
 
+// Proxy-like churn of 16 KiB slices: read a body through reservations and drain it, with the
+// thread's slice pool enabled (range(1) != 0) or disabled. Run on several threads to show that the
+// pools do not contend.
+static void bufferSlicePoolChurn(benchmark::State& state) {
+  const uint64_t body_size = state.range(0);
+  Buffer::SlicePoolConfig config;
+  if (state.range(1) == 0) {
+    config.max_blocks_per_class_ = 0;
+  }
+  if (state.thread_index() == 0) {
+    Buffer::SlicePool::setConfig(config);
+  }
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Buffer::OwnedImpl buffer;
+    while (buffer.length() < body_size) {
+      auto reservation = buffer.reserveForRead();
+      reservation.commit(std::min<uint64_t>(reservation.length(), body_size - buffer.length()));
+    }
+    benchmark::DoNotOptimize(buffer.length());
+    buffer.drain(buffer.length());
+  }
+
+  if (state.thread_index() == 0) {
+    Buffer::SlicePool::setConfig({});
+  }
+}
+BENCHMARK(bufferSlicePoolChurn)
+    ->Args({16384, 0})
+    ->Args({16384, 1})
+    ->Args({262144, 0})
+    ->Args({262144, 1})
+    ->Threads(1)
+    ->Threads(4);
+
 } // namespace Envoy
@@ -115,6 +115,51 @@ TEST_F(OwnedImplTest, MoveBufferFragmentWithReleaseDrainTracker) {
   buffer2.drain(buffer2.length());
 }
 
+// A fragment whose data is claimed to also be held by a file, for tests of the file range
+// tracking; nothing reads the file.
+class FileBackedTestFragment : public BufferFragmentImpl {
+public:
+  FileBackedTestFragment(absl::string_view data, int fd, off_t offset)
+      : BufferFragmentImpl(data.data(), data.size(), nullptr), fd_(fd), offset_(offset) {}
+
+  absl::optional<FileRange> fileRange() const override {
+    return FileRange{fd_, offset_, size()};
+  }
+
+private:
+  const int fd_;
+  const off_t offset_;
+};
+
+TEST_F(OwnedImplTest, FileBackedFragmentTracksFileRange) {
+  FileBackedTestFragment frag("hello world", 42, 100);
+  Buffer::OwnedImpl buffer("abc");
+  buffer.addBufferFragment(frag);
+  EXPECT_FALSE(buffer.frontFileRange().has_value());
+
+  buffer.drain(3);
+  absl::optional<FileRange> range = buffer.frontFileRange();
+  ASSERT_TRUE(range.has_value());
+  EXPECT_EQ(42, range->fd_);
+  EXPECT_EQ(100, range->offset_);
+  EXPECT_EQ(11, range->length_);
+
+  // The range follows the data as it is drained, and as the slice is moved to another buffer.
+  buffer.drain(6);
+  Buffer::OwnedImpl moved;
+  moved.move(buffer);
+  range = moved.frontFileRange();
+  ASSERT_TRUE(range.has_value());
+  EXPECT_EQ(106, range->offset_);
+  EXPECT_EQ(5, range->length_);
+  EXPECT_EQ("world", moved.toString());
+
+  // A copy of the data is not backed by the file.
+  Buffer::OwnedImpl copied;
+  copied.add(moved);
+  EXPECT_FALSE(copied.frontFileRange().has_value());
+}
+
 TEST_F(OwnedImplTest, AddEmptyFragment) {
   char input[] = "hello world";
   BufferFragmentImpl frag1(input, 11, [](const void*, size_t, const BufferFragmentImpl*) {});
@@ -1338,6 +1383,44 @@ TYPED_TEST(OwnedImplTypedTest, Write) {
   EXPECT_EQ(0, buffer.length());
 }
 
+#if defined(__linux__)
+TEST_F(OwnedImplTest, WriteFileBackedFragmentWithSendfile) {
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  Api::MockLinuxOsSysCalls linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+
+  FileBackedTestFragment frag("example", 42, 100);
+  Buffer::OwnedImpl buffer;
+  buffer.addBufferFragment(frag);
+  Network::IoSocketHandleImpl io_handle;
+  EXPECT_CALL(linux_os_sys_calls, sendfile(_, 42, _, 7))
+      .WillOnce([](int, int, off_t* offset, size_t) {
+        EXPECT_EQ(100, *offset);
+        return Api::SysCallSizeResult{4, 0};
+      });
+  Api::IoCallUint64Result result = io_handle.write(buffer);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(4, result.return_value_);
+  EXPECT_EQ("ple", buffer.toString());
+
+  EXPECT_CALL(linux_os_sys_calls, sendfile(_, 42, _, 3))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN}));
+  result = io_handle.write(buffer);
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+  EXPECT_EQ(3, buffer.length());
+
+  // If the file turns out to be short, the data is written from memory instead.
+  EXPECT_CALL(linux_os_sys_calls, sendfile(_, 42, _, 3))
+      .WillOnce(Return(Api::SysCallSizeResult{0, 0}));
+  EXPECT_CALL(os_sys_calls, send(_, _, 3, _)).WillOnce(Return(Api::SysCallSizeResult{3, 0}));
+  result = io_handle.write(buffer);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(3, result.return_value_);
+  EXPECT_EQ(0, buffer.length());
+}
+#endif
+
 TYPED_TEST(OwnedImplTypedTest, Read) {
   Api::MockOsSysCalls os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
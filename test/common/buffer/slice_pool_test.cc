@@ -0,0 +1,113 @@
+#include <thread>
+
+#include "source/common/buffer/slice_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+class SlicePoolTest : public testing::Test {
+protected:
+  SlicePoolTest() : initial_(SlicePool::stats()) {}
+  ~SlicePoolTest() override { SlicePool::setConfig({}); }
+
+  uint64_t hits() const { return SlicePool::stats().hits_ - initial_.hits_; }
+  uint64_t misses() const { return SlicePool::stats().misses_ - initial_.misses_; }
+  uint64_t overflows() const { return SlicePool::stats().overflows_ - initial_.overflows_; }
+  uint64_t crossThreadReleases() const {
+    return SlicePool::stats().cross_thread_releases_ - initial_.cross_thread_releases_;
+  }
+
+  const SlicePoolStats initial_;
+};
+
+TEST_F(SlicePoolTest, ReleasedBlockIsReused) {
+  // Use a size class no other test keeps cached.
+  constexpr uint64_t size = 20480;
+  uint8_t* address;
+  {
+    SlicePool::BlockPtr block = SlicePool::allocate(size);
+    address = block.get();
+  }
+  SlicePool::BlockPtr block = SlicePool::allocate(size);
+  EXPECT_EQ(address, block.get());
+  EXPECT_EQ(1, hits());
+}
+
+TEST_F(SlicePoolTest, UnpooledSizes) {
+  SlicePool::allocate(4096);
+  SlicePool::allocate(16385);
+  SlicePool::allocate(SlicePool::MaxBlockSize + SlicePool::PageSize);
+  EXPECT_EQ(0, hits());
+  EXPECT_EQ(0, misses());
+}
+
+TEST_F(SlicePoolTest, BlocksPerClassCap) {
+  SlicePoolConfig config;
+  config.max_blocks_per_class_ = 1;
+  SlicePool::setConfig(config);
+
+  constexpr uint64_t size = 24576;
+  SlicePool::BlockPtr first = SlicePool::allocate(size);
+  SlicePool::BlockPtr second = SlicePool::allocate(size);
+  const uint64_t cached_bytes = SlicePool::stats().cached_bytes_;
+  first.reset();
+  second.reset();
+  EXPECT_EQ(1, overflows());
+  EXPECT_EQ(cached_bytes + size, SlicePool::stats().cached_bytes_);
+}
+
+TEST_F(SlicePoolTest, CachedBytesCap) {
+  SlicePoolConfig config;
+  config.max_cached_bytes_ = 0;
+  SlicePool::setConfig(config);
+
+  SlicePool::allocate(SlicePool::MinBlockSize);
+  EXPECT_EQ(1, overflows());
+}
+
+TEST_F(SlicePoolTest, Disabled) {
+  SlicePoolConfig config;
+  config.max_blocks_per_class_ = 0;
+  SlicePool::setConfig(config);
+
+  SlicePool::allocate(SlicePool::MinBlockSize);
+  SlicePool::allocate(SlicePool::MinBlockSize);
+  EXPECT_EQ(0, hits());
+  EXPECT_EQ(0, misses());
+  EXPECT_EQ(0, overflows());
+}
+
+TEST_F(SlicePoolTest, ReleaseCachedBlocks) {
+  constexpr uint64_t size = 36864;
+  SlicePool::allocate(size);
+  EXPECT_LE(size, SlicePool::stats().cached_bytes_);
+
+  // The cache is dropped when the thread next uses its pool.
+  SlicePool::releaseCachedBlocks();
+  SlicePool::BlockPtr block = SlicePool::allocate(size);
+  EXPECT_EQ(0, SlicePool::stats().cached_bytes_);
+  EXPECT_EQ(0, hits());
+  EXPECT_EQ(2, misses());
+}
+
+TEST_F(SlicePoolTest, CrossThreadReleaseGoesToHeap) {
+  SlicePool::BlockPtr block = SlicePool::allocate(28672);
+  std::thread([&block]() { block.reset(); }).join();
+  EXPECT_EQ(1, crossThreadReleases());
+}
+
+TEST_F(SlicePoolTest, ExitedThreadCountersAreKept) {
+  std::thread([]() {
+    SlicePool::allocate(32768);
+    SlicePool::allocate(32768);
+  }).join();
+  EXPECT_EQ(1, hits());
+  EXPECT_EQ(1, misses());
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,78 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "source/common/common/arena_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+TEST(MonotonicArenaTest, NoBlockUntilFirstAllocation) {
+  MonotonicArena arena(1024);
+  EXPECT_EQ(0, arena.blockCount());
+  EXPECT_EQ(0, arena.bytesAllocated());
+}
+
+TEST(MonotonicArenaTest, AllocationsShareBlock) {
+  MonotonicArena arena(1024);
+  void* first = arena.allocate(10, 1);
+  void* second = arena.allocate(10, 8);
+  EXPECT_EQ(1, arena.blockCount());
+  EXPECT_EQ(20, arena.bytesAllocated());
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(second) % 8);
+  EXPECT_GE(static_cast<char*>(second), static_cast<char*>(first) + 10);
+}
+
+TEST(MonotonicArenaTest, NewBlockWhenFull) {
+  MonotonicArena arena(64);
+  arena.allocate(60, 1);
+  arena.allocate(8, 8);
+  EXPECT_EQ(2, arena.blockCount());
+}
+
+TEST(MonotonicArenaTest, OversizedAllocation) {
+  MonotonicArena arena(64);
+  void* memory = arena.allocate(1000, 64);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(memory) % 64);
+  EXPECT_EQ(1, arena.blockCount());
+  EXPECT_EQ(1000, arena.bytesAllocated());
+}
+
+class Counted {
+public:
+  explicit Counted(int& destroyed) : destroyed_(destroyed) {}
+  virtual ~Counted() { destroyed_++; }
+
+private:
+  int& destroyed_;
+};
+
+TEST(ArenaPtrTest, ArenaAndHeapObjectsAreDestroyed) {
+  int destroyed = 0;
+  MonotonicArena arena(256);
+  {
+    ArenaPtr<Counted> in_arena = makeArenaPtr<Counted>(arena, destroyed);
+    ArenaPtr<Counted> on_heap = makeArenaPtr<Counted>({}, destroyed);
+    ArenaPtr<Counted> converted = std::make_unique<Counted>(destroyed);
+    EXPECT_TRUE(in_arena.get_deleter().arenaAllocated());
+    EXPECT_FALSE(on_heap.get_deleter().arenaAllocated());
+    EXPECT_FALSE(converted.get_deleter().arenaAllocated());
+  }
+  EXPECT_EQ(3, destroyed);
+  EXPECT_EQ(sizeof(Counted), arena.bytesAllocated());
+}
+
+TEST(ArenaAllocatorTest, AllocateShared) {
+  int destroyed = 0;
+  MonotonicArena arena(256);
+  {
+    auto object = std::allocate_shared<Counted>(ArenaAllocator<Counted>(arena), destroyed);
+    EXPECT_GE(arena.bytesAllocated(), sizeof(Counted));
+  }
+  EXPECT_EQ(1, destroyed);
+}
+
+} // namespace
+} // namespace Envoy
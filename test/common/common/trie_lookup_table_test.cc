@@ -80,6 +80,29 @@ TEST(TrieLookupTable, LongestPrefix) {
   EXPECT_THAT(trie.findMatchingPrefixes(" "), ElementsAre());
 }
 
+TEST(TrieLookupTable, LongestSuffix) {
+  TrieLookupTable<const char*> trie;
+  const char* cstr_a = "a";
+  const char* cstr_b = "b";
+  const char* cstr_c = "c";
+
+  EXPECT_TRUE(trie.addReversed(".foo.com", cstr_a));
+  EXPECT_TRUE(trie.addReversed("-bar.foo.com", cstr_b));
+  EXPECT_TRUE(trie.addReversed(".com", cstr_c));
+  EXPECT_FALSE(trie.addReversed(".com", cstr_a, false));
+
+  EXPECT_EQ(cstr_a, trie.findLongestSuffix("www.foo.com"));
+  EXPECT_EQ(cstr_a, trie.findLongestSuffix(".foo.com"));
+  EXPECT_EQ(cstr_b, trie.findLongestSuffix("baz-bar.foo.com"));
+  EXPECT_EQ(cstr_c, trie.findLongestSuffix("bar.com"));
+  EXPECT_EQ(cstr_c, trie.findLongestSuffix("foo.com"));
+  EXPECT_EQ(nullptr, trie.findLongestSuffix("foo.org"));
+  EXPECT_EQ(nullptr, trie.findLongestSuffix(""));
+  // Keys are stored reversed, so a plain lookup of the original key does not match.
+  EXPECT_EQ(nullptr, trie.find(".com"));
+  EXPECT_EQ(cstr_c, trie.find("moc."));
+}
+
 TEST(TrieLookupTable, VeryDeepTrieDoesNotStackOverflowOnDestructor) {
   TrieLookupTable<const char*> trie;
   const char* cstr_a = "a";
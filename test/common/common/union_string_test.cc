@@ -91,6 +91,17 @@ TEST(UnionStringTest, All) {
     EXPECT_EQ(data_with_leading_lws, string.getStringView());
   }
 
+  // Reference rtrim narrows the view without touching the referenced data.
+  {
+    const std::string data_with_trailing_lws = "data \t\f\v";
+    UnionString string(data_with_trailing_lws);
+    string.rtrim();
+    EXPECT_TRUE(string.isReference());
+    EXPECT_EQ("data", string.getStringView());
+    EXPECT_EQ(data_with_trailing_lws.data(), string.getStringView().data());
+    EXPECT_EQ("data \t\f\v", data_with_trailing_lws);
+  }
+
   // Static clear() does nothing.
   {
     std::string static_string("HELLO");
@@ -46,6 +46,43 @@ TEST_F(HttpConnectionManagerImplTest, ResponseBeforeRequestComplete) {
   decoder_filters_[0]->callbacks_->encodeHeaders(std::move(response_headers), true, "details");
 }
 
+// With a per-stream arena configured, the filter wrappers are placed in the arena. A block size
+// smaller than a single wrapper makes every wrapper take a block of its own.
+TEST_F(HttpConnectionManagerImplTest, StreamArenaOverflow) {
+  stream_arena_block_size_ = 64;
+  setup();
+  setupFilterChain(2, 0);
+
+  EXPECT_CALL(*decoder_filters_[0], decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  startRequest(true);
+
+  EXPECT_CALL(response_encoder_, encodeHeaders(_, true));
+  ResponseHeaderMapPtr response_headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+  decoder_filters_[0]->callbacks_->streamInfo().setResponseCodeDetails("");
+  decoder_filters_[0]->callbacks_->encodeHeaders(std::move(response_headers), true, "details");
+
+  EXPECT_EQ(1U, stats_.named_.downstream_rq_arena_overflow_.value());
+}
+
+// A block size that fits the whole filter chain needs a single arena block.
+TEST_F(HttpConnectionManagerImplTest, StreamArenaSingleBlock) {
+  stream_arena_block_size_ = 64 * 1024;
+  setup();
+  setupFilterChain(2, 0);
+
+  EXPECT_CALL(*decoder_filters_[0], decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  startRequest(true);
+
+  EXPECT_CALL(response_encoder_, encodeHeaders(_, true));
+  ResponseHeaderMapPtr response_headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+  decoder_filters_[0]->callbacks_->streamInfo().setResponseCodeDetails("");
+  decoder_filters_[0]->callbacks_->encodeHeaders(std::move(response_headers), true, "details");
+
+  EXPECT_EQ(0U, stats_.named_.downstream_rq_arena_overflow_.value());
+}
+
 TEST_F(HttpConnectionManagerImplTest, ResponseBeforeRequestCompleteWithUpstreamHalfCloseEnabled) {
   TestScopedRuntime scoped_runtime;
   scoped_runtime.mergeValues(
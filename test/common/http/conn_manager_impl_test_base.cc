@@ -142,6 +142,7 @@ public:
   bool addProxyProtocolConnectionState() const override {
     return parent_.addProxyProtocolConnectionState();
   }
+  uint32_t streamArenaBlockSize() const override { return parent_.streamArenaBlockSize(); }
 
 private:
   ConnectionManagerConfig& parent_;
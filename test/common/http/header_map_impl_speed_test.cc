@@ -1,8 +1,12 @@
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/headers.h"
+#include "source/common/http/http1/balsa_parser.h"
 
+#include "test/common/memory/memory_test_utility.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -362,5 +366,101 @@ BENCHMARK(bmHeaderMapImplResponseStaticLookupHits);
 BENCHMARK(bmHeaderMapImplRequestStaticLookupMisses);
 BENCHMARK(bmHeaderMapImplResponseStaticLookupMisses);
 
+/**
+ * Builds a request header map from parser callbacks the way the HTTP/1 codec does, either copying
+ * every value or referencing long values in the parser's header storage.
+ */
+class HeaderMapParserCallbacks : public Http1::ParserCallbacks {
+public:
+  void setParser(const Http1::Parser& parser) { parser_ = &parser; }
+
+  Http1::CallbackResult onMessageBegin() override {
+    headers_ = RequestHeaderMapImpl::create();
+    headers_->setReferencedStorage(parser_->headerStorage());
+    return Http1::CallbackResult::Success;
+  }
+  Http1::CallbackResult onUrl(const char*, size_t) override {
+    return Http1::CallbackResult::Success;
+  }
+  Http1::CallbackResult onStatus(const char*, size_t) override {
+    return Http1::CallbackResult::Success;
+  }
+  Http1::CallbackResult onHeaderField(const char* data, size_t length) override {
+    field_.append(data, length);
+    field_.inlineTransform([](char c) { return absl::ascii_tolower(c); });
+    return Http1::CallbackResult::Success;
+  }
+  Http1::CallbackResult onHeaderValue(const char* data, size_t length) override {
+    value_.append(data, length);
+    copied_bytes_ += length;
+    headers_->addViaMove(std::move(field_), std::move(value_));
+    return Http1::CallbackResult::Success;
+  }
+  Http1::CallbackResult onHeaderValueReference(const char* data, size_t length) override {
+    value_.setReference(absl::string_view(data, length));
+    headers_->addViaMove(std::move(field_), std::move(value_));
+    value_.setCopy(absl::string_view());
+    return Http1::CallbackResult::Success;
+  }
+  Http1::CallbackResult onHeadersComplete() override { return Http1::CallbackResult::NoBody; }
+  void bufferBody(const char*, size_t) override {}
+  Http1::CallbackResult onMessageComplete() override { return Http1::CallbackResult::Success; }
+  void onChunkHeader(bool) override {}
+
+  RequestHeaderMapPtr releaseHeaders() { return std::move(headers_); }
+  uint64_t copiedBytes() const { return copied_bytes_; }
+
+private:
+  const Http1::Parser* parser_{};
+  RequestHeaderMapPtr headers_;
+  HeaderString field_;
+  HeaderString value_;
+  uint64_t copied_bytes_{};
+};
+
+/**
+ * Measure building a request header map with BalsaParser from a browser request carrying a
+ * session cookie and a bearer token. Each map is released only after the next request has been
+ * parsed, so in reference mode the parser cannot reuse the header storage the map still
+ * references. Arg 1 references long header values instead of copying them.
+ * The heap bytes held by one header map are reported when the memory usage API is available.
+ */
+static void bmBalsaBuildRequestHeaderMap(benchmark::State& state) {
+  const bool reference_header_values = state.range(0) != 0;
+  const std::string request = absl::StrCat(
+      "GET /shelves/shelf_1/books/1?format=json HTTP/1.1\r\n",
+      "Host: www.example.com\r\n",
+      "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+      "Chrome/120.0.0.0 Safari/537.36\r\n",
+      "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n",
+      "Accept-Language: en-US,en;q=0.9\r\n", "Accept-Encoding: gzip, deflate, br\r\n",
+      "Cookie: session=", std::string(256, 'a'), "; tracking=", std::string(64, 'b'), "\r\n",
+      "Authorization: Bearer ", std::string(800, 'c'), "\r\n",
+      "X-Request-Id: 5f1b3a2e-8c7d-4e6f-9a0b-1c2d3e4f5a6b\r\n", "Connection: keep-alive\r\n\r\n");
+  HeaderMapParserCallbacks callbacks;
+  Http1::BalsaParser parser(Http1::MessageType::Request, &callbacks, 64 * 1024,
+                            /*enable_trailers=*/false, /*allow_custom_methods=*/false,
+                            reference_header_values);
+  callbacks.setParser(parser);
+  RequestHeaderMapPtr previous_headers;
+  for (auto _ : state) { // NOLINT
+    const size_t consumed = parser.execute(request.data(), request.size());
+    benchmark::DoNotOptimize(consumed);
+    previous_headers = callbacks.releaseHeaders();
+  }
+  previous_headers.reset();
+  state.counters["copied_value_bytes"] =
+      benchmark::Counter(callbacks.copiedBytes(), benchmark::Counter::kAvgIterations);
+
+  // Measure one more request outside the timed loop, keeping its header map alive.
+  if (Memory::TestUtil::MemoryTest::mode() != Memory::TestUtil::MemoryTest::Mode::Disabled) {
+    Memory::TestUtil::MemoryTest memory_test;
+    parser.execute(request.data(), request.size());
+    const RequestHeaderMapPtr headers = callbacks.releaseHeaders();
+    state.counters["header_map_bytes"] = memory_test.consumedBytes();
+  }
+}
+BENCHMARK(bmBalsaBuildRequestHeaderMap)->Arg(0)->Arg(1);
+
 } // namespace Http
 } // namespace Envoy
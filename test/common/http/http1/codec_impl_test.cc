@@ -42,6 +42,7 @@ using testing::InvokeWithoutArgs;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
+using testing::SaveArg;
 using testing::StartsWith;
 using testing::StrictMock;
 
@@ -1033,6 +1034,81 @@ TEST_P(Http1ServerConnectionImplTest, Http10MultipleResponses) {
   }
 }
 
+// With http1_reference_header_values enabled, long header values reference the parser's header
+// storage and stay valid after the connection has parsed the next request.
+TEST_P(Http1ServerConnectionImplTest, ReferencedHeaderValuesOutliveMessage) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.http1_reference_header_values", "true"}});
+  initialize();
+
+  const std::string first_value(200, 'a');
+  const std::string second_value(200, 'b');
+  const std::string third_value(200, 'c');
+  MockRequestDecoder decoder;
+  RequestHeaderMapSharedPtr first_headers;
+  RequestHeaderMapSharedPtr second_headers;
+  {
+    Buffer::OwnedImpl buffer(
+        absl::StrCat("GET / HTTP/1.1\r\nx-long: ", first_value, "  \r\nx-short: c\r\n\r\n"));
+    Http::ResponseEncoder* response_encoder = nullptr;
+    EXPECT_CALL(callbacks_, newStream(_, _))
+        .WillOnce(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+          response_encoder = &encoder;
+          return decoder;
+        }));
+    EXPECT_CALL(decoder, decodeHeaders_(_, true)).WillOnce(SaveArg<0>(&first_headers));
+    auto status = codec_->dispatch(buffer);
+    EXPECT_TRUE(status.ok());
+
+    TestResponseHeaderMapImpl headers{{":status", "200"}};
+    response_encoder->encodeHeaders(headers, true);
+  }
+
+  const HeaderEntry* long_entry = first_headers->get(LowerCaseString("x-long"))[0];
+  EXPECT_EQ(first_value, long_entry->value().getStringView());
+  EXPECT_EQ(parser_impl_ == Http1ParserImpl::BalsaParser, long_entry->value().isReference());
+  EXPECT_FALSE(first_headers->get(LowerCaseString("x-short"))[0]->value().isReference());
+
+  {
+    Buffer::OwnedImpl buffer(
+        absl::StrCat("GET / HTTP/1.1\r\nx-long: ", second_value, "\r\n\r\n"));
+    Http::ResponseEncoder* response_encoder = nullptr;
+    EXPECT_CALL(callbacks_, newStream(_, _))
+        .WillOnce(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+          response_encoder = &encoder;
+          return decoder;
+        }));
+    EXPECT_CALL(decoder, decodeHeaders_(_, true)).WillOnce(SaveArg<0>(&second_headers));
+    auto status = codec_->dispatch(buffer);
+    EXPECT_TRUE(status.ok());
+    EXPECT_EQ(second_value,
+              second_headers->get(LowerCaseString("x-long"))[0]->value().getStringView());
+
+    TestResponseHeaderMapImpl headers{{":status", "200"}};
+    response_encoder->encodeHeaders(headers, true);
+  }
+
+  // The first request's value was not overwritten by parsing the second request.
+  EXPECT_EQ(first_value, long_entry->value().getStringView());
+
+  // Releasing the first request's headers lets the parser reuse their storage for the third
+  // request, which must leave the second request's value intact.
+  first_headers.reset();
+  {
+    Buffer::OwnedImpl buffer(
+        absl::StrCat("GET / HTTP/1.1\r\nx-long: ", third_value, "\r\n\r\n"));
+    RequestHeaderMapSharedPtr third_headers;
+    EXPECT_CALL(callbacks_, newStream(_, _)).WillOnce(ReturnRef(decoder));
+    EXPECT_CALL(decoder, decodeHeaders_(_, true)).WillOnce(SaveArg<0>(&third_headers));
+    auto status = codec_->dispatch(buffer);
+    EXPECT_TRUE(status.ok());
+    EXPECT_EQ(third_value,
+              third_headers->get(LowerCaseString("x-long"))[0]->value().getStringView());
+  }
+  EXPECT_EQ(second_value,
+            second_headers->get(LowerCaseString("x-long"))[0]->value().getStringView());
+}
+
 TEST_P(Http1ServerConnectionImplTest, HttpVersion) {
   codec_settings_.accept_http_10_ = true;
   // SPELLCHECKER(off)
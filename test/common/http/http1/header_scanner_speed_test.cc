@@ -0,0 +1,121 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+#include <vector>
+
+#include "source/common/http/http1/balsa_parser.h"
+#include "source/common/http/http1/header_scanner.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// A header set modeled after a browser request carrying a session cookie and a bearer token.
+const std::vector<std::pair<std::string, std::string>>& realisticHeaders() {
+  static const auto* headers = new std::vector<std::pair<std::string, std::string>>{
+      {"Host", "www.example.com"},
+      {"User-Agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+                     "Chrome/120.0.0.0 Safari/537.36"},
+      {"Accept", "text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;"
+                 "q=0.8"},
+      {"Accept-Language", "en-US,en;q=0.9"},
+      {"Accept-Encoding", "gzip, deflate, br"},
+      {"Referer", "https://www.example.com/shelves/shelf_1/books?page=2&sort=title"},
+      {"Cookie", absl::StrCat("session=", std::string(256, 'a'), "; tracking=",
+                              std::string(64, 'b'), "; preferences=dark-mode%3Dtrue")},
+      {"Authorization", absl::StrCat("Bearer ", std::string(800, 'c'))},
+      {"X-Request-Id", "5f1b3a2e-8c7d-4e6f-9a0b-1c2d3e4f5a6b"},
+      {"X-Forwarded-For", "203.0.113.195, 70.41.3.18, 150.172.238.178"},
+      {"Cache-Control", "no-cache"},
+      {"Connection", "keep-alive"},
+  };
+  return *headers;
+}
+
+std::string realisticRequest() {
+  std::string request = "GET /shelves/shelf_1/books/1?format=json HTTP/1.1\r\n";
+  for (const auto& [name, value] : realisticHeaders()) {
+    absl::StrAppend(&request, name, ": ", value, "\r\n");
+  }
+  absl::StrAppend(&request, "\r\n");
+  return request;
+}
+
+// Validates the names and scans the values of a realistic header set, as done for every request
+// once the parser has split the header block into fields.
+static void bmScanRealisticHeaders(benchmark::State& state) {
+  const auto& headers = realisticHeaders();
+  for (auto _ : state) { // NOLINT
+    for (const auto& [name, value] : headers) {
+      benchmark::DoNotOptimize(HeaderScanner::isToken(name));
+      benchmark::DoNotOptimize(HeaderScanner::findCrOrLf(value));
+    }
+  }
+}
+BENCHMARK(bmScanRealisticHeaders);
+
+// Scans a single header value of the given size for CR and LF.
+static void bmFindCrOrLf(benchmark::State& state) {
+  const std::string value(state.range(0), 'v');
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(HeaderScanner::findCrOrLf(value));
+  }
+  state.SetBytesProcessed(state.iterations() * value.size());
+}
+BENCHMARK(bmFindCrOrLf)->RangeMultiplier(4)->Range(16, 4096);
+
+// Validates a single token of the given size.
+static void bmFindInvalidTokenChar(benchmark::State& state) {
+  const std::string token(state.range(0), 't');
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(HeaderScanner::findInvalidTokenChar(token));
+  }
+  state.SetBytesProcessed(state.iterations() * token.size());
+}
+BENCHMARK(bmFindInvalidTokenChar)->RangeMultiplier(4)->Range(16, 4096);
+
+class NoopParserCallbacks : public ParserCallbacks {
+public:
+  CallbackResult onMessageBegin() override { return CallbackResult::Success; }
+  CallbackResult onUrl(const char*, size_t) override { return CallbackResult::Success; }
+  CallbackResult onStatus(const char*, size_t) override { return CallbackResult::Success; }
+  CallbackResult onHeaderField(const char* data, size_t length) override {
+    benchmark::DoNotOptimize(data);
+    benchmark::DoNotOptimize(length);
+    return CallbackResult::Success;
+  }
+  CallbackResult onHeaderValue(const char* data, size_t length) override {
+    benchmark::DoNotOptimize(data);
+    benchmark::DoNotOptimize(length);
+    return CallbackResult::Success;
+  }
+  CallbackResult onHeadersComplete() override { return CallbackResult::NoBody; }
+  void bufferBody(const char*, size_t) override {}
+  CallbackResult onMessageComplete() override { return CallbackResult::Success; }
+  void onChunkHeader(bool) override {}
+};
+
+// Parses a realistic request end to end with BalsaParser, feeding the whole request as a single
+// slice as the codec does for a request that arrives in one read.
+static void bmBalsaParseRealisticRequest(benchmark::State& state) {
+  const std::string request = realisticRequest();
+  NoopParserCallbacks callbacks;
+  BalsaParser parser(MessageType::Request, &callbacks, 64 * 1024, /*enable_trailers=*/false,
+                     /*allow_custom_methods=*/false);
+  for (auto _ : state) { // NOLINT
+    const size_t consumed = parser.execute(request.data(), request.size());
+    benchmark::DoNotOptimize(consumed);
+  }
+  state.SetBytesProcessed(state.iterations() * request.size());
+}
+BENCHMARK(bmBalsaParseRealisticRequest);
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,77 @@
+#include <string>
+
+#include "source/common/http/http1/header_scanner.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+constexpr absl::string_view kTokenCharacters =
+    "!#$%&'*+-.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ^_`abcdefghijklmnopqrstuvwxyz|~";
+
+TEST(HeaderScannerTest, TokenChars) {
+  for (int c = 0; c < 256; ++c) {
+    EXPECT_EQ(kTokenCharacters.find(static_cast<char>(c)) != absl::string_view::npos,
+              HeaderScanner::isTokenChar(static_cast<char>(c)))
+        << c;
+  }
+}
+
+TEST(HeaderScannerTest, IsToken) {
+  EXPECT_TRUE(HeaderScanner::isToken(""));
+  EXPECT_TRUE(HeaderScanner::isToken("content-type"));
+  EXPECT_TRUE(HeaderScanner::isToken(kTokenCharacters));
+  EXPECT_FALSE(HeaderScanner::isToken("content type"));
+  EXPECT_FALSE(HeaderScanner::isToken("host:"));
+  EXPECT_FALSE(HeaderScanner::isToken(absl::string_view("a\0b", 3)));
+}
+
+// Places every possible byte at every position of inputs longer than the vector widths, so that
+// both the vectorized blocks and the scalar tail are exercised.
+TEST(HeaderScannerTest, FindInvalidTokenCharAtEveryPosition) {
+  for (const size_t length : {1, 15, 16, 17, 31, 32, 33, 70}) {
+    for (size_t pos = 0; pos < length; ++pos) {
+      for (int c = 0; c < 256; ++c) {
+        std::string input(length, 'a');
+        input[pos] = static_cast<char>(c);
+        const size_t expected = HeaderScanner::isTokenChar(static_cast<char>(c))
+                                    ? absl::string_view::npos
+                                    : pos;
+        ASSERT_EQ(expected, HeaderScanner::findInvalidTokenChar(input))
+            << "length " << length << " pos " << pos << " char " << c;
+      }
+    }
+  }
+}
+
+TEST(HeaderScannerTest, FindInvalidTokenCharAfterPipeAndTilde) {
+  // '|' and '~' are token characters that the vectorized prefilter can't rule out on its own.
+  EXPECT_EQ(absl::string_view::npos, HeaderScanner::findInvalidTokenChar("a|b~c|d~e|f~g|h~i|"));
+  EXPECT_EQ(19, HeaderScanner::findInvalidTokenChar("a|b~c|d~e|f~g|h~i|j k"));
+}
+
+TEST(HeaderScannerTest, FindCrOrLfAtEveryPosition) {
+  for (const size_t length : {1, 15, 16, 17, 31, 32, 33, 70}) {
+    for (size_t pos = 0; pos < length; ++pos) {
+      for (const char c : {'\r', '\n'}) {
+        std::string input(length, 'a');
+        input[pos] = c;
+        ASSERT_EQ(pos, HeaderScanner::findCrOrLf(input)) << "length " << length << " pos " << pos;
+        if (pos + 1 < length) {
+          input[pos + 1] = c;
+          ASSERT_EQ(pos, HeaderScanner::findCrOrLf(input));
+        }
+      }
+    }
+    EXPECT_EQ(absl::string_view::npos, HeaderScanner::findCrOrLf(std::string(length, 'a')));
+  }
+  EXPECT_EQ(absl::string_view::npos, HeaderScanner::findCrOrLf(""));
+}
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -88,8 +88,10 @@ public:
 
 class IoUringWorkerTestImpl : public IoUringWorkerImpl {
 public:
-  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher)
-      : IoUringWorkerImpl(std::move(io_uring_instance), 8192, 1000, dispatcher) {}
+  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher,
+                        uint32_t provided_buffer_count = 0, uint32_t zero_copy_send_threshold = 0)
+      : IoUringWorkerImpl(std::move(io_uring_instance), 8192, 1000, provided_buffer_count,
+                          zero_copy_send_threshold, dispatcher) {}
 
   IoUringSocket& addTestSocket(os_fd_t fd) {
     return addSocket(std::make_unique<IoUringSocketTestImpl>(fd, *this));
@@ -108,11 +110,11 @@ protected:
     }
   }
 
-  void initialize() {
+  void initialize(uint32_t provided_buffer_count = 0) {
     api_ = Api::createApiForTest(time_system_);
     dispatcher_ = api_->allocateDispatcher("test_thread");
     io_uring_worker_ = std::make_unique<IoUringWorkerTestImpl>(
-        std::make_unique<IoUringImpl>(20, false), *dispatcher_);
+        std::make_unique<IoUringImpl>(20, false), *dispatcher_, provided_buffer_count);
   }
 
   void createListenerAndConnectedSocketPair() {
@@ -314,6 +316,44 @@ TEST_F(IoUringWorkerIntegrationTest, ServerSocketRead) {
   cleanup();
 }
 
+TEST_F(IoUringWorkerIntegrationTest, ServerSocketReadWithProvidedBuffers) {
+  initialize(4);
+  if (!io_uring_worker_->providedBuffersEnabled()) {
+    GTEST_SKIP() << "io_uring provided buffer rings are not supported";
+  }
+  createListenerAndConnectedSocketPair();
+
+  std::string received;
+  OptRef<IoUringSocket> socket;
+  socket = io_uring_worker_->addServerSocket(
+      server_socket_,
+      [&socket, &received](uint32_t events) {
+        ASSERT(events == Event::FileReadyType::Read);
+        EXPECT_NE(absl::nullopt, socket->getReadParam());
+        received += socket->getReadParam()->buf_.toString();
+        socket->getReadParam()->buf_.drain(socket->getReadParam()->buf_.length());
+        return absl::OkStatus();
+      },
+      false);
+
+  // Send more writes than there are buffers in the ring, so that buffers have to be recycled.
+  std::string expected;
+  for (int i = 0; i < 16; i++) {
+    std::string write_data = absl::StrCat("hello world ", i);
+    expected += write_data;
+    Api::OsSysCallsSingleton::get().write(client_socket_, write_data.data(), write_data.size());
+    while (received.size() < expected.size()) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+  EXPECT_EQ(expected, received);
+
+  socket->close(false);
+  runToClose(server_socket_);
+  EXPECT_EQ(io_uring_worker_->getSockets().size(), 0);
+  cleanup();
+}
+
 TEST_F(IoUringWorkerIntegrationTest, ServerSocketReadError) {
   initialize();
 
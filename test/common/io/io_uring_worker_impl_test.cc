@@ -33,8 +33,10 @@ public:
 
 class IoUringWorkerTestImpl : public IoUringWorkerImpl {
 public:
-  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher)
-      : IoUringWorkerImpl(std::move(io_uring_instance), 8192, 1000, dispatcher) {}
+  IoUringWorkerTestImpl(IoUringPtr io_uring_instance, Event::Dispatcher& dispatcher,
+                        uint32_t provided_buffer_count = 0, uint32_t zero_copy_send_threshold = 0)
+      : IoUringWorkerImpl(std::move(io_uring_instance), 8192, 1000, provided_buffer_count,
+                          zero_copy_send_threshold, dispatcher) {}
 
   IoUringSocket& addTestSocket(os_fd_t fd) {
     return addSocket(std::make_unique<IoUringSocketTestImpl>(fd, *this));
@@ -693,6 +695,307 @@ TEST(IoUringWorkerImplTest, NoEnableReadOnConnectError) {
   delete static_cast<Request*>(connect_req);
 }
 
+TEST(IoUringWorkerImplTest, ServerSocketRecvIntoProvidedBuffers) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  Event::FileReadyCb file_event_callback;
+
+  // The buffer count is rounded up to a power of two.
+  EXPECT_CALL(mock_io_uring, registerBufferRing(16, 8192)).WillOnce(Return(true));
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(
+          DoAll(SaveArg<1>(&file_event_callback), ReturnNew<NiceMock<Event::MockFileEvent>>()));
+  auto worker = std::make_unique<IoUringWorkerTestImpl>(std::move(io_uring_instance), dispatcher,
+                                                        10);
+  EXPECT_TRUE(worker->providedBuffersEnabled());
+
+  os_fd_t fd = 11;
+  SET_SOCKET_INVALID(fd);
+
+  // Reading is enabled, so a multishot recv is armed instead of a read with a dedicated buffer.
+  Request* recv_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareRecv(fd, true, _))
+      .WillOnce(DoAll(SaveArg<2>(&recv_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  std::string received;
+  OptRef<IoUringSocket> socket;
+  socket = worker->addServerSocket(
+      fd,
+      [&socket, &received](uint32_t events) {
+        EXPECT_EQ(events, Event::FileReadyType::Read);
+        received += socket->getReadParam()->buf_.toString();
+        socket->getReadParam()->buf_.drain(socket->getReadParam()->buf_.length());
+        return absl::OkStatus();
+      },
+      false);
+
+  // The data is copied out of the provided buffer, which goes straight back to the ring. The
+  // multishot recv stays armed.
+  std::string data = "hello";
+  EXPECT_CALL(mock_io_uring, providedBuffer(3))
+      .WillOnce(Return(reinterpret_cast<uint8_t*>(data.data())));
+  EXPECT_CALL(mock_io_uring, recycleProvidedBuffer(3));
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&recv_req, &data](const CompletionCb& cb) {
+        recv_req->setCompletionFlags(IORING_CQE_F_MORE | IORING_CQE_F_BUFFER |
+                                     (3 << IORING_CQE_BUFFER_SHIFT));
+        cb(recv_req, data.size(), false);
+      }));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+  EXPECT_EQ(data, received);
+
+  // The ring ran out of buffers, which terminates the multishot recv. The next read falls back to
+  // a dedicated buffer.
+  Request* read_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareReadv(fd, _, _, _, _))
+      .WillOnce(DoAll(SaveArg<4>(&read_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&recv_req](const CompletionCb& cb) {
+        recv_req->setCompletionFlags(0);
+        cb(recv_req, -ENOBUFS, false);
+      }));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+
+  // Disabling the read doesn't cancel a read with a dedicated buffer.
+  socket->disableRead();
+
+  // The IoUringWorker will close all the existing sockets.
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareCancel(read_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&mock_io_uring, fd, &read_req, &cancel_req](const CompletionCb& cb) {
+        Request* close_req = nullptr;
+        EXPECT_CALL(mock_io_uring, prepareClose(fd, _))
+            .WillOnce(DoAll(SaveArg<1>(&close_req), Return<IoUringResult>(IoUringResult::Ok)))
+            .RetiresOnSaturation();
+        EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+        EXPECT_CALL(mock_io_uring, removeInjectedCompletion(fd));
+        cb(read_req, -ECANCELED, false);
+        cb(cancel_req, 0, false);
+        cb(close_req, 0, false);
+      }));
+  EXPECT_CALL(dispatcher, deferredDelete_);
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  worker.reset();
+}
+
+TEST(IoUringWorkerImplTest, ServerSocketDisableReadCancelsMultishotRecv) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  Event::FileReadyCb file_event_callback;
+
+  EXPECT_CALL(mock_io_uring, registerBufferRing(16, 8192)).WillOnce(Return(true));
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(
+          DoAll(SaveArg<1>(&file_event_callback), ReturnNew<NiceMock<Event::MockFileEvent>>()));
+  auto worker = std::make_unique<IoUringWorkerTestImpl>(std::move(io_uring_instance), dispatcher,
+                                                        16);
+
+  os_fd_t fd = 11;
+  SET_SOCKET_INVALID(fd);
+
+  Request* recv_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareRecv(fd, true, _))
+      .WillOnce(DoAll(SaveArg<2>(&recv_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  auto& socket = worker->addServerSocket(fd, [](uint32_t) { return absl::OkStatus(); }, false);
+
+  // Disabling the read cancels the multishot recv so that no data is buffered.
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareCancel(recv_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  socket.disableRead();
+
+  // Once the multishot recv terminates, a single recv watches for the remote close.
+  Request* single_recv_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareRecv(fd, false, _))
+      .WillOnce(DoAll(SaveArg<2>(&single_recv_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&recv_req, &cancel_req](const CompletionCb& cb) {
+        recv_req->setCompletionFlags(0);
+        cb(recv_req, -ECANCELED, false);
+        cb(cancel_req, 0, false);
+      }));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+
+  // The IoUringWorker will close all the existing sockets.
+  EXPECT_CALL(mock_io_uring, prepareCancel(single_recv_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(
+          Invoke([&mock_io_uring, fd, &single_recv_req, &cancel_req](const CompletionCb& cb) {
+            Request* close_req = nullptr;
+            EXPECT_CALL(mock_io_uring, prepareClose(fd, _))
+                .WillOnce(DoAll(SaveArg<1>(&close_req), Return<IoUringResult>(IoUringResult::Ok)))
+                .RetiresOnSaturation();
+            EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+            EXPECT_CALL(mock_io_uring, removeInjectedCompletion(fd));
+            single_recv_req->setCompletionFlags(0);
+            cb(single_recv_req, -ECANCELED, false);
+            cb(cancel_req, 0, false);
+            cb(close_req, 0, false);
+          }));
+  EXPECT_CALL(dispatcher, deferredDelete_);
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  worker.reset();
+}
+
+TEST(IoUringWorkerImplTest, ServerSocketZeroCopySend) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+  Event::FileReadyCb file_event_callback;
+
+  EXPECT_CALL(mock_io_uring, isZeroCopySendSupported()).WillOnce(Return(true));
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(dispatcher,
+              createFileEvent_(_, _, Event::PlatformDefaultTriggerType, Event::FileReadyType::Read))
+      .WillOnce(
+          DoAll(SaveArg<1>(&file_event_callback), ReturnNew<NiceMock<Event::MockFileEvent>>()));
+  auto worker =
+      std::make_unique<IoUringWorkerTestImpl>(std::move(io_uring_instance), dispatcher, 0, 4);
+  EXPECT_EQ(4, worker->zeroCopySendThreshold());
+
+  os_fd_t fd = 11;
+  SET_SOCKET_INVALID(fd);
+
+  Request* read_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareReadv(fd, _, _, _, _))
+      .WillOnce(DoAll(SaveArg<4>(&read_req), Return<IoUringResult>(IoUringResult::Ok)));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  auto& socket = worker->addServerSocket(fd, [](uint32_t) { return absl::OkStatus(); }, false);
+
+  // The write is above the threshold, so the data is moved into a zero copy send.
+  Request* first_send_req = nullptr;
+  const char* first_send_data = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareSendmsgZc(fd, _, _))
+      .WillOnce(Invoke([&first_send_req, &first_send_data](os_fd_t, const struct msghdr* msg,
+                                                           Request* req) {
+        EXPECT_EQ(1, msg->msg_iovlen);
+        EXPECT_EQ("hello world", absl::string_view(static_cast<char*>(msg->msg_iov[0].iov_base),
+                                                   msg->msg_iov[0].iov_len));
+        first_send_req = req;
+        first_send_data = static_cast<const char*>(msg->msg_iov[0].iov_base);
+        return IoUringResult::Ok;
+      }));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  Buffer::OwnedImpl write_buf("hello world");
+  socket.write(write_buf);
+  EXPECT_EQ(0, write_buf.length());
+
+  // After a partial send, a new request sends the unsent tail from the first request's data
+  // without copying it.
+  Request* second_send_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareSendmsgZc(fd, _, _))
+      .WillOnce(Invoke([&second_send_req, &first_send_data](os_fd_t, const struct msghdr* msg,
+                                                            Request* req) {
+        EXPECT_EQ(1, msg->msg_iovlen);
+        EXPECT_EQ(first_send_data + 5, msg->msg_iov[0].iov_base);
+        EXPECT_EQ(" world", absl::string_view(static_cast<char*>(msg->msg_iov[0].iov_base),
+                                              msg->msg_iov[0].iov_len));
+        second_send_req = req;
+        return IoUringResult::Ok;
+      }));
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&first_send_req](const CompletionCb& cb) {
+        first_send_req->setCompletionFlags(IORING_CQE_F_MORE);
+        cb(first_send_req, 5, false);
+      }));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+
+  // The notification releases the first request. The second fails since the socket doesn't
+  // support zero copy sends, so the data is sent again with writev.
+  Request* write_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareWritev(fd, _, 1, _, _))
+      .WillOnce(Invoke([&write_req](os_fd_t, const struct iovec* iovecs, unsigned, off_t,
+                                    Request* req) {
+        EXPECT_EQ(" world",
+                  absl::string_view(static_cast<char*>(iovecs[0].iov_base), iovecs[0].iov_len));
+        write_req = req;
+        return IoUringResult::Ok;
+      }));
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&first_send_req, &second_send_req](const CompletionCb& cb) {
+        first_send_req->setCompletionFlags(IORING_CQE_F_NOTIF);
+        cb(first_send_req, 0, false);
+        cb(second_send_req, -EOPNOTSUPP, false);
+      }));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&write_req](const CompletionCb& cb) { cb(write_req, 6, false); }));
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  ASSERT_TRUE(file_event_callback(Event::FileReadyType::Read).ok());
+
+  // The IoUringWorker will close all the existing sockets.
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(mock_io_uring, prepareCancel(read_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return<IoUringResult>(IoUringResult::Ok)))
+      .RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+  EXPECT_CALL(mock_io_uring, forEveryCompletion(_))
+      .WillOnce(Invoke([&mock_io_uring, fd, &read_req, &cancel_req](const CompletionCb& cb) {
+        Request* close_req = nullptr;
+        EXPECT_CALL(mock_io_uring, prepareClose(fd, _))
+            .WillOnce(DoAll(SaveArg<1>(&close_req), Return<IoUringResult>(IoUringResult::Ok)))
+            .RetiresOnSaturation();
+        EXPECT_CALL(mock_io_uring, submit()).Times(1).RetiresOnSaturation();
+        EXPECT_CALL(mock_io_uring, removeInjectedCompletion(fd));
+        cb(read_req, -ECANCELED, false);
+        cb(cancel_req, 0, false);
+        cb(close_req, 0, false);
+      }));
+  EXPECT_CALL(dispatcher, deferredDelete_);
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+  worker.reset();
+}
+
+TEST(IoUringWorkerImplTest, ZeroCopySendUnsupported) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+
+  EXPECT_CALL(mock_io_uring, isZeroCopySendSupported()).WillOnce(Return(false));
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(dispatcher, createFileEvent_(_, _, Event::PlatformDefaultTriggerType,
+                                           Event::FileReadyType::Read));
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher, 0, 4096);
+  EXPECT_EQ(0, worker.zeroCopySendThreshold());
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+}
+
+TEST(IoUringWorkerImplTest, ProvidedBuffersUnsupported) {
+  Event::MockDispatcher dispatcher;
+  IoUringPtr io_uring_instance = std::make_unique<MockIoUring>();
+  MockIoUring& mock_io_uring = *dynamic_cast<MockIoUring*>(io_uring_instance.get());
+
+  EXPECT_CALL(mock_io_uring, registerBufferRing(32, 8192)).WillOnce(Return(false));
+  EXPECT_CALL(mock_io_uring, registerEventfd());
+  EXPECT_CALL(dispatcher, createFileEvent_(_, _, Event::PlatformDefaultTriggerType,
+                                           Event::FileReadyType::Read));
+  IoUringWorkerTestImpl worker(std::move(io_uring_instance), dispatcher, 32);
+  EXPECT_FALSE(worker.providedBuffersEnabled());
+  EXPECT_CALL(dispatcher, clearDeferredDeleteList());
+}
+
 } // namespace
 } // namespace Io
 } // namespace Envoy
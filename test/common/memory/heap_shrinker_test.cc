@@ -1,3 +1,4 @@
+#include "source/common/buffer/slice_pool.h"
 #include "source/common/event/dispatcher_impl.h"
 #include "source/common/memory/heap_shrinker.h"
 #include "source/common/memory/stats.h"
@@ -83,6 +84,27 @@ TEST_F(HeapShrinkerTest, ShrinkWhenTriggered) {
   EXPECT_EQ(2, shrink_count.value());
 }
 
+TEST_F(HeapShrinkerTest, ReleaseSlicePoolCacheWhenTriggered) {
+  Server::OverloadActionCb action_cb;
+  EXPECT_CALL(overload_manager_, registerForAction(_, _, _))
+      .WillOnce(Invoke([&](const std::string&, Event::Dispatcher&, Server::OverloadActionCb cb) {
+        action_cb = cb;
+        return true;
+      }));
+
+  HeapShrinker h(dispatcher_, overload_manager_, *stats_.rootScope());
+
+  Buffer::SlicePool::allocate(Buffer::SlicePool::MinBlockSize);
+  EXPECT_LE(Buffer::SlicePool::MinBlockSize, Buffer::SlicePool::stats().cached_bytes_);
+
+  action_cb(Server::OverloadActionState::saturated());
+  step();
+
+  // The cache is dropped the next time this thread uses its pool.
+  Buffer::SlicePool::BlockPtr block = Buffer::SlicePool::allocate(Buffer::SlicePool::MaxBlockSize);
+  EXPECT_EQ(0, Buffer::SlicePool::stats().cached_bytes_);
+}
+
 } // namespace
 } // namespace Memory
 } // namespace Envoy
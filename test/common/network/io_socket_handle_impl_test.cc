@@ -1,3 +1,4 @@
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/utility.h"
 #include "source/common/network/address_impl.h"
 #include "source/common/network/io_socket_error_impl.h"
@@ -278,6 +279,204 @@ TEST(IoSocketHandleImpl, DroppedUdpDatagramsMmsg) {
   EXPECT_EQ(dropped_packets, 5);
 }
 
+TEST(IoSocketHandleImpl, SendmmsgBatchesDatagrams) {
+  NiceMock<Envoy::Api::MockOsSysCalls> os_sys_calls;
+  auto os_calls =
+      std::make_unique<Envoy::TestThreadsafeSingletonInjector<Envoy::Api::OsSysCallsImpl>>(
+          &os_sys_calls);
+  ON_CALL(os_sys_calls, supportsMmsg()).WillByDefault(Return(true));
+  ON_CALL(os_sys_calls, supportsUdpGso()).WillByDefault(Return(true));
+
+  char first[100] = {};
+  char second[200] = {};
+  Buffer::RawSlice datagrams[] = {{first, sizeof(first)}, {second, sizeof(second)}};
+  Address::Ipv4Instance peer_address("127.0.0.1", 12345);
+
+  // The datagrams have different sizes, so they can't be segments of one GSO message.
+  EXPECT_CALL(os_sys_calls, sendmmsg(_, _, 2, _))
+      .WillOnce(Invoke([](os_fd_t, mmsghdr* mmsg_hdr, unsigned int, int) {
+        EXPECT_EQ(1, mmsg_hdr[0].msg_hdr.msg_iovlen);
+        EXPECT_EQ(100, mmsg_hdr[0].msg_hdr.msg_iov[0].iov_len);
+        EXPECT_EQ(200, mmsg_hdr[1].msg_hdr.msg_iov[0].iov_len);
+        EXPECT_NE(nullptr, mmsg_hdr[1].msg_hdr.msg_name);
+        return Api::SysCallIntResult{1, 0};
+      }));
+
+  IoSocketHandleImpl io_handle;
+  auto result = io_handle.sendmmsg(datagrams, 2, 0, nullptr, peer_address);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(1, result.return_value_);
+}
+
+TEST(IoSocketHandleImpl, SendmmsgUsesGsoForEqualSizedDatagrams) {
+  NiceMock<Envoy::Api::MockOsSysCalls> os_sys_calls;
+  auto os_calls =
+      std::make_unique<Envoy::TestThreadsafeSingletonInjector<Envoy::Api::OsSysCallsImpl>>(
+          &os_sys_calls);
+  ON_CALL(os_sys_calls, supportsMmsg()).WillByDefault(Return(true));
+  ON_CALL(os_sys_calls, supportsUdpGso()).WillByDefault(Return(true));
+
+  char buffer[300] = {};
+  // The last segment may be shorter than the others.
+  Buffer::RawSlice datagrams[] = {{buffer, 120}, {buffer + 120, 120}, {buffer + 240, 60}};
+  Address::Ipv4Instance peer_address("127.0.0.1", 12345);
+
+  EXPECT_CALL(os_sys_calls, sendmmsg(_, _, _, _)).Times(0);
+  EXPECT_CALL(os_sys_calls, sendmsg(_, _, _))
+      .WillOnce(Invoke([](os_fd_t, const msghdr* msg_hdr, int) {
+        EXPECT_EQ(3, msg_hdr->msg_iovlen);
+        const cmsghdr* cmsg = CMSG_FIRSTHDR(msg_hdr);
+        EXPECT_EQ(IPPROTO_UDP, cmsg->cmsg_level);
+        EXPECT_EQ(UDP_SEGMENT, cmsg->cmsg_type);
+        uint16_t gso_size;
+        memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+        EXPECT_EQ(120, gso_size);
+        return Api::SysCallSizeResult{300, 0};
+      }));
+
+  IoSocketHandleImpl io_handle;
+  auto result = io_handle.sendmmsg(datagrams, 3, 0, nullptr, peer_address);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(3, result.return_value_);
+}
+
+TEST(IoSocketHandleImpl, SendmmsgFallsBackFromGsoExceedingMtu) {
+  NiceMock<Envoy::Api::MockOsSysCalls> os_sys_calls;
+  auto os_calls =
+      std::make_unique<Envoy::TestThreadsafeSingletonInjector<Envoy::Api::OsSysCallsImpl>>(
+          &os_sys_calls);
+  ON_CALL(os_sys_calls, supportsMmsg()).WillByDefault(Return(true));
+  ON_CALL(os_sys_calls, supportsUdpGso()).WillByDefault(Return(true));
+
+  char buffer[3000] = {};
+  Buffer::RawSlice datagrams[] = {{buffer, 1500}, {buffer + 1500, 1500}};
+  Address::Ipv4Instance peer_address("127.0.0.1", 12345);
+
+  for (int error : {EMSGSIZE, EINVAL}) {
+    // The segments don't fit the path MTU, so the kernel rejects the GSO message, and the
+    // datagrams are sent separately.
+    EXPECT_CALL(os_sys_calls, sendmsg(_, _, _)).WillOnce(Return(Api::SysCallSizeResult{-1, error}));
+    EXPECT_CALL(os_sys_calls, sendmmsg(_, _, 2, _)).WillOnce(Return(Api::SysCallIntResult{2, 0}));
+
+    IoSocketHandleImpl io_handle;
+    auto result = io_handle.sendmmsg(datagrams, 2, 0, nullptr, peer_address);
+    EXPECT_TRUE(result.ok());
+    EXPECT_EQ(2, result.return_value_);
+  }
+
+  // Other errors are returned.
+  EXPECT_CALL(os_sys_calls, sendmsg(_, _, _))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN}));
+  EXPECT_CALL(os_sys_calls, sendmmsg(_, _, _, _)).Times(0);
+  IoSocketHandleImpl io_handle;
+  auto result = io_handle.sendmmsg(datagrams, 2, 0, nullptr, peer_address);
+  EXPECT_FALSE(result.ok());
+}
+
+#if defined(__linux__)
+// A fragment whose data is claimed to also be held by a file; the tests mock sendfile, so nothing
+// reads the file.
+class FileBackedTestFragment : public Buffer::BufferFragmentImpl {
+public:
+  FileBackedTestFragment(absl::string_view data, int fd, off_t offset)
+      : Buffer::BufferFragmentImpl(data.data(), data.size(), nullptr), fd_(fd), offset_(offset) {}
+
+  absl::optional<Buffer::FileRange> fileRange() const override {
+    return Buffer::FileRange{fd_, offset_, size()};
+  }
+
+private:
+  const int fd_;
+  const off_t offset_;
+};
+
+class IoSocketHandleImplSendfileTest : public testing::Test {
+protected:
+  IoSocketHandleImplSendfileTest()
+      : os_calls_(&os_sys_calls_), linux_os_calls_(&linux_os_sys_calls_),
+        fragment_("hello world", 42, 100) {
+    buffer_.addBufferFragment(fragment_);
+  }
+
+  testing::StrictMock<Api::MockOsSysCalls> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_;
+  testing::StrictMock<Api::MockLinuxOsSysCalls> linux_os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls_;
+  FileBackedTestFragment fragment_;
+  Buffer::OwnedImpl buffer_;
+  IoSocketHandleImpl io_handle_;
+};
+
+TEST_F(IoSocketHandleImplSendfileTest, SendsWholeRange) {
+  EXPECT_CALL(linux_os_sys_calls_, sendfile(_, 42, _, 11))
+      .WillOnce(Invoke([](int, int, off_t* offset, size_t) {
+        EXPECT_EQ(100, *offset);
+        return Api::SysCallSizeResult{11, 0};
+      }));
+  auto result = io_handle_.write(buffer_);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(11, result.return_value_);
+  EXPECT_EQ(0, buffer_.length());
+}
+
+TEST_F(IoSocketHandleImplSendfileTest, PartialSendContinuesFromFile) {
+  EXPECT_CALL(linux_os_sys_calls_, sendfile(_, 42, _, 11))
+      .WillOnce(Return(Api::SysCallSizeResult{6, 0}));
+  auto result = io_handle_.write(buffer_);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(6, result.return_value_);
+  EXPECT_EQ("world", buffer_.toString());
+
+  // The rest is sent from where the first call stopped.
+  EXPECT_CALL(linux_os_sys_calls_, sendfile(_, 42, _, 5))
+      .WillOnce(Invoke([](int, int, off_t* offset, size_t) {
+        EXPECT_EQ(106, *offset);
+        return Api::SysCallSizeResult{5, 0};
+      }));
+  result = io_handle_.write(buffer_);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(0, buffer_.length());
+}
+
+TEST_F(IoSocketHandleImplSendfileTest, ShortFileFallsBackToWritev) {
+  EXPECT_CALL(linux_os_sys_calls_, sendfile(_, 42, _, 11))
+      .WillOnce(Return(Api::SysCallSizeResult{0, 0}));
+  EXPECT_CALL(os_sys_calls_, writev(_, _, 1))
+      .WillOnce(Invoke([](os_fd_t, const iovec* iov, int) {
+        EXPECT_EQ("hello world",
+                  absl::string_view(static_cast<const char*>(iov[0].iov_base), iov[0].iov_len));
+        return Api::SysCallSizeResult{11, 0};
+      }));
+  auto result = io_handle_.write(buffer_);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(11, result.return_value_);
+  EXPECT_EQ(0, buffer_.length());
+}
+
+TEST_F(IoSocketHandleImplSendfileTest, UnsupportedFallsBackToWritev) {
+  for (int error : {EINVAL, ENOSYS, EOPNOTSUPP}) {
+    Buffer::OwnedImpl buffer;
+    FileBackedTestFragment fragment("hello", 42, 0);
+    buffer.addBufferFragment(fragment);
+    EXPECT_CALL(linux_os_sys_calls_, sendfile(_, 42, _, 5))
+        .WillOnce(Return(Api::SysCallSizeResult{-1, error}));
+    EXPECT_CALL(os_sys_calls_, writev(_, _, 1)).WillOnce(Return(Api::SysCallSizeResult{5, 0}));
+    auto result = io_handle_.write(buffer);
+    EXPECT_TRUE(result.ok());
+    EXPECT_EQ(0, buffer.length());
+  }
+}
+
+TEST_F(IoSocketHandleImplSendfileTest, ErrorIsReturned) {
+  EXPECT_CALL(linux_os_sys_calls_, sendfile(_, 42, _, 11))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, ECONNRESET}));
+  auto result = io_handle_.write(buffer_);
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(Api::IoError::IoErrorCode::ConnectionReset, result.err_->getErrorCode());
+  EXPECT_EQ(11, buffer_.length());
+}
+#endif
+
 class IoSocketHandleImplTest : public testing::TestWithParam<Network::Address::IpVersion> {};
 INSTANTIATE_TEST_SUITE_P(IpVersions, IoSocketHandleImplTest,
                          testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
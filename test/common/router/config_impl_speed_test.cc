@@ -39,12 +39,14 @@ static Http::TestRequestHeaderMapImpl genRequestHeaders(int route_num) {
  * Generates the route config for the type of matcher being tested.
  */
 static RouteConfiguration genRouteConfig(benchmark::State& state,
-                                         RouteMatch::PathSpecifierCase match_type) {
+                                         RouteMatch::PathSpecifierCase match_type,
+                                         bool compile_route_matchers = false) {
   // Create the base route config.
   RouteConfiguration route_config;
   VirtualHost* v_host = route_config.add_virtual_hosts();
   v_host->set_name("default");
   v_host->add_domains("*");
+  v_host->set_compile_route_matchers(compile_route_matchers);
 
   // Create `n` regex routes. The last route will be the only one matched.
   for (int i = 0; i < state.range(0); ++i) {
@@ -59,7 +61,7 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
       break;
     }
     case RouteMatch::PathSpecifierCase::kPath: {
-      match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+      match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
       break;
     }
     case RouteMatch::PathSpecifierCase::kSafeRegex: {
@@ -204,7 +206,8 @@ static RouteConfiguration genPrefixMatcherTreeRouteConfig(benchmark::State& stat
  * We then time how long it takes for the request to be matched against the
  * last route.
  */
-static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierCase match_type) {
+static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierCase match_type,
+                             bool compile_route_matchers = false) {
   // Setup router for benchmarking.
   Api::ApiPtr api = Api::createApiForTest();
   NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
@@ -213,8 +216,8 @@ static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierC
 
   // Create router config.
   std::shared_ptr<ConfigImpl> config =
-      *ConfigImpl::create(genRouteConfig(state, match_type), factory_context,
-                          ProtobufMessage::getNullValidationVisitor(), true);
+      *ConfigImpl::create(genRouteConfig(state, match_type, compile_route_matchers),
+                          factory_context, ProtobufMessage::getNullValidationVisitor(), true);
 
   for (auto _ : state) { // NOLINT
     // Do the actual timing here.
@@ -256,6 +259,28 @@ static void bmRouteTableSizeWithRegexMatch(benchmark::State& state) {
   bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kSafeRegex);
 }
 
+/**
+ * Same as bmRouteTableSizeWithPathPrefixMatch, with the routes compiled into a route match index.
+ */
+static void bmRouteTableSizeWithCompiledPathPrefixMatch(benchmark::State& state) {
+  bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kPrefix, true);
+}
+
+/**
+ * Same as bmRouteTableSizeWithExactPathMatch, with the routes compiled into a route match index.
+ */
+static void bmRouteTableSizeWithCompiledExactPathMatch(benchmark::State& state) {
+  bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kPath, true);
+}
+
+/**
+ * Same as bmRouteTableSizeWithRegexMatch, with compiled route matchers enabled. Regex routes are
+ * never indexed, so this measures the overhead of the index when it cannot help.
+ */
+static void bmRouteTableSizeWithCompiledRegexMatch(benchmark::State& state) {
+  bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kSafeRegex, true);
+}
+
 /**
  * Benchmark matcher tree route matching performance with exact path matchers in the form of:
  * - /shelves/shelf_1/route_1
@@ -311,13 +336,73 @@ static void bmRouteTableSizeWithPrefixMatcherTree(benchmark::State& state) {
   }
 }
 
+/**
+ * Generates a route config with `n` suffix wildcard virtual hosts of varying lengths in the form
+ * of:
+ * - *.0.example.com
+ * - *.1-a.example.com
+ * - *.2-aa.example.com
+ * - etc.
+ * plus a catch-all "*.example.com" virtual host, which is the shortest wildcard and therefore the
+ * last one considered by a longest match.
+ */
+static RouteConfiguration genWildcardVirtualHostRouteConfig(benchmark::State& state) {
+  RouteConfiguration route_config;
+  const auto add_virtual_host = [&route_config](const std::string& domain) {
+    VirtualHost* v_host = route_config.add_virtual_hosts();
+    v_host->set_name(domain);
+    v_host->add_domains(domain);
+    Route* route = v_host->add_routes();
+    route->mutable_match()->set_prefix("/");
+    route->mutable_direct_response()->set_status(200);
+  };
+
+  for (int i = 0; i < state.range(0); ++i) {
+    add_virtual_host(absl::StrCat("*.", i, "-", std::string(i % 64, 'a'), ".example.com"));
+  }
+  add_virtual_host("*.example.com");
+
+  return route_config;
+}
+
+/**
+ * Measure the speed of finding a wildcard virtual host when the route configuration contains
+ * wildcard domains of many different lengths. The request only matches the shortest wildcard, so
+ * every more specific candidate has to be ruled out first.
+ */
+static void bmWildcardVirtualHostLookup(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+
+  std::shared_ptr<ConfigImpl> config =
+      *ConfigImpl::create(genWildcardVirtualHostRouteConfig(state), factory_context,
+                          ProtobufMessage::getNullValidationVisitor(), true);
+
+  const Http::TestRequestHeaderMapImpl headers{{":authority", "www.unknown-service.example.com"},
+                                               {":method", "GET"},
+                                               {":path", "/"},
+                                               {"x-forwarded-proto", "http"}};
+  for (auto _ : state) { // NOLINT
+    RouteConstSharedPtr route = config->route(headers, stream_info, 0);
+    ASSERT(route != nullptr);
+  }
+}
+
 BENCHMARK(bmRouteTableSizeWithPathPrefixMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithExactPathMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 
+BENCHMARK(bmRouteTableSizeWithCompiledPathPrefixMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+BENCHMARK(bmRouteTableSizeWithCompiledExactPathMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+BENCHMARK(bmRouteTableSizeWithCompiledRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+
 BENCHMARK(bmRouteTableSizeWithExactMatcherTree)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithPrefixMatcherTree)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 
+BENCHMARK(bmWildcardVirtualHostLookup)->RangeMultiplier(4)->Ranges({{1, 2 << 15}});
+
 } // namespace
 } // namespace Router
 } // namespace Envoy
@@ -1234,6 +1234,62 @@ virtual_hosts:
             config.route(genHeaders("example.com", "/", "GET"), 0)->routeEntry()->clusterName());
 }
 
+TEST_F(RouteMatcherTest, CompiledRouteMatchers) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: compiled
+    domains: ["*"]
+    compile_route_matchers: true
+    routes:
+      - match:
+          prefix: "/foo"
+          headers:
+            - name: x-foo
+              string_match: { exact: "bar" }
+        route: { cluster: "foo_header" }
+      - match: { path: "/foo/exact" }
+        route: { cluster: "foo_exact" }
+      - match:
+          safe_regex:
+            regex: "/foo/regex/.*"
+        route: { cluster: "foo_regex" }
+      - match: { prefix: "/foo/" }
+        route: { cluster: "foo_prefix" }
+      - match: { prefix: "/BAR", case_sensitive: false }
+        route: { cluster: "bar_insensitive" }
+      - match: { path_separated_prefix: "/baz" }
+        route: { cluster: "baz" }
+      - match: { prefix: "/" }
+        route: { cluster: "default" }
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"foo_header", "foo_exact", "foo_regex", "foo_prefix", "bar_insensitive", "baz", "default"},
+      {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true,
+                        creation_status_);
+
+  const auto cluster_name = [&config](Http::TestRequestHeaderMapImpl headers) {
+    return config.route(headers, 0)->routeEntry()->clusterName();
+  };
+
+  EXPECT_EQ("foo_exact", cluster_name(genHeaders("www.lyft.com", "/foo/exact", "GET")));
+  EXPECT_EQ("foo_exact", cluster_name(genHeaders("www.lyft.com", "/foo/exact?a=b", "GET")));
+  EXPECT_EQ("foo_prefix", cluster_name(genHeaders("www.lyft.com", "/foo/exact/more", "GET")));
+  EXPECT_EQ("foo_regex", cluster_name(genHeaders("www.lyft.com", "/foo/regex/1", "GET")));
+  EXPECT_EQ("foo_prefix", cluster_name(genHeaders("www.lyft.com", "/foo/other", "GET")));
+  EXPECT_EQ("default", cluster_name(genHeaders("www.lyft.com", "/foo", "GET")));
+  EXPECT_EQ("bar_insensitive", cluster_name(genHeaders("www.lyft.com", "/bar/x", "GET")));
+  EXPECT_EQ("baz", cluster_name(genHeaders("www.lyft.com", "/baz/x", "GET")));
+  EXPECT_EQ("default", cluster_name(genHeaders("www.lyft.com", "/bazz", "GET")));
+  EXPECT_EQ("default", cluster_name(genHeaders("www.lyft.com", "/other", "GET")));
+
+  // An earlier route that only matches with a header still wins over the exact match.
+  Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", "/foo/exact", "GET");
+  headers.addCopy("x-foo", "bar");
+  EXPECT_EQ("foo_header", cluster_name(headers));
+}
+
 TEST_F(RouteMatcherTest, TestRoutesWithInvalidRegex) {
   std::string invalid_route = R"EOF(
 virtual_hosts:
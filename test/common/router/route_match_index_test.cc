@@ -0,0 +1,49 @@
+#include "source/common/router/route_match_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+TEST(RouteMatchIndexTest, Empty) {
+  RouteMatchIndex index;
+  EXPECT_THAT(index.candidates("/foo"), IsEmpty());
+  EXPECT_EQ(0, index.unindexedCount());
+}
+
+TEST(RouteMatchIndexTest, CandidatesInRouteOrder) {
+  RouteMatchIndex index;
+  index.addPrefix("/foo/", 0);
+  index.addExact("/foo/bar", 1);
+  index.addUnindexed(2);
+  index.addPrefix("/foo", 3);
+  index.addPrefix("/foo/", 4);
+  index.addExact("/baz", 5);
+  index.addPrefix("/", 6);
+  EXPECT_EQ(1, index.unindexedCount());
+
+  EXPECT_THAT(index.candidates("/foo/bar"), ElementsAre(0, 1, 2, 3, 4, 6));
+  EXPECT_THAT(index.candidates("/foo/baz"), ElementsAre(0, 2, 3, 4, 6));
+  EXPECT_THAT(index.candidates("/foo"), ElementsAre(2, 3, 6));
+  EXPECT_THAT(index.candidates("/baz"), ElementsAre(2, 5, 6));
+  EXPECT_THAT(index.candidates("/bazz"), ElementsAre(2, 6));
+  EXPECT_THAT(index.candidates("other"), ElementsAre(2));
+}
+
+TEST(RouteMatchIndexTest, EmptyPrefixIsAlwaysACandidate) {
+  RouteMatchIndex index;
+  index.addExact("/foo", 0);
+  index.addPrefix("", 1);
+  EXPECT_EQ(1, index.unindexedCount());
+  EXPECT_THAT(index.candidates("/foo"), ElementsAre(0, 1));
+  EXPECT_THAT(index.candidates(""), ElementsAre(1));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
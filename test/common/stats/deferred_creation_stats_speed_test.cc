@@ -1,4 +1,5 @@
 #include "source/common/common/random_generator.h"
+#include "source/common/memory/stats.h"
 #include "source/common/stats/deferred_creation.h"
 #include "source/common/stats/isolated_store_impl.h"
 #include "source/common/stats/symbol_table.h"
@@ -83,6 +84,19 @@ namespace Stats {
 MAKE_STAT_NAMES_STRUCT(AwesomeStatNames, AWESOME_STATS);
 MAKE_STATS_STRUCT(AwesomeStats, AwesomeStatNames, AWESOME_STATS);
 
+// Creates a copy of Upstream::ALL_CLUSTER_REQUEST_RESPONSE_SIZE_STATS, the largest optional
+// histogram block of a cluster.
+#define AWESOME_HISTOGRAMS(COUNTER, GAUGE, HISTOGRAM, TEXT_READOUT, STATNAME)                      \
+  HISTOGRAM(upstream_rq_headers_count, Unspecified)                                                \
+  HISTOGRAM(upstream_rq_headers_size, Bytes)                                                       \
+  HISTOGRAM(upstream_rq_body_size, Bytes)                                                          \
+  HISTOGRAM(upstream_rs_headers_count, Unspecified)                                                \
+  HISTOGRAM(upstream_rs_headers_size, Bytes)                                                       \
+  HISTOGRAM(upstream_rs_body_size, Bytes)
+
+MAKE_STAT_NAMES_STRUCT(AwesomeHistogramNames, AWESOME_HISTOGRAMS);
+MAKE_STATS_STRUCT(AwesomeHistograms, AwesomeHistogramNames, AWESOME_HISTOGRAMS);
+
 class DeferredCreationStatsBenchmarkBase {
 public:
   DeferredCreationStatsBenchmarkBase(bool lazy, const uint64_t n_clusters, Store& s)
@@ -149,6 +163,50 @@ BENCHMARK(benchmarkDeferredCreationCreationInstantiateSameThread)
     ->ArgsProduct({{0, 1}, {1000, 2000, 5000, 10000, 20000}})
     ->Unit(::benchmark::kMillisecond);
 
+// Measures the memory held per cluster by a cluster's traffic stats and optional histograms, when
+// none of the clusters have seen traffic yet. The histograms are either created in each cluster's
+// scope or in a scope shared by all clusters, see TrackClusterStats.histogram_aggregation_name.
+void benchmarkDeferredCreationMemory(::benchmark::State& state) {
+  const uint64_t num_clusters = benchmark::skipExpensiveBenchmarks() ? 1000 : state.range(0);
+  const bool deferred_creation = state.range(1);
+  const bool shared_histograms = state.range(2);
+
+  SymbolTableImpl symbol_table;
+  AllocatorImpl allocator(symbol_table);
+  ThreadLocalStoreImpl stats_store(allocator);
+  AwesomeStatNames stat_names(symbol_table);
+  AwesomeHistogramNames histogram_names(symbol_table);
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    std::vector<DeferredCreationCompatibleStats<AwesomeStats>> traffic_stats;
+    std::vector<DeferredCreationCompatibleStats<AwesomeHistograms>> histograms;
+    traffic_stats.reserve(num_clusters);
+    histograms.reserve(num_clusters);
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+
+    ScopeSharedPtr shared_scope = stats_store.createScope("cluster.template.");
+    for (uint64_t i = 0; i < num_clusters; ++i) {
+      ScopeSharedPtr scope = stats_store.createScope(absl::StrCat("cluster.cluster_", i, "."));
+      traffic_stats.push_back(
+          createDeferredCompatibleStats<AwesomeStats>(scope, stat_names, deferred_creation));
+      histograms.push_back(createDeferredCompatibleStats<AwesomeHistograms>(
+          shared_histograms ? shared_scope : scope, histogram_names, deferred_creation));
+    }
+
+    state.PauseTiming();
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["memory"] = end_mem - start_mem;
+    state.counters["memory_per_cluster"] = (end_mem - start_mem) / num_clusters;
+    traffic_stats.clear();
+    histograms.clear();
+    state.ResumeTiming();
+  }
+}
+
+BENCHMARK(benchmarkDeferredCreationMemory)
+    ->ArgsProduct({{100000}, {0, 1}, {0, 1}})
+    ->Unit(::benchmark::kMillisecond);
+
 class MultiThreadDeferredCreationStatsTest : public ThreadLocalRealThreadsMixin,
                                              public DeferredCreationStatsBenchmarkBase {
 public:
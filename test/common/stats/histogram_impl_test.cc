@@ -109,5 +109,48 @@ TEST_F(HistogramSettingsImplTest, ScaledPercent) {
   EXPECT_EQ(settings_->buckets("abcd"), ConstSupportedBuckets({0.1, 2}));
 }
 
+// Test that values recorded lock-free end up in the same buckets as with circllhist, and that
+// each merge only adds the values recorded since the previous one.
+TEST(AtomicLogLinearHistogramTest, MatchesCircllhist) {
+  const auto expect_equal = [](const histogram_t* expected, const histogram_t* actual) {
+    ASSERT_EQ(hist_num_buckets(expected), hist_num_buckets(actual));
+    for (int i = 0; i < hist_num_buckets(expected); ++i) {
+      hist_bucket_t expected_bucket, actual_bucket;
+      uint64_t expected_count, actual_count;
+      hist_bucket_idx_bucket(expected, i, &expected_bucket, &expected_count);
+      hist_bucket_idx_bucket(actual, i, &actual_bucket, &actual_count);
+      EXPECT_EQ(expected_bucket.val, actual_bucket.val);
+      EXPECT_EQ(expected_bucket.exp, actual_bucket.exp);
+      EXPECT_EQ(expected_count, actual_count);
+    }
+  };
+
+  AtomicLogLinearHistogram histogram;
+  histogram_t* expected = hist_alloc();
+  histogram_t* actual = hist_alloc();
+  for (uint64_t value : {0ULL, 0ULL, 1ULL, 9ULL, 10ULL, 43ULL, 99ULL, 100ULL, 415ULL, 2201ULL,
+                         999999ULL, 1000000ULL, 123456789012ULL, 9223372036854775807ULL}) {
+    histogram.recordValue(value);
+    hist_insert_intscale(expected, value, 0, 1);
+  }
+  histogram.merge(actual);
+  expect_equal(expected, actual);
+
+  hist_clear(expected);
+  hist_clear(actual);
+  histogram.merge(actual);
+  EXPECT_EQ(0, hist_sample_count(actual));
+
+  histogram.recordValue(43);
+  histogram.recordValue(5000);
+  hist_insert_intscale(expected, 43, 0, 1);
+  hist_insert_intscale(expected, 5000, 0, 1);
+  histogram.merge(actual);
+  expect_equal(expected, actual);
+
+  hist_free(expected);
+  hist_free(actual);
+}
+
 } // namespace Stats
 } // namespace Envoy
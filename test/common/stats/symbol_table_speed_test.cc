@@ -13,6 +13,7 @@
 #include "test/common/stats/make_elements_helper.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "benchmark/benchmark.h"
 
@@ -63,6 +64,104 @@ static void bmCreateRace(benchmark::State& state) {
 }
 BENCHMARK(bmCreateRace)->Unit(::benchmark::kMillisecond);
 
+// Mimics the stat creation of a config push spread across state.range(0)
+// threads. Each thread encodes, decodes and frees its own cluster stat names,
+// which share their leading and trailing tokens with the other threads.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmConcurrentEncode(benchmark::State& state) {
+  const int num_threads = state.range(0);
+  constexpr int num_names = 1000;
+  std::vector<std::vector<std::string>> names(num_threads);
+  for (int t = 0; t < num_threads; ++t) {
+    for (int i = 0; i < num_names; ++i) {
+      names[t].push_back(absl::StrCat("cluster.cluster_", t, "_", i, ".upstream_rq_total"));
+    }
+  }
+
+  Envoy::Thread::ThreadFactory& thread_factory = Envoy::Thread::threadFactoryForTest();
+  Envoy::Stats::SymbolTableImpl table;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Envoy::ConditionalInitializer access;
+    std::vector<Envoy::Thread::ThreadPtr> threads;
+    threads.reserve(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      threads.push_back(thread_factory.createThread([&access, &table, &names = names[t]]() {
+        access.wait();
+        std::vector<Envoy::Stats::StatNameStorage> storage;
+        storage.reserve(names.size());
+        for (const std::string& name : names) {
+          storage.emplace_back(name, table);
+        }
+        for (const Envoy::Stats::StatNameStorage& stat_name : storage) {
+          benchmark::DoNotOptimize(table.toString(stat_name.statName()));
+        }
+        for (Envoy::Stats::StatNameStorage& stat_name : storage) {
+          stat_name.free(table);
+        }
+      }));
+    }
+    access.setReady();
+    for (auto& thread : threads) {
+      thread->join();
+    }
+  }
+  const double encodes = static_cast<double>(state.iterations()) * num_threads * num_names;
+  state.counters["encodes_per_second"] = benchmark::Counter(encodes, benchmark::Counter::kIsRate);
+}
+BENCHMARK(bmConcurrentEncode)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->UseRealTime();
+
+// Mimics stat names already in the table being referenced and released from
+// state.range(0) threads, e.g. by per-worker scopes. Each thread copies and
+// frees its own cluster stat names.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmConcurrentRefCount(benchmark::State& state) {
+  const int num_threads = state.range(0);
+  constexpr int num_names = 1000;
+  Envoy::Stats::SymbolTableImpl table;
+  std::vector<std::vector<Envoy::Stats::StatNameStorage>> names(num_threads);
+  for (int t = 0; t < num_threads; ++t) {
+    names[t].reserve(num_names);
+    for (int i = 0; i < num_names; ++i) {
+      names[t].emplace_back(absl::StrCat("cluster.cluster_", t, "_", i, ".upstream_rq_total"),
+                            table);
+    }
+  }
+
+  Envoy::Thread::ThreadFactory& thread_factory = Envoy::Thread::threadFactoryForTest();
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Envoy::ConditionalInitializer access;
+    std::vector<Envoy::Thread::ThreadPtr> threads;
+    threads.reserve(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      threads.push_back(thread_factory.createThread([&access, &table, &names = names[t]]() {
+        access.wait();
+        std::vector<Envoy::Stats::StatNameStorage> refs;
+        refs.reserve(names.size());
+        for (const Envoy::Stats::StatNameStorage& stat_name : names) {
+          refs.emplace_back(stat_name.statName(), table);
+        }
+        for (Envoy::Stats::StatNameStorage& stat_name : refs) {
+          stat_name.free(table);
+        }
+      }));
+    }
+    access.setReady();
+    for (auto& thread : threads) {
+      thread->join();
+    }
+  }
+  for (auto& thread_names : names) {
+    for (Envoy::Stats::StatNameStorage& stat_name : thread_names) {
+      stat_name.free(table);
+    }
+  }
+  const double refs = static_cast<double>(state.iterations()) * num_threads * num_names;
+  state.counters["refs_per_second"] = benchmark::Counter(refs, benchmark::Counter::kIsRate);
+}
+BENCHMARK(bmConcurrentRefCount)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void bmJoinStatNames(benchmark::State& state) {
   Envoy::Stats::SymbolTableImpl symbol_table;
@@ -6,6 +6,7 @@
 #include "source/common/common/logger.h"
 #include "source/common/common/thread.h"
 #include "source/common/event/dispatcher_impl.h"
+#include "source/common/stats/histogram_impl.h"
 #include "source/common/stats/allocator_impl.h"
 #include "source/common/stats/stats_matcher_impl.h"
 #include "source/common/stats/symbol_table.h"
@@ -66,6 +67,32 @@ public:
     store_.initializeThreading(*dispatcher_, *tls_);
   }
 
+  void initHistograms(bool lock_free) {
+    stats_config_.set_lock_free_histograms(lock_free);
+    store_.setHistogramSettings(
+        std::make_unique<Stats::HistogramSettingsImpl>(stats_config_, context_));
+    Stats::Scope& scope = *store_.rootScope();
+    for (auto& stat_name_storage : stat_names_) {
+      histograms_.push_back(&scope.histogramFromStatName(stat_name_storage->statName(),
+                                                         Stats::Histogram::Unit::Unspecified));
+    }
+  }
+
+  void recordHistograms() {
+    uint64_t value = 0;
+    for (Stats::Histogram* histogram : histograms_) {
+      histogram->recordValue(++value);
+    }
+  }
+
+  void mergeHistograms() {
+    bool merged = false;
+    store_.mergeHistograms([&merged]() { merged = true; });
+    while (!merged) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
   void initPrefixRejections(const std::string& prefix) {
     stats_config_.mutable_stats_matcher()->mutable_exclusion_list()->add_patterns()->set_prefix(
         prefix);
@@ -84,6 +111,7 @@ private:
   Api::ApiPtr api_;
   envoy::config::metrics::v3::StatsConfig stats_config_;
   std::vector<std::unique_ptr<Stats::StatNameManagedStorage>> stat_names_;
+  std::vector<Stats::Histogram*> histograms_;
 };
 
 } // namespace Envoy
@@ -138,5 +166,38 @@ static void BM_StatsWithTlsAndRejectionsWithoutDot(benchmark::State& state) {
 }
 BENCHMARK(BM_StatsWithTlsAndRejectionsWithoutDot);
 
+// Compares the cost of recording histogram values with the default double-buffered
+// circllhist TLS histograms (arg 0) and with lock-free atomic buckets (arg 1).
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_HistogramRecord(benchmark::State& state) {
+  Envoy::ThreadLocalStorePerf context;
+  context.initThreading();
+  context.initHistograms(state.range(0) != 0);
+
+  for (auto _ : state) { // NOLINT
+    context.recordHistograms();
+  }
+}
+BENCHMARK(BM_HistogramRecord)->Arg(0)->Arg(1);
+
+// Compares the cost of a histogram merge for a stats flush. With the default TLS histograms
+// (arg 0) the merge first posts to every thread to swap their histograms, while lock-free
+// histograms (arg 1) are read directly by the merging thread. There is only one thread here, so
+// this underestimates the cross-thread cost of the default mode with many workers.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_HistogramMerge(benchmark::State& state) {
+  Envoy::ThreadLocalStorePerf context;
+  context.initThreading();
+  context.initHistograms(state.range(0) != 0);
+
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    context.recordHistograms();
+    state.ResumeTiming();
+    context.mergeHistograms();
+  }
+}
+BENCHMARK(BM_HistogramMerge)->Arg(0)->Arg(1);
+
 // TODO(jmarantz): add multi-threaded variant of this test, that aggressively
 // looks up stats in multiple threads to try to trigger contention issues.
@@ -1689,6 +1689,30 @@ TEST_F(HistogramTest, MultiHistogramMultipleMerges) {
   EXPECT_EQ(2, validateMerge());
 }
 
+TEST_F(HistogramTest, LockFreeHistogramMerge) {
+  envoy::config::metrics::v3::StatsConfig stats_config;
+  stats_config.set_lock_free_histograms(true);
+  store_->setHistogramSettings(std::make_unique<HistogramSettingsImpl>(stats_config, context_));
+
+  Histogram& h1 = scope_.histogramFromString("h1", Histogram::Unit::Unspecified);
+  Histogram& h2 = scope_.histogramFromString("h2", Histogram::Unit::Unspecified);
+
+  // Merging does not need to post to the threads that record values.
+  EXPECT_CALL(tls_, runOnAllThreads(_, _)).Times(0);
+  expectCallAndAccumulate(h1, 0);
+  expectCallAndAccumulate(h1, 43);
+  expectCallAndAccumulate(h1, 2201);
+  expectCallAndAccumulate(h2, 1);
+  EXPECT_EQ(2, validateMerge());
+
+  expectCallAndAccumulate(h2, 125);
+  expectCallAndAccumulate(h2, 3201);
+  EXPECT_EQ(2, validateMerge());
+
+  EXPECT_EQ(2, validateMerge());
+  testing::Mock::VerifyAndClearExpectations(&tls_);
+}
+
 TEST_F(HistogramTest, BasicScopeHistogramMerge) {
   ScopeSharedPtr scope1 = store_->createScope("scope1.");
 
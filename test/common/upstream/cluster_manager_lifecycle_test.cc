@@ -934,6 +934,65 @@ TEST_P(ClusterManagerLifecycleTest, HostsPostedToTlsCluster) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
 }
 
+// Verifies that a membership update hands the TLS clusters the main thread's immutable host
+// vectors rather than copies, so applying an update on a worker doesn't rebuild them.
+TEST_P(ClusterManagerLifecycleTest, TlsClusterSharesHostVectors) {
+  const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
+                                        clustersJson({defaultStaticClusterJson("fake_cluster")}));
+  std::shared_ptr<MockClusterRealPrioritySet> cluster1(new NiceMock<MockClusterRealPrioritySet>());
+  InSequence s;
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)));
+  ON_CALL(*cluster1, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+  EXPECT_CALL(*cluster1, initialize(_));
+
+  create(parseBootstrapFromV3Json(json));
+
+  ReadyWatcher initialized;
+  cluster_manager_->setInitializedCb([&]() -> void { initialized.ready(); });
+
+  EXPECT_CALL(initialized, ready());
+  cluster1->initialize_callback_();
+
+  HostSharedPtr host1 = makeTestHost(cluster1->info_, "tcp://127.0.0.1:80", time_system_);
+  HostSharedPtr host2 = makeTestHost(cluster1->info_, "tcp://127.0.0.1:81", time_system_);
+  host2->healthFlagSet(HostImpl::HealthFlag::DEGRADED_ACTIVE_HC);
+  HostSharedPtr host3 = makeTestHost(cluster1->info_, "tcp://127.0.0.1:82", time_system_);
+
+  auto* tls_cluster = cluster_manager_->getThreadLocalCluster(cluster1->info_->name());
+  const auto expect_shared = [&]() {
+    const HostSet& main_host_set = *cluster1->prioritySet().hostSetsPerPriority()[0];
+    const HostSet& tls_host_set = *tls_cluster->prioritySet().hostSetsPerPriority()[0];
+    EXPECT_EQ(main_host_set.hostsPtr().get(), tls_host_set.hostsPtr().get());
+    EXPECT_EQ(main_host_set.healthyHostsPtr().get(), tls_host_set.healthyHostsPtr().get());
+    EXPECT_EQ(main_host_set.degradedHostsPtr().get(), tls_host_set.degradedHostsPtr().get());
+    EXPECT_EQ(main_host_set.excludedHostsPtr().get(), tls_host_set.excludedHostsPtr().get());
+    EXPECT_EQ(main_host_set.hostsPerLocalityPtr().get(), tls_host_set.hostsPerLocalityPtr().get());
+  };
+
+  HostVector hosts{host1, host2};
+  cluster1->priority_set_.updateHosts(
+      0,
+      HostSetImpl::partitionHosts(std::make_shared<HostVector>(hosts),
+                                  HostsPerLocalityImpl::empty()),
+      nullptr, hosts, {}, 123, absl::nullopt, absl::nullopt);
+  expect_shared();
+
+  // A delta update replaces host2 with host3.
+  hosts = {host1, host3};
+  cluster1->priority_set_.updateHosts(
+      0,
+      HostSetImpl::partitionHosts(std::make_shared<HostVector>(hosts),
+                                  HostsPerLocalityImpl::empty()),
+      nullptr, {host3}, {host2}, 123, absl::nullopt, absl::nullopt);
+  expect_shared();
+  EXPECT_EQ(2, tls_cluster->prioritySet().hostSetsPerPriority()[0]->healthyHosts().size());
+
+  factory_.tls_.shutdownThread();
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
+}
+
 // Test that we close all HTTP connection pool connections when there is a host health failure.
 TEST_P(ClusterManagerLifecycleTest, CloseHttpConnectionsOnHealthFailure) {
   const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
@@ -0,0 +1,84 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <vector>
+
+#include "envoy/config/core/v3/base.pb.h"
+#include "envoy/config/endpoint/v3/endpoint_components.pb.h"
+
+#include "source/common/memory/stats.h"
+#include "source/common/network/utility.h"
+#include "source/common/upstream/upstream_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/common.h"
+#include "test/mocks/upstream/cluster_info.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+// Measures the memory of the hosts of a cluster, excluding their addresses which are created
+// up front. Hosts either copy their locality or share an interned one, and either never have their
+// stats accessed, as is the case for most hosts of a large cluster, or all do.
+void benchmarkHostMemory(::benchmark::State& state) {
+  const uint64_t num_hosts = benchmark::skipExpensiveBenchmarks() ? 100 : state.range(0);
+  const bool intern_locality = state.range(1);
+  const bool access_stats = state.range(2);
+
+  auto cluster = std::make_shared<testing::NiceMock<MockClusterInfo>>();
+  testing::NiceMock<MockTimeSystem> time_source;
+  Stats::SymbolTable& symbol_table = cluster->statsScope().symbolTable();
+  envoy::config::core::v3::Locality locality;
+  locality.set_region("us-east-1");
+  locality.set_zone("us-east-1a");
+  locality.set_sub_zone("rack-1");
+  const auto& health_check_config =
+      envoy::config::endpoint::v3::Endpoint::HealthCheckConfig::default_instance();
+
+  std::vector<Network::Address::InstanceConstSharedPtr> addresses;
+  addresses.reserve(num_hosts);
+  for (uint64_t i = 0; i < num_hosts; ++i) {
+    addresses.push_back(Network::Utility::parseInternetAddressNoThrow(
+        fmt::format("10.{}.{}.{}", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff), 80));
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    HostLocalityPool pool;
+    HostVector hosts;
+    hosts.reserve(num_hosts);
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+
+    for (const auto& address : addresses) {
+      std::unique_ptr<HostImpl> host =
+          intern_locality
+              ? *HostImpl::create(cluster, "", address, nullptr, nullptr, 1,
+                                  pool.get(locality, symbol_table), health_check_config, 0,
+                                  envoy::config::core::v3::HEALTHY, time_source)
+              : *HostImpl::create(cluster, "", address, nullptr, nullptr, 1, locality,
+                                  health_check_config, 0, envoy::config::core::v3::HEALTHY,
+                                  time_source);
+      if (access_stats) {
+        host->stats().rq_total_.inc();
+      }
+      hosts.emplace_back(std::move(host));
+    }
+
+    state.PauseTiming();
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["memory"] = end_mem - start_mem;
+    state.counters["memory_per_host"] = (end_mem - start_mem) / num_hosts;
+    hosts.clear();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(benchmarkHostMemory)
+    ->ArgsProduct({{10000, 100000}, {false, true}, {false, true}})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
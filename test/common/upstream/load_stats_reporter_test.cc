@@ -390,6 +390,42 @@ TEST_P(LoadStatsReporterTestWithRqTotal, UpstreamLocalityStats) {
   response_timer_cb_();
 }
 
+// Validate that a load report cycle does not allocate stats for hosts that saw no traffic.
+TEST_F(LoadStatsReporterTest, IdleHostsStatsNotAllocated) {
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage({});
+  createLoadStatsReporter();
+  time_system_.setMonotonicTime(std::chrono::microseconds(3));
+
+  NiceMock<MockClusterMockPrioritySet> cluster;
+  MockHostSet& host_set = *cluster.prioritySet().getMockHostSet(0);
+  ::envoy::config::core::v3::Locality locality;
+  locality.set_region("mars");
+  HostSharedPtr host0 = makeTestHost(cluster.info_, "tcp://10.0.0.1:80", time_system_, locality);
+  HostSharedPtr host1 = makeTestHost(cluster.info_, "tcp://10.0.0.2:80", time_system_, locality);
+  host_set.hosts_ = {host0, host1};
+  host_set.hosts_per_locality_ = makeHostsPerLocality({{host0, host1}});
+  host1->stats().rq_success_.inc();
+  host1->stats().rq_total_.inc();
+
+  ON_CALL(cm_, getActiveCluster("foo"))
+      .WillByDefault(Return(OptRef<const Upstream::Cluster>(cluster)));
+  deliverLoadStatsResponse({"foo"});
+  time_system_.setMonotonicTime(std::chrono::microseconds(4));
+  {
+    envoy::config::endpoint::v3::ClusterStats expected_cluster_stats;
+    expected_cluster_stats.set_cluster_name("foo");
+    expected_cluster_stats.mutable_load_report_interval()->MergeFrom(
+        Protobuf::util::TimeUtil::MicrosecondsToDuration(1));
+    expectSendMessage({expected_cluster_stats});
+  }
+  EXPECT_CALL(*response_timer_, enableTimer(std::chrono::milliseconds(42000), _));
+  response_timer_cb_();
+
+  EXPECT_EQ(nullptr, host0->statsIfAllocated());
+  EXPECT_NE(nullptr, host1->statsIfAllocated());
+}
+
 // Validate that the client can recover from a remote stream closure via retry.
 TEST_F(LoadStatsReporterTest, RemoteStreamClose) {
   EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
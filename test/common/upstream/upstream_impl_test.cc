@@ -1883,6 +1883,82 @@ TEST_F(HostImplTest, HostnameCanaryAndLocality) {
   EXPECT_EQ(1, host->priority());
 }
 
+TEST_F(HostImplTest, InternedLocality) {
+  MockClusterMockPrioritySet cluster;
+  Stats::SymbolTable& symbol_table = cluster.info_->statsScope().symbolTable();
+  envoy::config::core::v3::Locality locality;
+  locality.set_region("oceania");
+  locality.set_zone("hello");
+  envoy::config::core::v3::Locality other_locality = locality;
+  other_locality.set_sub_zone("world");
+
+  HostLocalityPool pool;
+  HostLocalityConstSharedPtr interned = pool.get(locality, symbol_table);
+  EXPECT_EQ(interned, pool.get(locality, symbol_table));
+  EXPECT_NE(interned, pool.get(other_locality, symbol_table));
+
+  auto make_host = [&](const std::string& url) {
+    return *HostImpl::create(
+        cluster.info_, "", *Network::Utility::resolveUrl(url), nullptr, nullptr, 1,
+        pool.get(locality, symbol_table),
+        envoy::config::endpoint::v3::Endpoint::HealthCheckConfig::default_instance(), 0,
+        envoy::config::core::v3::UNKNOWN, simTime());
+  };
+  std::unique_ptr<HostImpl> host1 = make_host("tcp://10.0.0.1:1234");
+  std::unique_ptr<HostImpl> host2 = make_host("tcp://10.0.0.2:1234");
+  EXPECT_EQ(&host1->locality(), &host2->locality());
+  EXPECT_EQ("hello", host1->locality().zone());
+  EXPECT_EQ("hello", symbol_table.toString(host2->localityZoneStatName()));
+
+  // Once no host references a locality anymore, its entry is purged as the pool grows, and a
+  // later lookup creates a new instance.
+  interned.reset();
+  host1.reset();
+  host2.reset();
+  for (int i = 0; i < 32; ++i) {
+    envoy::config::core::v3::Locality expired_locality;
+    expired_locality.set_zone(absl::StrCat("zone_", i));
+    pool.get(expired_locality, symbol_table);
+  }
+  HostLocalityConstSharedPtr recreated = pool.get(locality, symbol_table);
+  EXPECT_EQ("hello", recreated->locality().zone());
+  EXPECT_EQ("hello", symbol_table.toString(recreated->zoneStatName()));
+}
+
+TEST_F(HostImplTest, StatsCreatedOnFirstUse) {
+  MockClusterMockPrioritySet cluster;
+  HostSharedPtr host = makeTestHost(cluster.info_, "tcp://10.0.0.1:1234", simTime(), 1);
+  HostStats& stats = host->stats();
+  EXPECT_EQ(&stats, &host->stats());
+  stats.rq_total_.inc();
+  stats.cx_active_.inc();
+  EXPECT_EQ(1, host->stats().rq_total_.value());
+  EXPECT_EQ(1, host->stats().cx_active_.value());
+  for (const auto& [name, counter] : host->counters()) {
+    EXPECT_EQ(name == "rq_total" ? 1 : 0, counter.get().value());
+  }
+}
+
+TEST_F(HostImplTest, ReadingStatsDoesNotCreateThem) {
+  MockClusterMockPrioritySet cluster;
+  HostSharedPtr host = makeTestHost(cluster.info_, "tcp://10.0.0.1:1234", simTime(), 1);
+  // What the admin /clusters dump reads.
+  for (const auto& [name, counter] : host->counters()) {
+    EXPECT_EQ(0, counter.get().value()) << name;
+  }
+  for (const auto& [name, gauge] : host->gauges()) {
+    EXPECT_EQ(0, gauge.get().value()) << name;
+  }
+  EXPECT_EQ(nullptr, host->statsIfAllocated());
+
+  host->stats().rq_total_.inc();
+  ASSERT_NE(nullptr, host->statsIfAllocated());
+  EXPECT_EQ(1, host->statsIfAllocated()->rq_total_.value());
+  for (const auto& [name, counter] : host->counters()) {
+    EXPECT_EQ(name == "rq_total" ? 1 : 0, counter.get().value());
+  }
+}
+
 TEST_F(HostImplTest, CreateConnection) {
   MockClusterMockPrioritySet cluster;
   envoy::config::core::v3::Metadata metadata;
@@ -4892,6 +4968,58 @@ TEST_F(ClusterInfoImplTest, DEPRECATED_FEATURE_TEST(TestTrackTimeoutBudgetsOld))
             tb_stats.upstream_rq_timeout_budget_per_try_percent_used_.unit());
 }
 
+TEST_F(ClusterInfoImplTest, DeferredOptionalStats) {
+  ON_CALL(server_context_.stats_config_, enableDeferredCreationStats()).WillByDefault(Return(true));
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+    track_cluster_stats: { timeout_budgets : true, request_response_sizes : true }
+  )EOF";
+
+  auto cluster = makeCluster(yaml);
+  EXPECT_FALSE(stats_.findHistogramByString("cluster.name.upstream_rq_timeout_budget_percent_used")
+                   .has_value());
+  EXPECT_FALSE(stats_.findHistogramByString("cluster.name.upstream_rq_headers_size").has_value());
+
+  ASSERT_TRUE(cluster->info()->timeoutBudgetStats().has_value());
+  cluster->info()->timeoutBudgetStats()->get().upstream_rq_timeout_budget_percent_used_.recordValue(
+      50);
+  EXPECT_TRUE(stats_.findHistogramByString("cluster.name.upstream_rq_timeout_budget_percent_used")
+                  .has_value());
+  EXPECT_FALSE(stats_.findHistogramByString("cluster.name.upstream_rq_headers_size").has_value());
+
+  cluster->info()->loadReportStats().upstream_rq_dropped_.inc();
+  EXPECT_EQ(1, cluster->info()->loadReportStats().upstream_rq_dropped_.value());
+}
+
+TEST_F(ClusterInfoImplTest, SharedOptionalHistograms) {
+  const std::string yaml = R"EOF(
+    name: {}
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+    track_cluster_stats:
+      timeout_budgets: true
+      request_response_sizes: true
+      histogram_aggregation_name: template
+  )EOF";
+
+  auto cluster1 = makeCluster(fmt::format(yaml, "cluster1"));
+  auto cluster2 = makeCluster(fmt::format(yaml, "cluster2"));
+  ClusterTimeoutBudgetStats& tb_stats1 = cluster1->info()->timeoutBudgetStats()->get();
+  ClusterTimeoutBudgetStats& tb_stats2 = cluster2->info()->timeoutBudgetStats()->get();
+  EXPECT_EQ(&tb_stats1.upstream_rq_timeout_budget_percent_used_,
+            &tb_stats2.upstream_rq_timeout_budget_percent_used_);
+  EXPECT_EQ(&cluster1->info()->requestResponseSizeStats()->get().upstream_rq_headers_size_,
+            &cluster2->info()->requestResponseSizeStats()->get().upstream_rq_headers_size_);
+  EXPECT_TRUE(
+      stats_.findHistogramByString("cluster.template.upstream_rq_headers_size").has_value());
+  EXPECT_FALSE(
+      stats_.findHistogramByString("cluster.cluster1.upstream_rq_headers_size").has_value());
+}
+
 // Validates HTTP2 SETTINGS config.
 TEST_F(ClusterInfoImplTest, Http2ProtocolOptions) {
   const std::string yaml = R"EOF(
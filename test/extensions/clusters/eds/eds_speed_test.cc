@@ -1,6 +1,7 @@
 // Note: this should be run with --compilation_mode=opt, and would benefit from a
 // quiescent system with disabled cstate power management.
 
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/config/core/v3/health_check.pb.h"
 #include "envoy/config/endpoint/v3/endpoint.pb.h"
@@ -12,6 +13,9 @@
 
 #include "source/common/config/protobuf_link_hacks.h"
 #include "source/common/config/utility.h"
+#include "source/common/grpc/context_impl.h"
+#include "source/common/http/context_impl.h"
+#include "source/common/router/context_impl.h"
 #include "source/common/singleton/manager_impl.h"
 #include "source/extensions/clusters/eds/eds.h"
 #include "source/extensions/config_subscription/grpc/grpc_mux_impl.h"
@@ -20,8 +24,10 @@
 #include "source/server/transport_socket_config_impl.h"
 
 #include "test/benchmark/main.h"
+#include "test/common/upstream/test_cluster_manager.h"
 #include "test/common/upstream/utility.h"
 #include "test/mocks/config/custom_config_validators.h"
+#include "test/mocks/config/xds_manager.h"
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/protobuf/mocks.h"
 #include "test/mocks/runtime/mocks.h"
@@ -31,6 +37,7 @@
 #include "test/mocks/ssl/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "benchmark/benchmark.h"
@@ -43,12 +50,17 @@ namespace Upstream {
 
 class EdsSpeedTest {
 public:
-  EdsSpeedTest(State& state, bool use_unified_mux)
+  // If num_workers is not zero, the cluster is added to a cluster manager with that many workers.
+  EdsSpeedTest(State& state, bool use_unified_mux, uint32_t host_construction_concurrency = 1,
+               uint32_t num_workers = 0)
       : state_(state), use_unified_mux_(use_unified_mux),
         type_url_("type.googleapis.com/envoy.config.endpoint.v3.ClusterLoadAssignment"),
         subscription_stats_(Config::Utility::generateStats(scope_)),
         async_client_(new Grpc::MockAsyncClient()),
-        config_validators_(std::make_unique<NiceMock<Config::MockCustomConfigValidators>>()) {
+        config_validators_(std::make_unique<NiceMock<Config::MockCustomConfigValidators>>()),
+        http_context_(cm_factory_.stats_.symbolTable()),
+        grpc_context_(cm_factory_.stats_.symbolTable()),
+        router_context_(cm_factory_.stats_.symbolTable()) {
     auto backoff_strategy = std::make_unique<JitteredExponentialBackOffStrategy>(
         Config::SubscriptionFactory::RetryInitialDelayMs,
         Config::SubscriptionFactory::RetryMaxDelayMs, random_);
@@ -73,25 +85,33 @@ public:
     } else {
       grpc_mux_ = std::make_shared<Config::GrpcMuxImpl>(grpc_mux_context, true);
     }
-    resetCluster(R"EOF(
+    ON_CALL(server_context_.api_, threadFactory())
+        .WillByDefault(testing::ReturnRef(Thread::threadFactoryForTest()));
+    resetCluster(fmt::format(R"EOF(
       name: name
       connect_timeout: 0.25s
       type: EDS
       eds_cluster_config:
         service_name: fare
+        host_construction_concurrency: {}
         eds_config:
           api_config_source:
             cluster_names:
             - eds
             refresh_delay: 1s
     )EOF",
+                             host_construction_concurrency),
                  Envoy::Upstream::Cluster::InitializePhase::Secondary);
 
     EXPECT_CALL(*server_context_.cluster_manager_.subscription_factory_.subscription_, start(_));
-    cluster_->initialize([this] {
-      initialized_ = true;
-      return absl::OkStatus();
-    });
+    if (num_workers == 0) {
+      cluster_->initialize([this] {
+        initialized_ = true;
+        return absl::OkStatus();
+      });
+    } else {
+      createClusterManager(num_workers);
+    }
     EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(testing::Return(&async_stream_));
     subscription_->start({"fare"});
   }
@@ -113,12 +133,48 @@ public:
         Config::SubscriptionOptions());
   }
 
+  // Adds the cluster to a cluster manager, which initializes it and posts every membership update
+  // through postThreadLocalClusterUpdate() as in production. The benchmark has no worker threads,
+  // so the update callback runs num_workers times against the one thread local cluster manager,
+  // which costs the same as each worker applying it once.
+  void createClusterManager(uint32_t num_workers) {
+    ON_CALL(cm_factory_.tls_, runOnAllThreads(_))
+        .WillByDefault([num_workers](std::function<void()> cb) {
+          for (uint32_t i = 0; i < num_workers; ++i) {
+            cb();
+          }
+        });
+    ON_CALL(cm_factory_, clusterFromProto_(_, _, _, _))
+        .WillByDefault(testing::Return(
+            std::pair<ClusterSharedPtr, ThreadAwareLoadBalancer*>(cluster_, nullptr)));
+
+    envoy::config::bootstrap::v3::Bootstrap bootstrap;
+    *bootstrap.mutable_static_resources()->add_clusters() = eds_cluster_;
+    cluster_manager_ = TestClusterManagerImpl::createAndInit(
+        bootstrap, cm_factory_, cm_factory_.server_context_, cm_factory_.stats_, cm_factory_.tls_,
+        cm_factory_.runtime_, cm_factory_.local_info_, cm_factory_.log_manager_,
+        cm_factory_.dispatcher_, cm_factory_.admin_, *cm_factory_.api_, http_context_,
+        grpc_context_, router_context_, server_, xds_manager_);
+    // The cluster is an EDS cluster, so it is initialized with the secondary clusters.
+    THROW_IF_NOT_OK(cluster_manager_->initializeSecondaryClusters(bootstrap));
+  }
+
   // Set up an EDS config with multiple priorities, localities, weights and make sure
   // they are loaded as expected.
   void priorityAndLocalityWeightedHelper(bool ignore_unknown_dynamic_fields, size_t num_hosts,
                                          bool healthy) {
     state_.PauseTiming();
+    auto response = buildResponse(ignore_unknown_dynamic_fields, num_hosts, healthy);
+    state_.ResumeTiming();
+    deliverResponse(std::move(response), num_hosts);
+  }
 
+  // Builds an EDS response with num_hosts endpoints in a single locality. The first
+  // replaced_hosts endpoints get an address unique to this response, so that consecutive
+  // responses differ by that many hosts added and removed.
+  std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>
+  buildResponse(bool ignore_unknown_dynamic_fields, size_t num_hosts, bool healthy,
+                size_t replaced_hosts = 0) {
     envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
     cluster_load_assignment.set_cluster_name("fare");
 
@@ -141,7 +197,12 @@ public:
       }
       auto* socket_address =
           lb_endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
-      socket_address->set_address("10.0.1." + std::to_string(i / 60000));
+      if (i < replaced_hosts) {
+        socket_address->set_address(
+            fmt::format("10.1.{}.{}", version_ / 256 % 256, version_ % 256));
+      } else {
+        socket_address->set_address("10.0.1." + std::to_string(i / 60000));
+      }
       socket_address->set_port_value((port + i) % 60000);
     }
 
@@ -153,7 +214,12 @@ public:
     response->set_version_info(fmt::format("version-{}", version_++));
     auto* resource = response->mutable_resources()->Add();
     resource->PackFrom(cluster_load_assignment);
-    state_.ResumeTiming();
+    return response;
+  }
+
+  void
+  deliverResponse(std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>&& response,
+                  size_t num_hosts) {
     if (use_unified_mux_) {
       dynamic_cast<Config::XdsMux::GrpcMuxSotw&>(*grpc_mux_)
           .grpcStreamForTest()
@@ -165,6 +231,7 @@ public:
     }
     ASSERT(cluster_->prioritySet().hostSetsPerPriority()[1]->hostsPerLocality().get()[0].size() ==
            num_hosts);
+    UNREFERENCED_PARAMETER(num_hosts);
   }
 
   NiceMock<Server::Configuration::MockServerFactoryContext> server_context_;
@@ -193,6 +260,14 @@ public:
   Config::GrpcMuxSharedPtr grpc_mux_;
   Config::GrpcSubscriptionImplPtr subscription_;
   NiceMock<AccessLog::MockAccessLogManager> access_log_manager_;
+  NiceMock<TestClusterManagerFactory> cm_factory_;
+  Http::ContextImpl http_context_;
+  Grpc::ContextImpl grpc_context_;
+  Router::ContextImpl router_context_;
+  NiceMock<Server::MockInstance> server_;
+  NiceMock<Config::MockXdsManager> xds_manager_;
+  // Declared last so that it is destroyed before the cluster and the mocks it uses.
+  std::unique_ptr<TestClusterManagerImpl> cluster_manager_;
 };
 
 } // namespace Upstream
@@ -245,3 +320,65 @@ static void healthOnlyUpdate(State& state) {
 }
 
 BENCHMARK(healthOnlyUpdate)->Ranges({{1, 100000}, {false, true}})->Unit(benchmark::kMillisecond);
+
+// Measures constructing the hosts of a large update on a varying number of threads. The speedup
+// of parallel host construction is the ratio of the hosts_per_second counters of two runs that
+// only differ in the number of threads.
+static void parallelHostConstruction(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  const uint32_t endpoints = skipExpensiveBenchmarks() ? 1 : state.range(0);
+  const uint32_t concurrency = state.range(1);
+
+  std::unique_ptr<Envoy::Upstream::EdsSpeedTest> speed_test;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    speed_test.reset();
+    speed_test = std::make_unique<Envoy::Upstream::EdsSpeedTest>(state, false, concurrency);
+    state.ResumeTiming();
+
+    // Pauses timing while building the response itself.
+    speed_test->priorityAndLocalityWeightedHelper(true, endpoints, true);
+  }
+  state.counters["hosts_per_second"] =
+      benchmark::Counter(endpoints, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK(parallelHostConstruction)
+    ->ArgsProduct({{10000, 100000}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMillisecond);
+
+// Measures applying an update that replaces a few hosts of a large cluster, end to end from
+// receiving the EDS response to the cluster manager having applied the delta on every worker,
+// including each worker's load balancer refresh. Setting up the cluster with the initial full
+// update is not timed.
+static void deltaUpdate(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  const uint32_t endpoints = skipExpensiveBenchmarks() ? 1 : state.range(0);
+  const uint32_t num_workers = state.range(1);
+  const uint32_t replaced_hosts = std::min<uint32_t>(state.range(2), endpoints);
+
+  std::unique_ptr<Envoy::Upstream::EdsSpeedTest> speed_test;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    // Tear down the previous iteration outside of the timed region too.
+    speed_test.reset();
+    speed_test = std::make_unique<Envoy::Upstream::EdsSpeedTest>(state, false, 1, num_workers);
+    speed_test->deliverResponse(speed_test->buildResponse(true, endpoints, true), endpoints);
+    auto response = speed_test->buildResponse(true, endpoints, true, replaced_hosts);
+    state.ResumeTiming();
+
+    speed_test->deliverResponse(std::move(response), endpoints);
+  }
+  state.counters["workers"] = num_workers;
+}
+
+BENCHMARK(deltaUpdate)
+    ->Args({10000, 1, 1})
+    ->Args({10000, 16, 1})
+    ->Args({20000, 64, 1})
+    ->Args({20000, 64, 100})
+    ->Unit(benchmark::kMillisecond);
@@ -25,6 +25,7 @@
 #include "test/mocks/upstream/health_checker.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -33,6 +34,7 @@
 using testing::_;
 using testing::DoAll;
 using testing::Return;
+using testing::ReturnRef;
 using testing::SaveArg;
 
 namespace Envoy {
@@ -127,6 +129,27 @@ public:
                  Cluster::InitializePhase::Primary);
   }
 
+  void resetClusterWithHostConstructionConcurrency() {
+    ON_CALL(server_context_.api_, threadFactory())
+        .WillByDefault(ReturnRef(Thread::threadFactoryForTest()));
+    resetCluster(R"EOF(
+      name: name
+      connect_timeout: 0.25s
+      type: EDS
+      lb_policy: ROUND_ROBIN
+      eds_cluster_config:
+        service_name: fare
+        host_construction_concurrency: 4
+        eds_config:
+          api_config_source:
+            api_type: REST
+            cluster_names:
+            - eds
+            refresh_delay: 1s
+    )EOF",
+                 Cluster::InitializePhase::Secondary);
+  }
+
   void resetCluster(const std::string& yaml_config, Cluster::InitializePhase initialize_phase) {
     server_context_.local_info_.node_.mutable_locality()->set_zone("us-east-1a");
     eds_cluster_ = parseClusterFromV3Yaml(yaml_config);
@@ -469,6 +492,53 @@ TEST_F(EdsTest, RejectNonIpAdditionalAddresses) {
   }
 }
 
+// Verify that hosts constructed on several threads are registered in the order of the update, and
+// that duplicates are resolved the same way as when hosts are constructed on the main thread.
+TEST_F(EdsTest, ParallelHostConstruction) {
+  resetClusterWithHostConstructionConcurrency();
+  envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name("fare");
+  auto* endpoints = cluster_load_assignment.add_endpoints();
+  auto add_endpoint = [endpoints](uint32_t port, uint32_t weight) {
+    auto* endpoint = endpoints->add_lb_endpoints();
+    auto* socket_address =
+        endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
+    socket_address->set_address("1.2.3.4");
+    socket_address->set_port_value(port);
+    endpoint->mutable_load_balancing_weight()->set_value(weight);
+    return endpoint;
+  };
+  const uint32_t num_hosts = 5000;
+  for (uint32_t i = 0; i < num_hosts; ++i) {
+    add_endpoint(1000 + i, 1);
+  }
+  // A duplicate of the first endpoint, which must be dropped.
+  add_endpoint(1000, 2);
+  // An endpoint using a resolver that is not available off the main thread.
+  add_endpoint(80, 1)
+      ->mutable_endpoint()
+      ->mutable_address()
+      ->mutable_socket_address()
+      ->set_resolver_name("envoy.resolvers.unknown");
+
+  initialize();
+  const auto decoded_resources =
+      TestUtility::decodeResources({cluster_load_assignment}, "cluster_name");
+  EXPECT_THROW_WITH_REGEX(
+      THROW_IF_NOT_OK(eds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "")),
+      EnvoyException, "Unknown address resolver: envoy.resolvers.unknown");
+
+  endpoints->mutable_lb_endpoints()->RemoveLast();
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_TRUE(initialized_);
+  auto& hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+  ASSERT_EQ(num_hosts, hosts.size());
+  for (uint32_t i = 0; i < num_hosts; ++i) {
+    EXPECT_EQ(1000 + i, hosts[i]->address()->ip()->port());
+    EXPECT_EQ(1, hosts[i]->weight());
+  }
+}
+
 // Verify that failure to initialize the base class results in an error not a crash.
 // Note that this test is depending on the current implementation of how EDS inherits from
 // `BaseDynamicClusterImpl` and how `BaseDynamicClusterImpl` does error handling to have a
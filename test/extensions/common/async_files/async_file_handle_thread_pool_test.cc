@@ -17,6 +17,7 @@
 #include "test/test_common/status_utility.h"
 
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -138,6 +139,65 @@ TEST_F(AsyncFileHandleTest, WriteReadClose) {
   close(handle);
 }
 
+TEST_F(AsyncFileHandleTest, ReadFileBackedRefersToFile) {
+  auto handle = createAnonymousFile();
+  absl::StatusOr<size_t> write_status;
+  // Long enough that the range starts and ends part way through a page.
+  std::string contents = absl::StrCat(std::string(5000, 'a'), "hello", std::string(5000, 'b'));
+  Buffer::OwnedImpl data(contents);
+  ASSERT_OK(handle->write(dispatcher_.get(), data, 0, [&](absl::StatusOr<size_t> status) {
+    write_status = std::move(status);
+  }));
+  resolveFileActions();
+  EXPECT_THAT(write_status, IsOkAndHolds(contents.size()));
+
+  absl::StatusOr<Buffer::InstancePtr> read_status;
+  ASSERT_OK(handle->readFileBacked(dispatcher_.get(), 4998, 9,
+                                   [&](absl::StatusOr<Buffer::InstancePtr> status) {
+                                     read_status = std::move(status);
+                                   }));
+  resolveFileActions();
+  ASSERT_OK(read_status);
+  EXPECT_THAT(*read_status.value(), BufferStringEqual("aahellobb"));
+  absl::optional<Buffer::FileRange> range = read_status.value()->frontFileRange();
+  ASSERT_TRUE(range.has_value());
+  EXPECT_EQ(4998, range->offset_);
+  EXPECT_EQ(9, range->length_);
+
+  // The buffer stays valid after the file is closed.
+  close(handle);
+  EXPECT_THAT(*read_status.value(), BufferStringEqual("aahellobb"));
+}
+
+TEST_F(AsyncFileHandleTest, ReadFileBackedIsClippedToEndOfFile) {
+  auto handle = createAnonymousFile();
+  absl::StatusOr<size_t> write_status;
+  Buffer::OwnedImpl data("hello");
+  ASSERT_OK(handle->write(dispatcher_.get(), data, 0, [&](absl::StatusOr<size_t> status) {
+    write_status = std::move(status);
+  }));
+  resolveFileActions();
+  EXPECT_THAT(write_status, IsOkAndHolds(5U));
+
+  absl::StatusOr<Buffer::InstancePtr> read_status;
+  ASSERT_OK(handle->readFileBacked(dispatcher_.get(), 3, 100,
+                                   [&](absl::StatusOr<Buffer::InstancePtr> status) {
+                                     read_status = std::move(status);
+                                   }));
+  resolveFileActions();
+  ASSERT_OK(read_status);
+  EXPECT_THAT(*read_status.value(), BufferStringEqual("lo"));
+
+  ASSERT_OK(handle->readFileBacked(dispatcher_.get(), 5, 100,
+                                   [&](absl::StatusOr<Buffer::InstancePtr> status) {
+                                     read_status = std::move(status);
+                                   }));
+  resolveFileActions();
+  ASSERT_OK(read_status);
+  EXPECT_EQ(0, read_status.value()->length());
+  close(handle);
+}
+
 TEST_F(AsyncFileHandleTest, LinkCreatesNamedFile) {
   auto handle = createAnonymousFile();
   absl::StatusOr<size_t> write_status;
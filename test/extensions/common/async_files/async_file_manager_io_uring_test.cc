@@ -0,0 +1,224 @@
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/common/async_files/async_file_handle.h"
+#include "source/extensions/common/async_files/async_file_manager.h"
+#include "source/extensions/common/async_files/async_file_manager_factory.h"
+
+#if defined(__linux__) && !defined(__ANDROID_API__) && defined(ENVOY_ENABLE_IO_URING)
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+#endif
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/status_utility.h"
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+using StatusHelpers::IsOkAndHolds;
+using ::testing::HasSubstr;
+
+// These tests run against whichever manager the io_uring config produces, so on kernels or
+// builds without io_uring they verify that the thread pool fallback behaves the same.
+class AsyncFileManagerIoUringTest : public testing::Test {
+public:
+  void SetUp() override {
+    envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
+    config.mutable_io_uring()->set_submission_queue_size(4);
+    manager_ = factory_->getAsyncFileManager(config);
+  }
+
+  void resolveFileActions() {
+    manager_->waitForIdle();
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+  }
+
+  void close(AsyncFileHandle& handle) {
+    absl::Status close_result = absl::InternalError("not set");
+    EXPECT_OK(
+        handle->close(dispatcher_.get(), [&](absl::Status status) { close_result = status; }));
+    resolveFileActions();
+    EXPECT_OK(close_result);
+  }
+
+  AsyncFileHandle createAnonymousFile() {
+    AsyncFileHandle create_result;
+    manager_->createAnonymousFile(
+        dispatcher_.get(), tmpdir_,
+        [&](absl::StatusOr<AsyncFileHandle> result) { create_result = result.value(); });
+    resolveFileActions();
+    return create_result;
+  }
+
+  const char* test_tmpdir = std::getenv("TEST_TMPDIR");
+  std::string tmpdir_ = test_tmpdir ? test_tmpdir : "/tmp";
+
+  std::unique_ptr<Singleton::ManagerImpl> singleton_manager_ =
+      std::make_unique<Singleton::ManagerImpl>();
+  std::shared_ptr<AsyncFileManagerFactory> factory_ =
+      AsyncFileManagerFactory::singleton(singleton_manager_.get());
+  std::shared_ptr<AsyncFileManager> manager_;
+  Api::ApiPtr api_ = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
+};
+
+TEST_F(AsyncFileManagerIoUringTest, DescribesManagerType) {
+#if defined(__linux__) && !defined(__ANDROID_API__) && defined(ENVOY_ENABLE_IO_URING)
+  if (AsyncFileManagerIoUring::isSupported()) {
+    EXPECT_THAT(manager_->describe(), HasSubstr("io_uring_submission_queue_size = 4"));
+    return;
+  }
+#endif
+  EXPECT_THAT(manager_->describe(), HasSubstr("thread_pool_size"));
+}
+
+TEST_F(AsyncFileManagerIoUringTest, WriteReadStatTruncateClose) {
+  auto handle = createAnonymousFile();
+  ASSERT_NE(handle, nullptr);
+
+  // A multi-slice write is submitted as one vectored operation.
+  Buffer::OwnedImpl contents("hello");
+  contents.appendSliceForTest(" world");
+  absl::StatusOr<size_t> write_status;
+  ASSERT_OK(handle->write(dispatcher_.get(), contents, 0, [&](absl::StatusOr<size_t> status) {
+    write_status = std::move(status);
+  }));
+  resolveFileActions();
+  EXPECT_THAT(write_status, IsOkAndHolds(11U));
+
+  absl::StatusOr<Buffer::InstancePtr> read_status;
+  ASSERT_OK(handle->read(dispatcher_.get(), 6, 5, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+    read_status = std::move(status);
+  }));
+  resolveFileActions();
+  ASSERT_OK(read_status);
+  EXPECT_THAT(*read_status.value(), BufferStringEqual("world"));
+
+  // A read past the end of the file returns what there is.
+  ASSERT_OK(
+      handle->read(dispatcher_.get(), 6, 100, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+        read_status = std::move(status);
+      }));
+  resolveFileActions();
+  ASSERT_OK(read_status);
+  EXPECT_THAT(*read_status.value(), BufferStringEqual("world"));
+
+  absl::Status truncate_status = absl::InternalError("not set");
+  ASSERT_OK(handle->truncate(dispatcher_.get(), 5,
+                             [&](absl::Status status) { truncate_status = std::move(status); }));
+  resolveFileActions();
+  EXPECT_OK(truncate_status);
+
+  absl::StatusOr<struct stat> stat_status;
+  ASSERT_OK(handle->stat(dispatcher_.get(), [&](absl::StatusOr<struct stat> status) {
+    stat_status = std::move(status);
+  }));
+  resolveFileActions();
+  ASSERT_OK(stat_status);
+  EXPECT_EQ(5, stat_status.value().st_size);
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, LinkOpenStatUnlink) {
+  auto handle = createAnonymousFile();
+  Buffer::OwnedImpl contents("hello");
+  absl::StatusOr<size_t> write_status;
+  ASSERT_OK(handle->write(dispatcher_.get(), contents, 0, [&](absl::StatusOr<size_t> status) {
+    write_status = std::move(status);
+  }));
+  resolveFileActions();
+  ASSERT_THAT(write_status, IsOkAndHolds(5U));
+
+  std::string filename = absl::StrCat(tmpdir_, "/async_io_uring_link_test");
+  Api::OsSysCallsSingleton::get().unlink(filename.c_str());
+  absl::Status link_status = absl::InternalError("not set");
+  ASSERT_OK(handle->createHardLink(dispatcher_.get(), filename,
+                                   [&](absl::Status status) { link_status = std::move(status); }));
+  resolveFileActions();
+  ASSERT_OK(link_status);
+  close(handle);
+
+  absl::StatusOr<struct stat> stat_status;
+  manager_->stat(dispatcher_.get(), filename,
+                 [&](absl::StatusOr<struct stat> status) { stat_status = std::move(status); });
+  resolveFileActions();
+  ASSERT_OK(stat_status);
+  EXPECT_EQ(5, stat_status.value().st_size);
+
+  absl::StatusOr<AsyncFileHandle> open_status;
+  manager_->openExistingFile(
+      dispatcher_.get(), filename, AsyncFileManager::Mode::ReadOnly,
+      [&](absl::StatusOr<AsyncFileHandle> status) { open_status = std::move(status); });
+  resolveFileActions();
+  ASSERT_OK(open_status);
+  AsyncFileHandle opened = std::move(open_status.value());
+  absl::StatusOr<Buffer::InstancePtr> read_status;
+  ASSERT_OK(opened->read(dispatcher_.get(), 0, 5, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+    read_status = std::move(status);
+  }));
+  resolveFileActions();
+  ASSERT_OK(read_status);
+  EXPECT_THAT(*read_status.value(), BufferStringEqual("hello"));
+  close(opened);
+
+  absl::Status unlink_status = absl::InternalError("not set");
+  manager_->unlink(dispatcher_.get(), filename,
+                   [&](absl::Status status) { unlink_status = std::move(status); });
+  resolveFileActions();
+  EXPECT_OK(unlink_status);
+  manager_->stat(dispatcher_.get(), filename,
+                 [&](absl::StatusOr<struct stat> status) { stat_status = std::move(status); });
+  resolveFileActions();
+  EXPECT_EQ(absl::StatusCode::kNotFound, stat_status.status().code()) << stat_status.status();
+}
+
+TEST_F(AsyncFileManagerIoUringTest, OpenMissingFileFails) {
+  absl::StatusOr<AsyncFileHandle> open_status;
+  manager_->openExistingFile(
+      dispatcher_.get(), "/some/path/that/does/not/exist", AsyncFileManager::Mode::ReadOnly,
+      [&](absl::StatusOr<AsyncFileHandle> status) { open_status = std::move(status); });
+  resolveFileActions();
+  EXPECT_EQ(absl::StatusCode::kNotFound, open_status.status().code()) << open_status.status();
+}
+
+TEST_F(AsyncFileManagerIoUringTest, ManyOperationsBeyondSubmissionQueueSize) {
+  auto handle = createAnonymousFile();
+  // The submission queue holds 4 entries, so the rest wait in the manager until there is room.
+  constexpr int kWrites = 32;
+  int completed = 0;
+  for (int i = 0; i < kWrites; i++) {
+    Buffer::OwnedImpl contents("x");
+    ASSERT_OK(handle->write(dispatcher_.get(), contents, i, [&](absl::StatusOr<size_t> status) {
+      EXPECT_THAT(status, IsOkAndHolds(1U));
+      completed++;
+    }));
+  }
+  resolveFileActions();
+  EXPECT_EQ(kWrites, completed);
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, CancelledOpenClosesFile) {
+  bool called = false;
+  CancelFunction cancel = manager_->createAnonymousFile(
+      dispatcher_.get(), tmpdir_, [&](absl::StatusOr<AsyncFileHandle>) { called = true; });
+  cancel();
+  resolveFileActions();
+  EXPECT_FALSE(called);
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -40,6 +40,14 @@ MockAsyncFileContext::MockAsyncFileContext(std::shared_ptr<MockAsyncFileManager>
                                      std::unique_ptr<MockAsyncFileAction>(
                                          new TypedMockAsyncFileAction(std::move(on_complete))));
           });
+  ON_CALL(*this, readFileBacked(_, _, _, _))
+      .WillByDefault(
+          [this](Event::Dispatcher* dispatcher, off_t, size_t,
+                 absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) {
+            return manager_->enqueue(dispatcher,
+                                     std::unique_ptr<MockAsyncFileAction>(
+                                         new TypedMockAsyncFileAction(std::move(on_complete))));
+          });
   ON_CALL(*this, write(_, _, _, _))
       .WillByDefault([this](Event::Dispatcher* dispatcher, Buffer::Instance&, off_t,
                             absl::AnyInvocable<void(absl::StatusOr<size_t>)> on_complete) {
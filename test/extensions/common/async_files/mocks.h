@@ -36,6 +36,9 @@ public:
   MOCK_METHOD(absl::StatusOr<CancelFunction>, read,
               (Event::Dispatcher * dispatcher, off_t offset, size_t length,
                absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete));
+  MOCK_METHOD(absl::StatusOr<CancelFunction>, readFileBacked,
+              (Event::Dispatcher * dispatcher, off_t offset, size_t length,
+               absl::AnyInvocable<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete));
   MOCK_METHOD(absl::StatusOr<CancelFunction>, write,
               (Event::Dispatcher * dispatcher, Buffer::Instance& contents, off_t offset,
                absl::AnyInvocable<void(absl::StatusOr<size_t>)> on_complete));
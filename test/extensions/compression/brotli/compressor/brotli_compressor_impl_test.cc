@@ -6,6 +6,7 @@
 #include "test/mocks/server/factory_context.h"
 #include "test/test_common/utility.h"
 
+#include "brotli/decode.h"
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -133,6 +134,53 @@ TEST_P(ConfigTest, LoadConfig) {
   verifyWithDecompressor(factory->createCompressor());
 }
 
+// Verifies that a dictionary is shared by the compressors a factory creates, and that their
+// output can only be decompressed with it.
+TEST_F(BrotliCompressorImplTest, CompressWithDictionary) {
+  const std::string dictionary =
+      R"EOF({"id": 1234, "name": "example", "tags": ["alpha", "beta"], "active": true})EOF";
+  envoy::extensions::compression::brotli::compressor::v3::Brotli brotli;
+  brotli.mutable_quality()->set_value(5);
+  brotli.mutable_dictionary()->set_inline_string(dictionary);
+
+  BrotliCompressorLibraryFactory lib_factory;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  Envoy::Compression::Compressor::CompressorFactoryPtr factory =
+      lib_factory.createCompressorFactoryFromProto(brotli, context);
+
+  const std::string original_text = absl::StrCat(dictionary, dictionary);
+  auto compress = [&factory, &original_text]() {
+    Buffer::OwnedImpl buffer(original_text);
+    factory->createCompressor()->compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    return buffer.toString();
+  };
+  const std::string compressed = compress();
+  // A second compressor refers to the same prepared dictionary.
+  EXPECT_EQ(compressed, compress());
+
+  Buffer::OwnedImpl without_dictionary(original_text);
+  BrotliCompressorImpl(5, DefaultWindowBits, DefaultInputBlockBits, false,
+                       BrotliCompressorImpl::EncoderMode::Default, DefaultChunkSize)
+      .compress(without_dictionary, Envoy::Compression::Compressor::State::Finish);
+  EXPECT_LT(compressed.size(), without_dictionary.length());
+
+  std::unique_ptr<BrotliDecoderState, decltype(&BrotliDecoderDestroyInstance)> decoder(
+      BrotliDecoderCreateInstance(nullptr, nullptr, nullptr), &BrotliDecoderDestroyInstance);
+  ASSERT_EQ(BROTLI_TRUE, BrotliDecoderAttachDictionary(
+                             decoder.get(), BROTLI_SHARED_DICTIONARY_RAW, dictionary.size(),
+                             reinterpret_cast<const uint8_t*>(dictionary.data())));
+  std::string decompressed(original_text.size(), '\0');
+  size_t avail_in = compressed.size();
+  const uint8_t* next_in = reinterpret_cast<const uint8_t*>(compressed.data());
+  size_t avail_out = decompressed.size();
+  uint8_t* next_out = reinterpret_cast<uint8_t*>(decompressed.data());
+  EXPECT_EQ(BROTLI_DECODER_RESULT_SUCCESS,
+            BrotliDecoderDecompressStream(decoder.get(), &avail_in, &next_in, &avail_out, &next_out,
+                                          nullptr));
+  EXPECT_EQ(0, avail_out);
+  EXPECT_EQ(original_text, decompressed);
+}
+
 } // namespace
 } // namespace Compressor
 } // namespace Brotli
@@ -1,6 +1,7 @@
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/stats/isolated_store_impl.h"
 #include "source/extensions/compression/brotli/compressor/brotli_compressor_impl.h"
+#include "source/extensions/compression/brotli/compressor/config.h"
 #include "source/extensions/compression/brotli/decompressor/config.h"
 
 #include "test/mocks/server/factory_context.h"
@@ -194,6 +195,42 @@ TEST_F(BrotliDecompressorImplTest, DecompressWithSmallOutputBuffer) {
   EXPECT_EQ(0, stats_store.counterFromString("test.brotli_error").value());
 }
 
+// Exercises a compressor and a decompressor configured with the same dictionary, and verifies
+// that the output cannot be decompressed without it.
+TEST_F(BrotliDecompressorImplTest, CompressAndDecompressWithDictionary) {
+  const std::string dictionary =
+      R"EOF({"id": 1234, "name": "example", "tags": ["alpha", "beta"], "active": true})EOF";
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+
+  envoy::extensions::compression::brotli::compressor::v3::Brotli compressor_config;
+  compressor_config.mutable_dictionary()->set_inline_string(dictionary);
+  Brotli::Compressor::BrotliCompressorLibraryFactory compressor_lib_factory;
+  Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory =
+      compressor_lib_factory.createCompressorFactoryFromProto(compressor_config, context);
+
+  envoy::extensions::compression::brotli::decompressor::v3::Brotli decompressor_config;
+  decompressor_config.mutable_dictionary()->set_inline_string(dictionary);
+  BrotliDecompressorLibraryFactory decompressor_lib_factory;
+  Envoy::Compression::Decompressor::DecompressorFactoryPtr decompressor_factory =
+      decompressor_lib_factory.createDecompressorFactoryFromProto(decompressor_config, context);
+
+  const std::string original_text = absl::StrCat(dictionary, dictionary);
+  Buffer::OwnedImpl compressed(original_text);
+  compressor_factory->createCompressor()->compress(compressed,
+                                                   Envoy::Compression::Compressor::State::Finish);
+
+  Stats::IsolatedStoreImpl stats_store{};
+  Buffer::OwnedImpl output_buffer;
+  decompressor_factory->createDecompressor("test.")->decompress(compressed, output_buffer);
+  EXPECT_EQ(original_text, output_buffer.toString());
+
+  BrotliDecompressorImpl without_dictionary{*stats_store.rootScope(), "test.", 4096, false};
+  Buffer::OwnedImpl wrong_output;
+  without_dictionary.decompress(compressed, wrong_output);
+  EXPECT_NE(original_text, wrong_output.toString());
+  EXPECT_EQ(1, stats_store.counterFromString("test.brotli_error").value());
+}
+
 TEST_F(BrotliDecompressorImplTest, WrongInput) {
   Buffer::OwnedImpl buffer;
   Buffer::OwnedImpl output_buffer;
@@ -3,6 +3,7 @@
 #include "source/extensions/compression/gzip/compressor/config.h"
 #include "source/extensions/compression/gzip/compressor/zlib_compressor_impl.h"
 
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/utility.h"
 
 #include "absl/container/fixed_array.h"
@@ -68,6 +69,8 @@ class ZlibCompressorImplTester : public ZlibCompressorImpl {
 public:
   ZlibCompressorImplTester() = default;
   ZlibCompressorImplTester(uint64_t chunk_size) : ZlibCompressorImpl(chunk_size) {}
+  ZlibCompressorImplTester(uint64_t chunk_size, ZlibContextPoolSharedPtr context_pool)
+      : ZlibCompressorImpl(chunk_size, std::move(context_pool)) {}
   void compressThenFlush(Buffer::OwnedImpl& buffer) {
     compress(buffer, Envoy::Compression::Compressor::State::Flush);
   }
@@ -150,8 +153,9 @@ TEST_P(ZlibCompressorImplFactoryTest, CreateCompressorTest) {
                        strategy, compression_level);
   }
   TestUtility::loadFromJson(json, gzip);
+  NiceMock<ThreadLocal::MockInstance> tls;
   Envoy::Compression::Compressor::CompressorPtr compressor =
-      GzipCompressorFactory(gzip).createCompressor();
+      GzipCompressorFactory(gzip, tls).createCompressor();
   // Check the created compressor produces valid output.
   TestUtility::feedBufferWithRandomCharacters(buffer, 4096);
   compressor->compress(buffer, Envoy::Compression::Compressor::State::Flush);
@@ -159,6 +163,57 @@ TEST_P(ZlibCompressorImplFactoryTest, CreateCompressorTest) {
   drainBuffer(buffer);
 }
 
+// Verifies that a compressor created by a factory with a context pool gives its stream back to the
+// pool, and that the next compressor produces the same output with the reused stream.
+TEST_F(ZlibCompressorImplTest, CreateCompressorWithContextPool) {
+  envoy::extensions::compression::gzip::compressor::v3::Gzip gzip;
+  gzip.set_context_pool_size(1);
+  NiceMock<ThreadLocal::MockInstance> tls;
+  GzipCompressorFactory factory(gzip, tls);
+
+  Buffer::OwnedImpl input;
+  TestUtility::feedBufferWithRandomCharacters(input, 4096);
+  auto compress = [&factory, &input]() {
+    Buffer::OwnedImpl buffer(input.toString());
+    factory.createCompressor()->compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    return buffer.toString();
+  };
+  const std::string first = compress();
+  EXPECT_EQ(first, compress());
+  EXPECT_EQ(first, compress());
+}
+
+TEST_F(ZlibCompressorImplTest, ContextPoolKeepsResetStreams) {
+  auto pool = std::make_shared<ZlibContextPool>(1);
+  Buffer::OwnedImpl input;
+  TestUtility::feedBufferWithRandomCharacters(input, default_input_size);
+  std::string first_output;
+  {
+    ZlibCompressorImplTester first(4096, pool);
+    ZlibCompressorImplTester second(4096, pool);
+    first.init(ZlibCompressorImpl::CompressionLevel::Standard,
+               ZlibCompressorImpl::CompressionStrategy::Standard, gzip_window_bits, memory_level);
+    second.init(ZlibCompressorImpl::CompressionLevel::Standard,
+                ZlibCompressorImpl::CompressionStrategy::Standard, gzip_window_bits, memory_level);
+    Buffer::OwnedImpl buffer(input.toString());
+    first.finish(buffer);
+    first_output = buffer.toString();
+    EXPECT_EQ(0, pool->size());
+  }
+  // Only one of the two streams is kept, since the pool is full after the first.
+  EXPECT_EQ(1, pool->size());
+
+  ZlibCompressorImplTester reused(4096, pool);
+  reused.init(ZlibCompressorImpl::CompressionLevel::Standard,
+              ZlibCompressorImpl::CompressionStrategy::Standard, gzip_window_bits, memory_level);
+  EXPECT_EQ(0, pool->size());
+  EXPECT_EQ(0, reused.checksum());
+  Buffer::OwnedImpl buffer(input.toString());
+  reused.finish(buffer);
+  EXPECT_EQ(first_output, buffer.toString());
+  expectValidFinishedBuffer(buffer, default_input_size);
+}
+
 // Exercises death by passing bad initialization params or by calling
 // compress before init.
 TEST_F(ZlibCompressorImplDeathTest, CompressorDeathTest) {
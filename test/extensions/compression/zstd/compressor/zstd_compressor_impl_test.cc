@@ -105,6 +105,33 @@ TEST_F(ZstdCompressorImplTest, CompressWitHugeBuffer) {
   verifyWithDecompressor(std::move(compressor));
 }
 
+TEST_F(ZstdCompressorImplTest, CompressWithContextPool) {
+  auto pool = std::make_shared<ZstdCCtxPool>(1);
+  verifyWithDecompressor(std::make_unique<ZstdCompressorImpl>(
+      default_compression_level_, default_enable_checksum_, default_strategy_,
+      default_cdict_manager_, 4096, pool));
+  EXPECT_EQ(1, pool->size());
+
+  // The reused context was reset, so it compresses with the new compressor's parameters.
+  auto compressor = std::make_unique<ZstdCompressorImpl>(1, true, default_strategy_,
+                                                         default_cdict_manager_, 4096, pool);
+  EXPECT_EQ(0, pool->size());
+  verifyWithDecompressor(std::move(compressor));
+  EXPECT_EQ(1, pool->size());
+}
+
+TEST_F(ZstdCompressorImplTest, FactoryWithContextPool) {
+  envoy::extensions::compression::zstd::compressor::v3::Zstd zstd;
+  zstd.set_context_pool_size(4);
+  Zstd::Compressor::ZstdCompressorLibraryFactory lib_factory;
+  NiceMock<Server::Configuration::MockFactoryContext> mock_context;
+  Envoy::Compression::Compressor::CompressorFactoryPtr factory =
+      lib_factory.createCompressorFactoryFromProto(zstd, mock_context);
+
+  verifyWithDecompressor(factory->createCompressor());
+  verifyWithDecompressor(factory->createCompressor());
+}
+
 TEST_F(ZstdCompressorImplTest, IllegalConfig) {
   envoy::extensions::compression::zstd::compressor::v3::Zstd zstd;
   Zstd::Compressor::ZstdCompressorLibraryFactory lib_factory;
@@ -22,6 +22,7 @@ TEST(Coverage, LookupStatusToString) {
   EXPECT_EQ(lookupStatusToString(LookupStatus::RequestNotCacheable), "RequestNotCacheable");
   EXPECT_EQ(lookupStatusToString(LookupStatus::RequestIncomplete), "RequestIncomplete");
   EXPECT_EQ(lookupStatusToString(LookupStatus::LookupError), "LookupError");
+  EXPECT_EQ(lookupStatusToString(LookupStatus::CoalescedMiss), "CoalescedMiss");
   EXPECT_ENVOY_BUG(lookupStatusToString(static_cast<LookupStatus>(99)), "Unexpected LookupStatus");
 }
 
@@ -47,6 +48,7 @@ TEST(Coverage, InsertStatusToString) {
   EXPECT_EQ(insertStatusToString(InsertStatus::NoInsertResponseVaryDisallowed),
             "NoInsertResponseVaryDisallowed");
   EXPECT_EQ(insertStatusToString(InsertStatus::NoInsertLookupError), "NoInsertLookupError");
+  EXPECT_EQ(insertStatusToString(InsertStatus::NoInsertCoalesced), "NoInsertCoalesced");
   EXPECT_ENVOY_BUG(insertStatusToString(static_cast<InsertStatus>(99)), "Unexpected InsertStatus");
 }
 
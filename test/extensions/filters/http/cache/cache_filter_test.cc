@@ -1646,6 +1646,165 @@ TEST_F(CacheFilterTest, UpstreamResetMidResponseShouldLocalReply) {
   }
 }
 
+class CacheFilterCoalescingTest : public CacheFilterTest {
+protected:
+  void SetUp() override {
+    CacheFilterTest::SetUp();
+    config_.mutable_request_coalescing();
+    ON_CALL(waiter_callbacks_, dispatcher()).WillByDefault(::testing::ReturnRef(*dispatcher_));
+    ON_CALL(waiter_callbacks_.stream_info_, filterState())
+        .WillByDefault(::testing::ReturnRef(waiter_filter_state_));
+  }
+
+  // Filters for concurrent requests must share the config, which holds the RequestCoalescer.
+  CacheFilterSharedPtr makeCoalescingFilter(Http::StreamDecoderFilterCallbacks& decoder_callbacks) {
+    if (coalescing_config_ == nullptr) {
+      coalescing_config_ =
+          std::make_shared<CacheFilterConfig>(config_, context_.server_factory_context_);
+    }
+    std::shared_ptr<CacheFilter> filter(new CacheFilter(coalescing_config_, simple_cache_),
+                                        [](CacheFilter* f) {
+                                          f->onDestroy();
+                                          delete f;
+                                        });
+    filter->setDecoderFilterCallbacks(decoder_callbacks);
+    filter->setEncoderFilterCallbacks(encoder_callbacks_);
+    return filter;
+  }
+
+  // Starts the request that misses the cache first, and so sends the upstream request.
+  CacheFilterSharedPtr startFiller() {
+    CacheFilterSharedPtr filler = makeCoalescingFilter(decoder_callbacks_);
+    testDecodeRequestMiss(0, filler);
+    return filler;
+  }
+
+  // Starts a request that misses the cache while the filler's request is in flight.
+  CacheFilterSharedPtr startWaiter() {
+    CacheFilterSharedPtr waiter = makeCoalescingFilter(waiter_callbacks_);
+    EXPECT_EQ(waiter->decodeHeaders(waiter_request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+    pumpDispatcher();
+    // The waiter does not send its own upstream request.
+    EXPECT_EQ(mock_upstreams_.size(), 1);
+    return waiter;
+  }
+
+  void expectWaiterSentUpstream() {
+    ASSERT_EQ(mock_upstreams_.size(), 2);
+    EXPECT_THAT(mock_upstreams_headers_sent_[1], testing::Optional(waiter_request_headers_));
+  }
+
+  absl::StatusOr<LookupStatus> waiterLookupStatus() {
+    if (!waiter_filter_state_->hasData<CacheFilterLoggingInfo>(
+            CacheFilterLoggingInfo::FilterStateKey)) {
+      return absl::NotFoundError("cacheFilterLoggingInfo not found");
+    }
+    return waiter_filter_state_
+        ->getDataReadOnly<CacheFilterLoggingInfo>(CacheFilterLoggingInfo::FilterStateKey)
+        ->lookupStatus();
+  }
+
+  std::shared_ptr<const CacheFilterConfig> coalescing_config_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> waiter_callbacks_;
+  std::shared_ptr<StreamInfo::FilterState> waiter_filter_state_ =
+      std::make_shared<StreamInfo::FilterStateImpl>(StreamInfo::FilterState::LifeSpan::FilterChain);
+  Http::TestRequestHeaderMapImpl waiter_request_headers_{
+      {":path", "/"}, {":method", "GET"}, {":scheme", "https"}};
+};
+
+TEST_F(CacheFilterCoalescingTest, WaiterIsServedFillersResponse) {
+  CacheFilterSharedPtr filler = startFiller();
+  CacheFilterSharedPtr waiter = startWaiter();
+
+  receiveUpstreamHeaders(0, response_headers_, false);
+  EXPECT_CALL(waiter_callbacks_, encodeHeaders_(IsSupersetOfHeaders(response_headers_), false));
+  pumpDispatcher();
+
+  EXPECT_CALL(waiter_callbacks_,
+              encodeData(testing::Property(&Buffer::Instance::toString, testing::Eq("abc")), true));
+  receiveUpstreamBody(0, "abc", true);
+  pumpDispatcher();
+
+  waiter->onStreamComplete();
+  EXPECT_THAT(waiterLookupStatus(), IsOkAndHolds(LookupStatus::CoalescedMiss));
+  EXPECT_EQ(mock_upstreams_.size(), 1);
+}
+
+TEST_F(CacheFilterCoalescingTest, WaiterTimesOutAndSendsOwnRequest) {
+  CacheFilterSharedPtr filler = startFiller();
+  CacheFilterSharedPtr waiter = startWaiter();
+
+  // The default timeout is 5 seconds.
+  time_source_.advanceTimeWait(std::chrono::seconds(5));
+  pumpDispatcher();
+  expectWaiterSentUpstream();
+
+  // The filler's response no longer concerns the waiter.
+  EXPECT_CALL(waiter_callbacks_, encodeHeaders_).Times(0);
+  receiveUpstreamHeaders(0, response_headers_, true);
+  pumpDispatcher();
+}
+
+TEST_F(CacheFilterCoalescingTest, WaiterForDifferentVariantSendsOwnRequest) {
+  config_.add_allowed_vary_headers()->set_exact("accept");
+  request_headers_.setCopy(Http::LowerCaseString("accept"), "text/html");
+  waiter_request_headers_.setCopy(Http::LowerCaseString("accept"), "image/*");
+  response_headers_.setCopy(Http::LowerCaseString("vary"), "accept");
+  CacheFilterSharedPtr filler = startFiller();
+  CacheFilterSharedPtr waiter = startWaiter();
+
+  EXPECT_CALL(waiter_callbacks_, encodeHeaders_).Times(0);
+  receiveUpstreamHeaders(0, response_headers_, true);
+  pumpDispatcher();
+  expectWaiterSentUpstream();
+}
+
+TEST_F(CacheFilterCoalescingTest, WaiterSendsOwnRequestIfResponseIsNotCacheable) {
+  CacheFilterSharedPtr filler = startFiller();
+  CacheFilterSharedPtr waiter = startWaiter();
+
+  response_headers_.setCopy(Http::CustomHeaders::get().CacheControl, "no-store");
+  EXPECT_CALL(waiter_callbacks_, encodeHeaders_).Times(0);
+  receiveUpstreamHeaders(0, response_headers_, true);
+  pumpDispatcher();
+  expectWaiterSentUpstream();
+}
+
+TEST_F(CacheFilterCoalescingTest, FillerResetAfterHeadersResetsWaiter) {
+  CacheFilterSharedPtr filler = startFiller();
+  CacheFilterSharedPtr waiter = startWaiter();
+
+  receiveUpstreamHeaders(0, response_headers_, false);
+  EXPECT_CALL(waiter_callbacks_, encodeHeaders_(_, false));
+  pumpDispatcher();
+
+  // Part of the response has been sent to the waiter, so it cannot be retried.
+  EXPECT_CALL(decoder_callbacks_,
+              sendLocalReply(Http::Code::ServiceUnavailable, _, _, _, "cache_upstream_reset"));
+  EXPECT_CALL(waiter_callbacks_, resetStream(_, _));
+  mock_upstreams_callbacks_[0].get().onReset();
+  pumpDispatcher();
+  EXPECT_EQ(mock_upstreams_.size(), 1);
+}
+
+TEST_F(CacheFilterCoalescingTest, LocalReplyWhileWaitingStopsWaiting) {
+  CacheFilterSharedPtr filler = startFiller();
+  CacheFilterSharedPtr waiter = startWaiter();
+
+  Http::TestResponseHeaderMapImpl local_response_headers{{":status", "503"}};
+  EXPECT_EQ(waiter->encodeHeaders(local_response_headers, true),
+            Http::FilterHeadersStatus::Continue);
+
+  EXPECT_CALL(waiter_callbacks_, encodeHeaders_).Times(0);
+  receiveUpstreamHeaders(0, response_headers_, true);
+  pumpDispatcher();
+  // Nor does the timeout fire.
+  time_source_.advanceTimeWait(std::chrono::seconds(5));
+  pumpDispatcher();
+  EXPECT_EQ(mock_upstreams_.size(), 1);
+}
+
 } // namespace
 } // namespace Cache
 } // namespace HttpFilters
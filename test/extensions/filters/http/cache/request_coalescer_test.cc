@@ -0,0 +1,214 @@
+#include <memory>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/http/cache/request_coalescer.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/server_factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+using testing::NiceMock;
+
+class CountingWatcher : public CoalescedResponseWatcher {
+public:
+  void onCoalescedResponseProgress() override { ++notifications_; }
+  int notifications_ = 0;
+};
+
+class RequestCoalescerTest : public testing::Test {
+protected:
+  RequestCoalescerTest() { key_.set_host("example.com"); }
+
+  // Registers a watcher that reads the response when asked to, rather than when notified.
+  std::shared_ptr<CountingWatcher> watch(CoalescedResponse& response) {
+    auto watcher = std::make_shared<CountingWatcher>();
+    response.addWatcher(dispatcher_, watcher);
+    return watcher;
+  }
+
+  std::shared_ptr<RequestCoalescer> coalescer_ =
+      std::make_shared<RequestCoalescer>(std::chrono::milliseconds(100), 5);
+  Key key_;
+  Http::TestRequestHeaderMapImpl request_headers_{
+      {":path", "/"}, {":method", "GET"}, {":authority", "example.com"}, {"accept", "text/html"}};
+  Http::TestResponseHeaderMapImpl response_headers_{{":status", "200"}};
+  NiceMock<Event::MockDispatcher> dispatcher_;
+};
+
+TEST_F(RequestCoalescerTest, FirstRequestFills) {
+  auto [filling, is_filler] = coalescer_->getOrCreate(key_, request_headers_);
+  EXPECT_TRUE(is_filler);
+  auto [awaited, is_waiter_filler] = coalescer_->getOrCreate(key_, request_headers_);
+  EXPECT_FALSE(is_waiter_filler);
+  EXPECT_EQ(filling, awaited);
+
+  Key other_key = key_;
+  other_key.set_path("/other");
+  EXPECT_TRUE(coalescer_->getOrCreate(other_key, request_headers_).second);
+}
+
+TEST_F(RequestCoalescerTest, StopsTrackingDestroyedResponse) {
+  coalescer_->getOrCreate(key_, request_headers_);
+  // The returned response was dropped immediately, so the next request fills a new one.
+  EXPECT_TRUE(coalescer_->getOrCreate(key_, request_headers_).second);
+}
+
+TEST_F(RequestCoalescerTest, StopsTrackingAbortedResponse) {
+  CoalescedResponseSharedPtr filling = coalescer_->getOrCreate(key_, request_headers_).first;
+  CoalescedResponseSharedPtr awaited = coalescer_->getOrCreate(key_, request_headers_).first;
+  auto watcher = watch(*awaited);
+  filling->abort();
+
+  CoalescedResponse::Update update = awaited->read(*watcher);
+  EXPECT_TRUE(update.aborted_);
+  EXPECT_EQ(update.headers_, nullptr);
+  auto [next, is_filler] = coalescer_->getOrCreate(key_, request_headers_);
+  EXPECT_TRUE(is_filler);
+  EXPECT_NE(next, awaited);
+}
+
+TEST_F(RequestCoalescerTest, AbortAfterCompleteIsIgnored) {
+  CoalescedResponseSharedPtr response = coalescer_->getOrCreate(key_, request_headers_).first;
+  auto watcher = watch(*response);
+  response->setHeaders(response_headers_, true);
+  response->abort();
+
+  CoalescedResponse::Update update = response->read(*watcher);
+  EXPECT_FALSE(update.aborted_);
+  EXPECT_TRUE(update.end_stream_);
+  EXPECT_THAT(update.headers_.get(), HeaderMapEqualIgnoreOrder(&response_headers_));
+}
+
+TEST_F(RequestCoalescerTest, ReadsOnlyWhatIsNew) {
+  CoalescedResponseSharedPtr response = coalescer_->getOrCreate(key_, request_headers_).first;
+  auto watcher = watch(*response);
+  CoalescedResponse::Update update = response->read(*watcher);
+  EXPECT_EQ(update.headers_, nullptr);
+  EXPECT_FALSE(update.end_stream_);
+
+  response->setHeaders(response_headers_, false);
+  Buffer::OwnedImpl first("abc");
+  response->addBody(first, false);
+  auto late_watcher = watch(*response);
+  update = response->read(*watcher);
+  EXPECT_THAT(update.headers_.get(), HeaderMapEqualIgnoreOrder(&response_headers_));
+  ASSERT_NE(update.body_, nullptr);
+  EXPECT_EQ(update.body_->toString(), "abc");
+  EXPECT_FALSE(update.end_stream_);
+
+  Buffer::OwnedImpl second("def");
+  response->addBody(second, false);
+  Http::TestResponseTrailerMapImpl trailers{{"grpc-status", "0"}};
+  response->setTrailers(trailers);
+  update = response->read(*watcher);
+  EXPECT_EQ(update.headers_, nullptr);
+  ASSERT_NE(update.body_, nullptr);
+  EXPECT_EQ(update.body_->toString(), "def");
+  EXPECT_THAT(update.trailers_.get(), HeaderMapEqualIgnoreOrder(&trailers));
+  EXPECT_TRUE(update.end_stream_);
+
+  // A waiter that starts reading late gets the whole response.
+  update = response->read(*late_watcher);
+  ASSERT_NE(update.body_, nullptr);
+  EXPECT_EQ(update.body_->toString(), "abcdef");
+  EXPECT_NE(update.trailers_, nullptr);
+
+  // Waiters that have read the whole response are unregistered.
+  update = response->read(*watcher);
+  EXPECT_EQ(update.headers_, nullptr);
+  EXPECT_FALSE(update.end_stream_);
+}
+
+TEST_F(RequestCoalescerTest, BodyWithoutWaitersIsNotRetained) {
+  CoalescedResponseSharedPtr response = coalescer_->getOrCreate(key_, request_headers_).first;
+  response->setHeaders(response_headers_, false);
+  Buffer::OwnedImpl body("abc");
+  response->addBody(body, false);
+  // The start of the body is gone, so new misses no longer wait for this response.
+  EXPECT_TRUE(coalescer_->getOrCreate(key_, request_headers_).second);
+
+  // Nor can a waiter that got hold of it before then be served.
+  auto watcher = watch(*response);
+  EXPECT_TRUE(response->read(*watcher).aborted_);
+}
+
+TEST_F(RequestCoalescerTest, StopsJoiningPastRetainedBodyLimit) {
+  CoalescedResponseSharedPtr response = coalescer_->getOrCreate(key_, request_headers_).first;
+  auto first = watch(*response);
+  auto second = watch(*response);
+  response->setHeaders(response_headers_, false);
+  Buffer::OwnedImpl chunk("abc");
+  response->addBody(chunk, false);
+  EXPECT_FALSE(coalescer_->getOrCreate(key_, request_headers_).second);
+
+  // The limit is 5 bytes.
+  Buffer::OwnedImpl over_limit("def");
+  response->addBody(over_limit, false);
+  auto [next, is_filler] = coalescer_->getOrCreate(key_, request_headers_);
+  EXPECT_TRUE(is_filler);
+  EXPECT_NE(next, response);
+
+  // The waiters that already joined still get the whole response, including chunks that arrive
+  // after the other waiter gave up.
+  EXPECT_EQ(response->read(*first).body_->toString(), "abcdef");
+  response->removeWatcher(*second);
+  Buffer::OwnedImpl last("ghi");
+  response->addBody(last, true);
+  CoalescedResponse::Update update = response->read(*first);
+  EXPECT_EQ(update.body_->toString(), "ghi");
+  EXPECT_TRUE(update.end_stream_);
+}
+
+TEST_F(RequestCoalescerTest, NotifiesWatchers) {
+  CoalescedResponseSharedPtr response = coalescer_->getOrCreate(key_, request_headers_).first;
+  auto watcher = std::make_shared<CountingWatcher>();
+  response->addWatcher(dispatcher_, watcher);
+  EXPECT_EQ(watcher->notifications_, 0);
+
+  response->setHeaders(response_headers_, false);
+  EXPECT_EQ(watcher->notifications_, 1);
+
+  // Watchers added after the headers arrived are notified straight away.
+  auto late_watcher = std::make_shared<CountingWatcher>();
+  response->addWatcher(dispatcher_, late_watcher);
+  EXPECT_EQ(late_watcher->notifications_, 1);
+
+  // Destroyed watchers are skipped.
+  late_watcher.reset();
+  Buffer::OwnedImpl body("abc");
+  response->addBody(body, true);
+  EXPECT_EQ(watcher->notifications_, 2);
+}
+
+TEST_F(RequestCoalescerTest, SameVariant) {
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher> allow_list;
+  allow_list.Add()->set_exact("accept");
+  VaryAllowList vary_allow_list(allow_list, factory_context);
+  CoalescedResponseSharedPtr response = coalescer_->getOrCreate(key_, request_headers_).first;
+
+  Http::TestRequestHeaderMapImpl other_request_headers = request_headers_;
+  other_request_headers.setCopy(Http::LowerCaseString("accept"), "image/*");
+  EXPECT_TRUE(response->sameVariant(vary_allow_list, other_request_headers, response_headers_));
+
+  Http::TestResponseHeaderMapImpl varying_headers{{":status", "200"}, {"vary", "accept"}};
+  EXPECT_TRUE(response->sameVariant(vary_allow_list, request_headers_, varying_headers));
+  EXPECT_FALSE(response->sameVariant(vary_allow_list, other_request_headers, varying_headers));
+
+  Http::TestResponseHeaderMapImpl disallowed_headers{{":status", "200"}, {"vary", "cookie"}};
+  EXPECT_FALSE(response->sameVariant(vary_allow_list, request_headers_, disallowed_headers));
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -26,13 +26,17 @@ public:
   MockGzipCompressorFactory(
       Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionLevel level,
       Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionStrategy strategy,
-      int64_t window_bits, uint64_t memory_level)
+      int64_t window_bits, uint64_t memory_level, uint32_t context_pool_size = 0)
       : level_(level), strategy_(strategy), window_bits_(window_bits), memory_level_(memory_level) {
+    if (context_pool_size > 0) {
+      context_pool_ =
+          std::make_shared<Compression::Gzip::Compressor::ZlibContextPool>(context_pool_size);
+    }
   }
 
   Envoy::Compression::Compressor::CompressorPtr createCompressor() override {
     auto compressor = std::make_unique<Compression::Gzip::Compressor::ZlibCompressorImpl>(
-        Compression::Gzip::Compressor::DefaultChunkSize);
+        Compression::Gzip::Compressor::DefaultChunkSize, context_pool_);
     compressor->init(level_, strategy_, window_bits_, memory_level_);
     return compressor;
   }
@@ -47,16 +51,22 @@ private:
   const Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionStrategy strategy_;
   const int64_t window_bits_;
   const uint64_t memory_level_;
+  Compression::Gzip::Compressor::ZlibContextPoolSharedPtr context_pool_;
 };
 
 class MockZstdCompressorFactory : public Envoy::Compression::Compressor::CompressorFactory {
 public:
-  MockZstdCompressorFactory(uint32_t level, uint32_t strategy)
-      : level_(level), strategy_(strategy) {}
+  MockZstdCompressorFactory(uint32_t level, uint32_t strategy, uint32_t context_pool_size = 0)
+      : level_(level), strategy_(strategy) {
+    if (context_pool_size > 0) {
+      context_pool_ =
+          std::make_shared<Compression::Zstd::Compressor::ZstdCCtxPool>(context_pool_size);
+    }
+  }
 
   Envoy::Compression::Compressor::CompressorPtr createCompressor() override {
     return std::make_unique<Compression::Zstd::Compressor::ZstdCompressorImpl>(
-        level_, enable_checksum_, strategy_, cdict_manager_, chunk_size_);
+        level_, enable_checksum_, strategy_, cdict_manager_, chunk_size_, context_pool_);
   }
 
   const std::string& statsPrefix() const override { CONSTRUCT_ON_FIRST_USE(std::string, "zstd."); }
@@ -70,17 +80,21 @@ private:
   const bool enable_checksum_{};
   Compression::Zstd::Compressor::ZstdCDictManagerPtr cdict_manager_{nullptr};
   const uint64_t chunk_size_{4096};
+  Compression::Zstd::Compressor::ZstdCCtxPoolSharedPtr context_pool_;
 };
 
 class MockBrotliCompressorFactory : public Envoy::Compression::Compressor::CompressorFactory {
 public:
-  explicit MockBrotliCompressorFactory(uint32_t quality) : quality_(quality) {}
+  explicit MockBrotliCompressorFactory(
+      uint32_t quality,
+      Compression::Brotli::Compressor::BrotliCompressorDictionarySharedPtr dictionary = nullptr)
+      : quality_(quality), dictionary_(std::move(dictionary)) {}
 
   Envoy::Compression::Compressor::CompressorPtr createCompressor() override {
     return std::make_unique<Compression::Brotli::Compressor::BrotliCompressorImpl>(
         quality_, Compression::Brotli::Compressor::DefaultWindowBits,
         Compression::Brotli::Compressor::DefaultInputBlockBits, disable_literal_context_modeling_,
-        mode_, Compression::Brotli::Compressor::DefaultChunkSize);
+        mode_, Compression::Brotli::Compressor::DefaultChunkSize, dictionary_);
   }
 
   const std::string& statsPrefix() const override {
@@ -95,6 +109,7 @@ private:
       Compression::Brotli::Compressor::BrotliCompressorImpl::EncoderMode::Generic};
   const uint32_t quality_;
   const bool disable_literal_context_modeling_{false};
+  const Compression::Brotli::Compressor::BrotliCompressorDictionarySharedPtr dictionary_;
 };
 
 struct CompressionParams {
@@ -703,6 +718,112 @@ BENCHMARK(compressChunks1024WithBrotli)
     ->UseManualTime()
     ->Unit(benchmark::kMillisecond);
 
+// Compresses many small responses, each in its own stream, through one filter config, the way a
+// worker serves them. This is where the per-stream setup of a compressor shows.
+static constexpr uint64_t SmallResponseCount = 100;
+static constexpr uint64_t SmallResponseSize = 1024;
+// The dictionary is cut from the test data that the small responses are cut from, as a stand-in
+// for responses sharing content, e.g. JSON keys, with a pre-trained dictionary.
+static constexpr uint64_t DictionarySize = 16384;
+
+static void
+compressSmallResponses(Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory,
+                       const std::string& encoding, benchmark::State& state) {
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  Stats::IsolatedStoreImpl stats;
+  testing::NiceMock<Runtime::MockLoader> runtime;
+  ON_CALL(runtime.snapshot_, featureEnabled("test.filter_enabled", 100))
+      .WillByDefault(Return(true));
+  envoy::extensions::filters::http::compressor::v3::Compressor compressor;
+  CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
+      compressor, "test.", *stats.rootScope(), runtime, std::move(compressor_factory));
+
+  std::vector<std::string> responses;
+  responses.reserve(SmallResponseCount);
+  for (uint64_t i = 0; i < SmallResponseCount; ++i) {
+    const uint64_t offset = (i * SmallResponseSize) % (DictionarySize - SmallResponseSize);
+    responses.push_back(testData().toString().substr(offset, SmallResponseSize));
+  }
+
+  uint64_t total_compressed_bytes = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const std::string& response : responses) {
+      auto filter = std::make_unique<CompressorFilter>(config);
+      filter->setDecoderFilterCallbacks(decoder_callbacks);
+      Http::TestRequestHeaderMapImpl headers = {{":method", "get"}, {"accept-encoding", encoding}};
+      filter->decodeHeaders(headers, false);
+      Http::TestResponseHeaderMapImpl response_headers = {
+          {":method", "get"},
+          {"content-length", absl::StrCat(SmallResponseSize)},
+          {"content-type", "application/json;charset=utf-8"}};
+      filter->encodeHeaders(response_headers, false);
+      Buffer::OwnedImpl data(response);
+      filter->encodeData(data, true);
+      total_compressed_bytes += data.length();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+    state.SetIterationTime(elapsed.count());
+  }
+  state.counters["compression_ratio"] =
+      static_cast<double>(SmallResponseCount * SmallResponseSize * state.iterations()) /
+      total_compressed_bytes;
+}
+
+// The argument is the size of the per-worker pool of compression contexts, where 0 disables it.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void compressSmallResponsesWithGzip(benchmark::State& state) {
+  const auto& params = gzip_compression_params[4];
+  compressSmallResponses(
+      std::make_unique<MockGzipCompressorFactory>(
+          static_cast<Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionLevel>(
+              params.level),
+          static_cast<Compression::Gzip::Compressor::ZlibCompressorImpl::CompressionStrategy>(
+              params.strategy),
+          params.window_bits, params.memory_level, state.range(0)),
+      "gzip", state);
+}
+BENCHMARK(compressSmallResponsesWithGzip)
+    ->Arg(0)
+    ->Arg(16)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+// The argument is the size of the per-worker pool of compression contexts, where 0 disables it.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void compressSmallResponsesWithZstd(benchmark::State& state) {
+  const auto& params = zstd_compression_params[2];
+  compressSmallResponses(
+      std::make_unique<MockZstdCompressorFactory>(params.level, params.strategy, state.range(0)),
+      "zstd", state);
+}
+BENCHMARK(compressSmallResponsesWithZstd)
+    ->Arg(0)
+    ->Arg(16)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+// The argument is 1 to compress with a dictionary shared by all the streams, 0 without.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void compressSmallResponsesWithBrotliDictionary(benchmark::State& state) {
+  const uint32_t quality = brotli_compression_params[4].level;
+  Compression::Brotli::Compressor::BrotliCompressorDictionarySharedPtr dictionary;
+  if (state.range(0) != 0) {
+    dictionary = Compression::Brotli::Compressor::BrotliCompressorDictionary::create(
+                     testData().toString().substr(0, DictionarySize), quality)
+                     .value();
+  }
+  compressSmallResponses(std::make_unique<MockBrotliCompressorFactory>(quality, dictionary), "br",
+                         state);
+}
+BENCHMARK(compressSmallResponsesWithBrotliDictionary)
+    ->Arg(0)
+    ->Arg(1)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
 } // namespace Compressor
 } // namespace HttpFilters
 } // namespace Extensions
@@ -785,6 +785,95 @@ matcher:
   EXPECT_EQ(output_.front(), "fake_cluster 0 5 0 0 1");
 }
 
+// Verify that upstream datagrams are written in batches when configured.
+TEST_F(UdpProxyFilterTest, BatchedUpstreamWrites) {
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+upstream_write_batch_size: 2
+  )EOF"));
+
+  expectSessionCreate(upstream_address_);
+  TestSession& session = test_sessions_[0];
+  auto* flush_cb =
+      new NiceMock<Event::MockSchedulableCallback>(&callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*session.idle_timer_, enableTimer(config_->sessionTimeout(), nullptr)).Times(5);
+  EXPECT_CALL(*session.socket_->io_handle_, connect(_))
+      .WillOnce(Return(Api::SysCallIntResult{0, 0}));
+
+  // The first datagram is held until the end of the event loop iteration.
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+
+  // A full batch is written right away.
+  EXPECT_CALL(*session.socket_->io_handle_, sendmmsg(_, 2, 0, nullptr, _))
+      .WillOnce(Invoke([this](const Buffer::RawSlice* datagrams, uint64_t, int,
+                              const Network::Address::Ip*,
+                              const Network::Address::Instance& peer_address)
+                           -> Api::IoCallUint64Result {
+        EXPECT_EQ("hello", absl::string_view(static_cast<const char*>(datagrams[0].mem_),
+                                             datagrams[0].len_));
+        EXPECT_EQ("hello2", absl::string_view(static_cast<const char*>(datagrams[1].mem_),
+                                              datagrams[1].len_));
+        EXPECT_EQ(peer_address, *upstream_address_);
+        return makeNoError(2);
+      }));
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello2");
+  EXPECT_FALSE(flush_cb->enabled());
+  EXPECT_EQ(2, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_datagrams")
+                   ->value());
+  EXPECT_EQ(11, factory_context_.server_factory_context_.cluster_manager_.thread_local_cluster_
+                    .cluster_.info_->traffic_stats_->upstream_cx_tx_bytes_total_.value());
+
+  // A partial batch is written by the scheduled callback. Like single writes, datagrams that can't
+  // be written are dropped.
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello3");
+  EXPECT_CALL(*session.socket_->io_handle_, sendmmsg(_, 1, 0, nullptr, _))
+      .WillOnce(Invoke([](const Buffer::RawSlice*, uint64_t, int, const Network::Address::Ip*,
+                          const Network::Address::Instance&) -> Api::IoCallUint64Result {
+        return makeError(SOCKET_ERROR_AGAIN);
+      }));
+  flush_cb->invokeCallback();
+  EXPECT_EQ(1, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_errors")
+                   ->value());
+
+  // A datagram that is rejected, e.g. for being larger than the path MTU, is dropped on its own
+  // rather than with the rest of the batch.
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "toolarge");
+  EXPECT_CALL(*session.socket_->io_handle_, sendmmsg(_, 2, 0, nullptr, _))
+      .WillOnce(Return(ByMove(makeError(SOCKET_ERROR_MSG_SIZE))));
+  EXPECT_CALL(*session.socket_->io_handle_, sendmmsg(_, 1, 0, nullptr, _))
+      .WillOnce(Invoke([](const Buffer::RawSlice* datagrams, uint64_t, int,
+                          const Network::Address::Ip*,
+                          const Network::Address::Instance&) -> Api::IoCallUint64Result {
+        EXPECT_EQ("hello5", absl::string_view(static_cast<const char*>(datagrams[0].mem_),
+                                              datagrams[0].len_));
+        return makeNoError(1);
+      }));
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello5");
+  EXPECT_EQ(2, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_errors")
+                   ->value());
+  EXPECT_EQ(3, TestUtility::findCounter(factory_context_.server_factory_context_.cluster_manager_
+                                            .thread_local_cluster_.cluster_.info_->stats_store_,
+                                        "udp.sess_tx_datagrams")
+                   ->value());
+  checkTransferStats(30 /*rx_bytes*/, 5 /*rx_datagrams*/, 0 /*tx_bytes*/, 0 /*tx_datagrams*/);
+}
+
 // No upstream host handling.
 TEST_F(UdpProxyFilterTest, NoUpstreamHost) {
   InSequence s;
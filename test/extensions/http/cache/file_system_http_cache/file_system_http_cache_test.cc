@@ -720,6 +720,56 @@ TEST_F(FileSystemHttpCacheTestWithMockFiles, ReadWithMultipleBlocksWorksCorrectl
   pumpDispatcher();
 }
 
+TEST_F(FileSystemHttpCacheTestWithMockFiles, ServeBodyFromFileReadsLargeChunksFileBacked) {
+  ConfigProto cfg = testConfig();
+  cfg.set_serve_body_from_file(true);
+  cache_.reset();
+  cache_ = std::dynamic_pointer_cast<FileSystemHttpCache>(
+      http_cache_factory_->getCache(cacheConfig(cfg), context_));
+  trailers_size_ = 0;
+  const size_t large_chunk = FileSystemHttpCache::min_file_backed_body_chunk_size_;
+  auto lookup = testLookupContext();
+  LookupResult result;
+  EXPECT_CALL(*mock_async_file_manager_, openExistingFile(_, _, _, _));
+  EXPECT_CALL(*mock_async_file_handle_, read(_, 0, CacheFileFixedBlock::size(), _));
+  EXPECT_CALL(*mock_async_file_handle_,
+              read(_, CacheFileFixedBlock::offsetToHeaders(), headers_size_, _));
+  lookup->getHeaders([&](LookupResult&& r, bool) { result = std::move(r); });
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<AsyncFileHandle>(mock_async_file_handle_));
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<Buffer::InstancePtr>(testHeaderBlock(large_chunk + 4)));
+  pumpDispatcher();
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<Buffer::InstancePtr>(testHeaderBuffer()));
+  pumpDispatcher();
+  EXPECT_CALL(*mock_async_file_handle_,
+              readFileBacked(_, CacheFileFixedBlock::offsetToHeaders() + headers_size_,
+                             large_chunk, _));
+  lookup->getBody(AdjustedByteRange(0, large_chunk), [&](Buffer::InstancePtr body, bool) {
+    EXPECT_EQ(large_chunk, body->length());
+  });
+  mock_async_file_manager_->nextActionCompletes(absl::StatusOr<Buffer::InstancePtr>(
+      std::make_unique<Buffer::OwnedImpl>(std::string(large_chunk, 'x'))));
+  pumpDispatcher();
+  // Small chunks are still read into memory.
+  EXPECT_CALL(*mock_async_file_handle_,
+              read(_, CacheFileFixedBlock::offsetToHeaders() + headers_size_ + large_chunk, 4, _));
+  lookup->getBody(AdjustedByteRange(large_chunk, large_chunk + 4),
+                  [&](Buffer::InstancePtr body, bool end_stream) {
+                    EXPECT_EQ(body->toString(), "boop");
+                    EXPECT_TRUE(end_stream);
+                  });
+  mock_async_file_manager_->nextActionCompletes(
+      absl::StatusOr<Buffer::InstancePtr>(std::make_unique<Buffer::OwnedImpl>("boop")));
+  pumpDispatcher();
+  lookup->onDestroy();
+  lookup.reset();
+  mock_async_file_manager_->nextActionCompletes(absl::OkStatus());
+  pumpDispatcher();
+}
+
 TEST_F(FileSystemHttpCacheTestWithMockFiles, DestroyingALookupWithFileActionInFlightCancelsAction) {
   auto lookup = testLookupContext();
   absl::Cleanup destroy_lookup([&lookup]() { lookup->onDestroy(); });
@@ -0,0 +1,66 @@
+#include "source/extensions/http/cache/memory_http_cache/frequency_sketch.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+namespace {
+
+TEST(FrequencySketchTest, UnseenKeyHasZeroFrequency) {
+  FrequencySketch sketch(1024);
+  EXPECT_EQ(0, sketch.frequency(12345));
+}
+
+TEST(FrequencySketchTest, CountsIncrements) {
+  FrequencySketch sketch(1024);
+  for (uint32_t i = 0; i < 5; ++i) {
+    sketch.increment(12345);
+  }
+  // A count-min sketch never underestimates.
+  EXPECT_GE(sketch.frequency(12345), 5);
+  EXPECT_LT(sketch.frequency(67890), 5);
+}
+
+TEST(FrequencySketchTest, SaturatesAtMaxFrequency) {
+  FrequencySketch sketch(1024);
+  for (uint32_t i = 0; i < 100; ++i) {
+    sketch.increment(12345);
+  }
+  EXPECT_EQ(FrequencySketch::MaxFrequency, sketch.frequency(12345));
+}
+
+TEST(FrequencySketchTest, HalvesOnceSampleIsFull) {
+  // The smallest sketch has 16 words, so it is halved after 160 increments.
+  FrequencySketch sketch(16);
+  for (uint32_t i = 0; i < 8; ++i) {
+    sketch.increment(12345);
+  }
+  const uint32_t before = sketch.frequency(12345);
+  ASSERT_GE(before, 8);
+  // Spread the remaining increments over many keys, so that each one increments a counter.
+  for (uint64_t hash = 0; hash < 152; ++hash) {
+    sketch.increment(hash * 0x9e3779b97f4a7c15ULL);
+  }
+  EXPECT_LT(sketch.frequency(12345), before);
+}
+
+TEST(FrequencySketchTest, DistinguishesPopularKeys) {
+  FrequencySketch sketch(1024);
+  for (uint64_t hash = 0; hash < 512; ++hash) {
+    sketch.increment(hash * 0x9e3779b97f4a7c15ULL);
+  }
+  for (uint32_t i = 0; i < 4; ++i) {
+    sketch.increment(12345);
+  }
+  EXPECT_GT(sketch.frequency(12345), sketch.frequency(7 * 0x9e3779b97f4a7c15ULL));
+}
+
+} // namespace
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
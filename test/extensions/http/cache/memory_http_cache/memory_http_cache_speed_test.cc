@@ -0,0 +1,118 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "source/common/http/header_map_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/http/cache/memory_http_cache/memory_http_cache.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/server/server_factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+namespace {
+
+// State shared by the threads of a benchmark run. It is created and destroyed by the first
+// thread, outside of the timed loop, which all threads enter and leave together.
+class CacheBenchmarkState {
+public:
+  CacheBenchmarkState(uint32_t shards, uint32_t num_paths) {
+    ConfigProto config;
+    config.set_name("benchmark");
+    // Room for about half of the paths, so that the workload keeps evicting.
+    config.set_max_cache_size_bytes(uint64_t{num_paths} / 2 * (BodySize + 200));
+    config.mutable_shards()->set_value(shards);
+    cache_ = std::make_unique<MemoryHttpCache>(nullptr, config, *store_.rootScope());
+
+    requests_.reserve(num_paths);
+    for (uint32_t i = 0; i < num_paths; ++i) {
+      request_headers_.push_back(std::make_unique<Http::TestRequestHeaderMapImpl>(
+          Http::TestRequestHeaderMapImpl{{":method", "GET"},
+                                         {":scheme", "https"},
+                                         {":authority", "example.com"},
+                                         {":path", absl::StrCat("/", i)}}));
+      requests_.emplace_back(*request_headers_.back(), SystemTime(), vary_allow_list_);
+    }
+  }
+
+  // Looks up a path, and on a miss inserts a response for it as the cache filter would.
+  void lookupOrInsert(uint32_t index) {
+    const LookupRequest& request = requests_[index];
+    Entry entry = cache_->lookup(request);
+    if (entry.response_headers_ == nullptr) {
+      cache_->insert(request.key(),
+                     Entry{Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers_),
+                           {},
+                           body_,
+                           nullptr},
+                     *request_headers_[index], vary_allow_list_);
+    }
+  }
+
+  const CacheStats& stats() const { return cache_->stats(); }
+
+  static constexpr uint64_t BodySize = 1024;
+
+private:
+  Stats::IsolatedStoreImpl store_;
+  testing::NiceMock<Server::Configuration::MockServerFactoryContext> factory_context_;
+  VaryAllowList vary_allow_list_{{}, factory_context_};
+  std::vector<std::unique_ptr<Http::TestRequestHeaderMapImpl>> request_headers_;
+  std::vector<LookupRequest> requests_;
+  Http::TestResponseHeaderMapImpl response_headers_{{":status", "200"},
+                                                    {"cache-control", "max-age=3600"}};
+  std::shared_ptr<const std::string> body_ = std::make_shared<const std::string>(BodySize, 'x');
+  std::unique_ptr<MemoryHttpCache> cache_;
+};
+
+std::unique_ptr<CacheBenchmarkState> benchmark_state;
+
+// Looks up paths drawn from a skewed distribution on every thread, inserting on misses.
+// Compares a single shard, where all threads contend for one lock, against many.
+void bmConcurrentLookupOrInsert(::benchmark::State& state) {
+  const uint32_t shards = state.range(0);
+  const uint32_t num_paths = benchmark::skipExpensiveBenchmarks() ? 1000 : 100000;
+  if (state.thread_index() == 0) {
+    benchmark_state = std::make_unique<CacheBenchmarkState>(shards, num_paths);
+  }
+  // Smaller indexes are more popular, as with most cached content.
+  std::mt19937 rng(state.thread_index());
+  std::geometric_distribution<uint32_t> distribution(10.0 / num_paths);
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    benchmark_state->lookupOrInsert(distribution(rng) % num_paths);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    const CacheStats& stats = benchmark_state->stats();
+    const double hits = stats.cache_hit_.value();
+    state.counters["hit_ratio"] = hits / (hits + stats.cache_miss_.value());
+    state.counters["evictions"] = stats.evictions_.value();
+    benchmark_state.reset();
+  }
+}
+BENCHMARK(bmConcurrentLookupOrInsert)
+    ->Arg(1)
+    ->Arg(16)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime();
+
+} // namespace
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
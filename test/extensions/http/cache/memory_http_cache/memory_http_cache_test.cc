@@ -0,0 +1,286 @@
+#include "envoy/extensions/http/cache/memory_http_cache/v3/memory_http_cache.pb.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/http/header_map_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/http/cache/cache_entry_utils.h"
+#include "source/extensions/filters/http/cache/cache_headers_utils.h"
+#include "source/extensions/http/cache/memory_http_cache/memory_http_cache.h"
+
+#include "test/extensions/filters/http/cache/http_cache_implementation_test_common.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace MemoryHttpCache {
+namespace {
+
+using testing::NiceMock;
+
+ConfigProto testConfig() {
+  ConfigProto config;
+  config.set_name("test");
+  config.set_max_cache_size_bytes(1024 * 1024);
+  config.mutable_shards()->set_value(4);
+  return config;
+}
+
+class MemoryHttpCacheTestDelegate : public HttpCacheTestDelegate {
+public:
+  std::shared_ptr<HttpCache> cache() override { return cache_; }
+  bool validationEnabled() const override { return true; }
+
+private:
+  Stats::IsolatedStoreImpl store_;
+  std::shared_ptr<MemoryHttpCache> cache_ =
+      std::make_shared<MemoryHttpCache>(nullptr, testConfig(), *store_.rootScope());
+};
+
+INSTANTIATE_TEST_SUITE_P(MemoryHttpCacheTest, HttpCacheImplementationTest,
+                         testing::Values(std::make_unique<MemoryHttpCacheTestDelegate>),
+                         [](const testing::TestParamInfo<HttpCacheImplementationTest::ParamType>&) {
+                           return "MemoryHttpCache";
+                         });
+
+class CacheShardTest : public testing::Test {
+protected:
+  // Fits three of the entries made by makeEntry(), but not four.
+  static constexpr uint64_t ShardSizeBytes = 3500;
+
+  static Key makeKey(absl::string_view path) {
+    Key key;
+    key.set_host("example.com");
+    key.set_path(std::string(path));
+    return key;
+  }
+
+  static Entry makeEntry(size_t body_size = 1000) {
+    Http::TestResponseHeaderMapImpl headers{{":status", "200"}};
+    return Entry{Http::createHeaderMap<Http::ResponseHeaderMapImpl>(headers),
+                 {},
+                 std::make_shared<const std::string>(body_size, 'x'),
+                 nullptr};
+  }
+
+  bool insert(CacheShard& shard, absl::string_view path, size_t body_size = 1000) {
+    const Key key = makeKey(path);
+    return shard.insert(key, stableHashKey(key), makeEntry(body_size));
+  }
+  bool insert(absl::string_view path) { return insert(shard_, path); }
+
+  // Note that every lookup, hit or miss, counts towards the popularity of the key.
+  bool lookup(absl::string_view path) {
+    const Key key = makeKey(path);
+    return shard_.lookup(key, stableHashKey(key)).response_headers_ != nullptr;
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  CacheStatNames stat_names_{store_.symbolTable()};
+  CacheStats stats_{generateStats(stat_names_, *store_.rootScope(), "test")};
+  CacheShard shard_{ShardSizeBytes, ShardSizeBytes, stats_};
+};
+
+TEST_F(CacheShardTest, EvictsLeastRecentlyUsedProbationaryEntry) {
+  ASSERT_TRUE(insert("/a"));
+  ASSERT_TRUE(insert("/b"));
+  ASSERT_TRUE(insert("/c"));
+  // Promotes /a to the protected segment.
+  EXPECT_TRUE(lookup("/a"));
+  EXPECT_FALSE(lookup("/d"));
+
+  EXPECT_TRUE(insert("/d"));
+  EXPECT_EQ(1, stats_.evictions_.value());
+  EXPECT_EQ(4, stats_.inserts_.value());
+  EXPECT_EQ(3, stats_.size_count_.value());
+  EXPECT_FALSE(lookup("/b"));
+  EXPECT_TRUE(lookup("/a"));
+  EXPECT_TRUE(lookup("/c"));
+  EXPECT_TRUE(lookup("/d"));
+}
+
+TEST_F(CacheShardTest, RejectsLessPopularEntry) {
+  ASSERT_TRUE(insert("/a"));
+  ASSERT_TRUE(insert("/b"));
+  ASSERT_TRUE(insert("/c"));
+  for (absl::string_view path : {"/a", "/b", "/c", "/a", "/b", "/c"}) {
+    EXPECT_TRUE(lookup(path));
+  }
+  EXPECT_FALSE(lookup("/d"));
+
+  EXPECT_FALSE(insert("/d"));
+  EXPECT_EQ(1, stats_.insert_rejections_.value());
+  EXPECT_EQ(0, stats_.evictions_.value());
+  EXPECT_EQ(3, stats_.size_count_.value());
+  EXPECT_TRUE(lookup("/a"));
+  EXPECT_TRUE(lookup("/b"));
+  EXPECT_TRUE(lookup("/c"));
+}
+
+TEST_F(CacheShardTest, AdmitsMorePopularEntry) {
+  ASSERT_TRUE(insert("/a"));
+  ASSERT_TRUE(insert("/b"));
+  ASSERT_TRUE(insert("/c"));
+  for (absl::string_view path : {"/a", "/b", "/c"}) {
+    EXPECT_TRUE(lookup(path));
+  }
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_FALSE(lookup("/d"));
+  }
+
+  EXPECT_TRUE(insert("/d"));
+  EXPECT_EQ(0, stats_.insert_rejections_.value());
+  EXPECT_EQ(1, stats_.evictions_.value());
+  EXPECT_TRUE(lookup("/d"));
+}
+
+TEST_F(CacheShardTest, ScanDoesNotFlushPopularEntries) {
+  ASSERT_TRUE(insert("/a"));
+  EXPECT_TRUE(lookup("/a"));
+  EXPECT_TRUE(lookup("/a"));
+  // A stream of responses that are each requested once, as a scan would produce.
+  for (int i = 0; i < 20; ++i) {
+    const std::string path = absl::StrCat("/scan/", i);
+    EXPECT_FALSE(lookup(path));
+    insert(path);
+  }
+  EXPECT_TRUE(lookup("/a"));
+  EXPECT_GT(stats_.insert_rejections_.value(), 0);
+}
+
+TEST_F(CacheShardTest, ReplacingEntryIsAlwaysAdmitted) {
+  ASSERT_TRUE(insert("/a"));
+  ASSERT_TRUE(insert("/b"));
+  ASSERT_TRUE(insert("/c"));
+  for (absl::string_view path : {"/a", "/b", "/c", "/a", "/b", "/c"}) {
+    EXPECT_TRUE(lookup(path));
+  }
+
+  EXPECT_TRUE(insert("/a"));
+  EXPECT_EQ(0, stats_.insert_rejections_.value());
+  EXPECT_EQ(0, stats_.evictions_.value());
+  EXPECT_EQ(3, stats_.size_count_.value());
+}
+
+TEST_F(CacheShardTest, RejectsOversizedEntry) {
+  EXPECT_FALSE(insert(shard_, "/a", ShardSizeBytes));
+  EXPECT_EQ(1, stats_.insert_rejections_.value());
+  EXPECT_EQ(0, stats_.size_count_.value());
+  EXPECT_FALSE(lookup("/a"));
+
+  CacheShard shard{ShardSizeBytes, 500, stats_};
+  EXPECT_FALSE(insert(shard, "/a", 1000));
+  EXPECT_EQ(2, stats_.insert_rejections_.value());
+}
+
+TEST_F(CacheShardTest, SizeGaugesFollowShardLifetime) {
+  {
+    CacheShard shard{ShardSizeBytes, ShardSizeBytes, stats_};
+    ASSERT_TRUE(insert(shard, "/a"));
+    ASSERT_TRUE(insert(shard, "/b"));
+    EXPECT_EQ(2, stats_.size_count_.value());
+    EXPECT_GT(stats_.size_bytes_.value(), 2000);
+    EXPECT_LE(stats_.size_bytes_.value(), ShardSizeBytes);
+  }
+  EXPECT_EQ(0, stats_.size_count_.value());
+  EXPECT_EQ(0, stats_.size_bytes_.value());
+}
+
+TEST_F(CacheShardTest, UpdateHeaders) {
+  ASSERT_TRUE(insert("/a"));
+  const Key key = makeKey("/a");
+  Http::TestResponseHeaderMapImpl update{{":status", "200"}, {"x-updated", "yes"}};
+  EXPECT_TRUE(shard_.updateHeaders(key, stableHashKey(key), update, {}));
+  Http::ResponseHeaderMapPtr headers = shard_.responseHeaders(key, stableHashKey(key));
+  ASSERT_NE(headers, nullptr);
+  EXPECT_EQ("yes", headers->getByKey("x-updated").value_or(""));
+
+  const Key missing_key = makeKey("/missing");
+  EXPECT_FALSE(shard_.updateHeaders(missing_key, stableHashKey(missing_key), update, {}));
+}
+
+class MemoryHttpCacheTest : public testing::Test {
+protected:
+  LookupRequest makeLookupRequest(absl::string_view path) {
+    request_headers_.setPath(path);
+    return {request_headers_, SystemTime(), vary_allow_list_};
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  MemoryHttpCache cache_{nullptr, testConfig(), *store_.rootScope()};
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context_;
+  VaryAllowList vary_allow_list_{{}, factory_context_};
+  Http::TestRequestHeaderMapImpl request_headers_{
+      {":method", "GET"}, {":scheme", "https"}, {":authority", "example.com"}};
+};
+
+TEST_F(MemoryHttpCacheTest, LookupsShareCachedBody) {
+  EXPECT_EQ(nullptr, cache_.lookup(makeLookupRequest("/a")).response_headers_);
+  EXPECT_EQ(1, cache_.stats().cache_miss_.value());
+
+  Http::TestResponseHeaderMapImpl headers{{":status", "200"}};
+  ASSERT_TRUE(cache_.insert(makeLookupRequest("/a").key(),
+                            Entry{Http::createHeaderMap<Http::ResponseHeaderMapImpl>(headers),
+                                  {},
+                                  std::make_shared<const std::string>("body"),
+                                  nullptr},
+                            request_headers_, vary_allow_list_));
+
+  Entry first = cache_.lookup(makeLookupRequest("/a"));
+  Entry second = cache_.lookup(makeLookupRequest("/a"));
+  ASSERT_NE(nullptr, first.body_);
+  EXPECT_EQ("body", *first.body_);
+  EXPECT_EQ(first.body_.get(), second.body_.get());
+  EXPECT_EQ(2, cache_.stats().cache_hit_.value());
+  EXPECT_EQ(1, cache_.stats().inserts_.value());
+  EXPECT_EQ(1024 * 1024, cache_.stats().size_limit_bytes_.value());
+}
+
+TEST_F(MemoryHttpCacheTest, SupportsRangeRequests) {
+  EXPECT_EQ(MemoryHttpCache::name(), cache_.cacheInfo().name_);
+  EXPECT_TRUE(cache_.cacheInfo().supports_range_requests_);
+}
+
+envoy::extensions::filters::http::cache::v3::CacheConfig cacheConfig(const ConfigProto& config) {
+  envoy::extensions::filters::http::cache::v3::CacheConfig cache_config;
+  cache_config.mutable_typed_config()->PackFrom(config);
+  return cache_config;
+}
+
+TEST(Registration, GetFactory) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.extensions.http.cache.memory_http_cache.v3.MemoryHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  EXPECT_EQ(factory->getCache(cacheConfig(testConfig()), factory_context)->cacheInfo().name_,
+            "envoy.extensions.http.cache.memory_http_cache");
+}
+
+TEST(Registration, CachesAreSharedByName) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.extensions.http.cache.memory_http_cache.v3.MemoryHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  std::shared_ptr<HttpCache> cache = factory->getCache(cacheConfig(testConfig()), factory_context);
+  EXPECT_EQ(cache, factory->getCache(cacheConfig(testConfig()), factory_context));
+
+  ConfigProto other_name = testConfig();
+  other_name.set_name("other");
+  EXPECT_NE(cache, factory->getCache(cacheConfig(other_name), factory_context));
+
+  ConfigProto mismatched = testConfig();
+  mismatched.set_max_cache_size_bytes(1024);
+  EXPECT_THROW(factory->getCache(cacheConfig(mismatched), factory_context), EnvoyException);
+}
+
+} // namespace
+} // namespace MemoryHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
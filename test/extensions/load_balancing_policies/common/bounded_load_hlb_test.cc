@@ -32,9 +32,9 @@ public:
   TestBoundedLoadHashingLoadBalancer(
       ThreadAwareLoadBalancerBase::HashingLoadBalancerSharedPtr hlb_ptr,
       const NormalizedHostWeightVector& normalized_host_weights, uint32_t hash_balance_factor,
-      HostOverloadFactorPredicate host_overload_factor)
+      HostOverloadFactorPredicate host_overload_factor, bool probe_with_stride = false)
       : ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer(
-            hlb_ptr, normalized_host_weights, hash_balance_factor),
+            hlb_ptr, normalized_host_weights, hash_balance_factor, probe_with_stride),
         host_overload_factor_(host_overload_factor) {}
 
 private:
@@ -298,6 +298,71 @@ TEST_F(BoundedLoadHashingLoadBalancerTest, AllHostsOverloaded) {
   EXPECT_EQ(host->address()->asString(), "127.0.0.11:90");
 };
 
+// With stride probing, the hosts after an overloaded host are probed by a stride that depends on
+// the hash. For 5 hosts the strides for hashes 0-5 are 1 and the strides for hashes 6-9 are 2.
+TEST_F(BoundedLoadHashingLoadBalancerTest, StrideProbeHostOverloaded) {
+  std::vector<std::string> addresses;
+  addresses.push_back("127.0.0.10:90");
+  addresses.push_back("127.0.0.13:90");
+  host_overload_factor_predicate_ = getHostOverloadFactorPredicate(addresses);
+
+  NormalizedHostWeightVector normalized_host_weights, hosts_on_ring;
+  createHosts(5, normalized_host_weights, hosts_on_ring);
+
+  hlb_ = std::make_shared<TestHashingLoadBalancer>(hosts_on_ring);
+
+  lb_ = std::make_unique<TestBoundedLoadHashingLoadBalancer>(
+      hlb_, normalized_host_weights, 1, host_overload_factor_predicate_, true);
+
+  // Hash 1 maps to host 0, which is overloaded, and the stride of 1 leads to host 1.
+  HostConstSharedPtr host = lb_->chooseHost(1, 1).host;
+  EXPECT_NE(host, nullptr);
+  EXPECT_EQ(host->address()->asString(), "127.0.0.11:90");
+
+  // Hash 6 maps to host 3, which is overloaded. The stride of 2 leads to host 0, which is also
+  // overloaded, and then to host 2.
+  host = lb_->chooseHost(6, 1).host;
+  EXPECT_NE(host, nullptr);
+  EXPECT_EQ(host->address()->asString(), "127.0.0.12:90");
+
+  // Hash 4 maps to host 2, which is not overloaded.
+  host = lb_->chooseHost(4, 1).host;
+  EXPECT_NE(host, nullptr);
+  EXPECT_EQ(host->address()->asString(), "127.0.0.12:90");
+};
+
+// With stride probing, every host is probed once when all hosts are overloaded, and the least
+// overloaded host is selected.
+TEST_F(BoundedLoadHashingLoadBalancerTest, StrideProbeAllHostsOverloaded) {
+  std::vector<std::string> addresses;
+  for (uint32_t i = 0; i < 7; i++) {
+    addresses.push_back(fmt::format("127.0.0.1{}:90", (i + 4) % 7));
+  }
+  uint32_t probes = 0;
+  host_overload_factor_predicate_ = [&probes, predicate = getHostOverloadFactorPredicate(
+                                                  addresses)](const Host& h, double weight) {
+    probes++;
+    return predicate(h, weight);
+  };
+
+  NormalizedHostWeightVector normalized_host_weights;
+  createHosts(7, normalized_host_weights);
+
+  NormalizedHostWeightVector ring(normalized_host_weights);
+  hlb_ = std::make_shared<TestHashingLoadBalancer>(ring);
+
+  lb_ = std::make_unique<TestBoundedLoadHashingLoadBalancer>(
+      hlb_, normalized_host_weights, 1, host_overload_factor_predicate_, true);
+
+  for (uint64_t hash = 0; hash < 7; hash++) {
+    probes = 0;
+    HostConstSharedPtr host = lb_->chooseHost(hash, 1).host;
+    EXPECT_NE(host, nullptr);
+    EXPECT_EQ(host->address()->asString(), "127.0.0.14:90");
+    EXPECT_EQ(probes, 7);
+  }
+};
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
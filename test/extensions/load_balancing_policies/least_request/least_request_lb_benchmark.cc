@@ -9,9 +9,14 @@ namespace {
 
 class LeastRequestTester : public BaseTester {
 public:
-  LeastRequestTester(uint64_t num_hosts, uint32_t choice_count) : BaseTester(num_hosts) {
+  LeastRequestTester(uint64_t num_hosts, uint32_t choice_count, bool full_scan = false)
+      : BaseTester(num_hosts) {
     envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest lr_lb_config;
     lr_lb_config.mutable_choice_count()->set_value(choice_count);
+    if (full_scan) {
+      lr_lb_config.set_selection_method(
+          envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest::FULL_SCAN);
+    }
     lb_ =
         std::make_unique<LeastRequestLoadBalancer>(priority_set_, &local_priority_set_, stats_,
                                                    runtime_, random_, 50, lr_lb_config, simTime());
@@ -62,6 +67,34 @@ BENCHMARK(benchmarkLeastRequestLoadBalancerChooseHost)
     ->Args({100, 100, 1000000})
     ->Unit(::benchmark::kMillisecond);
 
+// Times picks alone, in clusters large enough that the hosts do not fit in the CPU caches. Args are
+// {num_hosts, choice_count, full_scan}.
+void benchmarkLeastRequestLoadBalancerPick(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t choice_count = state.range(1);
+  const bool full_scan = state.range(2) != 0;
+  const uint64_t picks = 10000;
+
+  LeastRequestTester tester(num_hosts, choice_count, full_scan);
+  const HostVector& hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+  for (uint64_t i = 0; i < hosts.size(); ++i) {
+    hosts[i]->stats().rq_active_.set(i % 7);
+  }
+  TestLoadBalancerContext context;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    for (uint64_t i = 0; i < picks; ++i) {
+      ::benchmark::DoNotOptimize(tester.lb_->chooseHost(&context));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * picks);
+}
+BENCHMARK(benchmarkLeastRequestLoadBalancerPick)
+    ->Args({5000, 2, 0})
+    ->Args({5000, 8, 0})
+    ->Args({5000, 32, 0})
+    ->Args({5000, 2, 1})
+    ->Unit(::benchmark::kMillisecond);
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
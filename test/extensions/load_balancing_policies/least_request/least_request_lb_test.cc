@@ -86,6 +86,24 @@ TEST_P(LeastRequestLoadBalancerTest, Normal) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr).host);
 }
 
+TEST_P(LeastRequestLoadBalancerTest, PickDoesNotAllocateHostStats) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime())};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2)).WillOnce(Return(3));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr).host);
+  EXPECT_EQ(nullptr, hostSet().healthy_hosts_[0]->statsIfAllocated());
+  EXPECT_EQ(nullptr, hostSet().healthy_hosts_[1]->statsIfAllocated());
+
+  // Stats allocated after the host sources were refreshed are seen by later picks.
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(1);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(2)).WillOnce(Return(3));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr).host);
+  EXPECT_EQ(nullptr, hostSet().healthy_hosts_[1]->statsIfAllocated());
+}
+
 TEST_P(LeastRequestLoadBalancerTest, PNC) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
                               makeTestHost(info_, "tcp://127.0.0.1:81", simTime()),
@@ -134,6 +152,56 @@ TEST_P(LeastRequestLoadBalancerTest, PNC) {
   EXPECT_EQ(hostSet().healthy_hosts_[3], lb_5.chooseHost(nullptr).host);
 }
 
+// Choices are sampled in batches of 16. The earliest sample with the fewest active requests is
+// selected, whether it is in the first batch or a later one.
+TEST_P(LeastRequestLoadBalancerTest, PNCMultipleBatches) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime()),
+                              makeTestHost(info_, "tcp://127.0.0.1:82", simTime()),
+                              makeTestHost(info_, "tcp://127.0.0.1:83", simTime())};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(4);
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(2);
+  hostSet().healthy_hosts_[2]->stats().rq_active_.set(2);
+  hostSet().healthy_hosts_[3]->stats().rq_active_.set(1);
+
+  envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest lr_lb_config;
+  lr_lb_config.mutable_choice_count()->set_value(20);
+  LeastRequestLoadBalancer lb_20{priority_set_, nullptr, stats_,       runtime_,
+                                 random_,       50,      lr_lb_config, simTime()};
+
+  // The least loaded host is only sampled in the second batch.
+  {
+    testing::InSequence s;
+    EXPECT_CALL(random_, random()).Times(17).WillRepeatedly(Return(0));
+    EXPECT_CALL(random_, random()).WillOnce(Return(2));
+    EXPECT_CALL(random_, random()).WillOnce(Return(3));
+    EXPECT_CALL(random_, random()).Times(2).WillRepeatedly(Return(1));
+    EXPECT_EQ(hostSet().healthy_hosts_[3], lb_20.chooseHost(nullptr).host);
+  }
+
+  // Hosts 1 and 2 tie. Host 2 is sampled first, in the first batch.
+  {
+    testing::InSequence s;
+    EXPECT_CALL(random_, random()).Times(2).WillRepeatedly(Return(0));
+    EXPECT_CALL(random_, random()).WillOnce(Return(2));
+    EXPECT_CALL(random_, random()).Times(18).WillRepeatedly(Return(1));
+    EXPECT_EQ(hostSet().healthy_hosts_[2], lb_20.chooseHost(nullptr).host);
+  }
+
+  // Active requests are read when picking, not when the hosts were last updated.
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(0);
+  {
+    testing::InSequence s;
+    EXPECT_CALL(random_, random()).WillOnce(Return(0));
+    EXPECT_CALL(random_, random()).Times(16).WillRepeatedly(Return(3));
+    EXPECT_CALL(random_, random()).Times(4).WillRepeatedly(Return(0));
+    EXPECT_EQ(hostSet().healthy_hosts_[0], lb_20.chooseHost(nullptr).host);
+  }
+}
+
 TEST_P(LeastRequestLoadBalancerTest, DefaultSelectionMethod) {
   envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest lr_lb_config;
   EXPECT_EQ(lr_lb_config.selection_method(),
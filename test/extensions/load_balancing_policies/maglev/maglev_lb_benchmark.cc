@@ -9,8 +9,10 @@ namespace {
 
 class MaglevTester : public BaseTester {
 public:
-  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0)
+  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0,
+               bool incremental_table_build = false)
       : BaseTester(num_hosts, weighted_subset_percent, weight) {
+    config_.set_incremental_table_build(incremental_table_build);
     maglev_lb_ = std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, stats_scope_, runtime_,
                                                       random_, 50, config_);
   }
@@ -180,6 +182,66 @@ BENCHMARK(benchmarkMaglevLoadBalancerWeighted)
     ->Args({500, 95, 75, 25, 10000})
     ->Unit(::benchmark::kMillisecond);
 
+// Times the table update after some hosts are removed, with full rebuilds (incremental = 0) and
+// with incremental builds (incremental = 1).
+void benchmarkMaglevLoadBalancerHostUpdate(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t hosts_to_lose = state.range(1);
+  const bool incremental = state.range(2) != 0;
+  const uint64_t keys_to_simulate = 10000;
+  uint64_t num_different_hosts = 0;
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    MaglevTester tester(num_hosts, 0, 0, incremental);
+    ASSERT_TRUE(tester.maglev_lb_->initialize().ok());
+    LoadBalancerPtr lb = tester.maglev_lb_->factory()->create(tester.lb_params_);
+    std::vector<HostConstSharedPtr> hosts_before;
+    TestLoadBalancerContext context;
+    for (uint64_t i = 0; i < keys_to_simulate; i++) {
+      context.hash_key_ = hashInt(i);
+      hosts_before.push_back(lb->chooseHost(&context).host);
+    }
+
+    HostVector hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+    const HostVector hosts_removed(hosts.end() - hosts_to_lose, hosts.end());
+    hosts.resize(hosts.size() - hosts_to_lose);
+    HostVectorConstSharedPtr updated_hosts = std::make_shared<HostVector>(hosts);
+    HostsPerLocalityConstSharedPtr hosts_per_locality = makeHostsPerLocality({hosts});
+    PrioritySet::UpdateHostsParams params =
+        HostSetImpl::partitionHosts(updated_hosts, hosts_per_locality);
+    state.ResumeTiming();
+
+    // The priority set update triggers the table update.
+    tester.priority_set_.updateHosts(0, std::move(params), {}, {}, hosts_removed,
+                                     tester.random_.random(), absl::nullopt);
+
+    state.PauseTiming();
+    lb = tester.maglev_lb_->factory()->create(tester.lb_params_);
+    num_different_hosts = 0;
+    for (uint64_t i = 0; i < keys_to_simulate; i++) {
+      context.hash_key_ = hashInt(i);
+      if (hosts_before[i] != lb->chooseHost(&context).host) {
+        num_different_hosts++;
+      }
+    }
+    state.ResumeTiming();
+  }
+
+  state.counters["percent_different"] =
+      (static_cast<double>(num_different_hosts) / keys_to_simulate) * 100;
+  state.counters["host_loss_over_N_optimal"] =
+      (static_cast<double>(hosts_to_lose) / num_hosts) * 100;
+}
+BENCHMARK(benchmarkMaglevLoadBalancerHostUpdate)
+    ->Args({500, 1, 0})
+    ->Args({500, 1, 1})
+    ->Args({5000, 1, 0})
+    ->Args({5000, 1, 1})
+    ->Args({5000, 50, 0})
+    ->Args({5000, 50, 1})
+    ->Unit(::benchmark::kMillisecond);
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
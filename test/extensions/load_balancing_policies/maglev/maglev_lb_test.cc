@@ -612,6 +612,67 @@ TEST_F(MaglevLoadBalancerTest, LocalityWeightedLopsided) {
   EXPECT_EQ(MaglevTable::DefaultTableSize - 1023, counts[0]);
 }
 
+// Incremental builds only reassign the table entries needed for the change in hosts.
+TEST_F(MaglevLoadBalancerTest, IncrementalTableBuild) {
+  for (uint32_t i = 0; i < 10; ++i) {
+    host_set_.hosts_.push_back(
+        makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 90 + i), simTime()));
+  }
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  config_.set_incremental_table_build(true);
+  init(1009);
+  EXPECT_EQ(100, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(101, lb_->stats().max_entries_per_host_.value());
+
+  const auto assignments = [this]() {
+    LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+    std::vector<HostConstSharedPtr> hosts;
+    for (uint32_t i = 0; i < 1009; ++i) {
+      TestLoadBalancerContext context(i);
+      hosts.push_back(lb->chooseHost(&context).host);
+    }
+    return hosts;
+  };
+  const std::vector<HostConstSharedPtr> before_removal = assignments();
+
+  // Only the entries of the removed host move.
+  const HostSharedPtr removed_host = host_set_.healthy_hosts_[3];
+  host_set_.healthy_hosts_.erase(host_set_.healthy_hosts_.begin() + 3);
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(112, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(113, lb_->stats().max_entries_per_host_.value());
+  const std::vector<HostConstSharedPtr> after_removal = assignments();
+  for (uint32_t i = 0; i < after_removal.size(); ++i) {
+    EXPECT_NE(removed_host, after_removal[i]);
+    if (before_removal[i] != removed_host) {
+      EXPECT_EQ(before_removal[i], after_removal[i]);
+    }
+  }
+
+  // Only entries that move to the added host change.
+  host_set_.healthy_hosts_.push_back(removed_host);
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(100, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(101, lb_->stats().max_entries_per_host_.value());
+  const std::vector<HostConstSharedPtr> after_addition = assignments();
+  uint32_t moved = 0;
+  for (uint32_t i = 0; i < after_addition.size(); ++i) {
+    if (after_removal[i] != after_addition[i]) {
+      EXPECT_EQ(removed_host, after_addition[i]);
+      ++moved;
+    }
+  }
+  EXPECT_GE(moved, 100);
+  EXPECT_LE(moved, 101);
+
+  // No hosts.
+  host_set_.healthy_hosts_.clear();
+  host_set_.hosts_.clear();
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(nullptr, lb_->factory()->create(lb_params_)->chooseHost(nullptr).host);
+}
+
 TEST(TypedMaglevLbConfigTest, TypedMaglevLbConfigTest) {
   {
     envoy::config::cluster::v3::Cluster::MaglevLbConfig legacy;
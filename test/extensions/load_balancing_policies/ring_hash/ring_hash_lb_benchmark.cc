@@ -1,5 +1,8 @@
 #include "source/extensions/load_balancing_policies/ring_hash/ring_hash_lb.h"
 
+#include <cmath>
+#include <random>
+
 #include "test/benchmark/main.h"
 #include "test/extensions/load_balancing_policies/common/benchmark_base_tester.h"
 
@@ -9,9 +12,20 @@ namespace {
 
 class RingHashTester : public BaseTester {
 public:
-  RingHashTester(uint64_t num_hosts, uint64_t min_ring_size) : BaseTester(num_hosts) {
+  RingHashTester(uint64_t num_hosts, uint64_t min_ring_size, uint32_t hash_balance_factor = 0,
+                 bool bounded_load_stride_probe = false)
+      : BaseTester(num_hosts) {
     envoy::extensions::load_balancing_policies::ring_hash::v3::RingHash config;
     config.mutable_minimum_ring_size()->set_value(min_ring_size);
+    if (hash_balance_factor != 0) {
+      auto* hashing_config = config.mutable_consistent_hashing_lb_config();
+      hashing_config->mutable_hash_balance_factor()->set_value(hash_balance_factor);
+      if (bounded_load_stride_probe) {
+        hashing_config->set_bounded_load_probe(
+            envoy::extensions::load_balancing_policies::common::v3::ConsistentHashingLbConfig::
+                HASHED_STRIDE);
+      }
+    }
     ring_hash_lb_ = std::make_unique<RingHashLoadBalancer>(priority_set_, stats_, stats_scope_,
                                                            runtime_, random_, 50, config);
   }
@@ -86,6 +100,149 @@ BENCHMARK(benchmarkRingHashLoadBalancerChooseHost)
     ->Args({500, 256000, 100000})
     ->Unit(::benchmark::kMillisecond);
 
+// Times lookups alone, to compare ring layouts. Larger rings no longer fit in the CPU caches.
+void benchmarkRingHashLoadBalancerLookup(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t min_ring_size = state.range(1);
+  const uint64_t keys_to_simulate = 100000;
+
+  if (benchmark::skipExpensiveBenchmarks() && min_ring_size > 65536) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  RingHashTester tester(num_hosts, min_ring_size);
+  ASSERT_TRUE(tester.ring_hash_lb_->initialize().ok());
+  LoadBalancerPtr lb = tester.ring_hash_lb_->factory()->create(tester.lb_params_);
+  TestLoadBalancerContext context;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    for (uint64_t i = 0; i < keys_to_simulate; i++) {
+      context.hash_key_ = hashInt(i);
+      ::benchmark::DoNotOptimize(lb->chooseHost(&context));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys_to_simulate);
+}
+BENCHMARK(benchmarkRingHashLoadBalancerLookup)
+    ->Args({100, 1024})
+    ->Args({100, 65536})
+    ->Args({500, 1048576})
+    ->Args({500, 8388608})
+    ->Unit(::benchmark::kMillisecond);
+
+// Times the ring update after some hosts are removed. The update is built from the previous ring,
+// compare with benchmarkRingHashLoadBalancerBuildRing for the cost of a full build.
+void benchmarkRingHashLoadBalancerHostUpdate(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t min_ring_size = state.range(1);
+  const uint64_t hosts_to_lose = state.range(2);
+
+  if (benchmark::skipExpensiveBenchmarks() && min_ring_size > 65536) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    RingHashTester tester(num_hosts, min_ring_size);
+    ASSERT_TRUE(tester.ring_hash_lb_->initialize().ok());
+
+    HostVector hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+    const HostVector hosts_removed(hosts.end() - hosts_to_lose, hosts.end());
+    hosts.resize(hosts.size() - hosts_to_lose);
+    HostVectorConstSharedPtr updated_hosts = std::make_shared<HostVector>(hosts);
+    HostsPerLocalityConstSharedPtr hosts_per_locality = makeHostsPerLocality({hosts});
+    PrioritySet::UpdateHostsParams params =
+        HostSetImpl::partitionHosts(updated_hosts, hosts_per_locality);
+    state.ResumeTiming();
+
+    // The priority set update triggers the ring update.
+    tester.priority_set_.updateHosts(0, std::move(params), {}, {}, hosts_removed,
+                                     tester.random_.random(), absl::nullopt);
+  }
+}
+BENCHMARK(benchmarkRingHashLoadBalancerHostUpdate)
+    ->Args({500, 65536, 1})
+    ->Args({500, 65536, 50})
+    ->Args({500, 1048576, 1})
+    ->Args({500, 1048576, 50})
+    ->Unit(::benchmark::kMillisecond);
+
+// Simulates requests whose keys follow a Zipf distribution, so that a few hot keys carry much of
+// the traffic. Each request stays in flight until in_flight newer requests have been sent. Reports
+// the peak number of in flight requests of the busiest host and the share of requests of the
+// busiest host, both relative to the mean, along with the cost of a pick. Args are
+// {num_hosts, hash_balance_factor, probe}, where a hash_balance_factor of 0 disables bounded
+// loads, and probe is 0 for RANDOM_SHUFFLE and 1 for HASHED_STRIDE.
+void benchmarkRingHashLoadBalancerBoundedLoad(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint32_t hash_balance_factor = state.range(1);
+  const bool stride_probe = state.range(2) != 0;
+  const uint64_t num_keys = 10000;
+  const uint64_t num_requests = 100000;
+  const uint64_t in_flight = 20 * num_hosts;
+
+  RingHashTester tester(num_hosts, 65536, hash_balance_factor, stride_probe);
+  ASSERT_TRUE(tester.ring_hash_lb_->initialize().ok());
+  LoadBalancerPtr lb = tester.ring_hash_lb_->factory()->create(tester.lb_params_);
+
+  // Do not time the generation of the request keys.
+  std::vector<double> key_cdf(num_keys);
+  double sum = 0;
+  for (uint64_t i = 0; i < num_keys; i++) {
+    sum += 1.0 / std::pow(i + 1, 1.1);
+    key_cdf[i] = sum;
+  }
+  std::mt19937_64 random(1);
+  std::uniform_real_distribution<double> uniform(0, sum);
+  std::vector<uint64_t> request_hashes(num_requests);
+  for (uint64_t& hash : request_hashes) {
+    hash = hashInt(std::lower_bound(key_cdf.begin(), key_cdf.end(), uniform(random)) -
+                   key_cdf.begin());
+  }
+
+  Stats::Gauge& cluster_rq_active = tester.info_->trafficStats()->upstream_rq_active_;
+  std::vector<HostConstSharedPtr> outstanding(in_flight);
+  absl::node_hash_map<const Host*, uint64_t> requests_per_host;
+  uint64_t next = 0;
+  uint64_t peak_host_rq_active = 0;
+  TestLoadBalancerContext context;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    for (const uint64_t hash : request_hashes) {
+      HostConstSharedPtr& slot = outstanding[next++ % in_flight];
+      if (slot != nullptr) {
+        slot->stats().rq_active_.dec();
+        cluster_rq_active.dec();
+      }
+      context.hash_key_ = hash;
+      slot = lb->chooseHost(&context).host;
+      slot->stats().rq_active_.inc();
+      cluster_rq_active.inc();
+      peak_host_rq_active = std::max(peak_host_rq_active, slot->stats().rq_active_.value());
+      requests_per_host[slot.get()]++;
+    }
+  }
+
+  uint64_t max_requests = 0;
+  for (const auto& entry : requests_per_host) {
+    max_requests = std::max(max_requests, entry.second);
+  }
+  state.SetItemsProcessed(state.iterations() * num_requests);
+  state.counters["peak_in_flight_over_mean"] =
+      static_cast<double>(peak_host_rq_active) * num_hosts / in_flight;
+  state.counters["max_requests_over_mean"] =
+      static_cast<double>(max_requests) * num_hosts / (state.iterations() * num_requests);
+}
+BENCHMARK(benchmarkRingHashLoadBalancerBoundedLoad)
+    ->Args({100, 0, 0})
+    ->Args({100, 150, 0})
+    ->Args({100, 150, 1})
+    ->Args({100, 125, 0})
+    ->Args({100, 125, 1})
+    ->Args({1000, 150, 0})
+    ->Args({1000, 150, 1})
+    ->Unit(::benchmark::kMillisecond);
+
 void benchmarkRingHashLoadBalancerHostLoss(::benchmark::State& state) {
   const uint64_t num_hosts = state.range(0);
   const uint64_t min_ring_size = state.range(1);
@@ -1001,6 +1001,55 @@ TEST_P(RingHashLoadBalancerTest, LopsidedWeightSmallScale) {
   }
 }
 
+// Rings that are built from the previous ring when hosts or weights change select the same hosts
+// as rings built from scratch.
+TEST_P(RingHashLoadBalancerTest, RingUpdateMatchesFullBuild) {
+  for (uint32_t i = 0; i < 10; ++i) {
+    hostSet().hosts_.push_back(
+        makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 90 + i), simTime(), i % 3 + 1));
+  }
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_.mutable_minimum_ring_size()->set_value(1000);
+  init();
+
+  auto expect_same_hosts_as_full_build = [this]() {
+    RingHashLoadBalancer full_build_lb(priority_set_, stats_, *stats_store_.rootScope(), runtime_,
+                                       random_, 50, config_);
+    ASSERT_TRUE(full_build_lb.initialize().ok());
+    LoadBalancerPtr full_build = full_build_lb.factory()->create(lb_params_);
+    LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+    for (uint64_t i = 0; i < 1000; ++i) {
+      TestLoadBalancerContext context(i * 0x9E3779B97F4A7C15);
+      EXPECT_EQ(full_build->chooseHost(&context).host, lb->chooseHost(&context).host);
+    }
+  };
+  expect_same_hosts_as_full_build();
+
+  // Remove a host and change the weight of another.
+  hostSet().healthy_hosts_.erase(hostSet().healthy_hosts_.begin() + 3);
+  hostSet().hosts_[5]->weight(7);
+  hostSet().runCallbacks({}, {});
+  expect_same_hosts_as_full_build();
+
+  // Add hosts.
+  for (uint32_t i = 10; i < 12; ++i) {
+    hostSet().hosts_.push_back(
+        makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 90 + i), simTime(), 2));
+    hostSet().healthy_hosts_.push_back(hostSet().hosts_.back());
+  }
+  hostSet().runCallbacks({}, {});
+  expect_same_hosts_as_full_build();
+
+  // Raise the minimum weight, which changes the number of hashes of every host.
+  for (const auto& host : hostSet().hosts_) {
+    host->weight(host->weight() + 1);
+  }
+  hostSet().runCallbacks({}, {});
+  expect_same_hosts_as_full_build();
+}
+
 TEST(TypedRingHashLbConfigTest, TypedRingHashLbConfigTest) {
   {
     envoy::config::cluster::v3::Cluster::RingHashLbConfig legacy;
@@ -9,6 +9,7 @@
 
 #include "source/common/common/random_generator.h"
 #include "source/common/memory/stats.h"
+#include "source/common/router/metadatamatchcriteria_impl.h"
 #include "source/common/upstream/upstream_impl.h"
 #include "source/extensions/load_balancing_policies/subset/subset_lb.h"
 
@@ -31,7 +32,8 @@ namespace {
 
 class SubsetLbTester : public Upstream::BaseTester {
 public:
-  SubsetLbTester(uint64_t num_hosts, bool single_host_per_subset)
+  SubsetLbTester(uint64_t num_hosts, bool single_host_per_subset, bool lazy_subsets = false,
+                 uint32_t max_lazy_subsets = 0)
       : BaseTester(num_hosts, 0, 0, true /* attach metadata */) {
     envoy::extensions::load_balancing_policies::subset::v3::Subset subset_config_proto{};
     subset_config_proto.set_fallback_policy(
@@ -39,6 +41,12 @@ public:
     auto* selector_proto = subset_config_proto.mutable_subset_selectors()->Add();
     selector_proto->set_single_host_per_subset(single_host_per_subset);
     *selector_proto->mutable_keys()->Add() = std::string(metadata_key);
+    if (lazy_subsets) {
+      auto* lazy_subsets_proto = subset_config_proto.mutable_lazy_subsets();
+      if (max_lazy_subsets > 0) {
+        lazy_subsets_proto->mutable_max_subsets()->set_value(max_lazy_subsets);
+      }
+    }
 
     auto* child_lb = subset_config_proto.mutable_subset_lb_policy()->mutable_policies()->Add();
     child_lb->mutable_typed_extension_config()->set_name("envoy.load_balancing_policies.random");
@@ -120,6 +128,73 @@ BENCHMARK(benchmarkSubsetLoadBalancerUpdate)
     ->Ranges({{false, true}, {50, 2500}})
     ->Unit(::benchmark::kMillisecond);
 
+// Every host carries a distinct metadata value, so eagerly built subsets are as many as the hosts.
+void benchmarkSubsetLoadBalancerLazyUpdate(::benchmark::State& state) {
+  const bool lazy_subsets = state.range(0);
+  const uint64_t num_hosts = state.range(1);
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  SubsetLbTester tester(num_hosts, false, lazy_subsets);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    tester.update();
+  }
+  state.counters["subsets"] = tester.stats_.lb_subsets_active_.value();
+}
+
+BENCHMARK(benchmarkSubsetLoadBalancerLazyUpdate)
+    ->Ranges({{false, true}, {50, 2500}})
+    ->Unit(::benchmark::kMillisecond);
+
+class MetadataMatchContext : public Upstream::LoadBalancerContextBase {
+public:
+  MetadataMatchContext(uint64_t value) {
+    ProtobufWkt::Struct metadata_matches;
+    (*metadata_matches.mutable_fields())[std::string(Upstream::BaseTester::metadata_key)]
+        .set_number_value(value);
+    criteria_ = std::make_unique<Router::MetadataMatchCriteriaImpl>(metadata_matches);
+  }
+
+  // Upstream::LoadBalancerContext
+  const Router::MetadataMatchCriteria* metadataMatchCriteria() override { return criteria_.get(); }
+
+private:
+  std::unique_ptr<Router::MetadataMatchCriteriaImpl> criteria_;
+};
+
+// Requests select num_selected of the subsets uniformly while at most max_subsets lazily built
+// subsets are kept, so smaller bounds trade memory for rebuilding evicted subsets.
+void benchmarkSubsetLoadBalancerLazyChooseHost(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t num_selected = state.range(1);
+  const uint32_t max_subsets = state.range(2);
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  SubsetLbTester tester(num_hosts, false, true, max_subsets);
+  std::vector<std::unique_ptr<MetadataMatchContext>> contexts;
+  for (uint64_t i = 0; i < num_selected; ++i) {
+    contexts.push_back(std::make_unique<MetadataMatchContext>(i * num_hosts / num_selected));
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    auto* context = contexts[tester.random_.random() % contexts.size()].get();
+    benchmark::DoNotOptimize(tester.lb_->chooseHost(context));
+  }
+  state.counters["subsets_created"] = tester.stats_.lb_subsets_created_.value();
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(benchmarkSubsetLoadBalancerLazyChooseHost)
+    ->Args({100, 64, 1024})
+    ->Args({10000, 64, 1024})
+    ->Args({10000, 1024, 1024})
+    ->Args({10000, 1024, 256});
+
 } // namespace
 } // namespace Subset
 } // namespace LoadBalancingPolices
@@ -60,6 +60,8 @@ public:
   MOCK_METHOD(bool, panicModeAny, (), (const));
   MOCK_METHOD(bool, listAsAny, (), (const));
   MOCK_METHOD(bool, allowRedundantKeys, (), (const));
+  MOCK_METHOD(bool, lazySubsets, (), (const));
+  MOCK_METHOD(uint32_t, maxLazySubsets, (), (const));
 
   std::vector<SubsetSelectorPtr> subset_selectors_;
 };
@@ -298,6 +300,20 @@ TEST(LoadBalancerSubsetInfoImplTest, SubsetConfig) {
             envoy::config::cluster::v3::Cluster::LbSubsetConfig::LbSubsetSelector::ANY_ENDPOINT);
 }
 
+TEST(LoadBalancerSubsetInfoImplTest, LazySubsetsConfig) {
+  envoy::extensions::load_balancing_policies::subset::v3::Subset subset_config;
+  subset_config.add_subset_selectors()->add_keys("key");
+
+  EXPECT_FALSE(LoadBalancerSubsetInfoImpl(subset_config).lazySubsets());
+
+  subset_config.mutable_lazy_subsets();
+  EXPECT_TRUE(LoadBalancerSubsetInfoImpl(subset_config).lazySubsets());
+  EXPECT_EQ(1024, LoadBalancerSubsetInfoImpl(subset_config).maxLazySubsets());
+
+  subset_config.mutable_lazy_subsets()->mutable_max_subsets()->set_value(16);
+  EXPECT_EQ(16, LoadBalancerSubsetInfoImpl(subset_config).maxLazySubsets());
+}
+
 class TestLoadBalancerContext : public LoadBalancerContextBase {
 public:
   TestLoadBalancerContext(
@@ -3080,6 +3096,136 @@ TEST_P(SubsetLoadBalancerTest, MetadataFallbackAndSubsetFallback) {
   EXPECT_EQ(c64_production_host, lb_->chooseHost(&context_unknown_or_c64).host);
 }
 
+TEST_F(SubsetLoadBalancerTest, LazySubsetsBuiltOnFirstUse) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::config::cluster::v3::Cluster::LbSubsetConfig::NO_FALLBACK));
+  EXPECT_CALL(subset_info_, lazySubsets()).WillRepeatedly(Return(true));
+  EXPECT_CALL(subset_info_, maxLazySubsets()).WillRepeatedly(Return(16));
+
+  std::vector<SubsetSelectorPtr> subset_selectors = {makeSelector({"version"}),
+                                                     makeSelector({"version", "stage"})};
+  EXPECT_CALL(subset_info_, subsetSelectors()).WillRepeatedly(ReturnRef(subset_selectors));
+
+  init({{"tcp://127.0.0.1:80", {{"version", "1.0"}}},
+        {"tcp://127.0.0.1:81", {{"version", "1.0"}, {"stage", "prod"}}},
+        {"tcp://127.0.0.1:82", {{"version", "1.1"}, {"stage", "prod"}}}});
+  EXPECT_EQ(0U, stats_.lb_subsets_created_.value());
+
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_10_prod({{"stage", "prod"}, {"version", "1.0"}});
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  TestLoadBalancerContext context_12({{"version", "1.2"}});
+  TestLoadBalancerContext context_prod({{"stage", "prod"}});
+
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10).host);
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_10).host);
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_10_prod).host);
+  EXPECT_EQ(host_set_.hosts_[2], lb_->chooseHost(&context_11).host);
+  // No host has version 1.2 and stage alone isn't a selector.
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_12).host);
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_prod).host);
+  EXPECT_EQ(3U, stats_.lb_subsets_created_.value());
+  EXPECT_EQ(3U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(3U, TestUtility::findGauge(stats_store_, "testprefix.lb_subsets_lazy_active")->value());
+
+  // Subsets that were built follow host updates.
+  host_set_.hosts_[1]->metadata(buildMetadataWithStage("1.1"));
+  host_set_.hosts_[2]->metadata(buildMetadataWithStage("1.0", "prod"));
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(host_set_.hosts_[2], lb_->chooseHost(&context_10_prod).host);
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_11).host);
+  EXPECT_EQ(3U, stats_.lb_subsets_created_.value());
+  EXPECT_EQ(0U, stats_.lb_subsets_removed_.value());
+
+  // And are purged like any other subset once empty.
+  host_set_.hosts_[1]->metadata(buildMetadataWithStage("1.2"));
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(1U, stats_.lb_subsets_removed_.value());
+  EXPECT_EQ(2U, TestUtility::findGauge(stats_store_, "testprefix.lb_subsets_lazy_active")->value());
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_11).host);
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_12).host);
+  EXPECT_EQ(4U, stats_.lb_subsets_created_.value());
+}
+
+TEST_F(SubsetLoadBalancerTest, LazySubsetsEvictLeastRecentlyUsed) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::config::cluster::v3::Cluster::LbSubsetConfig::NO_FALLBACK));
+  EXPECT_CALL(subset_info_, lazySubsets()).WillRepeatedly(Return(true));
+  EXPECT_CALL(subset_info_, maxLazySubsets()).WillRepeatedly(Return(2));
+
+  std::vector<SubsetSelectorPtr> subset_selectors = {makeSelector({"version"})};
+  EXPECT_CALL(subset_info_, subsetSelectors()).WillRepeatedly(ReturnRef(subset_selectors));
+
+  init({{"tcp://127.0.0.1:80", {{"version", "1.0"}}},
+        {"tcp://127.0.0.1:81", {{"version", "1.1"}}},
+        {"tcp://127.0.0.1:82", {{"version", "1.2"}}}});
+
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  TestLoadBalancerContext context_12({{"version", "1.2"}});
+
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10).host);
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_11).host);
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10).host);
+  // 1.1 is the least recently used subset.
+  EXPECT_EQ(host_set_.hosts_[2], lb_->chooseHost(&context_12).host);
+  EXPECT_EQ(3U, stats_.lb_subsets_created_.value());
+  EXPECT_EQ(1U, stats_.lb_subsets_removed_.value());
+  EXPECT_EQ(2U, stats_.lb_subsets_active_.value());
+  EXPECT_EQ(1U,
+            TestUtility::findCounter(stats_store_, "testprefix.lb_subsets_lazy_evicted")->value());
+
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_10).host);
+  EXPECT_EQ(3U, stats_.lb_subsets_created_.value());
+
+  // Evicted subsets are built again on their next use, this time evicting 1.2.
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_11).host);
+  EXPECT_EQ(4U, stats_.lb_subsets_created_.value());
+  EXPECT_EQ(2U,
+            TestUtility::findCounter(stats_store_, "testprefix.lb_subsets_lazy_evicted")->value());
+  EXPECT_EQ(2U, TestUtility::findGauge(stats_store_, "testprefix.lb_subsets_lazy_active")->value());
+
+  // The evicted entry is dropped from the subset map by the next update.
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(host_set_.hosts_[2], lb_->chooseHost(&context_12).host);
+  EXPECT_EQ(5U, stats_.lb_subsets_created_.value());
+}
+
+TEST_F(SubsetLoadBalancerTest, LazySubsetsAllowRedundantKeys) {
+  const std::string yaml = R"EOF(
+  subset_selectors:
+  - keys:
+    - A
+  - keys:
+    - A
+    - B
+  fallback_policy: NO_FALLBACK
+  allow_redundant_keys: true
+  lazy_subsets:
+    max_subsets: 16
+  )EOF";
+
+  envoy::extensions::load_balancing_policies::subset::v3::Subset subset_proto_config;
+  TestUtility::loadFromYaml(yaml, subset_proto_config);
+
+  init({{"tcp://127.0.0.1:80", {{"A", "A-V-0"}, {"B", "B-V-0"}}},
+        {"tcp://127.0.0.1:81", {{"A", "A-V-1"}, {"B", "B-V-1"}}}},
+       {}, std::make_unique<LoadBalancerSubsetInfoImpl>(subset_proto_config));
+  EXPECT_EQ(0U, stats_.lb_subsets_created_.value());
+
+  // The redundant keys are dropped before the lazy subset is looked up, so the subset of the
+  // longest matching selector is built.
+  TestLoadBalancerContext context_0({{"A", "A-V-0"}, {"B", "B-V-0"}, {"redundant", "X"}});
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context_0).host);
+  TestLoadBalancerContext context_1({{"A", "A-V-1"}, {"C", "C-V-X"}});
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_1).host);
+  TestLoadBalancerContext context_2({{"A", "A-V-1"}, {"B", "B-V-X"}, {"redundant", "X"}});
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_2).host);
+  EXPECT_EQ(2U, stats_.lb_subsets_created_.value());
+  EXPECT_EQ(2U, TestUtility::findGauge(stats_store_, "testprefix.lb_subsets_lazy_active")->value());
+}
+
 INSTANTIATE_TEST_SUITE_P(UpdateOrderings, SubsetLoadBalancerTest,
                          testing::ValuesIn({UpdateOrder::RemovesFirst, UpdateOrder::Simultaneous}));
 
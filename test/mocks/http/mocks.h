@@ -705,6 +705,7 @@ public:
   MOCK_METHOD(bool, appendLocalOverload, (), (const));
   MOCK_METHOD(bool, appendXForwardedPort, (), (const));
   MOCK_METHOD(bool, addProxyProtocolConnectionState, (), (const));
+  MOCK_METHOD(uint32_t, streamArenaBlockSize, (), (const));
 
   class AllowInternalAddressConfig : public Http::InternalAddressConfig {
   public:
@@ -12,6 +12,10 @@ public:
   MOCK_METHOD(os_fd_t, registerEventfd, ());
   MOCK_METHOD(void, unregisterEventfd, ());
   MOCK_METHOD(bool, isEventfdRegistered, (), (const));
+  MOCK_METHOD(bool, isZeroCopySendSupported, (), (const));
+  MOCK_METHOD(bool, registerBufferRing, (uint32_t buffer_count, uint32_t buffer_size));
+  MOCK_METHOD(uint8_t*, providedBuffer, (uint16_t buffer_id));
+  MOCK_METHOD(void, recycleProvidedBuffer, (uint16_t buffer_id));
   MOCK_METHOD(void, forEveryCompletion, (const CompletionCb& completion_cb));
   MOCK_METHOD(IoUringResult, prepareAccept,
               (os_fd_t fd, struct sockaddr* remote_addr, socklen_t* remote_addr_len,
@@ -22,9 +26,12 @@ public:
   MOCK_METHOD(IoUringResult, prepareReadv,
               (os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, off_t offset,
                Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareRecv, (os_fd_t fd, bool multishot, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareWritev,
               (os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs, off_t offset,
                Request* user_data));
+  MOCK_METHOD(IoUringResult, prepareSendmsgZc,
+              (os_fd_t fd, const struct msghdr* msg, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareClose, (os_fd_t fd, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareCancel, (Request * cancelling_user_data, Request* user_data));
   MOCK_METHOD(IoUringResult, prepareShutdown, (os_fd_t fd, int how, Request* user_data));